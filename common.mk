@@ -79,4 +79,10 @@ CONFIG_VOICE_CORE_MODE=LIMITED
 # Cooktop_Demo      -- use the cooktop demo model
 DEEPCRAFT_PROJECT_NAME=Smart_Lights_Demo
 
+# Additional projects from the va_models/ folder to link into the firmware.
+# DEEPCRAFT_PROJECT_NAME is loaded at boot, the others can be selected at
+# runtime with the user-button. Each linked project adds its tensor arena
+# and models to the memory footprint.
+#DEEPCRAFT_MODEL_SETS=Smart_Lights_Demo LED_Demo Cooktop_Demo
+
 include ../common_app.mk
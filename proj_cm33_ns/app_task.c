@@ -4,14 +4,22 @@
  */
 
 #include "cybsp.h"
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "cy_syslib.h" // for Cy_SysLib_GetUniqueId
 
 #include "FreeRTOS.h"
+#include "task.h"
 
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
+#include "va_string_table.h"
+#include "mbedtls/base64.h"
+#include "latency_trace.h"
+#include "intent_dispatch.h"
+#include "telemetry_batch.h"
 
 #include "wifi_config.h"
 #include "wifi_app.h"
@@ -29,17 +37,70 @@
 
 #define APP_VERSION_BASE "02.00.00"
 
-#if defined(Smart_Lights_Demo)
-#define APP_VERSION ("S-" APP_VERSION_BASE)
-#elif defined(LED_Demo)
-#define APP_VERSION ("L-" APP_VERSION_BASE)
-#elif defined(Cooktop_Demo)
-#define APP_VERSION ("B-" APP_VERSION_BASE)
-#else
-#define APP_VERSION ("?-" APP_VERSION_BASE)
+// the version is prefixed with the model set active on the CM55, which can be switched at runtime
+static const char* const app_versions[VA_STR_NUM_MODELS] = {
+#if defined(VA_STR_MODEL_Smart_Lights_Demo)
+    [VA_STR_MODEL_Smart_Lights_Demo] = "S-" APP_VERSION_BASE,
 #endif
+#if defined(VA_STR_MODEL_LED_Demo)
+    [VA_STR_MODEL_LED_Demo] = "L-" APP_VERSION_BASE,
+#endif
+#if defined(VA_STR_MODEL_Cooktop_Demo)
+    [VA_STR_MODEL_Cooktop_Demo] = "B-" APP_VERSION_BASE,
+#endif
+};
+
+// longest "event" string reported in the telemetry
+#define EVENT_STR_MAX_LEN 128
+
+// events taken from the CM55 event ring at once
+#define IPC_EVENTS_BATCH_SIZE 8
+
+// the SDK cannot wake the app task for inbound MQTT messages: they are checked
+// at this interval while waiting for the CM55
+#define MQTT_POLL_INTERVAL_MS 100
+
+// the last state is published when there is no event for this long. Changed by the set-reporting-interval command.
+#define IDLE_TELEMETRY_INTERVAL_MS 10000
+
+// how long to wait for the CM55 to respond to a control request. It is handled within one 10 ms frame.
+#define CONTROL_REQUEST_TIMEOUT_MS 1000
+
+// the trace clocks of the cores are matched with this many requests, the offset of the fastest one is kept
+#define CLOCK_SYNC_REQUESTS 8
 
-static int reporting_interval = 2000;
+// and matched again when idle at this interval, to follow their drift
+#define CLOCK_SYNC_INTERVAL_MS 60000
+
+// audio snippets of the events are uploaded in chunks of 1 KB of 16-bit samples, base64 encoded
+#define SNIPPET_CHUNK_SAMPLES 512
+#define SNIPPET_CHUNK_B64_LEN (((SNIPPET_CHUNK_SAMPLES * 2 + 2) / 3) * 4 + 1)
+
+// interval between two chunks, so an upload takes about 20 KB/s of the MQTT link and a 2 s snippet about 3.2 s.
+// The events, the telemetry batch and the inbound messages are served between chunks.
+#define SNIPPET_CHUNK_INTERVAL_MS 50
+
+// the telemetry records are sent together when the oldest one is this old, or when there are this many.
+// The flush interval is changed by the set-telemetry-flush-interval command, 0 sends every record on its own.
+#define TELEMETRY_FLUSH_INTERVAL_MS 500
+#define TELEMETRY_BATCH_SIZE 8
+
+// a record carries only the fields that changed, except every this often and after a connection
+#define TELEMETRY_SNAPSHOT_INTERVAL_MS (5 * 60 * 1000)
+
+// longest ISO 8601 time of a telemetry record, like "2026-01-01T00:00:00.000Z"
+#define TELEMETRY_TIME_STR_LEN 32
+
+static telemetry_batch_t telemetry;
+static uint32_t reporting_interval_ms = IDLE_TELEMETRY_INTERVAL_MS;
+
+// events in the telemetry batch, their latency is recorded when it is sent
+static struct {
+    ipc_payload_t event;
+    ipc_event_trace_t trace;
+    uint32_t queued_us;
+} queued_traces[TELEMETRY_BATCH_MAX_RECORDS];
+static uint32_t num_queued_traces;
 
 /////////////////////////////////////////////////////////////////////////////
 
@@ -72,40 +133,235 @@ static void on_ota(IotclC2dEventData data) {
     printf("OTA download request received for https://%s%s, but it is not implemented.\n", ota_host, ota_path);
 }
 
-// returns success on matching the expected format. Returns is_on, assuming "on" for true, "off" for false
-static bool parse_on_off_command(const char* command, const char* name, bool *arg_parsing_success, bool *is_on, const char** message) {
-    *arg_parsing_success = false;
-    *message = NULL;
-    size_t name_len = strlen(name);
-    if (0 == strncmp(command, name, name_len)) {
-        if (strlen(command) < name_len + 2) { // one for space and at least one character for the argument
-            printf("ERROR: Expected command \"%s\" to have an argument\n", command);
-            *message = "Command requires an argument";
-            *arg_parsing_success = false;
-        } else if (0 == strcmp(&command[name_len + 1], "on")) {
-            *is_on = true;
-            *message = "Value is now \"on\"";
-            *arg_parsing_success = true;
-        } else if (0 == strcmp(&command[name_len + 1], "off")) {
-            *is_on = false;
-            *message = "Value is now \"off\"";
-            *arg_parsing_success = true;
-        } else {
-            *message = "Command argument";
-            *arg_parsing_success = false;
+// names of the va_mode_t running modes of the CM55, in their order
+static const char* const va_mode_names[] = {
+    "ww-single-cmd",
+    "ww-multi-cmd",
+    "ww-only",
+    "cmd-only",
+};
+#define VA_MODE_COUNT (sizeof(va_mode_names) / sizeof(va_mode_names[0]))
+
+static const char* control_status_str(ipc_ctrl_status_t status) {
+    switch (status) {
+        case IPC_CTRL_STATUS_OK:               return "OK";
+        case IPC_CTRL_STATUS_INVALID_ARGUMENT: return "Invalid argument";
+        case IPC_CTRL_STATUS_NOT_SUPPORTED:    return "Not supported by the firmware";
+        case IPC_CTRL_STATUS_TIMEOUT:          return "No response from the CM55";
+        case IPC_CTRL_STATUS_BUSY:             return "CM55 busy with an earlier request";
+        default:                               return "Failed";
+    }
+}
+
+// the ack message of the control requests, which carries the status and round trip time
+static char control_message[64];
+
+// sends a control request to the CM55 and formats the outcome into control_message. Returns true on success.
+static bool send_control_request(ipc_ctrl_type_t type, int32_t value, ipc_ctrl_response_t* response, const char** message) {
+    uint32_t rtt_us = 0;
+    ipc_ctrl_status_t status = cm33_ipc_control_request(type, value, response, CONTROL_REQUEST_TIMEOUT_MS, &rtt_us);
+    if (IPC_CTRL_STATUS_TIMEOUT == status) {
+        snprintf(control_message, sizeof(control_message), "%s", control_status_str(status));
+    } else {
+        snprintf(control_message, sizeof(control_message), "%s (%lu us)", control_status_str(status), (unsigned long) rtt_us);
+    }
+    printf("Control request %d (%ld): %s\n", (int) type, (long) value, control_message);
+    *message = control_message;
+    return IPC_CTRL_STATUS_OK == status;
+}
+
+static void print_pipeline_stats(const ipc_ctrl_stats_t* stats) {
+    const char* model_name = va_string_table_model_name(stats->model_id);
+    printf("CM55 up %lu ms, model %s, mode %s, mic gain %d dB, command timeout %lu ms\n",
+        (unsigned long) stats->uptime_ms,
+        model_name ? model_name : "?",
+        stats->running_mode < VA_MODE_COUNT ? va_mode_names[stats->running_mode] : "?",
+        (int) stats->pdm_gain_db,
+        (unsigned long) stats->command_timeout_ms
+    );
+    printf("Frames processed %lu, dropped %lu, processing time avg %lu us, max %lu us. Events sent %lu, dropped %lu\n",
+        (unsigned long) stats->frames_processed,
+        (unsigned long) stats->frames_dropped,
+        (unsigned long) stats->frame_time_avg_us,
+        (unsigned long) stats->frame_time_max_us,
+        (unsigned long) stats->events_sent,
+        (unsigned long) stats->events_dropped
+    );
+    printf("Audio snippets sent %lu, dropped %lu\n",
+        (unsigned long) stats->snippets_sent,
+        (unsigned long) stats->snippets_dropped
+    );
+}
+
+// type of the argument of a command, decoded into an integer
+typedef enum {
+    COMMAND_ARG_NONE,
+    COMMAND_ARG_INT,      // decimal integer
+    COMMAND_ARG_ON_OFF,   // 1 for "on", 0 for "off"
+    COMMAND_ARG_VA_MODE,  // index in va_mode_names
+} command_arg_type_t;
+
+// handles a command with its decoded argument. Returns true on success, with the ack message.
+typedef bool (*command_handler_t)(int32_t arg, const char** message);
+
+typedef struct {
+    const char* name;
+    command_arg_type_t arg_type;
+    command_handler_t handler;
+} command_t;
+
+static bool on_board_user_led(int32_t on, const char** message) {
+    if (on) {
+        Cy_GPIO_Set(CYBSP_USER_LED_PORT, CYBSP_USER_LED_PIN);
+        *message = "Value is now \"on\"";
+    } else {
+        Cy_GPIO_Clr(CYBSP_USER_LED_PORT, CYBSP_USER_LED_PIN);
+        *message = "Value is now \"off\"";
+    }
+    return true;
+}
+
+static bool on_set_reporting_interval(int32_t interval, const char** message) {
+    if (interval <= 0) {
+        *message = "Argument parsing error";
+        return false;
+    }
+    reporting_interval_ms = (uint32_t) interval;
+    printf("Reporting interval set to %ld\n", (long) interval);
+    *message = "Reporting interval set";
+    return true;
+}
+
+static bool on_set_telemetry_flush_interval(int32_t interval, const char** message) {
+    if (interval < 0) {
+        *message = "Argument parsing error";
+        return false;
+    }
+    telemetry_batch_set_flush_interval(&telemetry, (uint32_t) interval);
+    printf("Telemetry flush interval set to %ld\n", (long) interval);
+    *message = "Telemetry flush interval set";
+    return true;
+}
+
+static bool on_set_mic_gain(int32_t gain_db, const char** message) {
+    ipc_ctrl_response_t response;
+    // the CM55 validates the range
+    return send_control_request(IPC_CTRL_SET_PDM_GAIN, gain_db, &response, message);
+}
+
+static bool on_set_va_mode(int32_t mode, const char** message) {
+    ipc_ctrl_response_t response;
+    return send_control_request(IPC_CTRL_SET_RUNNING_MODE, mode, &response, message);
+}
+
+static bool on_set_command_timeout(int32_t timeout_ms, const char** message) {
+    ipc_ctrl_response_t response;
+    if (timeout_ms <= 0) {
+        *message = "Argument parsing error";
+        return false;
+    }
+    return send_control_request(IPC_CTRL_SET_COMMAND_TIMEOUT, timeout_ms, &response, message);
+}
+
+static bool on_start_voice_id_enrollment(int32_t arg, const char** message) {
+    ipc_ctrl_response_t response;
+    (void) arg;
+    return send_control_request(IPC_CTRL_START_ENROLLMENT, 0, &response, message);
+}
+
+static bool on_get_pipeline_stats(int32_t arg, const char** message) {
+    ipc_ctrl_response_t response;
+    (void) arg;
+    bool success = send_control_request(IPC_CTRL_GET_STATS, 0, &response, message);
+    if (success) {
+        print_pipeline_stats(&response.stats);
+    }
+    return success;
+}
+
+static bool on_get_latency_stats(int32_t arg, const char** message) {
+    (void) arg;
+    latency_trace_print();
+    *message = "Latency statistics printed";
+    return true;
+}
+
+static bool on_get_telemetry_stats(int32_t arg, const char** message) {
+    const telemetry_batch_stats_t* stats = &telemetry.stats;
+    (void) arg;
+    printf("Telemetry: %lu records (%lu coalesced) in %lu messages, %lu snapshots. Fields: %lu sent, %lu unchanged, %lu dropped\n",
+        (unsigned long) stats->records,
+        (unsigned long) stats->coalesced,
+        (unsigned long) stats->messages,
+        (unsigned long) stats->snapshots,
+        (unsigned long) stats->fields_sent,
+        (unsigned long) stats->fields_skipped,
+        (unsigned long) stats->fields_dropped
+    );
+    *message = "Telemetry statistics printed";
+    return true;
+}
+
+static const command_t commands[] = {
+    {"board-user-led",               COMMAND_ARG_ON_OFF,  on_board_user_led},
+    {"set-reporting-interval",       COMMAND_ARG_INT,     on_set_reporting_interval},
+    {"set-telemetry-flush-interval", COMMAND_ARG_INT,     on_set_telemetry_flush_interval},
+    {"set-mic-gain",                 COMMAND_ARG_INT,     on_set_mic_gain},
+    {"set-va-mode",                  COMMAND_ARG_VA_MODE, on_set_va_mode},
+    {"set-command-timeout",          COMMAND_ARG_INT,     on_set_command_timeout},
+    {"start-voice-id-enrollment",    COMMAND_ARG_NONE,    on_start_voice_id_enrollment},
+    {"get-pipeline-stats",           COMMAND_ARG_NONE,    on_get_pipeline_stats},
+    {"get-latency-stats",            COMMAND_ARG_NONE,    on_get_latency_stats},
+    {"get-telemetry-stats",          COMMAND_ARG_NONE,    on_get_telemetry_stats},
+};
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+// decodes the argument of a command, NULL if it has none. Returns false with the ack message if it is not valid.
+static bool decode_command_arg(command_arg_type_t type, const char* arg, int32_t* value, const char** message) {
+    *value = 0;
+    if (type == COMMAND_ARG_NONE) {
+        if (arg) {
+            *message = "Command takes no argument";
+            return false;
         }
-        // we matches the command
         return true;
     }
-
-    // not our command
+    if (!arg || !arg[0]) {
+        *message = "Command requires an argument";
+        return false;
+    }
+    switch (type) {
+        case COMMAND_ARG_INT: {
+            char* end;
+            long number = strtol(arg, &end, 10);
+            if (end == arg || *end != '\0' || (long) (int32_t) number != number) {
+                break;
+            }
+            *value = (int32_t) number;
+            return true;
+        }
+        case COMMAND_ARG_ON_OFF:
+            if (0 == strcmp(arg, "on") || 0 == strcmp(arg, "off")) {
+                *value = (0 == strcmp(arg, "on"));
+                return true;
+            }
+            break;
+        case COMMAND_ARG_VA_MODE:
+            for (size_t mode = 0; mode < VA_MODE_COUNT; mode++) {
+                if (0 == strcmp(arg, va_mode_names[mode])) {
+                    *value = (int32_t) mode;
+                    return true;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    *message = "Argument parsing error";
     return false;
 }
 
 static void on_command(IotclC2dEventData data) {
-    const char * const BOARD_STATUS_LED = "board-user-led";
-    const char * const SET_REPORTING_INTERVAL = "set-reporting-interval "; // with a space
-
     bool command_success = false;
     const char * message = NULL;
 
@@ -113,32 +369,26 @@ static void on_command(IotclC2dEventData data) {
     const char *ack_id = iotcl_c2d_get_ack_id(data);
 
     if (command) {
-        bool arg_parsing_success;
         printf("Command %s received with %s ACK ID\n", command, ack_id ? ack_id : "no");
         // could be a command without acknowledgment, so ackID can be null
-        bool led_on;
-        if (parse_on_off_command(command, BOARD_STATUS_LED, &arg_parsing_success, &led_on, &message)) {
-            command_success = arg_parsing_success;
-            if (arg_parsing_success) {
-                if (led_on) {
-                    Cy_GPIO_Set(CYBSP_USER_LED_PORT, CYBSP_USER_LED_PIN);
-                } else {
-                    Cy_GPIO_Clr(CYBSP_USER_LED_PORT, CYBSP_USER_LED_PIN);
-                }
+        // the name is followed by a space and the argument, if any
+        const char* arg = strchr(command, ' ');
+        size_t name_len = arg ? (size_t) (arg - command) : strlen(command);
+        const command_t* entry = NULL;
+        for (size_t i = 0; i < COMMAND_COUNT; i++) {
+            if (0 == strncmp(commands[i].name, command, name_len) && '\0' == commands[i].name[name_len]) {
+                entry = &commands[i];
+                break;
             }
-        } else if (0 == strncmp(SET_REPORTING_INTERVAL, command, strlen(SET_REPORTING_INTERVAL))) {
-        	int value = atoi(&command[strlen(SET_REPORTING_INTERVAL)]);
-        	if (0 == value) {
-                message = "Argument parsing error";
-        	} else {
-        		reporting_interval = value;
-        		printf("Reporting interval set to %d\n", value);
-        		message = "Reporting interval set";
-        		command_success =  true;
-        	}
-        } else {
+        }
+        int32_t value;
+        if (!entry) {
             printf("Unknown command \"%s\"\n", command);
             message = "Unknown command";
+        } else if (decode_command_arg(entry->arg_type, arg ? &arg[1] : NULL, &value, &message)) {
+            command_success = entry->handler(value, &message);
+        } else {
+            printf("ERROR: Invalid argument of command \"%s\": %s\n", command, message);
         }
     } else {
         printf("Failed to parse command. Command or argument missing?\n");
@@ -159,98 +409,242 @@ static void on_command(IotclC2dEventData data) {
     }
 }
 
-#if defined(Smart_Lights_Demo)
-static void setup_message_smart_lights(IotclMessageHandle* msg, ipc_payload_t* payload) {
-
-    #define ROOM_IDX_KITCHEN 0
-    #define ROOM_IDX_BEDROOM 1
-    #define ROOM_IDX_LIVING_ROOM 2
-    #define ROOMS_ARRAY_LENGTH (ROOM_IDX_LIVING_ROOM + 1)
-    static int light_levels[ROOMS_ARRAY_LENGTH] = {0, 0, 10};  // start with living room lit
-
-    /* Intent Values */
-    #define ROOM_STR_KITCHEN "kitchen"
-    #define ROOM_STR_BEDROOM "bedroom"
-    #define ROOM_STR_LIVING_ROOM "living room"
-
-    if (strlen(payload->intent_name) > 0) {
-        if (0 == strcmp(payload->intent_name, "TurnOnAllLights")) {
-            light_levels[ROOM_IDX_KITCHEN] = 10;
-            light_levels[ROOM_IDX_BEDROOM] = 10;
-            light_levels[ROOM_IDX_LIVING_ROOM]= 10;
-        } else if (0 == strcmp(payload->intent_name, "TurnOffLights")) {
-            if (0 == strcmp(payload->intent_param1_str_var, ROOM_STR_KITCHEN)) {
-                light_levels[ROOM_IDX_KITCHEN] = 0;
-            } else if (0 == strcmp(payload->intent_param1_str_var, ROOM_STR_BEDROOM)) {
-                light_levels[ROOM_IDX_BEDROOM] = 0;
-            } else if (0 == strcmp(payload->intent_param1_str_var, ROOM_STR_LIVING_ROOM)) {
-                light_levels[ROOM_IDX_LIVING_ROOM] = 0;
-            } else {
-                printf("WARN: Unknown room parameter \"%s\" received\n", payload->intent_param1_str_var);
-            }
-        } else if (0 == strcmp(payload->intent_name, "TurnOnLights")) {
-            if (0 == strcmp(payload->intent_param1_str_var, ROOM_STR_KITCHEN)) {
-                light_levels[ROOM_IDX_KITCHEN] = 10;
-            } else if (0 == strcmp(payload->intent_param1_str_var, ROOM_STR_BEDROOM)) {
-                light_levels[ROOM_IDX_BEDROOM] = 10;
-            } else if (0 == strcmp(payload->intent_param1_str_var, ROOM_STR_LIVING_ROOM)) {
-                light_levels[ROOM_IDX_LIVING_ROOM] = 10;
-            } else {
-                printf("WARN: Unknown room parameter \"%s\" received\n", payload->intent_param1_str_var);
-            }            
-        } else if (0 == strcmp(payload->intent_name, "ChangeLights")) {
-            int light_value = (int) payload->intent_param1_int_var;
-            if (light_value >= 0 && light_value <= 10) {
-                if (light_levels[ROOM_IDX_KITCHEN] > 0) {
-                    light_levels[ROOM_IDX_KITCHEN] = light_value;
-                }
-                if (light_levels[ROOM_IDX_BEDROOM] > 0) {
-                    light_levels[ROOM_IDX_BEDROOM] = light_value;
-                }
-                if (light_levels[ROOM_IDX_LIVING_ROOM] > 0) {
-                    light_levels[ROOM_IDX_LIVING_ROOM] = light_value;            
-                }
+// turns an event received from CM55 back into a string with the string table of the model sets.
+// A command is reported as its intent followed by its variables, like "TurnOnLights kitchen"
+static const char* format_event(const ipc_payload_t* payload, char* buf, size_t buf_size) {
+    const char* model_name = va_string_table_model_name(payload->model_id);
+
+    switch (payload->event) {
+        case IPC_EVENT_NONE:
+            return "";
+        case IPC_EVENT_WAKE_WORD:
+            return IPC_CMD_WAKE_WORD_STR;
+        case IPC_EVENT_TIMEOUT:
+            return IPC_CMD_TIMEOUT_STR;
+        case IPC_EVENT_ERROR:
+            return "ERROR";
+        case IPC_EVENT_LICENSE_EXPIRED:
+            return "license expired";
+        case IPC_EVENT_MODEL_CHANGED:
+            snprintf(buf, buf_size, "model %s", model_name ? model_name : "?");
+            return buf;
+        case IPC_EVENT_COMMAND:
+            break;
+        default:
+            return "?";
+    }
 
+    const char* intent = va_string_table_intent(payload->model_id, payload->intent_id);
+    int len = snprintf(buf, buf_size, "%s", intent ? intent : "?");
+    for (unsigned int i = 0; i < payload->num_variables && i < IPC_EVENT_MAX_VARIABLES; i++) {
+        const ipc_variable_t* variable = &payload->variables[i];
+        if (len < 0 || (size_t) len >= buf_size) {
+            break;
+        }
+        if (variable->type == IPC_VARIABLE_PHRASE) {
+            const char* phrase = va_string_table_phrase(payload->model_id, (uint32_t) variable->value);
+            len += snprintf(&buf[len], buf_size - (size_t) len, " %s", phrase ? phrase : "?");
+        } else {
+            const char* unit = (variable->unit_id != IPC_EVENT_NO_UNIT) ?
+                va_string_table_unit(payload->model_id, variable->unit_id) : NULL;
+            if (unit && unit[0]) {
+                len += snprintf(&buf[len], buf_size - (size_t) len, " %ld %s", (long) variable->value, unit);
             } else {
-                printf("WARN: Invalid light level \"%d\" received\n", light_value);
+                len += snprintf(&buf[len], buf_size - (size_t) len, " %ld", (long) variable->value);
             }
-        } else {
-            printf("WARN: Unknown intent \"%s\" received\n", payload->intent_name);
         }
     }
+    return buf;
+}
 
-    iotcl_telemetry_set_number(*msg, "ll_kitchen", light_levels[ROOM_IDX_KITCHEN]);
-    iotcl_telemetry_set_number(*msg, "ll_bedroom", light_levels[ROOM_IDX_BEDROOM]);
-    iotcl_telemetry_set_number(*msg, "ll_living_room", light_levels[ROOM_IDX_LIVING_ROOM]);
+static uint32_t tick_ms(void) {
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
 }
-#endif
 
-static cy_rslt_t publish_telemetry(ipc_payload_t* payload) {
+// time of a record queued age_ms ago. The clock is set with SNTP by the SDK before it connects.
+static const char* format_record_time(time_t now, uint32_t age_ms, char* buf, size_t buf_size) {
+    uint64_t record_ms = (uint64_t) now * 1000 - age_ms;
+    time_t seconds = (time_t) (record_ms / 1000);
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    size_t len = strftime(buf, buf_size, "%Y-%m-%dT%H:%M:%S", &tm);
+    snprintf(&buf[len], buf_size - len, ".%03uZ", (unsigned int) (record_ms % 1000));
+    return buf;
+}
+
+// sends a batch of telemetry records as the data sets of one message, each with its own time
+static void send_telemetry(const telemetry_record_t* records, uint32_t count, void* context) {
+    char time_str[TELEMETRY_TIME_STR_LEN];
+    time_t now = time(NULL);
+    uint32_t now_ms = tick_ms();
+    (void) context;
+
     IotclMessageHandle msg = iotcl_telemetry_create();
+    for (uint32_t i = 0; i < count; i++) {
+        const telemetry_record_t* record = &records[i];
+        iotcl_telemetry_add_with_iso_time(msg, format_record_time(now, now_ms - record->time_ms, time_str, sizeof(time_str)));
+        for (uint32_t f = 0; f < record->num_fields; f++) {
+            const telemetry_field_t* field = &record->fields[f];
+            switch (field->type) {
+                case TELEMETRY_NUMBER:
+                    iotcl_telemetry_set_number(msg, field->name, field->number);
+                    break;
+                case TELEMETRY_BOOL:
+                    iotcl_telemetry_set_bool(msg, field->name, field->boolean);
+                    break;
+                default:
+                    iotcl_telemetry_set_string(msg, field->name, telemetry_record_string(record, field));
+                    break;
+            }
+        }
+    }
+    iotcl_mqtt_send_telemetry(msg, false);
+    iotcl_telemetry_destroy(msg);
+
+    uint32_t publish_done_us = ipc_trace_now_us();
+    for (uint32_t i = 0; i < num_queued_traces; i++) {
+        latency_trace_record(&queued_traces[i].event, &queued_traces[i].trace, queued_traces[i].queued_us, publish_done_us);
+    }
+    num_queued_traces = 0;
+}
 
-    iotcl_telemetry_set_string(msg, "version", APP_VERSION);
-    iotcl_telemetry_set_string(msg, "event", payload->event);
-    iotcl_telemetry_set_bool(msg, "has_event", payload->has_event);
-	iotcl_telemetry_set_bool(msg, "microphone_active", payload->is_mic_active);
+static const char* app_version(uint8_t model_id) {
+    if (model_id < VA_STR_NUM_MODELS && app_versions[model_id]) {
+        return app_versions[model_id];
+    }
+    return "?-" APP_VERSION_BASE;
+}
 
-#if defined(Smart_Lights_Demo)
-    setup_message_smart_lights(&msg, payload);
+// queues the telemetry of an event, or of the state only if trace is NULL. Only the fields that
+// changed are sent, and a state is merged with the previous one if it is not sent yet.
+static void queue_telemetry(ipc_payload_t* payload, const ipc_event_trace_t* trace) {
+    char event_str[EVENT_STR_MAX_LEN];
+    bool has_event = trace && payload->event != IPC_EVENT_NONE;
+
+    // the applications of the model sets act on the commands, and report their state in every record
+    intent_dispatch(payload);
+
+    telemetry_batch_begin(&telemetry, tick_ms(), has_event ? format_event(payload, event_str, sizeof(event_str)) : NULL);
+    telemetry_batch_set_string(&telemetry, "version", app_version(payload->model_id));
+    telemetry_batch_set_bool(&telemetry, "microphone_active", payload->is_mic_active);
+    intent_dispatch_set_telemetry(&telemetry);
+#ifdef LATENCY_TRACE_TELEMETRY
+    latency_trace_set_telemetry(&telemetry);
 #endif
 
-    iotcl_mqtt_send_telemetry(msg, false);
-    iotcl_telemetry_destroy(msg);
+    // the latency is traced from the audio capture to the message sent. Only the detections are traced:
+    // the other events are not raised by the audio.
+    if (has_event && (payload->event == IPC_EVENT_WAKE_WORD || payload->event == IPC_EVENT_COMMAND)) {
+        memcpy(&queued_traces[num_queued_traces].event, payload, sizeof(ipc_payload_t));
+        memcpy(&queued_traces[num_queued_traces].trace, trace, sizeof(ipc_event_trace_t));
+        queued_traces[num_queued_traces].queued_us = ipc_trace_now_us();
+        num_queued_traces++;
+    }
+    telemetry_batch_end(&telemetry, tick_ms());
+}
+
+// snippet being uploaded, and the throughput of the uploads so far
+static struct {
+    ipc_snippet_desc_t* snippet; // NULL if none
+    uint32_t offset; // samples sent
+    uint32_t chunks;
+    TickType_t start;
+    TickType_t last_chunk; // when the last chunk of any snippet was sent
+    uint32_t handover_ms; // from the handover by the CM55 to the start of the upload
+    uint32_t count;
+    uint64_t bytes;
+    uint32_t ms;
+} snippet_upload;
+
+static void report_snippet_upload(void) {
+    ipc_snippet_desc_t* snippet = snippet_upload.snippet;
+    uint32_t bytes = snippet->samples * sizeof(int16_t);
+    uint32_t ms = (uint32_t) ((xTaskGetTickCount() - snippet_upload.start) * portTICK_PERIOD_MS);
+    if (ms == 0) {
+        ms = 1;
+    }
+    snippet_upload.count++;
+    snippet_upload.bytes += bytes;
+    snippet_upload.ms += ms;
+    printf("Snippet of event #%lu uploaded: %lu bytes in %lu chunks, %lu ms, %lu B/s (avg %lu B/s over %lu snippets). Picked up %lu ms after the handover\n",
+        (unsigned long) snippet->seq,
+        (unsigned long) bytes,
+        (unsigned long) snippet_upload.chunks,
+        (unsigned long) ms,
+        (unsigned long) ((uint64_t) bytes * 1000 / ms),
+        (unsigned long) (snippet_upload.bytes * 1000 / snippet_upload.ms),
+        (unsigned long) snippet_upload.count,
+        (unsigned long) snippet_upload.handover_ms
+    );
+}
+
+// uploads the next chunk of the audio snippets handed over by the CM55, read in place in its memory,
+// once SNIPPET_CHUNK_INTERVAL_MS after the last one.
+// returns the ms until the next chunk is due, or UINT32_MAX if no upload is in progress.
+static uint32_t upload_snippet_chunk(void) {
+    static unsigned char b64[SNIPPET_CHUNK_B64_LEN];
+    const int16_t* samples;
+    size_t b64_len = 0;
+
+    if (!snippet_upload.snippet) {
+        snippet_upload.snippet = cm33_ipc_take_snippet();
+        if (!snippet_upload.snippet) {
+            return UINT32_MAX;
+        }
+        snippet_upload.offset = 0;
+        snippet_upload.chunks = 0;
+        snippet_upload.start = xTaskGetTickCount();
+        if (!cm33_ipc_get_cm55_age_ms(snippet_upload.snippet->ready_ms, &snippet_upload.handover_ms)) {
+            snippet_upload.handover_ms = 0;
+        }
+    }
+
+    // the next snippet is paced after the last chunk of the previous one too
+    uint32_t elapsed_ms = (uint32_t) ((xTaskGetTickCount() - snippet_upload.last_chunk) * portTICK_PERIOD_MS);
+    if (snippet_upload.chunks + snippet_upload.count > 0 && elapsed_ms < SNIPPET_CHUNK_INTERVAL_MS) {
+        return SNIPPET_CHUNK_INTERVAL_MS - elapsed_ms;
+    }
 
+    ipc_snippet_desc_t* snippet = snippet_upload.snippet;
+    // a chunk is shorter where the circular buffer of the CM55 wraps
+    uint32_t count = ipc_snippet_get_samples(snippet, snippet_upload.offset, SNIPPET_CHUNK_SAMPLES, &samples);
+    if (count > 0 && 0 == mbedtls_base64_encode(b64, sizeof(b64), &b64_len, (const unsigned char*) samples, count * sizeof(int16_t))) {
+        const char* model_name = va_string_table_model_name(snippet->model_id);
+        IotclMessageHandle msg = iotcl_telemetry_create();
+        iotcl_telemetry_set_number(msg, "snippet_seq", snippet->seq);
+        iotcl_telemetry_set_string(msg, "snippet_event", snippet->event == IPC_EVENT_WAKE_WORD ? "wake word" : "command");
+        iotcl_telemetry_set_string(msg, "snippet_model", model_name ? model_name : "?");
+        iotcl_telemetry_set_number(msg, "snippet_rate", IPC_SNIPPET_SAMPLE_RATE);
+        iotcl_telemetry_set_number(msg, "snippet_samples", snippet->samples);
+        iotcl_telemetry_set_number(msg, "snippet_offset", snippet_upload.offset);
+        iotcl_telemetry_set_string(msg, "snippet_audio", (const char*) b64); // 16-bit little endian PCM
+        iotcl_mqtt_send_telemetry(msg, false);
+        iotcl_telemetry_destroy(msg);
+        snippet_upload.offset += count;
+        snippet_upload.chunks++;
+    }
+    snippet_upload.last_chunk = xTaskGetTickCount();
 
-    return CY_RSLT_SUCCESS;
+    if (snippet_upload.offset >= snippet->samples) {
+        report_snippet_upload();
+        cm33_ipc_release_snippet(snippet); // the CM55 can record into the buffer again
+        snippet_upload.snippet = NULL;
+    }
+    return SNIPPET_CHUNK_INTERVAL_MS;
 }
 
 void app_task(void *pvParameters) {
     printf("CM33 /IOTCONNECT App Task Started. Waiting for CM55 IPC to start..\n");
     // we want to wait for CM33 to start receiving messages to prevent halts and errors below.
-    while (!cm33_ipc_has_received_message()) {
-        taskYIELD(); // wait for CM55
+    while (!cm33_ipc_wait_for_message(IPC_WAIT_FOREVER)) {
+        // wait for CM55
     }
     printf("App Task: CM55 IPC is ready. Resuming the application...\n");
+    if (!cm33_ipc_sync_clock(CLOCK_SYNC_REQUESTS, CONTROL_REQUEST_TIMEOUT_MS)) {
+        printf("WARN: Failed to match the clocks of the cores. The latency is traced without the IPC.\n");
+    }
+    TickType_t last_clock_sync = xTaskGetTickCount();
+    telemetry_batch_init(&telemetry, TELEMETRY_FLUSH_INTERVAL_MS, TELEMETRY_BATCH_SIZE, TELEMETRY_SNAPSHOT_INTERVAL_MS, send_telemetry, NULL);
 
     char iotc_duid[IOTCL_CONFIG_DUID_MAX_LEN] = IOTCONNECT_DUID;
     if (0 == strlen(iotc_duid)) {
@@ -312,21 +706,53 @@ void app_task(void *pvParameters) {
         }
         
         ipc_payload_t payload;
-        cm33_ipc_safe_get_and_clear_cached_detection(&payload);
-        publish_telemetry(&payload); // publish the inital message
-
-        for (int j = 0; iotconnect_sdk_is_connected() && j < 300; j++) { // send up to "300 messaages * i" to not flood while developing
-            for (int tries = 0; tries < 100; tries++) { // try 100 times * 100 ms = wait up to 10 seconds
-                iotconnect_sdk_poll_inbound_mq(100);
-                // printf("Has IPC Data: %s\n", cm33_ipc_has_received_message() ? "true" : "false");
-                bool has_payload = cm33_ipc_safe_get_and_clear_cached_detection(&payload);
-                if (!has_payload || !payload.has_event) {
-                    continue; // loop tries to do another poll for 100ms and try again
-                } else {
-                    break; // will break the try loop and publish ASAP
+        cm33_ipc_safe_copy_last_payload(&payload);
+        telemetry_batch_request_snapshot(&telemetry); // the cloud has every field again after a connection
+        queue_telemetry(&payload, NULL); // publish the inital message
+
+        TickType_t last_publish = xTaskGetTickCount();
+        for (int j = 0; iotconnect_sdk_is_connected() && j < 300;) { // send up to "300 messaages * i" to not flood while developing
+            static ipc_payload_t events[IPC_EVENTS_BATCH_SIZE];
+            static ipc_event_trace_t traces[IPC_EVENTS_BATCH_SIZE];
+            uint32_t num_events = cm33_ipc_receive_events(events, traces, IPC_EVENTS_BATCH_SIZE);
+            for (uint32_t k = 0; k < num_events; k++) {
+                queue_telemetry(&events[k], &traces[k]); // publish every event, in order, with the batch
+                j++;
+            }
+            if (num_events > 0) {
+                last_publish = xTaskGetTickCount();
+                if (num_events == IPC_EVENTS_BATCH_SIZE) {
+                    continue; // more events may be in the ring, which is not signaled again until empty
+                }
+            } else if ((xTaskGetTickCount() - last_publish) >= pdMS_TO_TICKS(reporting_interval_ms)) {
+                cm33_ipc_safe_copy_last_payload(&payload);
+                queue_telemetry(&payload, NULL); // publish whatever is available when there was no event for a while
+                last_publish = xTaskGetTickCount();
+                j++;
+                if ((last_publish - last_clock_sync) >= pdMS_TO_TICKS(CLOCK_SYNC_INTERVAL_MS)) {
+                    cm33_ipc_sync_clock(CLOCK_SYNC_REQUESTS, CONTROL_REQUEST_TIMEOUT_MS);
+                    last_clock_sync = xTaskGetTickCount();
                 }
             }
-            publish_telemetry(&payload); // publish the new message or whatever is available after a set number of tries
+            // audio snippets are uploaded one chunk at a time, paced after the events. Chunks are not counted in j.
+            uint32_t upload_ms = upload_snippet_chunk();
+
+            // sends the telemetry batch when its oldest record is due
+            uint32_t wait_ms = telemetry_batch_poll(&telemetry, tick_ms());
+
+            // sleep until the CM55 queues an event, or it is time to check for inbound messages, upload or send the batch
+            if (wait_ms > upload_ms) {
+                wait_ms = upload_ms;
+            }
+            if (wait_ms > MQTT_POLL_INTERVAL_MS) {
+                wait_ms = MQTT_POLL_INTERVAL_MS;
+            }
+            cm33_ipc_wait_for_message(wait_ms);
+            iotconnect_sdk_poll_inbound_mq(0);
+        }
+        // a batch left after a disconnection is sent after the next connection, with the time of its records
+        if (iotconnect_sdk_is_connected()) {
+            telemetry_batch_flush(&telemetry);
         }
         iotconnect_sdk_disconnect();
     }
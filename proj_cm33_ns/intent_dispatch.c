@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "intent_dispatch.h"
+#include "smart_lights.h"
+
+// applications of the model sets linked into the CM55 (VA_MODEL_SET_<name>), indexed by their
+// VA_STR_MODEL_<name> ID, whichever is active. A model set without an application is only reported
+// with its intent and variables in the "event" of the telemetry.
+static const intent_model_t* const intent_models[VA_STR_NUM_MODELS] = {
+#if defined(VA_MODEL_SET_Smart_Lights_Demo)
+    [VA_STR_MODEL_Smart_Lights_Demo] = &smart_lights_model,
+#endif
+};
+
+bool intent_args_get_phrase(const intent_args_t* args, uint16_t variable_id, int32_t* phrase_id) {
+    if (variable_id >= VA_STR_MAX_NUM_VARIABLES || 0 == (args->present & (1u << variable_id))
+        || args->variables[variable_id].type != IPC_VARIABLE_PHRASE) {
+        return false;
+    }
+    *phrase_id = args->variables[variable_id].value;
+    return true;
+}
+
+bool intent_args_get_number(const intent_args_t* args, uint16_t variable_id, int32_t* number) {
+    if (variable_id >= VA_STR_MAX_NUM_VARIABLES || 0 == (args->present & (1u << variable_id))
+        || args->variables[variable_id].type != IPC_VARIABLE_NUMBER) {
+        return false;
+    }
+    *number = args->variables[variable_id].value;
+    return true;
+}
+
+void intent_dispatch(const ipc_payload_t* event) {
+    if (event->event != IPC_EVENT_COMMAND || event->model_id >= VA_STR_NUM_MODELS) {
+        return;
+    }
+    const intent_model_t* model = intent_models[event->model_id];
+    if (!model || !model->intents) {
+        return;
+    }
+    if (event->intent_id >= model->num_intents) {
+        printf("WARN: Unknown intent %u received\n", (unsigned int) event->intent_id);
+        return;
+    }
+    intent_handler_t handler = model->intents[event->intent_id];
+    if (!handler) {
+        return;
+    }
+
+    intent_args_t args;
+    args.present = 0;
+    for (unsigned int i = 0; i < event->num_variables && i < IPC_EVENT_MAX_VARIABLES; i++) {
+        const ipc_variable_t* variable = &event->variables[i];
+        if (variable->variable_id < VA_STR_MAX_NUM_VARIABLES) {
+            memcpy(&args.variables[variable->variable_id], variable, sizeof(ipc_variable_t));
+            args.present |= 1u << variable->variable_id;
+        }
+    }
+    handler(&args);
+}
+
+void intent_dispatch_set_telemetry(telemetry_batch_t* telemetry) {
+    for (unsigned int m = 0; m < VA_STR_NUM_MODELS; m++) {
+        if (intent_models[m] && intent_models[m]->set_telemetry) {
+            intent_models[m]->set_telemetry(telemetry);
+        }
+    }
+}
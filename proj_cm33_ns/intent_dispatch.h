@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef INTENT_DISPATCH_H_
+#define INTENT_DISPATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ipc_communication.h"
+#include "va_string_table.h"
+#include "telemetry_batch.h"
+
+// arguments of a command, decoded from its variables: indexed by the variable IDs of its model set
+typedef struct {
+    uint32_t present; // bit per variable ID
+    ipc_variable_t variables[VA_STR_MAX_NUM_VARIABLES];
+} intent_args_t;
+
+_Static_assert(VA_STR_MAX_NUM_VARIABLES <= 32, "intent_args_t.present too small");
+
+typedef void (*intent_handler_t)(const intent_args_t* args);
+
+// application of a model set: handlers of its intents, indexed by their VA_STR_<model>_INTENT_<name> ID,
+// and the state it adds to every telemetry record. Any of them can be NULL.
+typedef struct {
+    const intent_handler_t* intents;
+    uint16_t num_intents;
+    void (*set_telemetry)(telemetry_batch_t* telemetry);
+} intent_model_t;
+
+// returns the phrase ID of a variable of the command, false if the command does not have it
+bool intent_args_get_phrase(const intent_args_t* args, uint16_t variable_id, int32_t* phrase_id);
+
+// returns the number of a variable of the command, false if the command does not have it
+bool intent_args_get_number(const intent_args_t* args, uint16_t variable_id, int32_t* number);
+
+// calls the handler of the intent of a command event, if its model set has one
+void intent_dispatch(const ipc_payload_t* event);
+
+// adds the state of the applications of the model sets to the telemetry record being queued
+void intent_dispatch_set_telemetry(telemetry_batch_t* telemetry);
+
+#endif /* INTENT_DISPATCH_H_ */
@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "latency_trace.h"
+
+// the histograms have 4 buckets per power of 2 of microseconds, so a percentile is within 25%.
+// The values below 4 us have a bucket each.
+#define LATENCY_SUB_BUCKET_BITS 2
+#define LATENCY_SUB_BUCKETS (1u << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKETS ((32 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_BUCKETS];
+} latency_histogram_t;
+
+static const char* const hop_names[LATENCY_HOP_COUNT] = {
+    "queue",
+    "inference",
+    "event",
+    "ipc",
+    "task",
+    "publish",
+    "total",
+};
+
+static latency_histogram_t histograms[LATENCY_HOP_COUNT];
+
+static uint32_t bucket_of(uint32_t us) {
+    if (us < LATENCY_SUB_BUCKETS) {
+        return us;
+    }
+    uint32_t exponent = 31 - (uint32_t) __builtin_clz(us);
+    uint32_t sub_bucket = (us >> (exponent - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1);
+    return (exponent - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS + sub_bucket;
+}
+
+// largest value that falls in the bucket
+static uint32_t bucket_top(uint32_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    uint32_t exponent = bucket / LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKET_BITS - 1;
+    uint32_t sub_bucket = bucket % LATENCY_SUB_BUCKETS;
+    uint32_t width = 1u << (exponent - LATENCY_SUB_BUCKET_BITS);
+    return ((LATENCY_SUB_BUCKETS + sub_bucket) << (exponent - LATENCY_SUB_BUCKET_BITS)) + (width - 1);
+}
+
+static void histogram_add(latency_histogram_t* h, uint32_t us) {
+    if (h->count == 0 || us < h->min_us) {
+        h->min_us = us;
+    }
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    h->sum_us += us;
+    h->count++;
+    h->buckets[bucket_of(us)]++;
+}
+
+// upper bound of the percentile, which is never above the maximum
+static uint32_t histogram_percentile(const latency_histogram_t* h, uint32_t percent) {
+    uint32_t rank = (uint32_t) (((uint64_t) h->count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen >= rank && seen > 0) {
+            uint32_t top = bucket_top(b);
+            return (top < h->max_us) ? top : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+// time from start_us to end_us of the same clock. A few us below 0 across the cores is the error of the clock offset.
+static uint32_t elapsed_us(uint32_t start_us, uint32_t end_us) {
+    int32_t elapsed = (int32_t) (end_us - start_us);
+    return (elapsed > 0) ? (uint32_t) elapsed : 0;
+}
+
+void latency_trace_record(const ipc_payload_t* event, const ipc_event_trace_t* trace, uint32_t queued_us, uint32_t publish_done_us) {
+    uint32_t hops[LATENCY_HOP_COUNT];
+    uint32_t send_us;
+    uint32_t capture_us;
+    bool synced = cm33_ipc_cm55_to_cm33_us(event->send_us, &send_us);
+    synced = synced && cm33_ipc_cm55_to_cm33_us(event->capture_us, &capture_us);
+
+    hops[LATENCY_HOP_QUEUE] = elapsed_us(event->capture_us, event->process_us);
+    hops[LATENCY_HOP_INFERENCE] = elapsed_us(event->process_us, event->detect_us);
+    hops[LATENCY_HOP_EVENT] = elapsed_us(event->detect_us, event->send_us);
+    hops[LATENCY_HOP_TASK] = elapsed_us(trace->received_us, queued_us);
+    hops[LATENCY_HOP_PUBLISH] = elapsed_us(queued_us, publish_done_us);
+    if (synced) {
+        hops[LATENCY_HOP_IPC] = elapsed_us(send_us, trace->received_us);
+        hops[LATENCY_HOP_TOTAL] = elapsed_us(capture_us, publish_done_us);
+    }
+
+    for (int hop = 0; hop < LATENCY_HOP_COUNT; hop++) {
+        if (synced || (hop != LATENCY_HOP_IPC && hop != LATENCY_HOP_TOTAL)) {
+            histogram_add(&histograms[hop], hops[hop]);
+        }
+    }
+
+    if (synced) {
+        printf("Event #%lu latency: queue %lu, inference %lu, event %lu, ipc %lu, task %lu, publish %lu, total %lu us\n",
+            (unsigned long) event->seq,
+            (unsigned long) hops[LATENCY_HOP_QUEUE],
+            (unsigned long) hops[LATENCY_HOP_INFERENCE],
+            (unsigned long) hops[LATENCY_HOP_EVENT],
+            (unsigned long) hops[LATENCY_HOP_IPC],
+            (unsigned long) hops[LATENCY_HOP_TASK],
+            (unsigned long) hops[LATENCY_HOP_PUBLISH],
+            (unsigned long) hops[LATENCY_HOP_TOTAL]
+        );
+    } else {
+        printf("Event #%lu latency: queue %lu, inference %lu, event %lu, task %lu, publish %lu us. The clocks of the cores are not matched yet\n",
+            (unsigned long) event->seq,
+            (unsigned long) hops[LATENCY_HOP_QUEUE],
+            (unsigned long) hops[LATENCY_HOP_INFERENCE],
+            (unsigned long) hops[LATENCY_HOP_EVENT],
+            (unsigned long) hops[LATENCY_HOP_TASK],
+            (unsigned long) hops[LATENCY_HOP_PUBLISH]
+        );
+    }
+}
+
+void latency_trace_print(void) {
+    int32_t offset_us;
+    uint32_t round_trip_us;
+    if (cm33_ipc_get_clock_offset(&offset_us, &round_trip_us)) {
+        printf("Event latency in us. CM55 clock offset %ld us, +/- %lu us\n", (long) offset_us, (unsigned long) (round_trip_us / 2));
+    } else {
+        printf("Event latency in us. The clocks of the cores are not matched: no ipc and total latency\n");
+    }
+    printf("%-10s %8s %8s %8s %8s %8s %8s %8s\n", "hop", "count", "min", "avg", "p50", "p90", "p99", "max");
+    for (int hop = 0; hop < LATENCY_HOP_COUNT; hop++) {
+        const latency_histogram_t* h = &histograms[hop];
+        if (h->count == 0) {
+            printf("%-10s %8u\n", hop_names[hop], 0u);
+            continue;
+        }
+        printf("%-10s %8lu %8lu %8lu %8lu %8lu %8lu %8lu\n",
+            hop_names[hop],
+            (unsigned long) h->count,
+            (unsigned long) h->min_us,
+            (unsigned long) (h->sum_us / h->count),
+            (unsigned long) histogram_percentile(h, 50),
+            (unsigned long) histogram_percentile(h, 90),
+            (unsigned long) histogram_percentile(h, 99),
+            (unsigned long) h->max_us
+        );
+    }
+}
+
+#ifdef LATENCY_TRACE_TELEMETRY
+void latency_trace_set_telemetry(telemetry_batch_t* telemetry) {
+    const latency_histogram_t* h = &histograms[LATENCY_HOP_TOTAL];
+    if (h->count == 0) {
+        return;
+    }
+    telemetry_batch_set_number(telemetry, "latency_count", h->count);
+    telemetry_batch_set_number(telemetry, "latency_p50_us", histogram_percentile(h, 50));
+    telemetry_batch_set_number(telemetry, "latency_p90_us", histogram_percentile(h, 90));
+    telemetry_batch_set_number(telemetry, "latency_p99_us", histogram_percentile(h, 99));
+    telemetry_batch_set_number(telemetry, "latency_max_us", h->max_us);
+}
+#endif
@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef LATENCY_TRACE_H_
+#define LATENCY_TRACE_H_
+
+#include <stdint.h>
+
+#include "ipc_communication.h"
+
+#ifdef LATENCY_TRACE_TELEMETRY
+#include "telemetry_batch.h"
+#endif
+
+// stages of an event from the audio capture on the CM55 to the telemetry sent by the CM33
+typedef enum {
+    LATENCY_HOP_QUEUE,      // audio frame captured -> voice assistant processing started (CM55)
+    LATENCY_HOP_INFERENCE,  // voice assistant processing of the frame (CM55)
+    LATENCY_HOP_EVENT,      // end of the processing -> event queued to the CM33 (CM55)
+    LATENCY_HOP_IPC,        // event queued -> event received by the CM33 (both cores)
+    LATENCY_HOP_TASK,       // event received -> telemetry queued (CM33)
+    LATENCY_HOP_PUBLISH,    // telemetry queued -> message published, with the wait for the batch (CM33)
+    LATENCY_HOP_TOTAL,      // audio frame captured -> telemetry published (both cores)
+    LATENCY_HOP_COUNT
+} latency_hop_t;
+
+// records the latency of an event queued at queued_us and published at publish_done_us, CM33 trace times.
+// The hops across the cores are only recorded once the trace clocks are matched.
+void latency_trace_record(const ipc_payload_t* event, const ipc_event_trace_t* trace, uint32_t queued_us, uint32_t publish_done_us);
+
+// prints the count, minimum, average, percentiles and maximum of every hop
+void latency_trace_print(void);
+
+#ifdef LATENCY_TRACE_TELEMETRY
+// adds the percentiles of the total latency to the telemetry record being queued
+void latency_trace_set_telemetry(telemetry_batch_t* telemetry);
+#endif
+
+#endif /* LATENCY_TRACE_H_ */
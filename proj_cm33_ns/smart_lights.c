@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+
+#include "smart_lights.h"
+
+#define ROOM_IDX_KITCHEN 0
+#define ROOM_IDX_BEDROOM 1
+#define ROOM_IDX_LIVING_ROOM 2
+#define ROOMS_ARRAY_LENGTH (ROOM_IDX_LIVING_ROOM + 1)
+
+#define LIGHT_LEVEL_MAX 10
+
+static int light_levels[ROOMS_ARRAY_LENGTH] = {0, 0, LIGHT_LEVEL_MAX};  // start with living room lit
+
+// room of the location phrases plus one, indexed by phrase ID. 0 for the other phrases.
+static const uint8_t phrase_rooms[VA_STR_Smart_Lights_Demo_NUM_VARIABLE_PHRASES] = {
+    [VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOn_kitchen] = ROOM_IDX_KITCHEN + 1,
+    [VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOn_bedroom] = ROOM_IDX_BEDROOM + 1,
+    [VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOn_living_room] = ROOM_IDX_LIVING_ROOM + 1,
+    [VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOff_kitchen] = ROOM_IDX_KITCHEN + 1,
+    [VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOff_bedroom] = ROOM_IDX_BEDROOM + 1,
+    [VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOff_living_room] = ROOM_IDX_LIVING_ROOM + 1,
+};
+
+// sets the level of the room of a location variable of the command
+static void set_room_level(const intent_args_t* args, uint16_t location_variable_id, int level) {
+    int32_t phrase_id = -1;
+    bool has_location = intent_args_get_phrase(args, location_variable_id, &phrase_id);
+    if (has_location && (uint32_t) phrase_id < VA_STR_Smart_Lights_Demo_NUM_VARIABLE_PHRASES
+        && phrase_rooms[phrase_id] != 0) {
+        light_levels[phrase_rooms[phrase_id] - 1] = level;
+    } else {
+        printf("WARN: Unknown room parameter %ld received\n", (long) phrase_id);
+    }
+}
+
+static void turn_on_lights(const intent_args_t* args) {
+    set_room_level(args, VA_STR_Smart_Lights_Demo_VARIABLE_LocationLightsOn, LIGHT_LEVEL_MAX);
+}
+
+static void turn_off_lights(const intent_args_t* args) {
+    set_room_level(args, VA_STR_Smart_Lights_Demo_VARIABLE_LocationLightsOff, 0);
+}
+
+static void turn_on_all_lights(const intent_args_t* args) {
+    (void) args;
+    for (int room = 0; room < ROOMS_ARRAY_LENGTH; room++) {
+        light_levels[room] = LIGHT_LEVEL_MAX;
+    }
+}
+
+// changes the level of the rooms that are lit
+static void change_lights(const intent_args_t* args) {
+    int32_t level = -1;
+    if (!intent_args_get_number(args, VA_STR_Smart_Lights_Demo_VARIABLE_Intensity, &level)
+        || level < 0 || level > LIGHT_LEVEL_MAX) {
+        printf("WARN: Invalid light level \"%ld\" received\n", (long) level);
+        return;
+    }
+    for (int room = 0; room < ROOMS_ARRAY_LENGTH; room++) {
+        if (light_levels[room] > 0) {
+            light_levels[room] = (int) level;
+        }
+    }
+}
+
+static void set_telemetry(telemetry_batch_t* telemetry) {
+    telemetry_batch_set_number(telemetry, "ll_kitchen", light_levels[ROOM_IDX_KITCHEN]);
+    telemetry_batch_set_number(telemetry, "ll_bedroom", light_levels[ROOM_IDX_BEDROOM]);
+    telemetry_batch_set_number(telemetry, "ll_living_room", light_levels[ROOM_IDX_LIVING_ROOM]);
+}
+
+static const intent_handler_t intents[VA_STR_Smart_Lights_Demo_NUM_INTENTS] = {
+    [VA_STR_Smart_Lights_Demo_INTENT_TurnOnLights] = turn_on_lights,
+    [VA_STR_Smart_Lights_Demo_INTENT_TurnOffLights] = turn_off_lights,
+    [VA_STR_Smart_Lights_Demo_INTENT_TurnOnAllLights] = turn_on_all_lights,
+    [VA_STR_Smart_Lights_Demo_INTENT_ChangeLights] = change_lights,
+};
+
+const intent_model_t smart_lights_model = {
+    .intents = intents,
+    .num_intents = VA_STR_Smart_Lights_Demo_NUM_INTENTS,
+    .set_telemetry = set_telemetry,
+};
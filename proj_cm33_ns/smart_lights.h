@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef SMART_LIGHTS_H_
+#define SMART_LIGHTS_H_
+
+#include "intent_dispatch.h"
+
+// light levels of the rooms, set by the commands of the Smart_Lights_Demo model set
+extern const intent_model_t smart_lights_model;
+
+#endif /* SMART_LIGHTS_H_ */
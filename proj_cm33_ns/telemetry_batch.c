@@ -0,0 +1,212 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+
+#include "telemetry_batch.h"
+
+// type of a last value never queued, or dropped for lack of room: the field is sent with the next record
+#define LAST_NONE 0xFFu
+
+// FNV-1a, to tell a changed string from the one last queued without keeping it
+static uint32_t string_hash(const char* s) {
+    uint32_t hash = 2166136261u;
+    while (*s) {
+        hash ^= (uint8_t) *s++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void telemetry_batch_init(telemetry_batch_t* batch, uint32_t flush_interval_ms, uint32_t batch_size,
+    uint32_t snapshot_interval_ms, telemetry_batch_send_t send, void* context) {
+    memset(batch, 0, sizeof(telemetry_batch_t));
+    batch->flush_interval_ms = flush_interval_ms;
+    batch->batch_size = (batch_size == 0 || batch_size > TELEMETRY_BATCH_MAX_RECORDS) ? TELEMETRY_BATCH_MAX_RECORDS : batch_size;
+    batch->snapshot_interval_ms = snapshot_interval_ms;
+    batch->send = send;
+    batch->context = context;
+    batch->snapshot_due = true;
+}
+
+void telemetry_batch_set_flush_interval(telemetry_batch_t* batch, uint32_t flush_interval_ms) {
+    batch->flush_interval_ms = flush_interval_ms;
+}
+
+void telemetry_batch_request_snapshot(telemetry_batch_t* batch) {
+    batch->snapshot_due = true;
+}
+
+const char* telemetry_record_string(const telemetry_record_t* record, const telemetry_field_t* field) {
+    return &record->strings[field->string];
+}
+
+// returns the last queued value of a field, a new one if it was never queued, NULL if there is no room
+static telemetry_last_t* find_last(telemetry_batch_t* batch, const char* name) {
+    for (uint32_t i = 0; i < batch->num_last; i++) {
+        if (batch->last[i].name == name || 0 == strcmp(batch->last[i].name, name)) {
+            return &batch->last[i];
+        }
+    }
+    if (batch->num_last >= TELEMETRY_RECORD_MAX_FIELDS) {
+        return NULL;
+    }
+    batch->last[batch->num_last].name = name;
+    batch->last[batch->num_last].type = LAST_NONE;
+    return &batch->last[batch->num_last++];
+}
+
+// removes the string of a field from its record, and moves the strings after it down
+static void remove_string(telemetry_record_t* record, const telemetry_field_t* field) {
+    uint16_t offset = field->string;
+    uint16_t len = (uint16_t) (strlen(&record->strings[offset]) + 1);
+    memmove(&record->strings[offset], &record->strings[offset + len], record->strings_len - offset - len);
+    record->strings_len -= len;
+    for (uint32_t i = 0; i < record->num_fields; i++) {
+        if (record->fields[i].type == TELEMETRY_STRING && record->fields[i].string > offset) {
+            record->fields[i].string -= len;
+        }
+    }
+}
+
+static void set_field(telemetry_batch_t* batch, const char* name, telemetry_type_t type,
+    double number, bool boolean, const char* string, bool always) {
+    telemetry_record_t* record = batch->current;
+    if (!record) {
+        return;
+    }
+
+    uint32_t hash = (type == TELEMETRY_STRING) ? string_hash(string) : 0;
+    telemetry_last_t* last = find_last(batch, name);
+    bool changed = !last || last->type != type ||
+        (type == TELEMETRY_NUMBER && last->number != number) ||
+        (type == TELEMETRY_BOOL && last->boolean != boolean) ||
+        (type == TELEMETRY_STRING && last->string_hash != hash);
+    if (!changed && !always && !record->snapshot) {
+        batch->stats.fields_skipped++;
+        return;
+    }
+    // a field set again in a coalesced record takes the new value, in place of the old one
+    telemetry_field_t* field = NULL;
+    for (uint32_t i = 0; i < record->num_fields; i++) {
+        if (record->fields[i].name == name || 0 == strcmp(record->fields[i].name, name)) {
+            field = &record->fields[i];
+            break;
+        }
+    }
+    size_t len = (type == TELEMETRY_STRING) ? strlen(string) + 1 : 0;
+    size_t old_len = (field && field->type == TELEMETRY_STRING) ? strlen(telemetry_record_string(record, field)) + 1 : 0;
+    if ((!field && record->num_fields >= TELEMETRY_RECORD_MAX_FIELDS)
+        || record->strings_len - old_len + len > TELEMETRY_RECORD_STRINGS_LEN) {
+        // a field of the record keeps its old value, which is the last one queued. A new field is
+        // sent with the next record that has room for it.
+        if (!field && last) {
+            last->type = LAST_NONE;
+        }
+        batch->stats.fields_dropped++;
+        return;
+    }
+    if (!field) {
+        field = &record->fields[record->num_fields++];
+        field->name = name;
+    } else if (old_len > 0) {
+        remove_string(record, field);
+    }
+    field->type = (uint8_t) type;
+    field->number = number;
+    field->boolean = boolean;
+    if (type == TELEMETRY_STRING) {
+        memcpy(&record->strings[record->strings_len], string, len);
+        field->string = record->strings_len;
+        record->strings_len += (uint16_t) len;
+    }
+    if (last) {
+        last->type = (uint8_t) type;
+        last->number = number;
+        last->boolean = boolean;
+        last->string_hash = hash;
+    }
+}
+
+void telemetry_batch_begin(telemetry_batch_t* batch, uint32_t now_ms, const char* event) {
+    bool snapshot = batch->snapshot_due || (now_ms - batch->snapshot_ms) >= batch->snapshot_interval_ms;
+    if (snapshot) {
+        batch->snapshot_due = false;
+        batch->snapshot_ms = now_ms;
+        batch->stats.snapshots++;
+    }
+
+    telemetry_record_t* record;
+    if (!event && batch->count > 0 && !batch->records[batch->count - 1].has_event) {
+        record = &batch->records[batch->count - 1];
+        record->snapshot = record->snapshot || snapshot;
+        batch->stats.coalesced++;
+    } else {
+        if (batch->count >= TELEMETRY_BATCH_MAX_RECORDS) {
+            telemetry_batch_flush(batch);
+        }
+        if (batch->count == 0) {
+            batch->first_ms = now_ms;
+        }
+        record = &batch->records[batch->count++];
+        record->has_event = (event != NULL);
+        record->snapshot = snapshot;
+        record->num_fields = 0;
+        record->strings_len = 0;
+    }
+    record->time_ms = now_ms;
+    batch->current = record;
+    batch->stats.records++;
+
+    // the event fields are sent with every record: the same event can happen twice
+    set_field(batch, "has_event", TELEMETRY_BOOL, 0, event != NULL, NULL, true);
+    if (event) {
+        set_field(batch, "event", TELEMETRY_STRING, 0, false, event, true);
+    }
+}
+
+void telemetry_batch_set_number(telemetry_batch_t* batch, const char* name, double value) {
+    set_field(batch, name, TELEMETRY_NUMBER, value, false, NULL, false);
+}
+
+void telemetry_batch_set_bool(telemetry_batch_t* batch, const char* name, bool value) {
+    set_field(batch, name, TELEMETRY_BOOL, 0, value, NULL, false);
+}
+
+void telemetry_batch_set_string(telemetry_batch_t* batch, const char* name, const char* value) {
+    set_field(batch, name, TELEMETRY_STRING, 0, false, value ? value : "", false);
+}
+
+void telemetry_batch_end(telemetry_batch_t* batch, uint32_t now_ms) {
+    batch->current = NULL;
+    if (batch->count >= batch->batch_size || batch->flush_interval_ms == 0) {
+        telemetry_batch_flush(batch);
+    } else {
+        (void) telemetry_batch_poll(batch, now_ms);
+    }
+}
+
+uint32_t telemetry_batch_poll(telemetry_batch_t* batch, uint32_t now_ms) {
+    if (batch->count == 0) {
+        return UINT32_MAX;
+    }
+    uint32_t age_ms = now_ms - batch->first_ms;
+    if (age_ms >= batch->flush_interval_ms) {
+        telemetry_batch_flush(batch);
+        return UINT32_MAX;
+    }
+    return batch->flush_interval_ms - age_ms;
+}
+
+void telemetry_batch_flush(telemetry_batch_t* batch) {
+    if (batch->count == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < batch->count; i++) {
+        batch->stats.fields_sent += batch->records[i].num_fields;
+    }
+    batch->stats.messages++;
+    batch->send(batch->records, batch->count, batch->context);
+    batch->count = 0;
+}
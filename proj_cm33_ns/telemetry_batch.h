@@ -0,0 +1,105 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef TELEMETRY_BATCH_H_
+#define TELEMETRY_BATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// most records held in a batch, fields of a record, and bytes of the strings of a record
+#define TELEMETRY_BATCH_MAX_RECORDS 16
+#define TELEMETRY_RECORD_MAX_FIELDS 16
+#define TELEMETRY_RECORD_STRINGS_LEN 192
+
+typedef enum {
+    TELEMETRY_NUMBER,
+    TELEMETRY_BOOL,
+    TELEMETRY_STRING,
+} telemetry_type_t;
+
+typedef struct {
+    const char* name;   // not copied: a string literal
+    uint8_t type;       // telemetry_type_t
+    bool boolean;
+    uint16_t string;    // offset of the string in the record
+    double number;
+} telemetry_field_t;
+
+// one data set of a telemetry message: an event, or the state of the application
+typedef struct {
+    uint32_t time_ms;   // of the event, or of the last state coalesced into the record
+    bool has_event;
+    bool snapshot;      // every field, not only the ones changed since they were last queued
+    uint8_t num_fields;
+    uint16_t strings_len;
+    telemetry_field_t fields[TELEMETRY_RECORD_MAX_FIELDS];
+    char strings[TELEMETRY_RECORD_STRINGS_LEN];
+} telemetry_record_t;
+
+// sends the records of a batch in one message
+typedef void (*telemetry_batch_send_t)(const telemetry_record_t* records, uint32_t count, void* context);
+
+typedef struct {
+    uint32_t records;           // records queued
+    uint32_t coalesced;         // state records merged into the previous one
+    uint32_t messages;          // batches sent
+    uint32_t fields_sent;
+    uint32_t fields_skipped;    // unchanged since they were last queued
+    uint32_t fields_dropped;    // no room in the record
+    uint32_t snapshots;
+} telemetry_batch_stats_t;
+
+// value of a field last queued, to send only the changed ones
+typedef struct {
+    const char* name;
+    uint8_t type;
+    bool boolean;
+    uint32_t string_hash;
+    double number;
+} telemetry_last_t;
+
+typedef struct {
+    uint32_t flush_interval_ms;
+    uint32_t batch_size;
+    uint32_t snapshot_interval_ms;
+    telemetry_batch_send_t send;
+    void* context;
+
+    telemetry_record_t records[TELEMETRY_BATCH_MAX_RECORDS];
+    uint32_t count;
+    uint32_t first_ms;              // first record of the batch queued
+    telemetry_record_t* current;    // record being filled, NULL outside begin/end
+    bool snapshot_due;
+    uint32_t snapshot_ms;
+    telemetry_last_t last[TELEMETRY_RECORD_MAX_FIELDS];
+    uint32_t num_last;
+    telemetry_batch_stats_t stats;
+} telemetry_batch_t;
+
+// records are held up to flush_interval_ms (0 to send every record on its own), or until batch_size
+// of them are queued. Every field is sent at snapshot_interval_ms (0 for every record), and the first time.
+void telemetry_batch_init(telemetry_batch_t* batch, uint32_t flush_interval_ms, uint32_t batch_size,
+    uint32_t snapshot_interval_ms, telemetry_batch_send_t send, void* context);
+void telemetry_batch_set_flush_interval(telemetry_batch_t* batch, uint32_t flush_interval_ms);
+
+// sends every field with the next record, after a new connection
+void telemetry_batch_request_snapshot(telemetry_batch_t* batch);
+
+// starts a record, with the event or NULL for the state only. A state record is coalesced into
+// the previous record of the batch if it is a state record too. Fields are then set until
+// telemetry_batch_end(), and only the ones that changed are sent. Times are in ms of any clock.
+void telemetry_batch_begin(telemetry_batch_t* batch, uint32_t now_ms, const char* event);
+void telemetry_batch_set_number(telemetry_batch_t* batch, const char* name, double value);
+void telemetry_batch_set_bool(telemetry_batch_t* batch, const char* name, bool value);
+void telemetry_batch_set_string(telemetry_batch_t* batch, const char* name, const char* value);
+void telemetry_batch_end(telemetry_batch_t* batch, uint32_t now_ms);
+
+// sends the batch if its oldest record is due. Returns the time until it is due, UINT32_MAX if empty.
+uint32_t telemetry_batch_poll(telemetry_batch_t* batch, uint32_t now_ms);
+void telemetry_batch_flush(telemetry_batch_t* batch);
+
+const char* telemetry_record_string(const telemetry_record_t* record, const telemetry_field_t* field);
+
+#endif /* TELEMETRY_BATCH_H_ */
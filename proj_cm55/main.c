@@ -59,6 +59,10 @@
 #include "audio_enhancement_interface.h"
 #endif /* USE_AUDIO_ENHANCEMENT */
 
+#ifdef USB_CAPTURE_MODE
+#include "usb_capture.h"
+#endif /* USB_CAPTURE_MODE */
+
 #include "user_button.h"
 #include "app_logger.h"
 
@@ -219,6 +223,12 @@ int main(void)
     setup_tickless_idle_timer();
     
     cm55_ipc_communication_setup();
+
+    /* Stream the mic, the VA input and the VA events over USB if enabled */
+#ifdef USB_CAPTURE_MODE
+    usb_capture_init();
+#endif /* USB_CAPTURE_MODE */
+
     /* Initialize DEEPCRAFT(TM) Audio Enhancement if enabled */
 #ifdef USE_AUDIO_ENHANCEMENT
     ae_init(AFE_INPUT_NUMBER_CHANNELS);
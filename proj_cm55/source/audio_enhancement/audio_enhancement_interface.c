@@ -43,6 +43,9 @@
 #include "va_task.h"
 #include "audio_usb_send_utils.h"
 #include "usb_audio_interface.h"
+#ifdef USB_CAPTURE_MODE
+#include "usb_capture.h"
+#endif /* USB_CAPTURE_MODE */
 #ifdef ENABLE_VOICE_ID
 #include "voice_id_task.h"
 #endif /* ENABLE_VOICE_ID */
@@ -57,16 +60,22 @@
 
 #define AE_USB_STACK_SIZE                               (1024)
 
+/* The tuning debug channels and the capture mode share the USB IN stream */
+#if defined(CY_AFE_ENABLE_TUNING_FEATURE) && !defined(USB_CAPTURE_MODE)
+#define AE_USB_DEBUG_CHANNELS
+#endif /* CY_AFE_ENABLE_TUNING_FEATURE && !USB_CAPTURE_MODE */
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
-#ifdef CY_AFE_ENABLE_TUNING_FEATURE
+#ifdef AE_USB_DEBUG_CHANNELS
 TaskHandle_t rtos_ae_usb_task;
 QueueHandle_t ae_usb_queue_handle;
-#endif /*CY_AFE_ENABLE_TUNING_FEATURE*/
+#endif /* AE_USB_DEBUG_CHANNELS */
 
 #ifdef ENABLE_VOICE_ID
 extern QueueHandle_t vid_queue_handle;
+extern volatile uint32_t vid_frames_dropped;
 #endif /* ENABLE_VOICE_ID */
 
 extern volatile uint8_t ptt_flag;
@@ -115,10 +124,16 @@ void audio_enhancement_process_output(ae_buffer_info_t *output_buffer)
     if (pdTRUE != ret)
     {
         //app_log_print(">>> Failed to send to Voice ID queue - Queue full \r\n");
+        vid_frames_dropped++;
     }
 #endif /* ENABLE_VOICE_ID */
 
-#ifdef CY_AFE_ENABLE_TUNING_FEATURE  
+#ifdef USB_CAPTURE_MODE
+    /* After the voice assistant, so that its event is in the same frame */
+    usb_capture_put(output_buffer->input_buf, NO_OF_CHANNELS_RECEIVED, output_buffer->output_buf);
+#endif /* USB_CAPTURE_MODE */
+
+#ifdef AE_USB_DEBUG_CHANNELS
     if (ae_usb_queue_handle !=NULL)
     {
         ret = xQueueSend(ae_usb_queue_handle, (void*)output_buffer, 0);
@@ -127,7 +142,7 @@ void audio_enhancement_process_output(ae_buffer_info_t *output_buffer)
     {
         //app_log_print(">>> Send failed to AE USB task - Queue full \r\n");
     }  
-#endif /* CY_AFE_ENABLE_TUNING_FEATURE */ 
+#endif /* AE_USB_DEBUG_CHANNELS */
 
 }
 
@@ -150,9 +165,9 @@ int ae_init(int channels)
 {
 
     ae_rslt_t result = AE_RSLT_SUCCESS;
-#ifdef CY_AFE_ENABLE_TUNING_FEATURE    
+#ifdef AE_USB_DEBUG_CHANNELS
     BaseType_t rtos_task_status;
-#endif /* CY_AFE_ENABLE_TUNING_FEATURE */
+#endif /* AE_USB_DEBUG_CHANNELS */
     result = audio_enhancement_init(channels);
     
     if (result != AE_RSLT_SUCCESS) 
@@ -164,7 +179,7 @@ int ae_init(int channels)
         app_log_print("DEEPCRAFT Audio Enhancement initialized \r\n");
     }
 
-#ifdef CY_AFE_ENABLE_TUNING_FEATURE
+#ifdef AE_USB_DEBUG_CHANNELS
     /* Enable USB interface*/
     usb_audio_interface_init();
     usb_send_out_dbg_init_channels();
@@ -185,7 +200,7 @@ int ae_init(int channels)
         app_log_print("AE USB streamer task create failed \r\n");
         CY_ASSERT(0);
     }
-#endif /* CY_AFE_ENABLE_TUNING_FEATURE */     
+#endif /* AE_USB_DEBUG_CHANNELS */
     return result;
 }
 
@@ -231,7 +246,7 @@ int ae_feed(void* audio_input, void* aec_buffer)
 *  None
 *
 *******************************************************************************/
-#ifdef CY_AFE_ENABLE_TUNING_FEATURE
+#ifdef AE_USB_DEBUG_CHANNELS
 void ae_usb_task(void *arg)
 {
 
@@ -246,13 +261,11 @@ void ae_usb_task(void *arg)
 
             ae_usb_data_ptr = (ae_buffer_info_t*)ae_usb_data;
     
-            usb_send_out_dbg_put(USB_CHANNEL_1,(int16_t *)ae_usb_data_ptr->dbg_output1);
-            usb_send_out_dbg_put(USB_CHANNEL_2,(int16_t *)ae_usb_data_ptr->dbg_output2);      
-            usb_send_out_dbg_put(USB_CHANNEL_3,(int16_t *)ae_usb_data_ptr->dbg_output3);
-            usb_send_out_dbg_put(USB_CHANNEL_4,(int16_t *)ae_usb_data_ptr->dbg_output4);
+            usb_send_out_dbg_put_all(ae_usb_data_ptr->dbg_output1, ae_usb_data_ptr->dbg_output2,
+                                     ae_usb_data_ptr->dbg_output3, ae_usb_data_ptr->dbg_output4);
 
         }
     }
 }
-#endif /* CY_AFE_ENABLE_TUNING_FEATURE*/
+#endif /* AE_USB_DEBUG_CHANNELS */
 /* [] END OF FILE */
@@ -37,10 +37,10 @@
 
 #include <stdint.h>
 #include "audio_input_configuration.h"
+#include "va_task.h"
 #ifdef USE_AUDIO_ENHANCEMENT
 #include "audio_enhancement_interface.h"
 #else
-#include "va_task.h"
 #ifdef ENABLE_VOICE_ID
 #include "voice_id_task.h"
 #endif /* ENABLE_VOICE_ID */
@@ -59,10 +59,12 @@
 
 #ifdef ENABLE_VOICE_ID
 extern QueueHandle_t vid_queue_handle;
+extern volatile uint32_t vid_frames_dropped;
 #endif /* ENABLE_VOICE_ID */
 
 #ifndef USE_AUDIO_ENHANCEMENT
 extern QueueHandle_t va_queue_handle;
+extern volatile uint32_t va_frames_dropped;
 #endif /* USE_AUDIO_ENHANCEMENT*/
 
 /*******************************************************************************
@@ -79,6 +81,8 @@ extern QueueHandle_t va_queue_handle;
 *******************************************************************************/
 void audio_mic_data_feed_cm55(int16_t *audio_data)
 {
+    /* Start of the end-to-end latency of the events detected in this frame */
+    uint32_t capture_us = ipc_trace_now_us();
 
 #ifdef USE_AUDIO_ENHANCEMENT
     cy_rslt_t result = CY_RSLT_SUCCESS;    
@@ -88,16 +92,30 @@ void audio_mic_data_feed_cm55(int16_t *audio_data)
     {
         app_log_print("Failed to feed audio frame to AFE - results %x \r\n ",result);
     }
+    else
+    {
+        va_task_mark_capture(capture_us);
+    }
 #else
 /* No Audio Enhancement, hence do VA inferencing directly */
     if (va_queue_handle !=NULL)
     {
-        xQueueSend(va_queue_handle, (void*)audio_data, 0);
+        if (pdTRUE != xQueueSend(va_queue_handle, (void*)audio_data, 0))
+        {
+            va_frames_dropped++;
+        }
+        else
+        {
+            va_task_mark_capture(capture_us);
+        }
     }
 #ifdef ENABLE_VOICE_ID 
     if (vid_queue_handle !=NULL)
     {
-        xQueueSend(vid_queue_handle, (void*)audio_data, 0);
+        if (pdTRUE != xQueueSend(vid_queue_handle, (void*)audio_data, 0))
+        {
+            vid_frames_dropped++;
+        }
     }
 #endif /* ENABLE_VOICE_ID */
 #endif /* USE_AUDIO_ENHANCEMENT */
@@ -172,5 +172,24 @@ uint32_t profiler_get_cycles(void)
     return profiler_cycles;
 }
 
+/*******************************************************************************
+* Function Name: profiler_get_cycle_count
+********************************************************************************
+* Summary:
+* Get the free-running cycle counter, to measure an interval without resetting
+* the counter used by profiler_start/profiler_stop.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Current cycle counter value.
+*
+*******************************************************************************/
+uint32_t profiler_get_cycle_count(void)
+{
+    return GET_CYCLE_CNT;
+}
+
 
 /* [] END OF FILE */
@@ -44,6 +44,7 @@ void profiler_init(void);
 void profiler_start(void);
 void profiler_stop(void);
 uint32_t profiler_get_cycles(void);
+uint32_t profiler_get_cycle_count(void);
 
 #if defined(__cplusplus)
 }
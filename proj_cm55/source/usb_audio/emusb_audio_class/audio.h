@@ -100,7 +100,10 @@ extern "C" {
 #define AUDIO_HID_REPORT_VOLUME_DOWN            (0x02u)
 #define AUDIO_HID_REPORT_PLAY_PAUSE             (0x08u)
 
-#define ADDITIONAL_AUDIO_IN_SAMPLE_SIZE_BYTES   (((AUDIO_IN_BIT_RESOLUTION) / 8U) * (AUDIO_IN_SUB_FRAME_SIZE)) /* In bytes */
+/* One additional sample of all the channels: with the clock drift
+ * compensation, a packet carries 1 ms of samples plus or minus one
+ */
+#define ADDITIONAL_AUDIO_IN_SAMPLE_SIZE_BYTES   (((AUDIO_IN_BIT_RESOLUTION) / 8U) * (AUDIO_IN_NUM_CHANNELS)) /* In bytes */
 
 #define MAX_AUDIO_IN_PACKET_SIZE_BYTES          ((((AUDIO_IN_SAMPLE_FREQ) * (((AUDIO_IN_BIT_RESOLUTION) / 8U) * (AUDIO_IN_NUM_CHANNELS))) / 1000U) + (ADDITIONAL_AUDIO_IN_SAMPLE_SIZE_BYTES)) /* In bytes */
 
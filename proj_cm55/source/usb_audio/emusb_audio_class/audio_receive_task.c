@@ -43,6 +43,7 @@
 #include "rtos.h"
 #include "audio_conv_utils.h"
 #include "audio_usb_send_utils.h"
+#include "audio_usb_drift.h"
 #include "audio_receive_task.h"
 #include "cyabs_rtos.h"
 #include "app_logger.h"
@@ -51,8 +52,17 @@
 * Macros
 *******************************************************************************/
 #define USB_10MS_AUDIO_SAMP            (160)
+#define USB_10MS_PERIOD_MS             (10)
 #define USB_AUDIO_RX_TASK_PRIORITY     (6)
 
+/* Fill level held by the drift compensation: 2 frames, in samples per channel */
+#define USB_OUT_DRIFT_TARGET           (2 * USB_10MS_AUDIO_SAMP)
+
+#ifdef USB_DRIFT_LOG
+/* Frames between two prints of the drift compensation telemetry */
+#define USB_OUT_DRIFT_LOG_FRAMES       (1000)
+#endif /* USB_DRIFT_LOG */
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -62,15 +72,22 @@ volatile bool audio_out_is_streaming    = false;
 volatile bool audio_start_streaming     = false;
 
 
-int usb_packet_count                    = 0;
-int ping_pong_buff                      = 0;
-int16_t audio_mic_buffer_usb_ping[USB_10MS_AUDIO_SAMP*2] = {0};
-int16_t audio_mic_buffer_usb_pong[USB_10MS_AUDIO_SAMP*2] = {0};
-int16_t usb_non_interleaved_buffer[USB_10MS_AUDIO_SAMP*4]= {0};
+/* Set by the OUT endpoint callback when the host starts streaming, the
+ * USB mic task then restarts the FIFO
+ */
+static volatile bool audio_out_restart  = false;
+
+/* Packet being received */
+static uint16_t audio_out_packet[MAX_AUDIO_OUT_PACKET_SIZE_WORDS];
+
+/* The host writes one packet per ms of the USB clock, the USB mic task reads
+ * one frame per 10 ms of the device clock: the FIFO between them is read
+ * through a resampler that follows the drift between the clocks
+ */
+static usb_drift_fifo_t audio_out_fifo;
+static usb_drift_t audio_out_drift;
 
-int8_t *audio_usb_ptr                   = NULL;
-int8_t *audio_usb_ref                   = NULL;
-int8_t *audio_usb_mic_ptr               = NULL;
+int16_t usb_non_interleaved_buffer[USB_10MS_AUDIO_SAMP*4]= {0};
 
 TaskHandle_t rtos_audio_out_task;
 TaskHandle_t usb_audio_mic_task;
@@ -92,6 +109,9 @@ void audio_out_init(void)
 {
     BaseType_t rtos_task_status;
 
+    usb_drift_fifo_init(&audio_out_fifo);
+    usb_drift_init(&audio_out_drift, USB_OUT_DRIFT_TARGET, USB_10MS_PERIOD_MS);
+
     rtos_task_status = xTaskCreate(audio_out_process, "usb_audio_to_psoc",
                         RTOS_STACK_DEPTH, NULL, USB_AUDIO_RX_TASK_PRIORITY,
                         &rtos_audio_out_task);
@@ -164,11 +184,40 @@ void audio_out_process(void *arg)
     }
 }
 
+#ifdef USB_DRIFT_LOG
+/*******************************************************************************
+* Function Name: audio_out_drift_log
+********************************************************************************
+* Summary:
+*   Print the drift compensation telemetry of the OUT endpoint every
+*   USB_OUT_DRIFT_LOG_FRAMES frames.
+*
+*******************************************************************************/
+static void audio_out_drift_log(void)
+{
+    static int frames = 0;
+    usb_drift_stats_t stats;
+
+    if (++frames < USB_OUT_DRIFT_LOG_FRAMES)
+    {
+        return;
+    }
+    frames = 0;
+
+    audio_out_get_drift_stats(&stats);
+    app_log_print("USB OUT drift: %d ppm, fill %u (%u..%u), underruns %u, overruns %u\r\n",
+        (int)stats.ppm, (unsigned int)stats.fill, (unsigned int)stats.fill_min,
+        (unsigned int)stats.fill_max, (unsigned int)stats.underruns, (unsigned int)stats.overruns);
+}
+#endif /* USB_DRIFT_LOG */
+
 /*******************************************************************************
 * Function Name: usb_mic_task
 ********************************************************************************
 * Summary:
-*   Sends audio packets received via USB to the audio pipeline.
+*   Sends audio packets received via USB to the audio pipeline. While the host
+*   is streaming, one frame is read every 10 ms of the RTOS tick, which runs
+*   off the same crystal as the audio clocks.
 *
 *******************************************************************************/
 
@@ -176,25 +225,63 @@ void usb_mic_task(void *arg)
 {
     int16_t usb_buffer[USB_10MS_AUDIO_SAMP*2];
     uint32_t notify_val=0;
+    TickType_t last_wake;
+
+    (void) arg;
+
     while (1) {
+        /* Wait for the host to start streaming */
         xTaskNotifyWait(0,0,&notify_val,portMAX_DELAY);
-        memcpy(usb_buffer,audio_usb_mic_ptr,USB_10MS_AUDIO_SAMP*2*2);
-        convert_interleaved_to_stereo_non_interleaved((uint16_t *)usb_buffer,(uint16_t *)usb_non_interleaved_buffer);
-#if AFE_INPUT_SOURCE==AFE_INPUT_SOURCE_USB       
-        usb_mic_data_feed((int16_t*)usb_non_interleaved_buffer);
-#endif /* AFE_INPUT_SOURCE */        
+        last_wake = xTaskGetTickCount();
+
+        while (audio_out_is_streaming)
+        {
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(USB_10MS_PERIOD_MS));
+
+            if (audio_out_restart)
+            {
+                /* Samples left from a previous stream are stale */
+                audio_out_restart = false;
+                usb_drift_fifo_flush(&audio_out_fifo);
+                usb_drift_restart(&audio_out_drift);
+            }
+
+            usb_drift_fifo_read(&audio_out_fifo, &audio_out_drift, usb_buffer, USB_10MS_AUDIO_SAMP);
+            convert_interleaved_to_stereo_non_interleaved((uint16_t *)usb_buffer,(uint16_t *)usb_non_interleaved_buffer);
+#if AFE_INPUT_SOURCE==AFE_INPUT_SOURCE_USB
+            usb_mic_data_feed((int16_t*)usb_non_interleaved_buffer);
+#endif /* AFE_INPUT_SOURCE */
+#ifdef USB_DRIFT_LOG
+            audio_out_drift_log();
+#endif /* USB_DRIFT_LOG */
+        }
     }
 
 
 }
 
+/*******************************************************************************
+* Function Name: audio_out_get_drift_stats
+********************************************************************************
+* Summary:
+*   Telemetry of the OUT endpoint drift compensation: resampling ratio and
+*   fill level of the FIFO, in samples per channel. Overruns are counted in
+*   packets.
+*
+*******************************************************************************/
+void audio_out_get_drift_stats(usb_drift_stats_t *stats)
+{
+    usb_drift_get_stats(&audio_out_drift, audio_out_fifo.overruns, stats);
+}
+
 /*******************************************************************************
 * Function Name: audio_out_endpoint_callback
 ********************************************************************************
 * Summary:
-*   Audio OUT endpoint callback implementation. 
-*     Populates buffers with audio data received over USB from PC.
-*   Populates buffers with audio data to loopback over USB to PC.
+*   Audio OUT endpoint callback implementation.
+*   Queues the audio data received over USB from PC in the FIFO read by the
+*   USB mic task. Packets of any size are taken: the FIFO carries samples
+*   split between packets over, and frames are cut by the reader.
 *
 *******************************************************************************/
 void audio_out_endpoint_callback(void * pUserContext,
@@ -208,50 +295,32 @@ void audio_out_endpoint_callback(void * pUserContext,
     {
         audio_start_streaming = false;
         audio_out_is_streaming = true;
+        audio_out_restart = true;
+        usb_drift_fifo_write_start(&audio_out_fifo);
+
+        xTaskNotify(usb_audio_mic_task, 0,eNoAction);
 
-        audio_usb_ptr = (int8_t*)audio_mic_buffer_usb_ping;
-        ping_pong_buff= 0;
-        audio_usb_ref = audio_usb_ptr;
-      
         /* Start a transfer to the Audio OUT endpoint */
-        *ppNextBuffer = (uint8_t *) audio_usb_ptr;
+        *ppNextBuffer = (uint8_t *) audio_out_packet;
+        *pNextBufferSize = MAX_AUDIO_OUT_PACKET_SIZE_BYTES;
 
     }
     else if(audio_out_is_streaming)
     {
-        if(NumBytesReceived != 0)
+        if(NumBytesReceived > 0)
         {
+            uint32_t bytes = (uint32_t)NumBytesReceived;
 
-            if (usb_packet_count<USB_10MS_AUDIO_SAMP*4) {
-                usb_packet_count+=NumBytesReceived;
-                audio_usb_ptr+=NumBytesReceived;
-            }
-            if (usb_packet_count>=USB_10MS_AUDIO_SAMP*4)
+            /* Never more than the buffer given for the transfer */
+            if (bytes > MAX_AUDIO_OUT_PACKET_SIZE_BYTES)
             {
-
-/* 10ms of data is received, so notify mic task */
-                audio_usb_mic_ptr=audio_usb_ref;
-
-                xTaskNotify(usb_audio_mic_task, 0,eNoAction);
-
-                usb_packet_count=0;
-
-                if (ping_pong_buff==0)
-                {
-                    audio_usb_ptr=(int8_t*)audio_mic_buffer_usb_pong;
-                    audio_usb_ref = audio_usb_ptr;
-                    ping_pong_buff=1;
-                }
-                else
-                {
-                    audio_usb_ptr=(int8_t*)audio_mic_buffer_usb_ping;
-                    audio_usb_ref = audio_usb_ptr;
-                    ping_pong_buff=0;
-                }
+                bytes = MAX_AUDIO_OUT_PACKET_SIZE_BYTES;
             }
+            (void)usb_drift_fifo_write(&audio_out_fifo, (const uint8_t *)audio_out_packet, bytes);
 
              /* Start a transfer to OUT endpoint */
-            *ppNextBuffer = (uint8_t *) audio_usb_ptr;
+            *ppNextBuffer = (uint8_t *) audio_out_packet;
+            *pNextBufferSize = MAX_AUDIO_OUT_PACKET_SIZE_BYTES;
 
         }
     }
@@ -41,6 +41,7 @@ extern "C" {
 #endif /* __cplusplus */
 
 #include <stdint.h>
+#include "audio_usb_drift.h"
 
 /*******************************************************************************
 * Functions Prototypes
@@ -52,6 +53,7 @@ void audio_out_process(void *arg);
 void audio_out_endpoint_callback(void * pUserContext, int NumBytesReceived, uint8_t ** ppNextBuffer, unsigned long * pNextBufferSize);
 
 void usb_mic_task(void *arg);
+void audio_out_get_drift_stats(usb_drift_stats_t *stats);
 
 #if defined(__cplusplus)
 }
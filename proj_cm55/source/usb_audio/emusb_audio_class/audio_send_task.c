@@ -176,6 +176,11 @@ void audio_in_endpoint_callback(void * pUserContext, const uint8_t ** ppNextBuff
         /* Clear Audio In buffer */
         memset(audio_in_pcm_buffer_ping, 0, (MAX_AUDIO_IN_PACKET_SIZE_BYTES));
 
+        /* Frames queued before the start are stale, and the stop event may
+         * not have been sent
+         */
+        usb_send_out_dbg_reset();
+
         audio_in_pcm_buffer = audio_in_pcm_buffer_ping;
 
         /* Start a transfer to the Audio IN endpoint */
@@ -0,0 +1,484 @@
+/******************************************************************************
+* File Name : audio_usb_drift.c
+*
+* Description :
+* Compensation of the clock drift between the USB host and the audio pipeline
+* of the device: fill level based rate estimator, and elastic FIFO with a
+* fractional resampler
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "audio_usb_drift.h"
+
+#if defined(__ARM_ARCH)
+#include "cmsis_compiler.h"
+#define USB_DRIFT_DMB()                 __DMB()
+#else
+/* Host builds, see tools/usb_drift_sim.c */
+#define USB_DRIFT_DMB()                 __sync_synchronize()
+#endif /* __ARM_ARCH */
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Time constant of the fill level filter. The fill level moves by a whole
+ * frame every 10 ms, the filter leaves less than a sample of this ripple.
+ */
+#define USB_DRIFT_FILTER_MS             (1000.0f)
+
+/* Controller gains, for a critically damped loop settling in about 10 s.
+ * The fill level moves by 0.016 samples per second and ppm of drift.
+ */
+#define USB_DRIFT_KP                    (12.5f)     /* ppm per sample */
+#define USB_DRIFT_KI                    (0.625f)    /* ppm per sample and second */
+
+/* One ppm of the read position step, in Q0.32 */
+#define USB_DRIFT_PPM_Q32               (4294.967296f)
+#define USB_DRIFT_Q32_TO_FLOAT          (2.3283064e-10f)
+
+/* Samples the resampler needs in the FIFO for one output sample */
+#define USB_DRIFT_TAPS                  (4u)
+
+/*******************************************************************************
+* Function Name: usb_drift_clamp
+*******************************************************************************/
+static float usb_drift_clamp(float ppm)
+{
+    if (ppm > USB_DRIFT_MAX_PPM)
+    {
+        return USB_DRIFT_MAX_PPM;
+    }
+    if (ppm < -USB_DRIFT_MAX_PPM)
+    {
+        return -USB_DRIFT_MAX_PPM;
+    }
+    return ppm;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_init
+********************************************************************************
+* Summary:
+*   Initialize the rate estimator of one direction.
+*
+* Parameters:
+*  drift     - Rate estimator
+*  target    - Fill level to hold, in samples
+*  period_ms - Time between two updates by the consumer
+*
+*******************************************************************************/
+void usb_drift_init(usb_drift_t *drift, uint32_t target, uint32_t period_ms)
+{
+    memset(drift, 0, sizeof(*drift));
+    drift->target = (float)target;
+    drift->alpha = (float)period_ms / USB_DRIFT_FILTER_MS;
+    drift->kp = USB_DRIFT_KP;
+    drift->ki = USB_DRIFT_KI * (float)period_ms / 1000.0f;
+    usb_drift_restart(drift);
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_restart
+********************************************************************************
+* Summary:
+*   Wait for the target fill level again, at the start of a stream or after
+*   an underrun. The estimated drift is kept: it depends on the clocks, not
+*   on the stream.
+*
+*******************************************************************************/
+void usb_drift_restart(usb_drift_t *drift)
+{
+    drift->fill = drift->target;
+    drift->phase = 0.0f;
+    drift->priming = true;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_update
+********************************************************************************
+* Summary:
+*   Update the rate estimate with the fill level seen by the consumer.
+*
+* Parameters:
+*  drift - Rate estimator
+*  fill  - Samples buffered between the producer and the consumer
+*
+* Return:
+*  Rate correction of the consumer, in ppm: positive to consume faster.
+*
+*******************************************************************************/
+float usb_drift_update(usb_drift_t *drift, uint32_t fill)
+{
+    float error;
+
+    if (drift->window_restart)
+    {
+        drift->window_restart = false;
+        drift->fill_min = fill;
+        drift->fill_max = fill;
+    }
+    if (fill < drift->fill_min)
+    {
+        drift->fill_min = fill;
+    }
+    if (fill > drift->fill_max)
+    {
+        drift->fill_max = fill;
+    }
+
+    if (drift->priming)
+    {
+        if ((float)fill < drift->target)
+        {
+            return drift->ppm;
+        }
+        drift->priming = false;
+    }
+
+    drift->fill += drift->alpha * ((float)fill - drift->fill);
+    error = drift->fill - drift->target;
+    drift->integral = usb_drift_clamp(drift->integral + (drift->ki * error));
+    drift->ppm = usb_drift_clamp((drift->kp * error) + drift->integral);
+    return drift->ppm;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_packet_samples
+********************************************************************************
+* Summary:
+*   Number of samples to send in the next packet of an asynchronous IN
+*   endpoint: the nominal number, one more or one less, so that the host
+*   follows the device clock without any sample being changed.
+*
+* Parameters:
+*  drift   - Rate estimator
+*  fill    - Samples buffered for the endpoint
+*  nominal - Samples per packet at the nominal rate
+*
+* Return:
+*  Samples to send, 0 while waiting for the target fill level.
+*
+*******************************************************************************/
+uint32_t usb_drift_packet_samples(usb_drift_t *drift, uint32_t fill, uint32_t nominal)
+{
+    float ppm = usb_drift_update(drift, fill);
+
+    if (drift->priming)
+    {
+        return 0u;
+    }
+
+    drift->phase += (float)nominal * ppm * 1e-6f;
+    if (drift->phase >= 1.0f)
+    {
+        drift->phase -= 1.0f;
+        return nominal + 1u;
+    }
+    if (drift->phase <= -1.0f)
+    {
+        drift->phase += 1.0f;
+        return nominal - 1u;
+    }
+    return nominal;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_underrun
+********************************************************************************
+* Summary:
+*   Count an underrun of the consumer, and wait for the target fill level.
+*
+*******************************************************************************/
+void usb_drift_underrun(usb_drift_t *drift)
+{
+    drift->underruns++;
+    usb_drift_restart(drift);
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_get_stats
+********************************************************************************
+* Summary:
+*   Read the telemetry of one direction and restart the fill level range.
+*   Can be called from another context than the consumer.
+*
+* Parameters:
+*  drift    - Rate estimator
+*  overruns - Overruns counted by the producer
+*  stats    - Telemetry
+*
+*******************************************************************************/
+void usb_drift_get_stats(usb_drift_t *drift, uint32_t overruns, usb_drift_stats_t *stats)
+{
+    stats->ppm = (int32_t)drift->integral;
+    stats->fill = (uint32_t)drift->fill;
+    stats->fill_min = drift->fill_min;
+    stats->fill_max = drift->fill_max;
+    stats->underruns = drift->underruns;
+    stats->overruns = overruns;
+    drift->window_restart = true;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_fifo_init
+*******************************************************************************/
+void usb_drift_fifo_init(usb_drift_fifo_t *fifo)
+{
+    memset(fifo, 0, sizeof(*fifo));
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_fifo_level
+********************************************************************************
+* Summary:
+*   Samples per channel in the FIFO.
+*
+*******************************************************************************/
+uint32_t usb_drift_fifo_level(const usb_drift_fifo_t *fifo)
+{
+    return fifo->head - fifo->tail;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_fifo_write_start
+********************************************************************************
+* Summary:
+*   Start a new byte stream: forget the sample left incomplete by the previous
+*   stream. Producer side.
+*
+*******************************************************************************/
+void usb_drift_fifo_write_start(usb_drift_fifo_t *fifo)
+{
+    fifo->partial_bytes = 0u;
+    fifo->skip_bytes = 0u;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_fifo_write
+********************************************************************************
+* Summary:
+*   Copy a packet of interleaved samples into the FIFO. Producer side, safe in
+*   interrupt context. The packets form a byte stream: a sample split between
+*   two packets is completed by the second one, so packets of any size are
+*   taken. A packet that does not fit is dropped whole and counted, along
+*   with the rest of the sample it ends in, so that the stream stays aligned
+*   on samples.
+*
+* Parameters:
+*  fifo  - FIFO
+*  data  - Packet
+*  bytes - Size of the packet
+*
+* Return:
+*  Samples per channel completed by the packet.
+*
+*******************************************************************************/
+uint32_t usb_drift_fifo_write(usb_drift_fifo_t *fifo, const uint8_t *data, uint32_t bytes)
+{
+    const uint32_t sample_bytes = sizeof(fifo->samples[0]);
+    uint32_t head = fifo->head;
+    uint32_t skip = fifo->skip_bytes;
+    uint32_t count;
+    uint32_t start;
+    uint32_t first;
+
+    if (skip > bytes)
+    {
+        skip = bytes;
+    }
+    fifo->skip_bytes -= skip;
+    data += skip;
+    bytes -= skip;
+
+    count = (fifo->partial_bytes + bytes) / sample_bytes;
+    if ((head - fifo->tail + count) > USB_DRIFT_FIFO_SAMPLES)
+    {
+        uint32_t end = (fifo->partial_bytes + bytes) % sample_bytes;
+
+        fifo->overruns++;
+        fifo->partial_bytes = 0u;
+        fifo->skip_bytes = (end == 0u) ? 0u : (sample_bytes - end);
+        return 0u;
+    }
+
+    /* Complete the sample split with the previous packet */
+    if (fifo->partial_bytes > 0u)
+    {
+        uint32_t part = sample_bytes - fifo->partial_bytes;
+
+        if (part > bytes)
+        {
+            part = bytes;
+        }
+        memcpy(&fifo->partial[fifo->partial_bytes], data, part);
+        fifo->partial_bytes += part;
+        data += part;
+        bytes -= part;
+        if (fifo->partial_bytes < sample_bytes)
+        {
+            return 0u;
+        }
+        memcpy(fifo->samples[head % USB_DRIFT_FIFO_SAMPLES], fifo->partial, sample_bytes);
+        fifo->partial_bytes = 0u;
+        head++;
+    }
+
+    /* Whole samples, in two parts if the FIFO wraps */
+    start = head % USB_DRIFT_FIFO_SAMPLES;
+    first = USB_DRIFT_FIFO_SAMPLES - start;
+    if (first > (bytes / sample_bytes))
+    {
+        first = bytes / sample_bytes;
+    }
+    memcpy(fifo->samples[start], data, first * sample_bytes);
+    memcpy(fifo->samples[0], &data[first * sample_bytes], ((bytes / sample_bytes) - first) * sample_bytes);
+    head += bytes / sample_bytes;
+
+    /* Keep the start of a sample split with the next packet */
+    fifo->partial_bytes = bytes % sample_bytes;
+    memcpy(fifo->partial, &data[bytes - fifo->partial_bytes], fifo->partial_bytes);
+
+    /* Publish the samples only after they are written */
+    USB_DRIFT_DMB();
+    fifo->head = head;
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_fifo_flush
+********************************************************************************
+* Summary:
+*   Discard the content of the FIFO. Consumer side.
+*
+*******************************************************************************/
+void usb_drift_fifo_flush(usb_drift_fifo_t *fifo)
+{
+    fifo->tail = fifo->head;
+    fifo->frac = 0u;
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_interpolate
+********************************************************************************
+* Summary:
+*   4-point cubic Hermite (Catmull-Rom) interpolation between x1 and x2.
+*   On a 1 kHz tone, it keeps the error 60 dB down, where linear interpolation
+*   leaves it 44 dB down (see tools/usb_drift_sim.c).
+*
+*******************************************************************************/
+static inline int16_t usb_drift_interpolate(int32_t x0, int32_t x1, int32_t x2, int32_t x3, float t)
+{
+    float c1 = 0.5f * (float)(x2 - x0);
+    float c2 = (float)x0 - (2.5f * (float)x1) + (float)(2 * x2) - (0.5f * (float)x3);
+    float c3 = (0.5f * (float)(x3 - x0)) + (1.5f * (float)(x1 - x2));
+    float y = (float)x1 + (t * (c1 + (t * (c2 + (t * c3)))));
+
+    if (y >= 32767.0f)
+    {
+        return INT16_MAX;
+    }
+    if (y <= -32768.0f)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)lrintf(y);
+}
+
+/*******************************************************************************
+* Function Name: usb_drift_fifo_read
+********************************************************************************
+* Summary:
+*   Read interleaved samples out of the FIFO at the rate given by the rate
+*   estimator: the read position advances by 1 + ppm / 10^6 samples per
+*   output sample, with cubic interpolation between input samples. Silence
+*   is read while the FIFO fills up to the target level, and after an
+*   underrun. Consumer side.
+*
+* Parameters:
+*  fifo    - FIFO
+*  drift   - Rate estimator of the FIFO, updated once per call
+*  samples - Interleaved output samples
+*  count   - Samples per channel to read
+*
+*******************************************************************************/
+void usb_drift_fifo_read(usb_drift_fifo_t *fifo, usb_drift_t *drift, int16_t *samples, uint32_t count)
+{
+    uint32_t level = usb_drift_fifo_level(fifo);
+    float ppm = usb_drift_update(drift, level);
+    int32_t step = (int32_t)(ppm * USB_DRIFT_PPM_Q32);
+    uint32_t tail = fifo->tail;
+    uint32_t frac = fifo->frac;
+
+    /* The read position moves by less than one sample more than count, and
+     * the interpolation looks 3 samples ahead of the tail
+     */
+    if (!drift->priming && (level < (count + USB_DRIFT_TAPS)))
+    {
+        usb_drift_underrun(drift);
+    }
+    if (drift->priming)
+    {
+        memset(samples, 0, count * sizeof(fifo->samples[0]));
+        return;
+    }
+
+    /* Read the samples only after their index */
+    USB_DRIFT_DMB();
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        const int16_t *x0 = fifo->samples[tail % USB_DRIFT_FIFO_SAMPLES];
+        const int16_t *x1 = fifo->samples[(tail + 1u) % USB_DRIFT_FIFO_SAMPLES];
+        const int16_t *x2 = fifo->samples[(tail + 2u) % USB_DRIFT_FIFO_SAMPLES];
+        const int16_t *x3 = fifo->samples[(tail + 3u) % USB_DRIFT_FIFO_SAMPLES];
+        float t = (float)frac * USB_DRIFT_Q32_TO_FLOAT;
+        int64_t next;
+
+        for (uint32_t ch = 0u; ch < USB_DRIFT_FIFO_CHANNELS; ch++)
+        {
+            *samples++ = usb_drift_interpolate(x0[ch], x1[ch], x2[ch], x3[ch], t);
+        }
+
+        next = (int64_t)frac + ((int64_t)1 << 32) + step;
+        tail += (uint32_t)(next >> 32);
+        frac = (uint32_t)next;
+    }
+
+    /* Release the samples only after they are read */
+    USB_DRIFT_DMB();
+    fifo->tail = tail;
+    fifo->frac = frac;
+}
+
+/* [] END OF FILE */
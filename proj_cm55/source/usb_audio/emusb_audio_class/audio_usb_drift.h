@@ -0,0 +1,137 @@
+/******************************************************************************
+* File Name : audio_usb_drift.h
+*
+* Description :
+* Header for the compensation of the clock drift between the USB host and the
+* audio pipeline of the device
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef AUDIO_USB_DRIFT_H
+#define AUDIO_USB_DRIFT_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Largest rate correction, in ppm. USB hosts and the device crystal are
+ * within a few hundred ppm of each other.
+ */
+#define USB_DRIFT_MAX_PPM               (1500.0f)
+
+/* Elastic FIFO of the audio received from the host: 64 ms of stereo samples,
+ * a power of 2
+ */
+#define USB_DRIFT_FIFO_SAMPLES          (1024u)
+#define USB_DRIFT_FIFO_CHANNELS         (2u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Rate estimator of one direction. The buffer between the USB clock and the
+ * pipeline clock is held at a target fill level: a PI controller on the
+ * filtered fill level gives the rate the consumer has to run at, relative to
+ * its nominal rate. Updated by the consumer only.
+ */
+typedef struct
+{
+    float       target;         /* Fill level to hold, in samples */
+    float       fill;           /* Filtered fill level, in samples */
+    float       alpha;          /* Fill level filter coefficient per update */
+    float       kp;             /* ppm per sample of error */
+    float       ki;             /* ppm per sample of error and update */
+    float       integral;       /* Integral term, the clock drift once settled, in ppm */
+    float       ppm;            /* Rate correction of the consumer, in ppm */
+    float       phase;          /* Samples owed by or to the consumer */
+    bool        priming;        /* Waiting for the target fill level */
+
+    /* Telemetry. The fill level range is restarted by usb_drift_get_stats() */
+    uint32_t    fill_min;
+    uint32_t    fill_max;
+    volatile bool window_restart;
+    uint32_t    underruns;      /* Consumer ran out of samples */
+} usb_drift_t;
+
+typedef struct
+{
+    int32_t     ppm;            /* Clock drift estimate, consumer faster than nominal if positive */
+    uint32_t    fill;           /* Filtered fill level, in samples */
+    uint32_t    fill_min;       /* Since the previous usb_drift_get_stats() */
+    uint32_t    fill_max;
+    uint32_t    underruns;      /* Since start-up */
+    uint32_t    overruns;       /* Producer found the buffer full, since start-up */
+} usb_drift_stats_t;
+
+/* Single-producer single-consumer FIFO of interleaved stereo samples, read
+ * through a cubic interpolation resampler. The indexes run freely, in
+ * samples per channel.
+ */
+typedef struct
+{
+    volatile uint32_t   head;       /* Written by the producer */
+    volatile uint32_t   tail;       /* Written by the consumer */
+    volatile uint32_t   overruns;   /* Packets dropped by the producer */
+    uint8_t             partial[USB_DRIFT_FIFO_CHANNELS * sizeof(int16_t)];
+    uint32_t            partial_bytes;  /* Start of a sample split between packets */
+    uint32_t            skip_bytes;     /* Rest of a sample dropped with its packet */
+    uint32_t            frac;       /* Read position between tail and tail + 1, Q0.32 */
+    int16_t             samples[USB_DRIFT_FIFO_SAMPLES][USB_DRIFT_FIFO_CHANNELS];
+} usb_drift_fifo_t;
+
+/*******************************************************************************
+* Functions Prototypes
+*******************************************************************************/
+void     usb_drift_init(usb_drift_t *drift, uint32_t target, uint32_t period_ms);
+void     usb_drift_restart(usb_drift_t *drift);
+float    usb_drift_update(usb_drift_t *drift, uint32_t fill);
+uint32_t usb_drift_packet_samples(usb_drift_t *drift, uint32_t fill, uint32_t nominal);
+void     usb_drift_underrun(usb_drift_t *drift);
+void     usb_drift_get_stats(usb_drift_t *drift, uint32_t overruns, usb_drift_stats_t *stats);
+
+void     usb_drift_fifo_init(usb_drift_fifo_t *fifo);
+uint32_t usb_drift_fifo_level(const usb_drift_fifo_t *fifo);
+void     usb_drift_fifo_write_start(usb_drift_fifo_t *fifo);
+uint32_t usb_drift_fifo_write(usb_drift_fifo_t *fifo, const uint8_t *data, uint32_t bytes);
+void     usb_drift_fifo_flush(usb_drift_fifo_t *fifo);
+void     usb_drift_fifo_read(usb_drift_fifo_t *fifo, usb_drift_t *drift, int16_t *samples, uint32_t count);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* AUDIO_USB_DRIFT_H */
+
+/* [] END OF FILE */
@@ -48,63 +48,113 @@
 #include "cyabs_rtos.h"
 #include "app_logger.h"
 #include "audio_usb_send_utils.h"
+#include "audio_usb_drift.h"
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#endif /* __ARM_FEATURE_MVE */
+#ifdef USB_DBG_PROFILE
+#include "profiler.h"
+#endif /* USB_DBG_PROFILE */
 
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
 
-#define MAX_USB_CH1_DATA_Q              (320)
-#define MAX_USB_CH2_DATA_Q              (320)
-#define MAX_USB_CH3_DATA_Q              (320)
-#define MAX_USB_CH4_DATA_Q              (320)
-
-
-#define USB_QUEUE_ELEMENTS_CH1          (10)
-#define USB_QUEUE_ELEMENTS_CH2          (10)
-#define USB_QUEUE_ELEMENTS_CH3          (10)
-#define USB_QUEUE_ELEMENTS_CH4          (10)
-
-
 #define USB_MONO_AUDIO_SIZE_BYTES       (320)
 #define USB_MIC_IN_Q_LEN                (10)
 #define USB_MIC_IN_Q_SIZE               (640)
 
 #define USB_QUAD_1MS_DATA               (128)
+
+/* Debug channels: one 10 ms mono frame per channel is sent as 10 packets of
+ * 1 ms, the 4 channels interleaved
+ */
+#define USB_DBG_CHANNELS                (4)
+#define USB_DBG_FRAME_SAMPLES           (USB_MONO_AUDIO_SIZE_BYTES / 2)
+#define USB_DBG_PACKETS_PER_FRAME       (10)
+#define USB_DBG_SAMPLES_PER_PACKET      (USB_DBG_FRAME_SAMPLES / USB_DBG_PACKETS_PER_FRAME)
+
+/* Frames buffered per channel, a power of 2 */
+#define USB_DBG_RING_FRAMES             (8u)
+
+/* Fill level held by the drift compensation, in samples per channel: 3 of
+ * the 8 frames, the frames reach the rings a few ms late after processing
+ */
+#define USB_DBG_DRIFT_TARGET            (3u * USB_DBG_FRAME_SAMPLES)
+
+#ifdef USB_DBG_PROFILE
+/* Number of callbacks between two prints of the callback duration */
+#define USB_DBG_PROFILE_CALLS           (1000u)
+#endif /* USB_DBG_PROFILE */
+
+#ifdef USB_DRIFT_LOG
+/* Frames between two prints of the drift compensation telemetry, summed
+ * over the channels
+ */
+#define USB_DBG_DRIFT_LOG_FRAMES        (1000u * USB_DBG_CHANNELS)
+#endif /* USB_DRIFT_LOG */
 /*******************************************************************************
 * Functions Prototypes
 *******************************************************************************/
 
 extern int is_audio_usb_send_out_data_from_device_started(void);
 extern bool is_in_isr();
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Single-producer single-consumer ring of 10 ms frames of one debug channel.
+ * The audio task only writes head and the USB IN callback only writes tail,
+ * so neither side needs a lock or a kernel call. The indexes run freely,
+ * head - tail is the number of frames in the ring.
+ */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    short frames[USB_DBG_RING_FRAMES][USB_DBG_FRAME_SAMPLES];
+} usb_dbg_ring_t;
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
 
 uint16_t audio_usb_out_buffer[USB_MONO_AUDIO_SIZE_BYTES] = {0};
 
-QueueHandle_t usb_ch1_queue;
-QueueHandle_t usb_ch2_queue;
-QueueHandle_t usb_ch3_queue;
-QueueHandle_t usb_ch4_queue;
 QueueHandle_t usb_aec_ref_queue;
 QueueHandle_t usb_mic_queue;
 
-short channel_1[USB_MONO_AUDIO_SIZE_BYTES/2]= {0};
-short channel_2[USB_MONO_AUDIO_SIZE_BYTES/2]= {0};
-short channel_3[USB_MONO_AUDIO_SIZE_BYTES/2]= {0};
-short channel_4[USB_MONO_AUDIO_SIZE_BYTES/2]= {0};
+static usb_dbg_ring_t usb_dbg_rings[USB_DBG_CHANNELS];
 
-short *ch1 = NULL;
-short *ch2 = NULL;
-short *ch3 = NULL;
-short *ch4 = NULL;
+/* Frame of each channel being sent, copied out of the ring, and the next
+ * sample of it to send. USB_DBG_FRAME_SAMPLES when a new frame is needed.
+ */
+static short usb_dbg_frames[USB_DBG_CHANNELS][USB_DBG_FRAME_SAMPLES];
+static uint32_t usb_dbg_frame_pos = USB_DBG_FRAME_SAMPLES;
 
-void* bufferch1[USB_MONO_AUDIO_SIZE_BYTES] = {0};
+/* The host reads the IN endpoint at the USB clock, the frames are produced
+ * at the mic clock: the packet size follows the drift between the clocks
+ */
+static usb_drift_t usb_dbg_drift;
 
-void* bufferch2[USB_MONO_AUDIO_SIZE_BYTES] = {0};
-void* bufferch3[USB_MONO_AUDIO_SIZE_BYTES] = {0};
-void* bufferch4[USB_MONO_AUDIO_SIZE_BYTES] = {0};
+/* Frames the rings had no room for, summed over the channels */
+static volatile uint32_t usb_dbg_overruns;
+
+/* Frames discarded while the host is not recording: dropped by the producer,
+ * and left in the rings on start or stop. One counter per side, so that
+ * neither is updated from two contexts at the same time (start and stop
+ * events do not overlap).
+ */
+static volatile uint32_t usb_dbg_dropped_at_source;
+static volatile uint32_t usb_dbg_discarded_at_reset;
+
+#ifdef USB_DBG_PROFILE
+static volatile uint32_t usb_dbg_profile_max;
+static volatile uint32_t usb_dbg_profile_sum;
+static volatile uint32_t usb_dbg_profile_calls;
+#endif /* USB_DBG_PROFILE */
 
 /*******************************************************************************
 * Function Name: usb_queue_push
@@ -182,174 +232,443 @@ cy_rslt_t usb_queue_pop(QueueHandle_t queue, void* item_ptr, bool isr)
 
 
 /*******************************************************************************
-* Function Name: usb_send_out_dbg_get
+* Function Name: usb_dbg_ring_pop
 ********************************************************************************
 * Summary:
-*   Get the data for 4 channel audio from RTOS queues.
+*   Copy the oldest frame of a debug channel out of its ring. Consumer side,
+*   safe in interrupt context.
+*
+* Parameters:
+*  ring, frame
+*
+* Return:
+*  true if a frame was read, false if the ring is empty
 *
 *******************************************************************************/
 
-static void usb_send_out_dbg_get(unsigned int channel_no,void *pbuffer)
+static bool usb_dbg_ring_pop(usb_dbg_ring_t *ring, short *frame)
 {
-    cy_rslt_t ret_val = CY_RSLT_SUCCESS;
+    uint32_t tail = ring->tail;
 
-    if (1 == channel_no)
+    if (ring->head == tail)
     {
-        ret_val = usb_queue_pop(usb_ch1_queue, pbuffer, is_in_isr());
+        return false;
     }
 
-    if (2 == channel_no)
+    /* Read the frame only after its index */
+    __DMB();
+    memcpy(frame, ring->frames[tail % USB_DBG_RING_FRAMES], USB_MONO_AUDIO_SIZE_BYTES);
+    /* Release the slot only after the frame is read */
+    __DMB();
+    ring->tail = tail + 1u;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: usb_dbg_ring_push
+********************************************************************************
+* Summary:
+*   Copy a frame into the ring of a debug channel. Producer side.
+*
+* Parameters:
+*  ring, frame
+*
+* Return:
+*  true if the frame was written, false if the ring is full
+*
+*******************************************************************************/
+
+static bool usb_dbg_ring_push(usb_dbg_ring_t *ring, const short *frame)
+{
+    uint32_t head = ring->head;
+
+    if ((head - ring->tail) >= USB_DBG_RING_FRAMES)
     {
-        ret_val = usb_queue_pop(usb_ch2_queue, pbuffer, is_in_isr());
+        return false;
     }
-    if (3 == channel_no)
+
+    memcpy(ring->frames[head % USB_DBG_RING_FRAMES], frame, USB_MONO_AUDIO_SIZE_BYTES);
+    /* Publish the frame only after it is written */
+    __DMB();
+    ring->head = head + 1u;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: usb_dbg_interleave
+********************************************************************************
+* Summary:
+*   Interleave samples of the 4 debug channel frames being sent.
+*
+* Parameters:
+*  data_to_send - Interleaved output
+*  pos          - First sample in the frames
+*  count        - Samples per channel
+*
+*******************************************************************************/
+
+static void usb_dbg_interleave(short *data_to_send, uint32_t pos, uint32_t count)
+{
+    const short *ch1 = &usb_dbg_frames[0][pos];
+    const short *ch2 = &usb_dbg_frames[1][pos];
+    const short *ch3 = &usb_dbg_frames[2][pos];
+    const short *ch4 = &usb_dbg_frames[3][pos];
+    uint32_t i = 0;
+
+#if defined(__ARM_FEATURE_MVE)
+    /* Interleave 8 samples of the 4 channels per store */
+    for (; (i + 8u) <= count; i += 8u)
     {
-        ret_val = usb_queue_pop(usb_ch3_queue, pbuffer, is_in_isr());
+        int16x8x4_t samples;
+
+        samples.val[0] = vld1q_s16(&ch1[i]);
+        samples.val[1] = vld1q_s16(&ch2[i]);
+        samples.val[2] = vld1q_s16(&ch3[i]);
+        samples.val[3] = vld1q_s16(&ch4[i]);
+        vst4q_s16(&data_to_send[i * USB_DBG_CHANNELS], samples);
     }
-    if (4 == channel_no)
+#endif /* __ARM_FEATURE_MVE */
+    for (; i < count; i++)
+    {
+        data_to_send[i * USB_DBG_CHANNELS] = ch1[i];
+        data_to_send[(i * USB_DBG_CHANNELS) + 1u] = ch2[i];
+        data_to_send[(i * USB_DBG_CHANNELS) + 2u] = ch3[i];
+        data_to_send[(i * USB_DBG_CHANNELS) + 3u] = ch4[i];
+    }
+}
+
+/*******************************************************************************
+* Function Name: usb_send_out_for_2_channel_worth_1ms
+********************************************************************************
+* Summary:
+*   Create 4 channel data worth about 1 ms from the debug channel frames. The
+*   host reads one packet per ms of its clock, so the packet carries one
+*   sample more or less than 1 ms when the drift compensation asks for it.
+*   Samples are never changed or skipped, so the frames stay whole. A new
+*   frame is taken from each ring when the previous one is sent, silence if
+*   the rings run empty.
+*
+* Return:
+*  Samples per channel in the packet
+*
+*******************************************************************************/
+
+static uint32_t usb_send_out_for_2_channel_worth_1ms(short *data_to_send)
+{
+    /* The channels are pushed in order, so the last one is the last to
+     * receive a frame: count and pop only complete frames, to keep them
+     * aligned
+     */
+    usb_dbg_ring_t *last = &usb_dbg_rings[USB_DBG_CHANNELS - 1];
+    uint32_t fill = ((last->head - last->tail) * USB_DBG_FRAME_SAMPLES) +
+                    (USB_DBG_FRAME_SAMPLES - usb_dbg_frame_pos);
+    uint32_t count = usb_drift_packet_samples(&usb_dbg_drift, fill, USB_DBG_SAMPLES_PER_PACKET);
+    uint32_t done = 0;
+
+    if (count == 0u)
     {
-        ret_val = usb_queue_pop(usb_ch4_queue, pbuffer, is_in_isr());
+        /* Filling up to the target level */
+        memset(data_to_send, 0, USB_QUAD_1MS_DATA);
+        return USB_DBG_SAMPLES_PER_PACKET;
     }
 
-    if ((CY_RSLT_SUCCESS != ret_val))
+    while (done < count)
     {
+        uint32_t chunk;
 
-        if (1 == channel_no)
+        if (usb_dbg_frame_pos == USB_DBG_FRAME_SAMPLES)
         {
-            memset(pbuffer, 0, USB_MONO_AUDIO_SIZE_BYTES);
+            if (last->head == last->tail)
+            {
+                memset(&data_to_send[done * USB_DBG_CHANNELS], 0,
+                       (count - done) * USB_DBG_CHANNELS * sizeof(short));
+                usb_drift_underrun(&usb_dbg_drift);
+                break;
+            }
+            for (int i = 0; i < USB_DBG_CHANNELS; i++)
+            {
+                (void)usb_dbg_ring_pop(&usb_dbg_rings[i], usb_dbg_frames[i]);
+            }
+            usb_dbg_frame_pos = 0;
         }
 
-        if (2 == channel_no)
-        {
-            memset(pbuffer, 0, USB_MONO_AUDIO_SIZE_BYTES);
-        }
-        if (3 == channel_no)
-        {
-            memset(pbuffer, 0, USB_MONO_AUDIO_SIZE_BYTES);
-        }
-        if (4 == channel_no)
+        chunk = USB_DBG_FRAME_SAMPLES - usb_dbg_frame_pos;
+        if (chunk > (count - done))
         {
-            memset(pbuffer, 0, USB_MONO_AUDIO_SIZE_BYTES);
+            chunk = count - done;
         }
-
+        usb_dbg_interleave(&data_to_send[done * USB_DBG_CHANNELS], usb_dbg_frame_pos, chunk);
+        usb_dbg_frame_pos += chunk;
+        done += chunk;
     }
+    return count;
 }
 
 /*******************************************************************************
-* Function Name: usb_send_out_for_2_channel_worth_1ms
+* Function Name: usb_send_out_dbg_callback
 ********************************************************************************
 * Summary:
-*   Create 2 channel data worth 1 ms from buffers.
+*   USB audio callback to send audio data back to PC.
 *
 *******************************************************************************/
 
-static void usb_send_out_for_2_channel_worth_1ms(short *data_to_send)
+void usb_send_out_dbg_callback(uint8_t **data, uint16_t *length)
 {
-    static int usb_send_counter = 0;
-    if ((usb_send_counter % 10) == 0)
+    uint32_t samples;
+#ifdef USB_DBG_PROFILE
+    uint32_t start_cycles = profiler_get_cycle_count();
+    uint32_t cycles;
+#endif /* USB_DBG_PROFILE */
+
+    samples = usb_send_out_for_2_channel_worth_1ms((short *)audio_usb_out_buffer);
+    *data = (uint8_t*)audio_usb_out_buffer;
+    *length = (uint16_t)(samples * USB_DBG_CHANNELS * sizeof(short));
+
+#ifdef USB_DBG_PROFILE
+    cycles = profiler_get_cycle_count() - start_cycles;
+    if (cycles > usb_dbg_profile_max)
     {
-        usb_send_counter=0;
+        usb_dbg_profile_max = cycles;
+    }
+    usb_dbg_profile_sum += cycles;
+    usb_dbg_profile_calls++;
+#endif /* USB_DBG_PROFILE */
+}
 
-        usb_send_out_dbg_get(1, bufferch1);
-        ch1 = (short *)bufferch1;
-        usb_send_out_dbg_get(2, bufferch2);
-        ch2 = (short *)bufferch2;
+#ifdef USB_DBG_PROFILE
+/*******************************************************************************
+* Function Name: usb_dbg_profile_print
+********************************************************************************
+* Summary:
+*   Print the average and maximum duration of the USB IN callback, from task
+*   context, every USB_DBG_PROFILE_CALLS callbacks.
+*
+*******************************************************************************/
 
-        usb_send_out_dbg_get(3, bufferch3);
-        ch3 = (short *)bufferch3;
+static void usb_dbg_profile_print(void)
+{
+    uint32_t calls = usb_dbg_profile_calls;
 
-        usb_send_out_dbg_get(4, bufferch4);
-        ch4 = (short *)bufferch4;
+    if (calls >= USB_DBG_PROFILE_CALLS)
+    {
+        app_log_print("USB debug callback: avg %u cycles, max %u cycles (%u calls)\r\n",
+            (unsigned int)(usb_dbg_profile_sum / calls), (unsigned int)usb_dbg_profile_max,
+            (unsigned int)calls);
+        usb_dbg_profile_sum = 0;
+        usb_dbg_profile_max = 0;
+        usb_dbg_profile_calls = 0;
     }
+}
+#endif /* USB_DBG_PROFILE */
 
-    usb_send_counter++;
+#ifdef USB_DRIFT_LOG
+/*******************************************************************************
+* Function Name: usb_dbg_drift_log
+********************************************************************************
+* Summary:
+*   Print the drift compensation telemetry of the IN endpoint, from task
+*   context, every USB_DBG_DRIFT_LOG_FRAMES frames queued.
+*
+*******************************************************************************/
+
+static void usb_dbg_drift_log(uint32_t frames)
+{
+    static uint32_t queued = 0;
+    usb_drift_stats_t stats;
 
-    for (int i = 0; i < 16; i++)
+    queued += frames;
+    if (queued < USB_DBG_DRIFT_LOG_FRAMES)
     {
-        *data_to_send++ = *ch1++;
-        *data_to_send++ = *ch2++;
-        *data_to_send++ = *ch3++;
-        *data_to_send++ = *ch4++;
+        return;
     }
+    queued = 0;
+
+    usb_send_out_dbg_get_drift_stats(&stats);
+    app_log_print("USB IN drift: %d ppm, fill %u (%u..%u), underruns %u, overruns %u\r\n",
+        (int)stats.ppm, (unsigned int)stats.fill, (unsigned int)stats.fill_min,
+        (unsigned int)stats.fill_max, (unsigned int)stats.underruns, (unsigned int)stats.overruns);
 }
+#endif /* USB_DRIFT_LOG */
 
 /*******************************************************************************
-* Function Name: usb_send_out_dbg_callback
+* Function Name: usb_dbg_is_recording
 ********************************************************************************
 * Summary:
-*   USB audio callback to send audio data back to PC.
+*   Check that the host is recording before a frame is queued. Otherwise the
+*   frame is counted as dropped at the source. Producer side.
+*
+* Parameters:
+*  frames - Number of frames the caller is about to queue
+*
+* Return:
+*  true if the frames are to be queued
 *
 *******************************************************************************/
 
-void usb_send_out_dbg_callback(uint8_t **data, uint16_t *length)
+static bool usb_dbg_is_recording(uint32_t frames)
 {
+    static bool was_started = false;
 
-    usb_send_out_for_2_channel_worth_1ms((short *)audio_usb_out_buffer);
-    *data = (uint8_t*)audio_usb_out_buffer;
-    *length = USB_QUAD_1MS_DATA;
+#ifdef USB_DBG_PROFILE
+    usb_dbg_profile_print();
+#endif /* USB_DBG_PROFILE */
 
+    if(false == is_audio_usb_send_out_data_from_device_started())
+    {
+        /* Nothing is sent, drop the frame without copying it */
+        usb_dbg_dropped_at_source += frames;
+        was_started = false;
+        return false;
+    }
+
+    if (!was_started)
+    {
+        was_started = true;
+        app_log_print("USB debug stream started, %u frames discarded while not recording\r\n",
+            (unsigned int)usb_send_out_dbg_get_discarded());
+    }
+#ifdef USB_DRIFT_LOG
+    usb_dbg_drift_log(frames);
+#endif /* USB_DRIFT_LOG */
+    return true;
 }
 
 /*******************************************************************************
 * Function Name: usb_send_out_dbg_put
 ********************************************************************************
 * Summary:
-*   Store audio data in RTOS queues.
+*   Store audio data in the ring of a debug channel.
 *
 *******************************************************************************/
 
 cy_rslt_t usb_send_out_dbg_put(unsigned int channel_no, short *mono_data_10ms)
 {
-    cy_rslt_t ret_val  = CY_RSLT_SUCCESS;
-    size_t num_waiting = 0;
-    int index = 0;
+    usb_dbg_ring_t *ring;
 
-    if(false == is_audio_usb_send_out_data_from_device_started())
+    if ((channel_no < USB_CHANNEL_1) || (channel_no > USB_CHANNEL_4) || (mono_data_10ms == NULL))
     {
-        num_waiting = uxQueueMessagesWaiting(usb_ch1_queue);
-        for (index=0; index < num_waiting; index++)
-        {
-            usb_send_out_dbg_get(1, bufferch1);
-        }
+        return USB_QUEUE_FAILURE;
+    }
+    ring = &usb_dbg_rings[channel_no - USB_CHANNEL_1];
 
-        num_waiting = uxQueueMessagesWaiting(usb_ch2_queue);
-        for (index=0; index < num_waiting; index++)
-        {
-            usb_send_out_dbg_get(2, bufferch2);
-        }
-        num_waiting = uxQueueMessagesWaiting(usb_ch3_queue);
-        for (index=0; index < num_waiting; index++)
-        {
-            usb_send_out_dbg_get(3, bufferch3);
-        }
-        num_waiting = uxQueueMessagesWaiting(usb_ch4_queue);
-        for (index=0; index < num_waiting; index++)
-        {
-            usb_send_out_dbg_get(4, bufferch4);
-        }
+    if (!usb_dbg_is_recording(1u))
+    {
+        return CY_RSLT_SUCCESS;
+    }
 
-        return ret_val;
+    if (!usb_dbg_ring_push(ring, mono_data_10ms))
+    {
+        usb_dbg_overruns++;
+        return USB_QUEUE_FAILURE;
     }
+    return CY_RSLT_SUCCESS;
+}
 
-    if(1 == channel_no)
+/*******************************************************************************
+* Function Name: usb_send_out_dbg_put_all
+********************************************************************************
+* Summary:
+*   Store one frame of each debug channel, all or none, so that the channels
+*   stay aligned when the rings are full. Only the consumer frees slots, so
+*   the rings cannot fill up between the check and the pushes.
+*
+*******************************************************************************/
+
+cy_rslt_t usb_send_out_dbg_put_all(const short *ch1, const short *ch2, const short *ch3, const short *ch4)
+{
+    const short *frames[USB_DBG_CHANNELS] = { ch1, ch2, ch3, ch4 };
+
+    if ((ch1 == NULL) || (ch2 == NULL) || (ch3 == NULL) || (ch4 == NULL))
     {
-        ret_val = usb_queue_push(usb_ch1_queue, mono_data_10ms,is_in_isr());
+        return USB_QUEUE_FAILURE;
     }
 
-    if(2 == channel_no)
+    if (!usb_dbg_is_recording(USB_DBG_CHANNELS))
     {
-        ret_val = usb_queue_push(usb_ch2_queue, mono_data_10ms,is_in_isr());
+        return CY_RSLT_SUCCESS;
     }
-    if(3 == channel_no)
+
+    for (int i = 0; i < USB_DBG_CHANNELS; i++)
     {
-        ret_val = usb_queue_push(usb_ch3_queue, mono_data_10ms,is_in_isr());
+        if ((usb_dbg_rings[i].head - usb_dbg_rings[i].tail) >= USB_DBG_RING_FRAMES)
+        {
+            usb_dbg_overruns += USB_DBG_CHANNELS;
+            return USB_QUEUE_FAILURE;
+        }
     }
-    if(4 == channel_no)
+    for (int i = 0; i < USB_DBG_CHANNELS; i++)
     {
-        ret_val = usb_queue_push(usb_ch4_queue, mono_data_10ms,is_in_isr());
+        (void)usb_dbg_ring_push(&usb_dbg_rings[i], frames[i]);
     }
+    return CY_RSLT_SUCCESS;
+}
 
-    return ret_val;
+/*******************************************************************************
+* Function Name: usb_send_out_dbg_reset
+********************************************************************************
+* Summary:
+*   Discard the frames queued in the debug channel rings, in O(1). Called by
+*   the USB IN callback when the host starts recording, so no stale frame is
+*   sent. Only moves the tails, so it must only run in the consumer context.
+*   The frames left in the rings when the host stops are discarded here at
+*   the next start: the producer drops its frames meanwhile, so the rings
+*   hold at most USB_DBG_RING_FRAMES stale frames. The same number of
+*   frames is discarded from every ring, so that a frame the producer is
+*   pushing is kept whole. The rings fill up to the drift compensation target
+*   again before the stream starts.
+*
+*******************************************************************************/
+
+void usb_send_out_dbg_reset(void)
+{
+    uint32_t discard = USB_DBG_RING_FRAMES;
+
+    for (int i = 0; i < USB_DBG_CHANNELS; i++)
+    {
+        uint32_t count = usb_dbg_rings[i].head - usb_dbg_rings[i].tail;
+
+        if (count < discard)
+        {
+            discard = count;
+        }
+    }
+
+    for (int i = 0; i < USB_DBG_CHANNELS; i++)
+    {
+        usb_dbg_rings[i].tail += discard;
+    }
+    usb_dbg_discarded_at_reset += discard * USB_DBG_CHANNELS;
+    usb_dbg_frame_pos = USB_DBG_FRAME_SAMPLES;
+    usb_drift_restart(&usb_dbg_drift);
+}
+
+/*******************************************************************************
+* Function Name: usb_send_out_dbg_get_discarded
+********************************************************************************
+* Summary:
+*   Number of debug channel frames discarded because the host was not
+*   recording, summed over the channels.
+*
+*******************************************************************************/
+
+uint32_t usb_send_out_dbg_get_discarded(void)
+{
+    return usb_dbg_dropped_at_source + usb_dbg_discarded_at_reset;
+}
+
+/*******************************************************************************
+* Function Name: usb_send_out_dbg_get_drift_stats
+********************************************************************************
+* Summary:
+*   Telemetry of the IN endpoint drift compensation: packet rate correction
+*   and fill level of the debug channel rings, in samples per channel.
+*   Overruns are counted in frames, summed over the channels.
+*
+*******************************************************************************/
+
+void usb_send_out_dbg_get_drift_stats(usb_drift_stats_t *stats)
+{
+    usb_drift_get_stats(&usb_dbg_drift, usb_dbg_overruns, stats);
 }
 
 /*******************************************************************************
@@ -450,38 +769,19 @@ void usb_mic_flush()
 * Function Name: usb_send_out_dbg_init_channels
 ********************************************************************************
 * Summary:
-*   Initialize RTOS queues for USB data.
+*   Initialize the debug channel rings and the RTOS queues for USB data.
 *
 *******************************************************************************/
 
 void usb_send_out_dbg_init_channels()
 {
 
-    usb_ch1_queue = xQueueCreate(USB_QUEUE_ELEMENTS_CH1, MAX_USB_CH1_DATA_Q);
-    if (usb_ch1_queue == NULL)
-    {
-         app_log_print("Init queue for channel 1 failed \r\n");
-    }
-
-
-    usb_ch2_queue = xQueueCreate(USB_QUEUE_ELEMENTS_CH2, MAX_USB_CH2_DATA_Q);
-    if (usb_ch2_queue == NULL)
-    {
-         app_log_print("Init queue for channel 2 failed \r\n");
-    }
-
-    usb_ch3_queue = xQueueCreate(USB_QUEUE_ELEMENTS_CH3, MAX_USB_CH3_DATA_Q);
-    if (usb_ch3_queue == NULL)
-    {
-         app_log_print("Init queue for channel 3 failed \r\n");
-    }
-
-    usb_ch4_queue = xQueueCreate(USB_QUEUE_ELEMENTS_CH4, MAX_USB_CH4_DATA_Q);
-    if (usb_ch4_queue == NULL)
-    {
-         app_log_print("Init queue for channel 4 failed \r\n");
-    }
-
+    memset(usb_dbg_rings, 0, sizeof(usb_dbg_rings));
+    usb_dbg_frame_pos = USB_DBG_FRAME_SAMPLES;
+    usb_drift_init(&usb_dbg_drift, USB_DBG_DRIFT_TARGET, 1u);
+#ifdef USB_DBG_PROFILE
+    profiler_init();
+#endif /* USB_DBG_PROFILE */
 
     usb_mic_queue = xQueueCreate(USB_MIC_IN_Q_LEN, USB_MIC_IN_Q_SIZE);
     if (usb_mic_queue == NULL)
@@ -45,6 +45,7 @@ extern "C"
 #include "rtos.h"
 #include "cyabs_rtos.h"
 #include "cyabs_rtos_internal.h"
+#include "audio_usb_drift.h"
 /*******************************************************************************
 * Macros
 *******************************************************************************/
@@ -62,7 +63,11 @@ extern "C"
 *******************************************************************************/
 void usb_send_out_dbg_init_channels();
 cy_rslt_t usb_send_out_dbg_put(unsigned int channel_no, short *mono_data_10ms);
+cy_rslt_t usb_send_out_dbg_put_all(const short *ch1, const short *ch2, const short *ch3, const short *ch4);
 void usb_send_out_dbg_callback(uint8_t** data, uint16_t* length);
+void usb_send_out_dbg_reset(void);
+uint32_t usb_send_out_dbg_get_discarded(void);
+void usb_send_out_dbg_get_drift_stats(usb_drift_stats_t *stats);
 
 cy_rslt_t usb_queue_push(QueueHandle_t queue, void* item_ptr, bool isr);
 cy_rslt_t usb_queue_pop(QueueHandle_t queue, void* item_ptr, bool isr);
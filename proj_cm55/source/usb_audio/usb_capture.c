@@ -0,0 +1,200 @@
+/******************************************************************************
+* File Name : usb_capture.c
+*
+* Description :
+* Full-rate USB capture mode: raw mic channels, pipeline output and voice
+* assistant markers streamed over the USB IN debug channels, with a frame
+* sequence number so that the host can detect dropped frames
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifdef USB_CAPTURE_MODE
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "usb_capture.h"
+#include "usb_capture_format.h"
+#include "usb_audio_interface.h"
+#include "audio_usb_send_utils.h"
+#include "app_logger.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Frames being built. The mic channels are only split when the input is
+ * interleaved; the rest of the data channel after the header stays silent.
+ */
+static int16_t usb_capture_mic_left[USB_CAPTURE_FRAME_SAMPLES];
+static int16_t usb_capture_mic_right[USB_CAPTURE_FRAME_SAMPLES];
+static uint16_t usb_capture_data[USB_CAPTURE_FRAME_SAMPLES];
+
+static uint32_t usb_capture_seq;
+static volatile uint32_t usb_capture_dropped;
+
+/* Event of the frame being processed, set by the voice assistant before the
+ * frame is captured, in the same task
+ */
+static uint16_t usb_capture_event = VA_NO_EVENT;
+static uint16_t usb_capture_event_arg = USB_CAPTURE_NO_ARG;
+
+/*******************************************************************************
+* Function Name: usb_capture_init
+********************************************************************************
+* Summary:
+*   Start the USB audio interface and the debug channels used by the capture
+*   stream.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Result of the USB audio interface initialization.
+*
+*******************************************************************************/
+cy_rslt_t usb_capture_init(void)
+{
+    cy_rslt_t result = usb_audio_interface_init();
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        app_log_print("USB capture: USB audio init failed (0x%x)\r\n", (unsigned int)result);
+        return result;
+    }
+    usb_send_out_dbg_init_channels();
+
+    app_log_print("USB capture mode: ch1 mic left, ch2 mic right, ch3 output, ch4 frame data\r\n");
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: usb_capture_mark_event
+********************************************************************************
+* Summary:
+*   Record a voice assistant event in the header of the next captured frame,
+*   the frame that raised it. Called from the task that runs the voice
+*   assistant, before usb_capture_put() of the same frame.
+*
+* Parameters:
+*  event   - Event returned by voice_assistant_process
+*  va_data - Data of the event
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void usb_capture_mark_event(va_event_t event, const va_data_t *va_data)
+{
+    usb_capture_event = (uint16_t)event;
+    usb_capture_event_arg = USB_CAPTURE_NO_ARG;
+
+    if ((VA_EVENT_CMD_DETECTED == event) && (NULL != va_data))
+    {
+        usb_capture_event_arg = (uint16_t)va_data->intent_index;
+    }
+    else if (VA_EVENT_MODEL_CHANGED == event)
+    {
+        usb_capture_event_arg = (uint16_t)voice_assistant_get_model_index();
+    }
+}
+
+/*******************************************************************************
+* Function Name: usb_capture_put
+********************************************************************************
+* Summary:
+*   Capture one 10 ms frame: the mic input, the audio the voice assistant
+*   processed, and a header with the sequence number and the voice assistant
+*   state. The four channels are queued together, or the frame is dropped
+*   and counted; the sequence number advances either way.
+*
+* Parameters:
+*  mic          - Mic frame, interleaved if mic_channels is 2
+*  mic_channels - 1 or 2
+*  output       - Mono frame fed to the voice assistant
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void usb_capture_put(const int16_t *mic, uint32_t mic_channels, const int16_t *output)
+{
+    const int16_t *left = mic;
+    const int16_t *right = mic;
+    uint32_t dropped = usb_capture_dropped;
+
+    if (mic_channels > 1u)
+    {
+        for (uint32_t i = 0u; i < USB_CAPTURE_FRAME_SAMPLES; i++)
+        {
+            usb_capture_mic_left[i] = mic[i * mic_channels];
+            usb_capture_mic_right[i] = mic[(i * mic_channels) + 1u];
+        }
+        left = usb_capture_mic_left;
+        right = usb_capture_mic_right;
+    }
+
+    usb_capture_data[USB_CAPTURE_HDR_SYNC0] = USB_CAPTURE_SYNC0;
+    usb_capture_data[USB_CAPTURE_HDR_SYNC1] = USB_CAPTURE_SYNC1;
+    usb_capture_data[USB_CAPTURE_HDR_VERSION] = USB_CAPTURE_VERSION;
+    usb_capture_data[USB_CAPTURE_HDR_SEQ_LO] = (uint16_t)usb_capture_seq;
+    usb_capture_data[USB_CAPTURE_HDR_SEQ_HI] = (uint16_t)(usb_capture_seq >> 16);
+    usb_capture_data[USB_CAPTURE_HDR_STATE] = (uint16_t)voice_assistant_get_state();
+    usb_capture_data[USB_CAPTURE_HDR_EVENT] = usb_capture_event;
+    usb_capture_data[USB_CAPTURE_HDR_EVENT_ARG] = usb_capture_event_arg;
+    usb_capture_data[USB_CAPTURE_HDR_DROPPED_LO] = (uint16_t)dropped;
+    usb_capture_data[USB_CAPTURE_HDR_DROPPED_HI] = (uint16_t)(dropped >> 16);
+    usb_capture_data[USB_CAPTURE_HDR_CHECKSUM] = usb_capture_header_checksum(usb_capture_data);
+
+    usb_capture_event = VA_NO_EVENT;
+    usb_capture_event_arg = USB_CAPTURE_NO_ARG;
+    usb_capture_seq++;
+
+    if (CY_RSLT_SUCCESS != usb_send_out_dbg_put_all(left, right, output, (const short *)usb_capture_data))
+    {
+        usb_capture_dropped = dropped + 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: usb_capture_get_dropped
+********************************************************************************
+* Summary:
+*   Number of frames dropped on the device because the USB debug channels
+*   were full.
+*
+*******************************************************************************/
+uint32_t usb_capture_get_dropped(void)
+{
+    return usb_capture_dropped;
+}
+
+#endif /* USB_CAPTURE_MODE */
+
+/* [] END OF FILE */
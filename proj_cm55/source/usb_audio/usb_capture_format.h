@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name : usb_capture_format.h
+*
+* Description :
+* Format of the full-rate USB capture stream, shared by the firmware and the
+* host recorder (tools/usb_capture_recorder.c)
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef __USB_CAPTURE_FORMAT_H__
+#define __USB_CAPTURE_FORMAT_H__
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The capture stream uses the USB IN format of the debug channels: 4 channels
+ * of 16-bit samples at 16 kHz, sent as 10 ms frames split in 1 ms packets.
+ */
+#define USB_CAPTURE_SAMPLE_RATE         (16000u)
+#define USB_CAPTURE_CHANNELS            (4u)
+#define USB_CAPTURE_FRAME_SAMPLES       (160u)
+
+/* Channels of the stream, zero-based */
+#define USB_CAPTURE_CH_MIC_LEFT         (0u)    /* Raw mic, left */
+#define USB_CAPTURE_CH_MIC_RIGHT        (1u)    /* Raw mic, right (left again with one mic) */
+#define USB_CAPTURE_CH_OUTPUT           (2u)    /* Audio fed to the voice assistant */
+#define USB_CAPTURE_CH_DATA             (3u)    /* Frame header, then silence */
+
+/* The data channel of every frame starts with a header of 16-bit words. The
+ * sync words spell "CAPT" in little-endian byte order.
+ */
+#define USB_CAPTURE_SYNC0               (0x4143u)
+#define USB_CAPTURE_SYNC1               (0x5450u)
+#define USB_CAPTURE_VERSION             (1u)
+
+#define USB_CAPTURE_HDR_SYNC0           (0u)
+#define USB_CAPTURE_HDR_SYNC1           (1u)
+#define USB_CAPTURE_HDR_VERSION         (2u)
+#define USB_CAPTURE_HDR_SEQ_LO          (3u)    /* Frame sequence number, +1 per 10 ms frame */
+#define USB_CAPTURE_HDR_SEQ_HI          (4u)
+#define USB_CAPTURE_HDR_STATE           (5u)    /* va_run_state_t */
+#define USB_CAPTURE_HDR_EVENT           (6u)    /* va_event_t raised by this frame, VA_NO_EVENT if none */
+#define USB_CAPTURE_HDR_EVENT_ARG       (7u)    /* Intent index or model set index, USB_CAPTURE_NO_ARG */
+#define USB_CAPTURE_HDR_DROPPED_LO      (8u)    /* Frames dropped on the device since start-up */
+#define USB_CAPTURE_HDR_DROPPED_HI      (9u)
+#define USB_CAPTURE_HDR_CHECKSUM        (10u)
+#define USB_CAPTURE_HDR_WORDS           (11u)
+
+#define USB_CAPTURE_NO_ARG              (0xFFFFu)
+
+/*******************************************************************************
+* Function Name: usb_capture_header_checksum
+********************************************************************************
+* Summary:
+*   Checksum of a frame header: one's complement of the 16-bit sum of the
+*   words before the checksum. A header is valid if its sync words match and
+*   its checksum word equals this value.
+*
+*******************************************************************************/
+static inline uint16_t usb_capture_header_checksum(const uint16_t *header)
+{
+    uint16_t sum = 0u;
+
+    for (uint32_t i = 0u; i < USB_CAPTURE_HDR_CHECKSUM; i++)
+    {
+        sum = (uint16_t)(sum + header[i]);
+    }
+    return (uint16_t)~sum;
+}
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* __USB_CAPTURE_FORMAT_H__ */
+
+/* [] END OF FILE */
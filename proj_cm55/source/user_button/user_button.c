@@ -39,6 +39,7 @@
 *******************************************************************************/
 #include "user_button.h"
 #include "app_logger.h"
+#include "va_model_registry.h"
 
 /*****************************************************************************
  * Macros
@@ -77,9 +78,11 @@ int8_t nop_mark = 0;
 #endif /* USE_KIT_PSE84_AI */
 uint8_t user_button_1 = 0;
 volatile uint8_t ptt_flag = 0;
+volatile uint8_t model_switch_flag = 0;
 
-#ifdef ENABLE_VOICE_ID
 uint8_t user_button_2 = 0;
+
+#ifdef ENABLE_VOICE_ID
 volatile uint8_t enroll_flag = 0;
 volatile uint8_t erase_flag = 0;
 #endif /* ENABLE_VOICE_ID */
@@ -166,7 +169,10 @@ void process_user_button(void)
     }
     if (button_press>BUTTON_DEBOUNCE_ERASE && nop_mark==0)
     {
-        printf("Release User-Button now for no-action \r\n");
+        if (va_model_registry_count() > 1)
+        {
+            printf("Release User-Button now for switching the model set \r\n");
+        }
         nop_mark=1;
     }
 
@@ -197,9 +203,13 @@ void process_user_button(void)
                 app_log_print("Voice ID Erasing enrollments \r\n");
             }    
         }
-        else if (button_press>BUTTON_DEBOUNCE_THRESHOLD_HIGH)
+        else if (button_press>BUTTON_DEBOUNCE_ERASE && va_model_registry_count() > 1)
         {
-
+            if (model_switch_flag == 0)
+            {
+                model_switch_flag = 1;
+                app_log_print("Switching model set \r\n");
+            }
         }
         button_release = 0;
         button_press = 0;
@@ -283,6 +293,25 @@ void process_user_button(void)
         }
     } 
 #else
+    /* Without Voice ID the second user-button switches the model set, once
+     * per press: the count stops above the debounce until it is released
+     */
+    if (0 == Cy_GPIO_Read(CYBSP_USER_BTN2_PORT, CYBSP_USER_BTN2_NUM))
+    {
+        if (user_button_2 <= BUTTON_DEBOUNCE_COUNT)
+        {
+            user_button_2++;
+            if (user_button_2 > BUTTON_DEBOUNCE_COUNT && va_model_registry_count() > 1)
+            {
+                model_switch_flag = 1;
+            }
+        }
+    }
+    else
+    {
+        user_button_2 = 0;
+    }
+
     if (user_button_1 > BUTTON_DEBOUNCE_COUNT)
     {
 
@@ -292,6 +321,7 @@ void process_user_button(void)
             ptt_flag = 1;
         }
     }
+
 #endif /* ENABLE_VOICE_ID */        
 }
 
@@ -0,0 +1,248 @@
+/******************************************************************************
+* File Name : va_arena.c
+*
+* Description :
+* Plans the memory shared by the DEEPCRAFT(TM) Voice Assistant model sets and
+* prints the resulting memory map
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "va_arena.h"
+
+#include "mtb_ml.h"
+#include "mtb_ml_model_16x8.h"
+#include "AM_LSTM_tflm_model_int16x8.h"
+
+#include "ifx_va_prms.h"
+#include "ifx_sp_common_priv.h"
+
+#include "app_logger.h"
+
+#if defined(ENABLE_VOICE_ID) && defined(VOICE_ID_STREAMING)
+#include "ifx_voice_id.h"
+#endif /* ENABLE_VOICE_ID && VOICE_ID_STREAMING */
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Buffers every model set configuration needs, see <set>_config.c */
+#define VA_MODEL_BUFFERS_SIZE       (AM_LSTM_ARENA_SIZE + \
+                                     (N_SEQ * FEATURE_BUF_SZ * (sizeof(int16_t) + sizeof(float))) + \
+                                     (FRAME_SIZE_16K * sizeof(float)) + \
+                                     (FEATURE_BUF_SZ * sizeof(float)) + \
+                                     ((N_PHONEMES + 1) * (1 + AM_LOOKBACK) * sizeof(float)))
+
+#ifdef VA_SHARED_MODEL_BUFFERS
+#define VA_MODEL_REGION(set)                VA_ARENA_REGION_MODEL_SHARED
+#else
+#define VA_MODEL_REGION(set)                VA_ARENA_REGION_MODEL(set)
+#endif /* VA_SHARED_MODEL_BUFFERS */
+
+/* Users of the memory regions: X(arg, name, region, lifetime, size) */
+#ifdef VA_MODEL_SET_Smart_Lights_Demo
+#define VA_ARENA_USER_Smart_Lights_Demo(X, arg) \
+    X(arg, Smart_Lights_Demo, VA_MODEL_REGION(Smart_Lights_Demo), VA_ARENA_STATES_SET(Smart_Lights_Demo), VA_MODEL_BUFFERS_SIZE)
+#else
+#define VA_ARENA_USER_Smart_Lights_Demo(X, arg)
+#endif /* VA_MODEL_SET_Smart_Lights_Demo */
+
+#ifdef VA_MODEL_SET_LED_Demo
+#define VA_ARENA_USER_LED_Demo(X, arg) \
+    X(arg, LED_Demo, VA_MODEL_REGION(LED_Demo), VA_ARENA_STATES_SET(LED_Demo), VA_MODEL_BUFFERS_SIZE)
+#else
+#define VA_ARENA_USER_LED_Demo(X, arg)
+#endif /* VA_MODEL_SET_LED_Demo */
+
+#ifdef VA_MODEL_SET_Cooktop_Demo
+#define VA_ARENA_USER_Cooktop_Demo(X, arg) \
+    X(arg, Cooktop_Demo, VA_MODEL_REGION(Cooktop_Demo), VA_ARENA_STATES_SET(Cooktop_Demo), VA_MODEL_BUFFERS_SIZE)
+#else
+#define VA_ARENA_USER_Cooktop_Demo(X, arg)
+#endif /* VA_MODEL_SET_Cooktop_Demo */
+
+/* The streaming verification starts with the command detection and goes on
+ * after it, in the wake-word detection: it cannot share the model buffers
+ */
+#if defined(ENABLE_VOICE_ID) && defined(VOICE_ID_STREAMING)
+#define VA_ARENA_USER_Voice_ID(X, arg) \
+    X(arg, Voice_ID_verification, VA_ARENA_REGION_VOICE_ID, VA_ARENA_STATES_ALL, FE_AUDIO_LEN * sizeof(int16_t))
+#else
+#define VA_ARENA_USER_Voice_ID(X, arg)
+#endif /* ENABLE_VOICE_ID && VOICE_ID_STREAMING */
+
+#define VA_ARENA_USERS(X, arg)              \
+    VA_ARENA_USER_Smart_Lights_Demo(X, arg) \
+    VA_ARENA_USER_LED_Demo(X, arg)          \
+    VA_ARENA_USER_Cooktop_Demo(X, arg)      \
+    VA_ARENA_USER_Voice_ID(X, arg)
+
+/* Compile time popcount of a lifetime mask */
+#define VA_BITS2(x)                         (((x) & 1u) + (((x) >> 1) & 1u))
+#define VA_BITS4(x)                         (VA_BITS2(x) + VA_BITS2((x) >> 2))
+#define VA_BITS8(x)                         (VA_BITS4(x) + VA_BITS4((x) >> 4))
+#define VA_BITS16(x)                        (VA_BITS8(x) + VA_BITS8((x) >> 8))
+
+#define VA_USER_LIFETIME_OR(r, name, region, lifetime, size)    | (((region) == (r)) ? (lifetime) : 0u)
+#define VA_USER_LIFETIME_BITS(r, name, region, lifetime, size)  + (((region) == (r)) ? VA_BITS16(lifetime) : 0u)
+#define VA_USER_COUNT(r, name, region, lifetime, size)          + (((region) == (r)) ? 1u : 0u)
+
+#define VA_REGION_LIFETIME(r)               (0u VA_ARENA_USERS(VA_USER_LIFETIME_OR, r))
+#define VA_REGION_LIFETIME_BITS(r)          (0u VA_ARENA_USERS(VA_USER_LIFETIME_BITS, r))
+#define VA_REGION_USERS(r)                  (0u VA_ARENA_USERS(VA_USER_COUNT, r))
+
+/* The users of a region are mutually exclusive if no state is counted twice */
+#define VA_REGION_EXCLUSIVE(r)              (VA_BITS16(VA_REGION_LIFETIME(r)) == VA_REGION_LIFETIME_BITS(r))
+
+_Static_assert(VA_REGION_EXCLUSIVE(VA_ARENA_REGION_MODEL_SHARED),
+               "Users of the shared model buffers are not mutually exclusive");
+_Static_assert(VA_REGION_EXCLUSIVE(VA_ARENA_REGION_MODEL(Smart_Lights_Demo)),
+               "Users of the Smart_Lights_Demo model buffers are not mutually exclusive");
+_Static_assert(VA_REGION_EXCLUSIVE(VA_ARENA_REGION_MODEL(LED_Demo)),
+               "Users of the LED_Demo model buffers are not mutually exclusive");
+_Static_assert(VA_REGION_EXCLUSIVE(VA_ARENA_REGION_MODEL(Cooktop_Demo)),
+               "Users of the Cooktop_Demo model buffers are not mutually exclusive");
+_Static_assert(VA_REGION_EXCLUSIVE(VA_ARENA_REGION_VOICE_ID),
+               "Users of the Voice ID buffers are not mutually exclusive");
+
+#ifdef VA_SHARED_MODEL_BUFFERS
+_Static_assert(VA_REGION_USERS(VA_ARENA_REGION_MODEL_SHARED) > 1u,
+               "VA_SHARED_MODEL_BUFFERS needs more than one model set");
+#endif /* VA_SHARED_MODEL_BUFFERS */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    const char  *name;
+    uint32_t    region;
+    uint32_t    lifetime;
+    uint32_t    size;
+} va_arena_user_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+#ifdef VA_SHARED_MODEL_BUFFERS
+/* Same placement as the buffers in <set>_config.c. The tensor arena must be in
+ * SOCMEM and aligned by 16, which is required by U55.
+ */
+uint8_t va_shared_am_tensor_arena[AM_LSTM_ARENA_SIZE] __attribute__((aligned(16)))
+                                          __attribute__((section(".cy_socmem_data")));
+
+int16_t va_shared_data_feed_int[N_SEQ * FEATURE_BUF_SZ] __attribute__((aligned(16)));
+float va_shared_mtb_ml_input_buffer[N_SEQ * FEATURE_BUF_SZ];
+
+float va_shared_xIn[FRAME_SIZE_16K] __attribute__((section(".wwd_nlu_data3")));
+float va_shared_features[FEATURE_BUF_SZ] __attribute__((section(".wwd_nlu_data4")));
+float va_shared_output_scores[(N_PHONEMES + 1) * (1 + AM_LOOKBACK)] __attribute__((section(".wwd_nlu_data5")));
+#endif /* VA_SHARED_MODEL_BUFFERS */
+
+static const char *const va_arena_region_names[VA_ARENA_REGION_COUNT] =
+{
+    "Shared model buffers",
+    "Smart_Lights_Demo model buffers",
+    "LED_Demo model buffers",
+    "Cooktop_Demo model buffers",
+    "Voice ID buffers",
+};
+
+#define VA_USER_ENTRY(arg, name, region, lifetime, size) \
+    { #name, (region), (lifetime), (uint32_t) (size) },
+
+static const va_arena_user_t va_arena_users[] =
+{
+    VA_ARENA_USERS(VA_USER_ENTRY, 0)
+};
+
+/*******************************************************************************
+ * Function Name: va_arena_print_map
+ *******************************************************************************
+ * Summary:
+ * Prints the memory regions, the users overlaid in each one with the states
+ * of their lifetime, and how much memory is saved by overlaying them.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void va_arena_print_map(void)
+{
+    uint32_t saved = 0;
+
+    app_log_print("Voice Assistant memory map:\r\n");
+
+    for (uint32_t region = 0; region < VA_ARENA_REGION_COUNT; region++)
+    {
+        uint32_t size = 0;
+        uint32_t total = 0;
+
+        for (uint32_t i = 0; i < sizeof(va_arena_users) / sizeof(va_arena_users[0]); i++)
+        {
+            if (va_arena_users[i].region == region)
+            {
+                size = (va_arena_users[i].size > size) ? va_arena_users[i].size : size;
+                total += va_arena_users[i].size;
+            }
+        }
+        if (total == 0)
+        {
+            continue;
+        }
+
+        app_log_print("  %s: %u bytes\r\n", va_arena_region_names[region], size);
+        for (uint32_t i = 0; i < sizeof(va_arena_users) / sizeof(va_arena_users[0]); i++)
+        {
+            if (va_arena_users[i].region == region)
+            {
+                app_log_print("    %-24s %6u bytes, states 0x%02x\r\n", va_arena_users[i].name,
+                    va_arena_users[i].size, va_arena_users[i].lifetime);
+            }
+        }
+        saved += total - size;
+    }
+
+#ifdef VA_SHARED_MODEL_BUFFERS
+    app_log_print("  Tensor arena (SOCMEM): %u bytes at 0x%08x\r\n",
+        (uint32_t) AM_LSTM_ARENA_SIZE, (uint32_t) (uintptr_t) va_shared_am_tensor_arena);
+#else
+    app_log_print("  Tensor arena (SOCMEM): %u bytes per model set\r\n", (uint32_t) AM_LSTM_ARENA_SIZE);
+#endif /* VA_SHARED_MODEL_BUFFERS */
+    app_log_print("  States: bit 2n wake-word, bit 2n+1 command detection of model set n\r\n");
+    app_log_print("  Saved by overlaying: %u bytes\r\n\r\n", saved);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name : va_arena.h
+*
+* Description :
+* Header for the planner of the memory shared by the DEEPCRAFT(TM) Voice
+* Assistant model sets
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef _VA_ARENA_H_
+#define _VA_ARENA_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Mutually exclusive states of the pipeline. A buffer holds live data in the
+ * states of its lifetime; buffers overlaid in one region must not have a
+ * state in common, which va_arena.c checks at compile time. Only one model
+ * set is loaded at a time (see voice_assistant_select_model), and it runs
+ * either the wake-word or the command detection. Both phases use the same
+ * buffers of the set, which the middleware overlays.
+ */
+#define VA_ARENA_SET_Smart_Lights_Demo      (0u)
+#define VA_ARENA_SET_LED_Demo               (1u)
+#define VA_ARENA_SET_Cooktop_Demo           (2u)
+
+#define VA_ARENA_STATE_WWD(set)             (1u << (2u * VA_ARENA_SET_##set))
+#define VA_ARENA_STATE_CMD(set)             (1u << ((2u * VA_ARENA_SET_##set) + 1u))
+#define VA_ARENA_STATES_SET(set)            (VA_ARENA_STATE_WWD(set) | VA_ARENA_STATE_CMD(set))
+#define VA_ARENA_STATES_ALL                 (VA_ARENA_STATES_SET(Smart_Lights_Demo) | \
+                                             VA_ARENA_STATES_SET(LED_Demo) | \
+                                             VA_ARENA_STATES_SET(Cooktop_Demo))
+
+/* Memory regions: the users of a region are overlaid at its start */
+#define VA_ARENA_REGION_MODEL_SHARED        (0u)
+#define VA_ARENA_REGION_MODEL(set)          (1u + VA_ARENA_SET_##set)
+#define VA_ARENA_REGION_VOICE_ID            (4u)
+#define VA_ARENA_REGION_COUNT               (5u)
+
+/* Buffers of a model set configuration. With VA_SHARED_MODEL_BUFFERS, all
+ * linked model sets use the same buffers.
+ */
+#ifdef VA_SHARED_MODEL_BUFFERS
+#define VA_MODEL_BUF(name)                  va_shared_##name
+#else
+#define VA_MODEL_BUF(name)                  name
+#endif /* VA_SHARED_MODEL_BUFFERS */
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+#ifdef VA_SHARED_MODEL_BUFFERS
+extern uint8_t va_shared_am_tensor_arena[];
+extern int16_t va_shared_data_feed_int[];
+extern float   va_shared_mtb_ml_input_buffer[];
+extern float   va_shared_xIn[];
+extern float   va_shared_features[];
+extern float   va_shared_output_scores[];
+#endif /* VA_SHARED_MODEL_BUFFERS */
+
+/*******************************************************************************
+ * Function Prototypes
+ *******************************************************************************/
+void va_arena_print_map(void);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VA_ARENA_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,275 @@
+/******************************************************************************
+* File Name : va_control.c
+*
+* Description :
+* Handles the control requests received from the CM33: PDM gain, running mode,
+* command timeout, Voice ID enrollment and pipeline statistics
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+
+#include "va_control.h"
+#include "va_task.h"
+#include "pdm_mic_interface.h"
+#include "app_logger.h"
+
+/* RTOS includes */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* PDM gain set at start-up by pdm_mic_interface_init() */
+static int8_t va_control_pdm_gain_db = PDM_MIC_GAIN_VALUE;
+
+/* Response not sent yet, the IPC channel was busy */
+static ipc_ctrl_response_t va_control_response;
+static bool va_control_response_pending = false;
+
+#ifdef ENABLE_VOICE_ID
+extern volatile uint8_t enroll_flag;
+#endif /* ENABLE_VOICE_ID */
+
+/*******************************************************************************
+ * Function Name: va_control_set_pdm_gain
+ *******************************************************************************
+ * Summary:
+ * Sets the gain of the PDM/PCM converter of both channels.
+ *
+ * Parameters:
+ *  gain_db: gain in dB
+ *
+ * Return:
+ *  Status of the request
+ *
+ *******************************************************************************/
+static ipc_ctrl_status_t va_control_set_pdm_gain(int32_t gain_db)
+{
+    if ((gain_db < PDM_PCM_MIN_GAIN) || (gain_db > PDM_PCM_MAX_GAIN))
+    {
+        return IPC_CTRL_STATUS_INVALID_ARGUMENT;
+    }
+
+    set_pdm_pcm_gain(convert_db_to_pdm_scale((float) gain_db));
+    va_control_pdm_gain_db = (int8_t) gain_db;
+    app_log_print("PDM gain set to %d dB\r\n", (int) gain_db);
+
+    return IPC_CTRL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function Name: va_control_set_command_timeout
+ *******************************************************************************
+ * Summary:
+ * Sets the command timeout until the next running mode switch.
+ *
+ * Parameters:
+ *  timeout_ms: timeout in milliseconds
+ *
+ * Return:
+ *  Status of the request
+ *
+ *******************************************************************************/
+static ipc_ctrl_status_t va_control_set_command_timeout(int32_t timeout_ms)
+{
+    if ((timeout_ms <= 0) || (timeout_ms > CY_NLU_COMMAND_TIMEOUT_MAX))
+    {
+        return IPC_CTRL_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (VA_RSLT_SUCCESS != voice_assistant_set_command_timeout((uint32_t) timeout_ms))
+    {
+        return IPC_CTRL_STATUS_FAILED;
+    }
+    app_log_print("Command timeout set to %d ms\r\n", (int) timeout_ms);
+
+    return IPC_CTRL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function Name: va_control_start_enrollment
+ *******************************************************************************
+ * Summary:
+ * Starts the Voice ID enrollment of a new user, as the user button does.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Status of the request
+ *
+ *******************************************************************************/
+static ipc_ctrl_status_t va_control_start_enrollment(void)
+{
+#ifdef ENABLE_VOICE_ID
+    if (enroll_flag != 0)
+    {
+        /* An enrollment is already running */
+        return IPC_CTRL_STATUS_FAILED;
+    }
+    app_log_print("Voice ID Enroll Enabled \r\n");
+    enroll_flag = 1;
+
+    return IPC_CTRL_STATUS_OK;
+#else
+    return IPC_CTRL_STATUS_NOT_SUPPORTED;
+#endif /* ENABLE_VOICE_ID */
+}
+
+/*******************************************************************************
+ * Function Name: va_control_get_stats
+ *******************************************************************************
+ * Summary:
+ * Fills the statistics of the audio pipeline.
+ *
+ * Parameters:
+ *  stats: statistics to fill
+ *
+ * Return:
+ *  Status of the request
+ *
+ *******************************************************************************/
+static ipc_ctrl_status_t va_control_get_stats(ipc_ctrl_stats_t *stats)
+{
+    ipc_ring_stats_t ring_stats;
+
+    va_task_get_stats(stats);
+    cm55_ipc_get_ring_stats(&ring_stats);
+
+    stats->uptime_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+    stats->events_sent = ring_stats.events;
+    stats->events_dropped = ring_stats.dropped;
+    cm55_ipc_get_snippet_stats(&stats->snippets_sent, &stats->snippets_dropped);
+    stats->pdm_gain_db = va_control_pdm_gain_db;
+
+    return IPC_CTRL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function Name: va_control_process
+ *******************************************************************************
+ * Summary:
+ * Handles the control request received from the CM33, if any, and sends its
+ * response. Called in the context of the VA task before every frame, so a
+ * request takes up to one frame to be handled. If the IPC channel is busy,
+ * the response is sent with a later frame.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void va_control_process(void)
+{
+    ipc_ctrl_request_t request;
+    ipc_ctrl_response_t *response = &va_control_response;
+    uint32_t rx_us;
+
+    if (va_control_response_pending)
+    {
+        if (!cm55_ipc_send_control_response(response))
+        {
+            return;
+        }
+        va_control_response_pending = false;
+    }
+
+    /* A request re-sent by the CM33 while the previous one was handled */
+    if (cm55_ipc_receive_rejected_control_request(&request))
+    {
+        memset(response, 0, sizeof(ipc_ctrl_response_t));
+        response->id = request.id;
+        response->type = request.type;
+        response->status = IPC_CTRL_STATUS_BUSY;
+        va_control_response_pending = !cm55_ipc_send_control_response(response);
+        return;
+    }
+
+    if (!cm55_ipc_receive_control_request(&request, &rx_us))
+    {
+        return;
+    }
+
+    memset(response, 0, sizeof(ipc_ctrl_response_t));
+    response->id = request.id;
+    response->type = request.type;
+    response->rx_us = rx_us;
+
+    switch (request.type)
+    {
+        case IPC_CTRL_SET_PDM_GAIN:
+            response->status = va_control_set_pdm_gain(request.value);
+            break;
+
+        case IPC_CTRL_SET_RUNNING_MODE:
+            if ((request.value < VA_MODE_WW_SINGLE_CMD) || (request.value > VA_MODE_CMD_ONLY))
+            {
+                response->status = IPC_CTRL_STATUS_INVALID_ARGUMENT;
+            }
+            else
+            {
+                response->status = (VA_RSLT_SUCCESS == va_task_set_running_mode((va_mode_t) request.value)) ?
+                    IPC_CTRL_STATUS_OK : IPC_CTRL_STATUS_FAILED;
+            }
+            break;
+
+        case IPC_CTRL_SET_COMMAND_TIMEOUT:
+            response->status = va_control_set_command_timeout(request.value);
+            break;
+
+        case IPC_CTRL_START_ENROLLMENT:
+            response->status = va_control_start_enrollment();
+            break;
+
+        case IPC_CTRL_GET_STATS:
+            response->status = va_control_get_stats(&response->stats);
+            break;
+
+        case IPC_CTRL_SYNC_CLOCK:
+            /* The CM33 only needs the trace times of the response */
+            response->status = IPC_CTRL_STATUS_OK;
+            break;
+
+        default:
+            response->status = IPC_CTRL_STATUS_NOT_SUPPORTED;
+            break;
+    }
+
+    va_control_response_pending = !cm55_ipc_send_control_response(response);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,377 @@
+/******************************************************************************
+* File Name : va_model_loader.c
+*
+* Description :
+* Loads DEEPCRAFT(TM) Voice Assistant models from model containers stored in a
+* dedicated XIP flash region or in the LittleFS partition
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "va_model_loader.h"
+
+#ifdef VA_MODEL_LOADER
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cy_pdl.h"
+#include "profiler.h"
+#include "ifx_storage.h"
+#include "app_logger.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Buffers in SOCMEM used when the models are copied from LittleFS */
+#ifndef VA_MODEL_LOADER_WW_BUF_SIZE
+#define VA_MODEL_LOADER_WW_BUF_SIZE         (16u * 1024u)
+#endif /* VA_MODEL_LOADER_WW_BUF_SIZE */
+
+#ifndef VA_MODEL_LOADER_CMD_BUF_SIZE
+#define VA_MODEL_LOADER_CMD_BUF_SIZE        (48u * 1024u)
+#endif /* VA_MODEL_LOADER_CMD_BUF_SIZE */
+
+/* Number of model sets whose built-in models are remembered */
+#define VA_MODEL_LOADER_MAX_SETS            (4u)
+
+/* LittleFS file name: <model set>_<ww|cmd>.vam */
+#define VA_MODEL_FILE_NAME_LEN              (VA_MODEL_SET_NAME_LEN + 8u)
+
+#define VA_MODEL_ALIGN_UP(x)                (((x) + VA_MODEL_CONTAINER_ALIGN - 1u) & \
+                                             ~(VA_MODEL_CONTAINER_ALIGN - 1u))
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* The U55 requires the models to be aligned by 16 */
+static uint8_t va_model_ww_buf[VA_MODEL_LOADER_WW_BUF_SIZE] __attribute__((aligned(16)))
+                                          __attribute__((section(".cy_socmem_data")));
+static uint8_t va_model_cmd_buf[VA_MODEL_LOADER_CMD_BUF_SIZE] __attribute__((aligned(16)))
+                                          __attribute__((section(".cy_socmem_data")));
+
+/* Built-in models of every configuration patched by the loader */
+static struct
+{
+    mtb_wwd_nlu_config_t    *config;
+    const char              *ww_model;
+    const char              *cmd_model;
+} va_model_builtin[VA_MODEL_LOADER_MAX_SETS];
+
+/* CRC-32 (IEEE 802.3), 4 bits at a time */
+static const uint32_t va_model_crc32_table[16] =
+{
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL,
+};
+
+/*******************************************************************************
+ * Function Name: va_model_crc32
+ *******************************************************************************
+ * Summary:
+ * Computes the CRC-32 used by the model containers.
+ *
+ * Parameters:
+ *  data: Pointer to the data.
+ *  size: Number of bytes.
+ *
+ * Return:
+ *  CRC-32 of the data.
+ *
+ *******************************************************************************/
+static uint32_t va_model_crc32(const uint8_t *data, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ va_model_crc32_table[crc & 0x0Fu];
+        crc = (crc >> 4) ^ va_model_crc32_table[crc & 0x0Fu];
+    }
+
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+/*******************************************************************************
+ * Function Name: va_model_check_header
+ *******************************************************************************
+ * Summary:
+ * Checks that a container header is valid and holds the requested model.
+ *
+ * Parameters:
+ *  hdr: Pointer to the container header.
+ *  name: Name of the model set.
+ *  type: Type of the model.
+ *
+ * Return:
+ *  true if the container holds the requested model.
+ *
+ *******************************************************************************/
+static bool va_model_check_header(const va_model_container_hdr_t *hdr, const char *name, va_model_type_t type)
+{
+    if ((hdr->magic != VA_MODEL_CONTAINER_MAGIC) ||
+        (hdr->format_version != VA_MODEL_CONTAINER_FORMAT_VERSION) ||
+        (hdr->header_size != sizeof(va_model_container_hdr_t)))
+    {
+        return false;
+    }
+
+    if (hdr->header_crc32 != va_model_crc32((const uint8_t *) hdr, offsetof(va_model_container_hdr_t, header_crc32)))
+    {
+        return false;
+    }
+
+    return ((hdr->model_type == (uint32_t) type) &&
+            (strncmp(hdr->model_set, name, VA_MODEL_SET_NAME_LEN) == 0));
+}
+
+#if defined(VA_MODEL_XIP_ADDRESS) && defined(VA_MODEL_XIP_SIZE)
+/*******************************************************************************
+ * Function Name: va_model_find_xip
+ *******************************************************************************
+ * Summary:
+ * Looks for a model in the memory mapped XIP region. Containers are stored
+ * back to back, each one starting at a VA_MODEL_CONTAINER_ALIGN boundary.
+ *
+ * Parameters:
+ *  name: Name of the model set.
+ *  type: Type of the model.
+ *  version: Model version found.
+ *
+ * Return:
+ *  Pointer to the model in flash, or NULL if not found or corrupted.
+ *
+ *******************************************************************************/
+static const char* va_model_find_xip(const char *name, va_model_type_t type, uint32_t *version)
+{
+    const va_model_container_hdr_t *hdr;
+    const uint8_t *payload;
+    uint32_t offset = 0;
+
+    while ((offset + sizeof(va_model_container_hdr_t)) <= VA_MODEL_XIP_SIZE)
+    {
+        hdr = (const va_model_container_hdr_t *) ((uintptr_t) VA_MODEL_XIP_ADDRESS + offset);
+
+        /* Erased flash or anything else ends the region */
+        if ((hdr->magic != VA_MODEL_CONTAINER_MAGIC) ||
+            ((offset + hdr->header_size + hdr->payload_size) > VA_MODEL_XIP_SIZE))
+        {
+            break;
+        }
+
+        if (va_model_check_header(hdr, name, type))
+        {
+            payload = (const uint8_t *) hdr + hdr->header_size;
+            if (hdr->payload_crc32 != va_model_crc32(payload, hdr->payload_size))
+            {
+                app_log_print("Model %s: XIP container CRC error\r\n", name);
+                return NULL;
+            }
+            *version = hdr->model_version;
+            return (const char *) payload;
+        }
+
+        offset = VA_MODEL_ALIGN_UP(offset + hdr->header_size + hdr->payload_size);
+    }
+
+    return NULL;
+}
+#endif /* VA_MODEL_XIP_ADDRESS && VA_MODEL_XIP_SIZE */
+
+/*******************************************************************************
+ * Function Name: va_model_load_file
+ *******************************************************************************
+ * Summary:
+ * Copies a model from a LittleFS container file into a SOCMEM buffer.
+ *
+ * Parameters:
+ *  name: Name of the model set.
+ *  type: Type of the model.
+ *  buffer: Destination buffer.
+ *  size: Size of the destination buffer.
+ *  version: Model version found.
+ *
+ * Return:
+ *  Pointer to the model in SOCMEM, or NULL if not found or corrupted.
+ *
+ *******************************************************************************/
+static const char* va_model_load_file(const char *name, va_model_type_t type,
+                                      uint8_t *buffer, uint32_t size, uint32_t *version)
+{
+    va_model_container_hdr_t hdr;
+    char file_name[VA_MODEL_FILE_NAME_LEN];
+
+    snprintf(file_name, sizeof(file_name), "%s_%s.vam", name, (type == VA_MODEL_TYPE_WW) ? "ww" : "cmd");
+
+    if (CY_RSLT_SUCCESS != ifx_storage_read_file(file_name, 0, &hdr, sizeof(hdr)))
+    {
+        return NULL;
+    }
+
+    if (!va_model_check_header(&hdr, name, type))
+    {
+        app_log_print("Model %s: invalid container header in %s\r\n", name, file_name);
+        return NULL;
+    }
+
+    if (hdr.payload_size > size)
+    {
+        app_log_print("Model %s: %s needs %u bytes, buffer has %u\r\n", name, file_name, hdr.payload_size, size);
+        return NULL;
+    }
+
+    if ((CY_RSLT_SUCCESS != ifx_storage_read_file(file_name, hdr.header_size, buffer, hdr.payload_size)) ||
+        (hdr.payload_crc32 != va_model_crc32(buffer, hdr.payload_size)))
+    {
+        app_log_print("Model %s: CRC error in %s\r\n", name, file_name);
+        return NULL;
+    }
+
+    *version = hdr.model_version;
+
+    return (const char *) buffer;
+}
+
+/*******************************************************************************
+ * Function Name: va_model_builtin_get
+ *******************************************************************************
+ * Summary:
+ * Returns the entry holding the built-in models of a configuration. The
+ * models referenced by the configuration are saved the first time it is seen.
+ *
+ * Parameters:
+ *  config: Configuration of the model set.
+ *
+ * Return:
+ *  Index of the entry, or VA_MODEL_LOADER_MAX_SETS if the table is full.
+ *
+ *******************************************************************************/
+static uint32_t va_model_builtin_get(mtb_wwd_nlu_config_t *config)
+{
+    uint32_t i;
+
+    for (i = 0; i < VA_MODEL_LOADER_MAX_SETS; i++)
+    {
+        if (va_model_builtin[i].config == config)
+        {
+            return i;
+        }
+        if (va_model_builtin[i].config == NULL)
+        {
+            va_model_builtin[i].config = config;
+            va_model_builtin[i].ww_model = config->ww_model_ptr;
+            va_model_builtin[i].cmd_model = config->cmd_model_ptr;
+            return i;
+        }
+    }
+
+    return VA_MODEL_LOADER_MAX_SETS;
+}
+
+/*******************************************************************************
+ * Function Name: va_model_loader_apply
+ *******************************************************************************
+ * Summary:
+ * Points the configuration of a model set to the newest models available,
+ * before the wake-word and command detection are initialized. A model is
+ * used in place from the XIP region if found there, otherwise it is copied
+ * from LittleFS into SOCMEM. If neither holds a valid container, the model
+ * compiled into the firmware is used.
+ *
+ * Parameters:
+ *  model: Model set to be loaded.
+ *  info: Filled with the source and version of each model.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void va_model_loader_apply(const va_model_set_t *model, va_model_load_info_t *info)
+{
+    mtb_wwd_nlu_config_t *config = model->configs[0];
+    uint32_t start_cycles = profiler_get_cycle_count();
+    const char *ww_model = NULL;
+    const char *cmd_model = NULL;
+    uint32_t builtin;
+
+    memset(info, 0, sizeof(va_model_load_info_t));
+
+    builtin = va_model_builtin_get(config);
+    if (builtin == VA_MODEL_LOADER_MAX_SETS)
+    {
+        return;
+    }
+
+#if defined(VA_MODEL_XIP_ADDRESS) && defined(VA_MODEL_XIP_SIZE)
+    ww_model = va_model_find_xip(model->name, VA_MODEL_TYPE_WW, &info->ww_version);
+    if (ww_model != NULL)
+    {
+        info->ww_source = VA_MODEL_SOURCE_XIP;
+    }
+    cmd_model = va_model_find_xip(model->name, VA_MODEL_TYPE_CMD, &info->cmd_version);
+    if (cmd_model != NULL)
+    {
+        info->cmd_source = VA_MODEL_SOURCE_XIP;
+    }
+#endif /* VA_MODEL_XIP_ADDRESS && VA_MODEL_XIP_SIZE */
+
+    if ((ww_model == NULL) || (cmd_model == NULL))
+    {
+        (void) ifx_storage_init();
+    }
+    if (ww_model == NULL)
+    {
+        ww_model = va_model_load_file(model->name, VA_MODEL_TYPE_WW, va_model_ww_buf,
+                                      sizeof(va_model_ww_buf), &info->ww_version);
+        info->ww_source = (ww_model != NULL) ? VA_MODEL_SOURCE_LITTLEFS : VA_MODEL_SOURCE_BUILTIN;
+    }
+    if (cmd_model == NULL)
+    {
+        cmd_model = va_model_load_file(model->name, VA_MODEL_TYPE_CMD, va_model_cmd_buf,
+                                       sizeof(va_model_cmd_buf), &info->cmd_version);
+        info->cmd_source = (cmd_model != NULL) ? VA_MODEL_SOURCE_LITTLEFS : VA_MODEL_SOURCE_BUILTIN;
+    }
+
+    config->ww_model_ptr = (ww_model != NULL) ? ww_model : va_model_builtin[builtin].ww_model;
+    config->cmd_model_ptr = (cmd_model != NULL) ? cmd_model : va_model_builtin[builtin].cmd_model;
+
+    info->load_time_us = (profiler_get_cycle_count() - start_cycles) / (SystemCoreClock / 1000000u);
+}
+
+#endif /* VA_MODEL_LOADER */
+
+/* [] END OF FILE */
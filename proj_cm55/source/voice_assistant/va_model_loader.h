@@ -0,0 +1,116 @@
+/******************************************************************************
+* File Name : va_model_loader.h
+*
+* Description :
+* Header for loading DEEPCRAFT(TM) Voice Assistant models from model containers
+* stored in flash
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef _VA_MODEL_LOADER_H_
+#define _VA_MODEL_LOADER_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+#include "va_model_registry.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* "VAMC" */
+#define VA_MODEL_CONTAINER_MAGIC            (0x434D4156UL)
+#define VA_MODEL_CONTAINER_FORMAT_VERSION   (1u)
+
+/* Containers in the XIP region start at this alignment */
+#define VA_MODEL_CONTAINER_ALIGN            (16u)
+
+#define VA_MODEL_SET_NAME_LEN               (32u)
+
+/******************************************************************************
+ * Typedefs
+ *****************************************************************************/
+typedef enum
+{
+    VA_MODEL_TYPE_WW = 1,
+    VA_MODEL_TYPE_CMD = 2,
+} va_model_type_t;
+
+typedef enum
+{
+    VA_MODEL_SOURCE_BUILTIN = 0,    /* C array compiled into the firmware */
+    VA_MODEL_SOURCE_XIP = 1,        /* Used in place from the XIP region */
+    VA_MODEL_SOURCE_LITTLEFS = 2,   /* Copied from LittleFS into SOCMEM */
+} va_model_source_t;
+
+/******************************************************************************
+ * Structures
+ ******************************************************************************/
+/* Header in front of every model payload. The payload follows the header
+ * directly. All fields are little endian.
+ */
+typedef struct
+{
+    uint32_t    magic;                              /* VA_MODEL_CONTAINER_MAGIC */
+    uint16_t    format_version;                     /* VA_MODEL_CONTAINER_FORMAT_VERSION */
+    uint16_t    header_size;                        /* sizeof(va_model_container_hdr_t) */
+    uint32_t    model_type;                         /* va_model_type_t */
+    uint32_t    model_version;                      /* Set by the model publisher */
+    uint32_t    payload_size;                       /* Bytes following the header */
+    uint32_t    payload_crc32;                      /* CRC-32 (IEEE 802.3) of the payload */
+    char        model_set[VA_MODEL_SET_NAME_LEN];   /* Model set name, NUL terminated */
+    uint32_t    reserved;
+    uint32_t    header_crc32;                       /* CRC-32 of all previous header bytes */
+} va_model_container_hdr_t;
+
+/* Where the models of the active model set were loaded from */
+typedef struct
+{
+    va_model_source_t   ww_source;
+    va_model_source_t   cmd_source;
+    uint32_t            ww_version;
+    uint32_t            cmd_version;
+    uint32_t            load_time_us;
+} va_model_load_info_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ *******************************************************************************/
+void va_model_loader_apply(const va_model_set_t *model, va_model_load_info_t *info);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VA_MODEL_LOADER_H_ */
+
+/* [] END OF FILE */
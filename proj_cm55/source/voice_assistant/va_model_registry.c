@@ -0,0 +1,262 @@
+/******************************************************************************
+* File Name : va_model_registry.c
+*
+* Description :
+* Registry of the DEEPCRAFT(TM) Voice Assistant model sets linked into the
+* firmware image. The model sets are selected with DEEPCRAFT_MODEL_SETS in
+* common.mk and can be switched at runtime by the voice assistant.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+
+#include "va_model_registry.h"
+#include "va_string_table.h"
+
+/* Headers generated by the DEEPCRAFT Voice-Assistant cloud tool. To link a new
+ * model set, add it to DEEPCRAFT_MODEL_SETS and add a matching entry below.
+ */
+#ifdef VA_MODEL_SET_Smart_Lights_Demo
+#include MTB_WWD_NLU_APP_HEADER(Smart_Lights_Demo)
+#include MTB_WWD_NLU_CONFIG_HEADER(Smart_Lights_Demo)
+#endif /* VA_MODEL_SET_Smart_Lights_Demo */
+
+#ifdef VA_MODEL_SET_LED_Demo
+#include MTB_WWD_NLU_APP_HEADER(LED_Demo)
+#include MTB_WWD_NLU_CONFIG_HEADER(LED_Demo)
+#endif /* VA_MODEL_SET_LED_Demo */
+
+#ifdef VA_MODEL_SET_Cooktop_Demo
+#include MTB_WWD_NLU_APP_HEADER(Cooktop_Demo)
+#include MTB_WWD_NLU_CONFIG_HEADER(Cooktop_Demo)
+#endif /* VA_MODEL_SET_Cooktop_Demo */
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define VA_MODEL_STR(x)                 #x
+#define VA_MODEL_XSTR(x)                VA_MODEL_STR(x)
+
+#define VA_MODEL_ARRAY_LEN(array)       (sizeof(array) / sizeof((array)[0]))
+
+#define VA_MODEL_SET_ENTRY(prefix)                                                  \
+    {                                                                               \
+        .name                   = #prefix,                                          \
+        .string_table_id        = VA_STR_MODEL_##prefix,                            \
+        .configs                = MTB_WWD_NLU_CONFIG_STRUCT(prefix),                \
+        .wake_word_str          = MTB_WWD_NLU_CONFIG_WAKE_WORD_STR(prefix),         \
+        .intent_name_list       = MTB_NLU_INTENT_NAME_LIST(prefix),                 \
+        .num_intents            = VA_MODEL_ARRAY_LEN(MTB_NLU_INTENT_NAME_LIST(prefix)),     \
+        .variable_phrase_list   = MTB_NLU_VARIABLE_PHRASE_LIST(prefix),             \
+        .num_variable_phrases   = VA_MODEL_ARRAY_LEN(MTB_NLU_VARIABLE_PHRASE_LIST(prefix)), \
+        .unit_phrase_list       = MTB_NLU_UNIT_PHRASE_LIST(prefix),                 \
+        .num_unit_phrases       = VA_MODEL_ARRAY_LEN(MTB_NLU_UNIT_PHRASE_LIST(prefix)),     \
+        .variable_name_list     = prefix##_variable_name_list,                      \
+        .num_variables          = VA_MODEL_ARRAY_LEN(prefix##_variable_name_list),  \
+        .variable_phrase_sizes  = prefix##_variable_phrase_sizes,                   \
+        .intent_map_array       = prefix##_intent_map_array,                        \
+        .intent_map_array_sizes = prefix##_intent_map_array_sizes,                  \
+        .num_commands           = VA_MODEL_ARRAY_LEN(prefix##_intent_map_array_sizes),      \
+        .command_offsets        = va_index_##prefix##_command_offsets,              \
+        .phrase_variable        = va_index_##prefix##_phrase_variable,              \
+        .variable_offsets       = va_index_##prefix##_variable_offsets,             \
+        .intent_slot_variable   = va_index_##prefix##_intent_slot_variable,         \
+    }
+
+/* The CM33 reports the events with the string table, and the CM55 decodes
+ * them with the index, both generated by tools/va_string_table_gen.c:
+ * regenerate them if a model set changed.
+ */
+#define VA_MODEL_SET_CHECK_TABLES(prefix)                                           \
+    _Static_assert(VA_MODEL_ARRAY_LEN(MTB_NLU_INTENT_NAME_LIST(prefix)) == VA_STR_##prefix##_NUM_INTENTS,     \
+        "String table of " #prefix " out of date");                                 \
+    _Static_assert(VA_MODEL_ARRAY_LEN(prefix##_variable_name_list) == VA_STR_##prefix##_NUM_VARIABLES,        \
+        "String table of " #prefix " out of date");                                 \
+    _Static_assert(VA_MODEL_ARRAY_LEN(MTB_NLU_VARIABLE_PHRASE_LIST(prefix)) == VA_STR_##prefix##_NUM_VARIABLE_PHRASES, \
+        "String table of " #prefix " out of date");                                 \
+    _Static_assert(VA_MODEL_ARRAY_LEN(MTB_NLU_UNIT_PHRASE_LIST(prefix)) == VA_STR_##prefix##_NUM_UNIT_PHRASES, \
+        "String table of " #prefix " out of date");                                 \
+    _Static_assert(VA_MODEL_ARRAY_LEN(prefix##_intent_map_array_sizes) == VA_IDX_##prefix##_NUM_COMMANDS,     \
+        "Decoding index of " #prefix " out of date");                               \
+    _Static_assert(VA_MODEL_ARRAY_LEN(prefix##_intent_map_array) == VA_IDX_##prefix##_INTENT_MAP_SIZE,        \
+        "Decoding index of " #prefix " out of date");
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+#ifdef VA_MODEL_SET_Smart_Lights_Demo
+VA_MODEL_SET_CHECK_TABLES(Smart_Lights_Demo)
+#endif /* VA_MODEL_SET_Smart_Lights_Demo */
+#ifdef VA_MODEL_SET_LED_Demo
+VA_MODEL_SET_CHECK_TABLES(LED_Demo)
+#endif /* VA_MODEL_SET_LED_Demo */
+#ifdef VA_MODEL_SET_Cooktop_Demo
+VA_MODEL_SET_CHECK_TABLES(Cooktop_Demo)
+#endif /* VA_MODEL_SET_Cooktop_Demo */
+
+static const va_model_set_t va_model_sets[] =
+{
+#ifdef VA_MODEL_SET_Smart_Lights_Demo
+    VA_MODEL_SET_ENTRY(Smart_Lights_Demo),
+#endif /* VA_MODEL_SET_Smart_Lights_Demo */
+#ifdef VA_MODEL_SET_LED_Demo
+    VA_MODEL_SET_ENTRY(LED_Demo),
+#endif /* VA_MODEL_SET_LED_Demo */
+#ifdef VA_MODEL_SET_Cooktop_Demo
+    VA_MODEL_SET_ENTRY(Cooktop_Demo),
+#endif /* VA_MODEL_SET_Cooktop_Demo */
+};
+
+/*******************************************************************************
+ * Function Name: va_model_registry_count
+ *******************************************************************************
+ * Summary:
+ * Returns the number of model sets linked into the firmware.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Number of model sets.
+ *
+ *******************************************************************************/
+uint32_t va_model_registry_count(void)
+{
+    return VA_MODEL_ARRAY_LEN(va_model_sets);
+}
+
+/*******************************************************************************
+ * Function Name: va_model_registry_get
+ *******************************************************************************
+ * Summary:
+ * Returns the model set stored at the given registry index.
+ *
+ * Parameters:
+ *  index: registry index of the model set.
+ *
+ * Return:
+ *  Pointer to the model set, or NULL if the index is out of range.
+ *
+ *******************************************************************************/
+const va_model_set_t* va_model_registry_get(uint32_t index)
+{
+    if (index >= va_model_registry_count())
+    {
+        return NULL;
+    }
+
+    return &va_model_sets[index];
+}
+
+/*******************************************************************************
+ * Function Name: va_model_registry_find
+ *******************************************************************************
+ * Summary:
+ * Looks up a model set by the project name used in the DEEPCRAFT cloud tool.
+ *
+ * Parameters:
+ *  name: project name of the model set (e.g. "Smart_Lights_Demo").
+ *
+ * Return:
+ *  Registry index of the model set, or VA_MODEL_SET_INVALID_INDEX.
+ *
+ *******************************************************************************/
+int32_t va_model_registry_find(const char *name)
+{
+    if (name == NULL)
+    {
+        return VA_MODEL_SET_INVALID_INDEX;
+    }
+
+    for (uint32_t i = 0; i < va_model_registry_count(); i++)
+    {
+        if (0 == strcmp(va_model_sets[i].name, name))
+        {
+            return (int32_t) i;
+        }
+    }
+
+    return VA_MODEL_SET_INVALID_INDEX;
+}
+
+/*******************************************************************************
+ * Function Name: va_model_registry_default_index
+ *******************************************************************************
+ * Summary:
+ * Returns the registry index of the model set loaded at boot, which is the
+ * one selected by DEEPCRAFT_PROJECT_NAME.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Registry index of the default model set.
+ *
+ *******************************************************************************/
+uint32_t va_model_registry_default_index(void)
+{
+    int32_t index = va_model_registry_find(VA_MODEL_XSTR(PROJECT_PREFIX));
+
+    return (index < 0) ? 0u : (uint32_t) index;
+}
+
+/*******************************************************************************
+ * Function Name: va_model_registry_get_command
+ *******************************************************************************
+ * Summary:
+ * Returns the record of a command in the intent map of a model set, found
+ * with the generated offset index.
+ *
+ * Parameters:
+ *  model: model set.
+ *  command: command index.
+ *  length: set to the number of entries of the record.
+ *
+ * Return:
+ *  Pointer to the record (intent, n, n x (variable, phrase)), or NULL if the
+ *  command does not exist.
+ *
+ *******************************************************************************/
+const int* va_model_registry_get_command(const va_model_set_t *model, uint32_t command, uint32_t *length)
+{
+    if ((model == NULL) || (length == NULL) || (command >= model->num_commands))
+    {
+        return NULL;
+    }
+
+    *length = (uint32_t) model->intent_map_array_sizes[command];
+
+    return &model->intent_map_array[model->command_offsets[command]];
+}
+
+/* [] END OF FILE */
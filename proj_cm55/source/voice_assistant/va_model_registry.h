@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name : va_model_registry.h
+*
+* Description :
+* Header for the registry of DEEPCRAFT(TM) Voice Assistant model sets linked into
+* the firmware image
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+#ifndef _VA_MODEL_REGISTRY_H_
+#define _VA_MODEL_REGISTRY_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+#include "mtb_wwd_nlu_common.h"
+#include "va_model_index.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define VA_MODEL_SET_INVALID_INDEX      (-1)
+
+/* Variables per command supported by the decoding index */
+#define VA_MODEL_MAX_VARIABLE_SLOTS     VA_IDX_MAX_VARIABLE_SLOTS
+
+/* Variable of a slot that differs between the commands of an intent */
+#define VA_MODEL_VARIABLE_UNKNOWN       VA_IDX_VARIABLE_UNKNOWN
+
+/******************************************************************************
+ * Structures
+ ******************************************************************************/
+/* Everything the application needs to run and report one model set generated
+ * by the DEEPCRAFT Voice Assistant cloud tool.
+ */
+typedef struct
+{
+    const char              *name;
+    uint8_t                 string_table_id;        /* VA_STR_MODEL_<name> of va_string_table.h */
+    mtb_wwd_nlu_config_t    **configs;
+    char                    **wake_word_str;
+    const char              **intent_name_list;
+    uint32_t                num_intents;
+    const char              **variable_phrase_list;
+    uint32_t                num_variable_phrases;
+    const char              **unit_phrase_list;
+    uint32_t                num_unit_phrases;
+    const char              **variable_name_list;
+    uint32_t                num_variables;
+    const int               *variable_phrase_sizes;
+    const int               *intent_map_array;      /* Records: intent, n, n x (variable, phrase) */
+    const int               *intent_map_array_sizes;
+    uint32_t                num_commands;
+
+    /* Decoding index generated by tools/va_string_table_gen.c (va_model_index.c) */
+    const uint32_t          *command_offsets;       /* Record of every command in intent_map_array */
+    const uint16_t          *phrase_variable;       /* Variable of every entry of variable_phrase_list */
+    const uint16_t          *variable_offsets;      /* First entry of every variable in variable_phrase_list */
+    const uint16_t          (*intent_slot_variable)[VA_MODEL_MAX_VARIABLE_SLOTS]; /* Variable of every slot of an intent */
+} va_model_set_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ *******************************************************************************/
+uint32_t              va_model_registry_count(void);
+const va_model_set_t* va_model_registry_get(uint32_t index);
+int32_t               va_model_registry_find(const char *name);
+uint32_t              va_model_registry_default_index(void);
+const int*            va_model_registry_get_command(const va_model_set_t *model, uint32_t command, uint32_t *length);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VA_MODEL_REGISTRY_H_ */
+
+/* [] END OF FILE */
@@ -54,6 +54,12 @@
 #include "Cooktop_Demo.h"
 #include "Cooktop_Demo_ifx_va_config_prms.h"
 
+#include "va_arena.h"
+
+/* With VA_SHARED_MODEL_BUFFERS all linked model sets share the buffers below,
+ * see va_arena.c
+ */
+#ifndef VA_SHARED_MODEL_BUFFERS
 /* Following am_tensor_arena has been counted as part of persistent memory total size */
 /* Tensor_arena buffer must be in SOCMEM and aligned by 16 which are required by U55 */
 static uint8_t am_tensor_arena[AM_LSTM_ARENA_SIZE] __attribute__((aligned(16)))
@@ -66,20 +72,21 @@ static float mtb_ml_input_buffer[N_SEQ * FEATURE_BUF_SZ];
 static float xIn[FRAME_SIZE_16K] __attribute__((section(".wwd_nlu_data3")));
 static float features[FEATURE_BUF_SZ] __attribute__((section(".wwd_nlu_data4")));
 static float output_scores[(N_PHONEMES + 1) * (1 + AM_LOOKBACK)] __attribute__((section(".wwd_nlu_data5")));
+#endif /* VA_SHARED_MODEL_BUFFERS */
 
 //common buffers
 static mtb_wwd_nlu_buff_t wwd_nlu_buff =
 {
     .am_model_bin = { MTB_ML_MODEL_BIN_DATA(AM_LSTM) },
     .am_model_buffer = {
-        .tensor_arena = am_tensor_arena,
+        .tensor_arena = VA_MODEL_BUF(am_tensor_arena),
         .tensor_arena_size = AM_LSTM_ARENA_SIZE
     },
-    .data_feed_int = data_feed_int,
-    .mtb_ml_input_buffer = mtb_ml_input_buffer,
-    .output_scores = output_scores,
-    .xIn = xIn,
-    .features = features
+    .data_feed_int = VA_MODEL_BUF(data_feed_int),
+    .mtb_ml_input_buffer = VA_MODEL_BUF(mtb_ml_input_buffer),
+    .output_scores = VA_MODEL_BUF(output_scores),
+    .xIn = VA_MODEL_BUF(xIn),
+    .features = VA_MODEL_BUF(features)
 };
 
 // NLU setup array
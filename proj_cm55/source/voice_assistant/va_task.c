@@ -37,6 +37,7 @@
 * Header Files
 *******************************************************************************/
 
+#include <stdio.h>
 #include <string.h>
 
 #include "va_task.h"
@@ -47,15 +48,19 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
-#ifdef SHOW_MCPS
 #include "profiler.h"
-#endif /* SHOW_MCPS */
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
+#include "va_control.h"
 #ifdef ENABLE_VOICE_ID
 #include "voice_id_task.h"
 #endif /* ENABLE_VOICE_ID */
 #include "app_logger.h"
+#include "va_arena.h"
+#include "va_string_table.h"
+#ifdef USB_CAPTURE_MODE
+#include "usb_capture.h"
+#endif /* USB_CAPTURE_MODE */
 
 
 /*****************************************************************************
@@ -69,6 +74,11 @@
 #define VA_QUEUE_SIZE                             (VA_AUDIO_DATA_IN_BYTES)
 #define VA_QUEUE_ELEMENTS                         (10)    
 
+/* Capture times of the frames on their way to the voice assistant, more than
+ * the frames the queue or the Audio Enhancement can hold, a power of 2
+ */
+#define VA_CAPTURE_FIFO_SIZE                      (16u)
+
 /* This is the maximum size of the command string that can be detected by the 
  * voice assistant. 
  */
@@ -85,6 +95,7 @@
  * VA_MODE_WW_MULTI_CMD  : For every wake word, multiple commands can be detected
  * VA_MODE_WW_ONLY       : Only wake word detection is performed
  * VA_MODE_CMD_ONLY      : Only command detection is performed
+ * The CM33 can switch the mode at runtime (IPC_CTRL_SET_RUNNING_MODE).
  */
 #define RUNNING_MODE                              (VA_MODE_WW_SINGLE_CMD) 
 
@@ -94,6 +105,16 @@
 /* How often to print the MCPS (multiply by 10 ms) */
 #define PRINT_MCPS_COUNT                        (100u) 
 
+#ifdef VA_BATCH_BENCHMARK
+/* Frames in the benchmark buffer and how often the buffer is processed */
+#define BATCH_BENCHMARK_FRAMES                  (10u)
+#define BATCH_BENCHMARK_REPEAT                  (100u)
+#endif /* VA_BATCH_BENCHMARK */
+
+/* The commands are sent to the CM33 as they are decoded */
+_Static_assert(IPC_EVENT_MAX_VARIABLES == VA_NLU_MAX_NUM_VARIABLES, "IPC event records too small");
+_Static_assert(IPC_EVENT_NO_ID == VA_MODEL_VARIABLE_UNKNOWN, "IPC variable IDs differ");
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -104,6 +125,25 @@ static uint8_t breathing_counter;
 uint8_t bf_coeffs[1];
 uint32_t bf_coeffs_total_len;
 
+/* Pipeline statistics, restarted when read by va_task_get_stats() */
+static uint32_t va_frames_processed;
+static uint64_t va_frame_cycles_sum;
+static uint32_t va_frame_cycles_max;
+static uint32_t va_frames_dropped_read;
+
+/* Capture times of the frames, in the order they are processed: written by
+ * the PDM interrupt, read by the voice assistant. Trace times of the current
+ * frame.
+ */
+static volatile uint32_t va_capture_us[VA_CAPTURE_FIFO_SIZE];
+static volatile uint32_t va_capture_head;
+static volatile uint32_t va_capture_tail;
+static uint32_t va_frame_capture_us;
+static uint32_t va_frame_process_us;
+
+/* Frames lost with the voice assistant queue full */
+volatile uint32_t va_frames_dropped = 0;
+
 #ifdef SHOW_MCPS
 /* Variables used to print and calculate MCPS */
 uint32_t show_count = 0;
@@ -115,6 +155,7 @@ QueueHandle_t va_queue_handle;
 
 uint8_t ptt_control_flag=0;
 extern volatile uint8_t ptt_flag;
+extern volatile uint8_t model_switch_flag;
 
 #ifdef ENABLE_VOICE_ID
 extern volatile char voice_id_mode;
@@ -140,22 +181,22 @@ static void led_demo(int intent, uint8_t brightness)
     /* LED PWM driver is used to control the LED brightness and state. */
     switch (intent)
     {
-        case LED_DEMO_INTENT_TurnOnLight:
+        case VA_STR_LED_Demo_INTENT_TurnOnLight:
             led_pwm_on(LED_PWM_GREEN_LED);
             break;
-        case LED_DEMO_INTENT_TurnOffLight:
+        case VA_STR_LED_Demo_INTENT_TurnOffLight:
             led_pwm_off(LED_PWM_GREEN_LED);
             break;
-        case LED_DEMO_INTENT_IncreaseBrightness:
+        case VA_STR_LED_Demo_INTENT_IncreaseBrightness:
             led_pwm_set_brightness(LED_PWM_GREEN_LED, LED_PWM_MAX_BRIGHTNESS);
             break;
-        case LED_DEMO_INTENT_DecreaseBrightness:
+        case VA_STR_LED_Demo_INTENT_DecreaseBrightness:
             led_pwm_set_brightness(LED_PWM_GREEN_LED, LED_PWM_MIN_BRIGHTNESS);
             break;
-        case LED_DEMO_INTENT_SetBrightness:
+        case VA_STR_LED_Demo_INTENT_SetBrightness:
             led_pwm_set_brightness(LED_PWM_GREEN_LED, brightness);
             break;
-        case LED_DEMO_INTENT_ToggleLight:
+        case VA_STR_LED_Demo_INTENT_ToggleLight:
             led_pwm_toggle(LED_PWM_GREEN_LED);
             break;
         default:
@@ -191,6 +232,85 @@ static void print_mcps(void)
 }
 #endif /* SHOW_MCPS */
 
+#ifdef VA_BATCH_BENCHMARK
+/*******************************************************************************
+ * Function Name: run_batch_benchmark
+ *******************************************************************************
+ * Summary:
+ * Measures the CM55 throughput of the voice assistant by processing a silent
+ * buffer with voice_assistant_process_batch and prints how much faster than
+ * real time the audio is processed. The re-initialization of the detection
+ * around every batch is measured with an empty batch and left out.
+ *  
+ * Parameters:
+ *  void
+ *  
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void run_batch_benchmark(void)
+{
+    static int16_t frames[BATCH_BENCHMARK_FRAMES * VA_AUDIO_FRAME_SAMPLES];
+    va_batch_event_t events[BATCH_BENCHMARK_FRAMES];
+    uint32_t num_events;
+    uint64_t cycle_sum = 0;
+    uint32_t start_cycles;
+    uint32_t reset_cycles;
+    uint32_t audio_ms = BATCH_BENCHMARK_FRAMES * BATCH_BENCHMARK_REPEAT * VA_AUDIO_FRAME_MS;
+    uint32_t cpu_ms;
+
+    profiler_init();
+
+    num_events = BATCH_BENCHMARK_FRAMES;
+    start_cycles = profiler_get_cycle_count();
+    voice_assistant_process_batch(frames, 0, events, &num_events);
+    reset_cycles = profiler_get_cycle_count() - start_cycles;
+
+    for (uint32_t i = 0; i < BATCH_BENCHMARK_REPEAT; i++)
+    {
+        uint32_t batch_cycles;
+
+        num_events = BATCH_BENCHMARK_FRAMES;
+        start_cycles = profiler_get_cycle_count();
+        voice_assistant_process_batch(frames, BATCH_BENCHMARK_FRAMES, events, &num_events);
+        batch_cycles = profiler_get_cycle_count() - start_cycles;
+        cycle_sum += (batch_cycles > reset_cycles) ? (batch_cycles - reset_cycles) : 0;
+    }
+
+    cpu_ms = (uint32_t) (cycle_sum / (SystemCoreClock / 1000u));
+    app_log_print("Batch benchmark: %u ms of audio in %u ms, %u MCPS, %ux real time\r\n\r\n",
+        audio_ms, cpu_ms, (uint32_t) (cycle_sum / 1000u / audio_ms),
+        (cpu_ms != 0) ? (audio_ms / cpu_ms) : audio_ms);
+}
+#endif /* VA_BATCH_BENCHMARK */
+
+#ifdef VA_MODEL_LOADER
+/*******************************************************************************
+ * Function Name: print_model_load_info
+ *******************************************************************************
+ * Summary:
+ * Prints where the models of the active model set were loaded from and how
+ * long loading took.
+ *  
+ * Parameters:
+ *  void
+ *  
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void print_model_load_info(void)
+{
+    static const char *source_str[] = { "built-in", "XIP", "LittleFS" };
+    const va_model_load_info_t *info = voice_assistant_get_model_load_info();
+
+    app_log_print("Models of %s loaded in %u us\r\n", voice_assistant_get_model()->name, info->load_time_us);
+    app_log_print("  WW model : %s, version %u\r\n", source_str[info->ww_source], info->ww_version);
+    app_log_print("  CMD model: %s, version %u\r\n\r\n", source_str[info->cmd_source], info->cmd_version);
+}
+#endif /* VA_MODEL_LOADER */
+
 /*******************************************************************************
  * Function Name: print_voice_assistant_status
  *******************************************************************************
@@ -211,29 +331,29 @@ static void print_mcps(void)
 static void print_voice_assistant_status(cy_rslt_t result, va_event_t event, va_data_t *va_data)
 {
     char command_text[COMMAND_STRING_SIZE] = {0};
+    const va_model_set_t *model = voice_assistant_get_model();
+    va_mode_t mode = voice_assistant_get_mode();
+    va_intent_t intent;
 
     ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
-    payload->has_event = false;
-    payload->event[0] = '\0'; // make sure there's no string in the event buffer
+    payload->event = IPC_EVENT_NONE;
+    payload->model_id = model->string_table_id;
 
-    // we will initialize this array for whatever intent gets discovered later
-    payload->intent_name[0] = '\0';
-    payload->intent_param1_str_var[0] = '\0';
-    payload->intent_param1_int_var = -1;
+    // we will fill the intent and its variables if a command gets discovered later
+    payload->intent_id = IPC_EVENT_NO_ID;
+    payload->num_variables = 0;
 
     if (result == VA_RSLT_LICENSE_ERROR)
     {
         app_log_print("ERROR! Voice Assistant license expired!\r\n");
         handle_error();
-        strcpy(payload->event, "license expired");
-        payload->has_event = true;
+        payload->event = IPC_EVENT_LICENSE_EXPIRED;
         payload->is_mic_active = false;
     }
     else if ( result != VA_RSLT_SUCCESS )
     {
         app_log_print("Error! voice_assistant_process!! Error code=%d\r\n", result);
-        strcpy(payload->event, "ERROR");
-        payload->has_event = true;
+        payload->event = IPC_EVENT_ERROR;
         payload->is_mic_active = false;
 
     }
@@ -241,13 +361,12 @@ static void print_voice_assistant_status(cy_rslt_t result, va_event_t event, va_
     {
         if ( event == VA_EVENT_WW_DETECTED )
         {
-            if (RUNNING_MODE != VA_MODE_WW_ONLY)
+            if (mode != VA_MODE_WW_ONLY)
             {
                 breathing_counter = LED_PWM_MIN_BRIGHTNESS;
             }
             app_log_print("Wake-word detected!\r\n");
-            strcpy(payload->event, IPC_CMD_WAKE_WORD_STR);
-            payload->has_event = true;
+            payload->event = IPC_EVENT_WAKE_WORD;
             payload->is_mic_active = true;
 
 #ifdef ENABLE_VOICE_ID 
@@ -264,33 +383,31 @@ static void print_voice_assistant_status(cy_rslt_t result, va_event_t event, va_
         }
         else if ( event == VA_EVENT_CMD_TIMEOUT )
         {
-            if (RUNNING_MODE != VA_MODE_CMD_ONLY)
+            if (mode != VA_MODE_CMD_ONLY)
             {
                 breathing_counter = 0;
                 ptt_flag = 0;
                 ptt_control_flag = 0;
                 app_log_print("Command Timeout!\r\n");
-                strcpy(payload->event, IPC_CMD_TIMEOUT_STR);
-                payload->has_event = true;
+                payload->event = IPC_EVENT_TIMEOUT;
                 payload->is_mic_active = false;
             }
         }
         else if ( event == VA_EVENT_CMD_SILENCE_TIMEOUT )
         {
-            if ((RUNNING_MODE != VA_MODE_WW_MULTI_CMD) && (RUNNING_MODE != VA_MODE_CMD_ONLY))
+            if ((mode != VA_MODE_WW_MULTI_CMD) && (mode != VA_MODE_CMD_ONLY))
             {
                 breathing_counter = 0;
                 ptt_flag = 0;
                 ptt_control_flag = 0;
                 app_log_print("Pre Silence Timeout!\r\n");
-                strcpy(payload->event, IPC_CMD_TIMEOUT_STR);
-                payload->has_event = true;
+                payload->event = IPC_EVENT_TIMEOUT;
                 payload->is_mic_active = false;
             }
         }
         else if ( event == VA_EVENT_CMD_DETECTED )
         {
-            if (RUNNING_MODE == VA_MODE_WW_SINGLE_CMD)
+            if (mode == VA_MODE_WW_SINGLE_CMD)
             {
                 breathing_counter = 0;
             }
@@ -298,8 +415,7 @@ static void print_voice_assistant_status(cy_rslt_t result, va_event_t event, va_
             if (CY_RSLT_SUCCESS == voice_assistant_get_command(command_text))
             {
                 app_log_print("%s\r\n\r\n", command_text);
-                strcpy(payload->event, command_text);
-                payload->has_event = true;
+                payload->event = IPC_EVENT_COMMAND;
                 payload->is_mic_active = false;
             }
 
@@ -308,46 +424,67 @@ static void print_voice_assistant_status(cy_rslt_t result, va_event_t event, va_
                 return;
             }
 
-            app_log_print("Intent name: %s\r\n", MTB_NLU_INTENT_NAME_LIST(PROJECT_PREFIX)[va_data->intent_index] );
-            strcpy(payload->intent_name, MTB_NLU_INTENT_NAME_LIST(PROJECT_PREFIX)[va_data->intent_index]);
+            if (VA_RSLT_SUCCESS != voice_assistant_decode_intent(va_data, &intent))
+            {
+                return;
+            }
 
-            if (va_data->num_var != 0)
+            app_log_print("Intent name: %s\r\n", model->intent_name_list[intent.intent_id]);
+            payload->intent_id = intent.intent_id;
+            payload->num_variables = (uint8_t) intent.num_variables;
+
+            for (int i = 0; i < intent.num_variables; i++)
             {
-                app_log_print("Variable values: ");
-                for (int i = 0; i < va_data->num_var; i++)
+                va_intent_variable_t *variable = &intent.variables[i];
+                ipc_variable_t *ipc_variable = &payload->variables[i];
+                const char *variable_name = (variable->variable_id != VA_MODEL_VARIABLE_UNKNOWN) ?
+                    model->variable_name_list[variable->variable_id] : "Variable";
+
+                if (variable->phrase_id != VA_INTENT_NO_PHRASE)
                 {
-                    if (va_data->variable[i].unit_idx < 0)
-                    {
-                        app_log_print("%s ", MTB_NLU_VARIABLE_PHRASE_LIST(PROJECT_PREFIX)[va_data->variable[i].value]);
-                        strcpy(payload->intent_param1_str_var, MTB_NLU_VARIABLE_PHRASE_LIST(PROJECT_PREFIX)[va_data->variable[i].value]);
-                    }
-                    else
-                    {
-                        app_log_print("%d ", va_data->variable[i].value);
-                        payload->intent_param1_int_var = va_data->variable[i].value;
-                    }
+                    app_log_print("%s: %s\r\n", variable_name, model->variable_phrase_list[variable->value]);
+                    ipc_variable->type = IPC_VARIABLE_PHRASE;
+                    ipc_variable->unit_id = IPC_EVENT_NO_UNIT;
                 }
-                app_log_print("\n\rVariable units : ");
-                for (int i = 0; i < va_data->num_var; i++)
+                else
                 {
-                    if (va_data->variable[i].unit_idx < 0)
-                    {
-                        app_log_print("---");
-                    }
-                    else
-                    {
-                        app_log_print("%s", MTB_NLU_UNIT_PHRASE_LIST(PROJECT_PREFIX)[va_data->variable[i].unit_idx]);
-                    }
+                    app_log_print("%s: %d %s\r\n", variable_name, (int) variable->value,
+                        (variable->unit_id >= 0) ? model->unit_phrase_list[variable->unit_id] : "");
+                    ipc_variable->type = IPC_VARIABLE_NUMBER;
+                    ipc_variable->unit_id = (variable->unit_id >= 0) ? (uint8_t) variable->unit_id : IPC_EVENT_NO_UNIT;
                 }
-                app_log_print("\n\r");
+                ipc_variable->variable_id = variable->variable_id;
+                ipc_variable->value = variable->value;
             }
+            app_log_print("Command latency: %u ms (pre-roll replayed: %u ms)\r\n",
+                va_data->cmd_latency_ms, va_data->preroll_ms);
             app_log_print("\n\r");
             ptt_flag = 0;
             ptt_control_flag = 0;
         }
+        else if ( event == VA_EVENT_MODEL_CHANGED )
+        {
+            /* A new model set always starts in its initial state */
+            breathing_counter = (mode == VA_MODE_CMD_ONLY) ? LED_PWM_MIN_BRIGHTNESS : 0;
+            ptt_flag = 0;
+            ptt_control_flag = 0;
+            app_log_print("Model set changed to %s in %u us\r\n",
+                model->name, voice_assistant_get_model_switch_time_us());
+            if (mode != VA_MODE_CMD_ONLY)
+            {
+                app_log_print("Say the wake-word \"%s\".\n\r\n\r", model->wake_word_str[0]);
+            }
+            payload->event = IPC_EVENT_MODEL_CHANGED;
+            payload->is_mic_active = (mode == VA_MODE_CMD_ONLY);
+        }
+    }
+
+    /* Only events are queued to the CM33 */
+    if (payload->event != IPC_EVENT_NONE)
+    {
+        cm55_ipc_send_to_cm33();
     }
 
-    cm55_ipc_send_to_cm33();
     /* Update the Green LED state */
     if (breathing_counter == 0)
     {
@@ -387,6 +524,32 @@ static void print_voice_assistant_status(cy_rslt_t result, va_event_t event, va_
 
 void voice_assistant_infer(int16_t *audio_frame)
 {
+    uint32_t start_cycles;
+    uint32_t cycles;
+
+    /* Take the capture time of the frame. If it is missing, the frame was
+     * captured now as far as the trace is concerned.
+     */
+    va_frame_capture_us = ipc_trace_now_us();
+    if (va_capture_tail != va_capture_head)
+    {
+        va_frame_capture_us = va_capture_us[va_capture_tail % VA_CAPTURE_FIFO_SIZE];
+        va_capture_tail++;
+    }
+
+    /* Requests of the CM33 are applied between two frames */
+    va_control_process();
+
+    /* Audio of the snippets of the events, as heard by the voice assistant */
+    cm55_ipc_put_audio(audio_frame, VA_AUDIO_FRAME_SAMPLES);
+
+    if (model_switch_flag == 1)
+    {
+        /* Cycle through the model sets linked into the firmware */
+        model_switch_flag = 0;
+        voice_assistant_select_model((voice_assistant_get_model_index() + 1) % va_model_registry_count());
+    }
+
  #ifdef ENABLE_VOICE_ID
      if (voice_id_mode!=IFX_VOICE_ID_ENROLL)
      {
@@ -400,9 +563,18 @@ void voice_assistant_infer(int16_t *audio_frame)
 #ifdef SHOW_MCPS
     profiler_start();
 #endif /* SHOW_MCPS */    
+        start_cycles = profiler_get_cycle_count();
+        va_frame_process_us = ipc_trace_now_us();
 
         run_voice_assistant_process(audio_frame);
 
+        cycles = profiler_get_cycle_count() - start_cycles;
+        va_frames_processed++;
+        va_frame_cycles_sum += cycles;
+        if (cycles > va_frame_cycles_max)
+        {
+            va_frame_cycles_max = cycles;
+        }
 #ifdef SHOW_MCPS
     profiler_stop();
     print_mcps();
@@ -431,24 +603,204 @@ void run_voice_assistant_process(int16_t *audio_frame)
     va_rslt_t va_result;
     va_data_t va_data;
     va_event_t va_event;
+    ipc_payload_t *payload = cm55_ipc_get_payload_ptr();
 
  
     /* Process the audio data */
     va_result = voice_assistant_process(audio_frame, &va_event, &va_data);
 
+    /* Trace times of an event raised by this frame */
+    payload->capture_us = va_frame_capture_us;
+    payload->process_us = va_frame_process_us;
+    payload->detect_us = ipc_trace_now_us();
 
     /* Print the status of the voice assistant */
     print_voice_assistant_status(va_result, va_event, &va_data);
 
+#ifdef USB_CAPTURE_MODE
+    if (va_event != VA_NO_EVENT)
+    {
+        usb_capture_mark_event(va_event, &va_data);
+    }
+#endif /* USB_CAPTURE_MODE */
+
     #ifdef USE_LED_DEMO
         /* Change the status of the LED if a command was detected */
-        if (va_event == VA_EVENT_CMD_DETECTED)
+        if ((va_event == VA_EVENT_CMD_DETECTED) &&
+            (voice_assistant_get_model()->string_table_id == VA_STR_MODEL_LED_Demo))
         {
             led_demo(va_data.intent_index, va_data.variable[0].value);
         }
     #endif
 }
 
+/*******************************************************************************
+ * Function Name: set_mode_command_timeout
+ *******************************************************************************
+ * Summary:
+ * Sets the command timeout used by default in a running mode.
+ *
+ * Parameters:
+ *  mode: running mode of the voice assistant
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+static va_rslt_t set_mode_command_timeout(va_mode_t mode)
+{
+    va_rslt_t va_result = VA_RSLT_SUCCESS;
+
+    if (mode == VA_MODE_WW_SINGLE_CMD)
+    {
+        /* Set the command timeout for single commands */
+        va_result = voice_assistant_set_command_timeout(CMD_TIMEOUT_SINGLE_CMD);
+    }
+    else if (mode == VA_MODE_WW_MULTI_CMD)
+    {
+        /* Set the command timeout for multiple commands */
+        va_result = voice_assistant_set_command_timeout(CMD_TIMEOUT_MULTI_CMD);
+    }
+    else if (mode == VA_MODE_CMD_ONLY)
+    {
+        /* Set the command timeout for the maximum value */
+        va_result = voice_assistant_set_command_timeout(CY_NLU_COMMAND_TIMEOUT_MAX);
+    }
+
+    return va_result;
+}
+
+/*******************************************************************************
+ * Function Name: send_state_to_cm33
+ *******************************************************************************
+ * Summary:
+ * Queues a record without event to the CM33, with the state of the
+ * microphone and the active model set.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_state_to_cm33(void)
+{
+    ipc_payload_t *payload = cm55_ipc_get_payload_ptr();
+
+    payload->event = IPC_EVENT_NONE;
+    payload->is_mic_active = (voice_assistant_get_state() == VA_RUN_CMD);
+    payload->model_id = voice_assistant_get_model()->string_table_id;
+    payload->intent_id = IPC_EVENT_NO_ID;
+    payload->num_variables = 0;
+    cm55_ipc_send_to_cm33();
+}
+
+/*******************************************************************************
+ * Function Name: va_task_set_running_mode
+ *******************************************************************************
+ * Summary:
+ * Switches the running mode of the voice assistant, with the default command
+ * timeout of the new mode. Must be called in the context of the VA task.
+ *
+ * Parameters:
+ *  mode: new running mode
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t va_task_set_running_mode(va_mode_t mode)
+{
+    static const char *mode_str[] = { "VA_MODE_WW_SINGLE_CMD", "VA_MODE_WW_MULTI_CMD",
+                                      "VA_MODE_WW_ONLY", "VA_MODE_CMD_ONLY" };
+    va_rslt_t va_result;
+
+    va_result = voice_assistant_set_mode(mode);
+    if (va_result == VA_RSLT_SUCCESS)
+    {
+        va_result = set_mode_command_timeout(mode);
+    }
+    if (va_result != VA_RSLT_SUCCESS)
+    {
+        app_log_print("Error setting the running mode. Error code=%d\r\n", va_result);
+        return va_result;
+    }
+
+    /* The new mode starts in its initial state */
+    breathing_counter = (mode == VA_MODE_CMD_ONLY) ? LED_PWM_MIN_BRIGHTNESS : 0;
+    ptt_flag = 0;
+    ptt_control_flag = 0;
+    app_log_print("Running mode set to %s\r\n\r\n", mode_str[mode]);
+    send_state_to_cm33();
+
+    return VA_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: va_task_mark_capture
+ *******************************************************************************
+ * Summary:
+ * Records the capture time of a frame queued to the voice assistant, directly
+ * or through the Audio Enhancement. Called from the PDM interrupt once the
+ * frame is queued, which the voice assistant cannot take before the
+ * interrupt returns.
+ *
+ * Parameters:
+ *  capture_us: trace time of the frame captured, ipc_trace_now_us()
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void va_task_mark_capture(uint32_t capture_us)
+{
+    uint32_t head = va_capture_head;
+
+    /* Full only if the voice assistant lost frames: they get the time they
+     * are processed at
+     */
+    if ((head - va_capture_tail) < VA_CAPTURE_FIFO_SIZE)
+    {
+        va_capture_us[head % VA_CAPTURE_FIFO_SIZE] = capture_us;
+        va_capture_head = head + 1u;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: va_task_get_stats
+ *******************************************************************************
+ * Summary:
+ * Fills the statistics of the voice assistant pipeline and restarts the
+ * frame counters.
+ *
+ * Parameters:
+ *  stats: statistics to fill
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void va_task_get_stats(ipc_ctrl_stats_t *stats)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    uint32_t frames_dropped = va_frames_dropped;
+
+    stats->frames_processed = va_frames_processed;
+    stats->frames_dropped = frames_dropped - va_frames_dropped_read;
+    stats->frame_time_avg_us = (va_frames_processed != 0) ?
+        (uint32_t) (va_frame_cycles_sum / va_frames_processed / cycles_per_us) : 0;
+    stats->frame_time_max_us = va_frame_cycles_max / cycles_per_us;
+    stats->command_timeout_ms = voice_assistant_get_command_timeout();
+    stats->running_mode = (uint8_t) voice_assistant_get_mode();
+    stats->model_id = voice_assistant_get_model()->string_table_id;
+
+    va_frames_processed = 0;
+    va_frame_cycles_sum = 0;
+    va_frame_cycles_max = 0;
+    va_frames_dropped_read = frames_dropped;
+}
+
 /*******************************************************************************
  * Function Name: voice_assistant_task_init
  *******************************************************************************
@@ -481,22 +833,18 @@ void run_voice_assistant_process(int16_t *audio_frame)
         app_log_print("Voice Assistant initialized!\r\n\r\n");
     }
 
+    va_arena_print_map();
+
+#ifdef VA_MODEL_LOADER
+    print_model_load_info();
+#endif /* VA_MODEL_LOADER */
+
+#ifdef VA_BATCH_BENCHMARK
+    run_batch_benchmark();
+#endif /* VA_BATCH_BENCHMARK */
+
     /* Set the command timeout based on running mode */
-    if (RUNNING_MODE == VA_MODE_WW_SINGLE_CMD)
-    {
-        /* Set the command timeout for single commands */
-        va_result = voice_assistant_set_command_timeout(CMD_TIMEOUT_SINGLE_CMD);
-    }
-    else if (RUNNING_MODE == VA_MODE_WW_MULTI_CMD)
-    {
-        /* Set the command timeout for multiple commands */
-        va_result = voice_assistant_set_command_timeout(CMD_TIMEOUT_MULTI_CMD);
-    }
-    else if (RUNNING_MODE == VA_MODE_CMD_ONLY)
-    {
-        /* Set the command timeout for the maximum value */
-        va_result = voice_assistant_set_command_timeout(CY_NLU_COMMAND_TIMEOUT_MAX);
-    }
+    va_result = set_mode_command_timeout(RUNNING_MODE);
 
     if (va_result != VA_RSLT_SUCCESS)
     {
@@ -514,40 +862,52 @@ void run_voice_assistant_process(int16_t *audio_frame)
         breathing_counter = 0;
     }
 
+    /* Tell the CM33 the voice assistant is running, and its initial state */
+    send_state_to_cm33();
+
     /* Initialize the LED PWM driver */
     led_pwm_init();
 
 #ifdef USE_LED_DEMO
-    app_log_print("Wake word: Okay Infineon \n\n\r");
-    app_log_print("Example: Okay Infineon <switch on the light>\n\n\r");
-    app_log_print("Commands: \r\n");
-    app_log_print("1. Turn/Switch on the light \r\n");
-    app_log_print("2. Turn/Switch off the light \r\n");
-    app_log_print("3. Enable/Disable the light \r\n");
-    app_log_print("4. Increase/Decrease the brightness \r\n");
-    app_log_print("5. Make the light brighter/dimmer \r\n");
-    app_log_print("6. Set/Adjust the brightness to <numbers 1 to 10> \r\n");
-    app_log_print("7. Dim light to <numbers 1 to 10> \r\n");
-    app_log_print("8. Flip/Toggle the light \r\n");
-    app_log_print("9. Change the light state \r\n\r\n");
-#else
+    if (voice_assistant_get_model()->string_table_id == VA_STR_MODEL_LED_Demo)
+    {
+        app_log_print("Wake word: Okay Infineon \n\n\r");
+        app_log_print("Example: Okay Infineon <switch on the light>\n\n\r");
+        app_log_print("Commands: \r\n");
+        app_log_print("1. Turn/Switch on the light \r\n");
+        app_log_print("2. Turn/Switch off the light \r\n");
+        app_log_print("3. Enable/Disable the light \r\n");
+        app_log_print("4. Increase/Decrease the brightness \r\n");
+        app_log_print("5. Make the light brighter/dimmer \r\n");
+        app_log_print("6. Set/Adjust the brightness to <numbers 1 to 10> \r\n");
+        app_log_print("7. Dim light to <numbers 1 to 10> \r\n");
+        app_log_print("8. Flip/Toggle the light \r\n");
+        app_log_print("9. Change the light state \r\n\r\n");
+    }
+    else
+#endif /* USE_LED_DEMO */
     /* Print the instructions */
     if ((RUNNING_MODE == VA_MODE_WW_SINGLE_CMD) || (RUNNING_MODE == VA_MODE_WW_MULTI_CMD)) 
     {
 
         app_log_print("Say the wake-word \"%s\" followed by a command.\n\r\n\r", 
-            MTB_WWD_NLU_CONFIG_WAKE_WORD_STR(PROJECT_PREFIX)[0]);
+            voice_assistant_get_model()->wake_word_str[0]);
     } 
     else if (RUNNING_MODE == VA_MODE_WW_ONLY)
     {
         app_log_print("\n\rSay the wake-word \"%s\".\n\r\n\r", 
-            MTB_WWD_NLU_CONFIG_WAKE_WORD_STR(PROJECT_PREFIX)[0]);
+            voice_assistant_get_model()->wake_word_str[0]);
     } 
     else if (RUNNING_MODE == VA_MODE_CMD_ONLY)
     {
         app_log_print("\n\rSay a command.\n\r");
     }
-#endif /* USE_LED_DEMO */
+
+    if (va_model_registry_count() > 1)
+    {
+        app_log_print("Model sets available: %u, active: %s\r\n\r\n",
+            va_model_registry_count(), voice_assistant_get_model()->name);
+    }
 
         /* Print the behavior of the Blue LED */
     app_log_print("Note:\r\n");
@@ -562,6 +922,14 @@ void run_voice_assistant_process(int16_t *audio_frame)
 #else
         app_log_print("e. For Push To Talk (PTT), Press and hold USER BTN1, release after UART notification to skip Wake Word \r\n");
 #endif /* USE_KIT_PSE84_AI */      
+        if (va_model_registry_count() > 1)
+        {
+#ifndef ENABLE_VOICE_ID
+            app_log_print("f. Press USER BTN2 to switch to the next model set \r\n");
+#else
+            app_log_print("f. Press and hold USER BTN1, release after the model set notification to switch to the next model set \r\n");
+#endif /* ENABLE_VOICE_ID */
+        }
 
 
     }
@@ -613,6 +981,10 @@ void voice_assistant_task(void * arg)
         if (pdTRUE == xQueueReceive(va_queue_handle, (void*)va_audio_data, portMAX_DELAY))
         {
             voice_assistant_infer((int16_t*)va_audio_data);
+#ifdef USB_CAPTURE_MODE
+            /* Without Audio Enhancement, the mic frame is the VA input */
+            usb_capture_put((int16_t*)va_audio_data, 1, (int16_t*)va_audio_data);
+#endif /* USB_CAPTURE_MODE */
         }
     }
     
@@ -40,6 +40,7 @@ extern "C" {
 #endif /* __cplusplus */
 
 #include "voice_assistant.h"
+#include "ipc_communication.h"
 
 #ifdef USE_AUDIO_ENHANCEMENT
 #include "audio_enhancement_interface.h"
@@ -50,9 +51,12 @@ extern "C" {
 * Macros
 *******************************************************************************/
 
-/* Include the headers generated by the DEEPCRAFT Voice-Assistant cloud tool*/
-#include MTB_WWD_NLU_APP_HEADER(PROJECT_PREFIX)
-#include MTB_WWD_NLU_CONFIG_HEADER(PROJECT_PREFIX)
+/* Model sets are linked through va_model_registry.c. Only the LED demo needs
+ * the intent indexes generated by the DEEPCRAFT Voice-Assistant cloud tool.
+ */
+#ifdef USE_LED_DEMO
+#include MTB_WWD_NLU_APP_HEADER(LED_Demo)
+#endif /* USE_LED_DEMO */
 
 /*******************************************************************************
  * Function Prototypes
@@ -66,6 +70,12 @@ void run_voice_assistant_process(int16_t *audio_frame);
 
 void voice_assistant_infer(int16_t *audio_frame);
 
+va_rslt_t va_task_set_running_mode(va_mode_t mode);
+
+void va_task_get_stats(ipc_ctrl_stats_t *stats);
+
+void va_task_mark_capture(uint32_t capture_us);
+
 
 #if defined(__cplusplus)
 }
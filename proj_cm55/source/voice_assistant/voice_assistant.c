@@ -36,13 +36,25 @@
 /*******************************************************************************
 * Header Files
 *******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+
 #include "voice_assistant.h"
 
-#include MTB_WWD_NLU_CONFIG_HEADER(PROJECT_PREFIX)
+#include "cy_pdl.h"
+#include "profiler.h"
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
+#define VA_PREROLL_WW_FRAMES        (VA_PREROLL_WW_MS / VA_AUDIO_FRAME_MS)
+#define VA_PREROLL_PTT_FRAMES       (VA_PREROLL_PTT_MS / VA_AUDIO_FRAME_MS)
+#define VA_PREROLL_FRAMES           ((VA_PREROLL_WW_FRAMES > VA_PREROLL_PTT_FRAMES) ? \
+                                      VA_PREROLL_WW_FRAMES : VA_PREROLL_PTT_FRAMES)
+/* One slot more than the pre-roll: the live frame queued behind a full
+ * pre-roll must not overwrite its oldest frame before it is replayed
+ */
+#define VA_PREROLL_RING_FRAMES      (VA_PREROLL_FRAMES + 1)
 
 
 /*******************************************************************************
@@ -50,75 +62,350 @@
 *******************************************************************************/
 static mtb_wwd_t va_wwd_obj;
 static mtb_nlu_t va_nlu_obj;
+static bool va_wwd_initialized = false;
+static bool va_nlu_initialized = false;
 static va_mode_t va_mode = VA_MODE_WW_SINGLE_CMD;
 static va_run_state_t va_state = VA_RUN_WWD;
 
+/* Model set currently loaded and the one requested to be loaded next */
+static uint32_t va_model_index = 0;
+static volatile int32_t va_model_pending = VA_MODEL_SET_INVALID_INDEX;
+static uint32_t va_model_switch_time_us = 0;
+
+#ifdef VA_MODEL_LOADER
+/* Source, version and load time of the models of the active set */
+static va_model_load_info_t va_model_load_info;
+#endif /* VA_MODEL_LOADER */
+
+/* Command timeout set by the application, re-applied after a model switch */
+static uint32_t va_command_timeout_ms = 0;
+
+#if (VA_PREROLL_FRAMES > 0)
+/* Pre-roll ring. While waiting for the trigger it keeps the latest frames.
+ * After the trigger it also queues the live frames until the replayed audio
+ * has been processed by the command detection. The live frames still queued
+ * when the command detection ends are processed by the wake-word detection.
+ */
+static int16_t va_preroll_buf[VA_PREROLL_RING_FRAMES][VA_AUDIO_FRAME_SAMPLES];
+static uint32_t va_preroll_write = 0;
+static uint32_t va_preroll_fill = 0;
+static uint32_t va_preroll_backlog = 0;
+static uint32_t va_preroll_live = 0;    /* Newest frames of the backlog, queued live */
+#endif /* VA_PREROLL_FRAMES */
+
+/* Live frames since entering command detection and pre-roll frames queued */
+static uint32_t va_cmd_live_frames = 0;
+static uint32_t va_cmd_preroll_frames = 0;
+
+#if (VA_PREROLL_FRAMES > 0)
 /*******************************************************************************
- * Function Name: voice_assistant_init
+ * Function Name: voice_assistant_preroll_push
  *******************************************************************************
  * Summary:
- * Initializes the voice assistant with the specified mode.
+ * Stores an audio frame in the pre-roll ring, overwriting the oldest frame
+ * when the ring is full. The ring keeps the backlog of a full pre-roll plus
+ * the live frame, which is replayed before the next push.
  *
  * Parameters:
- *  mode: New mode to set.
+ *  audio_frame: Pointer to the audio data frame.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void voice_assistant_preroll_push(const int16_t *audio_frame)
+{
+    memcpy(va_preroll_buf[va_preroll_write], audio_frame, sizeof(va_preroll_buf[0]));
+    va_preroll_write = (va_preroll_write + 1) % VA_PREROLL_RING_FRAMES;
+
+    if (va_preroll_fill < VA_PREROLL_FRAMES)
+    {
+        va_preroll_fill++;
+    }
+    if (va_preroll_backlog > 0)
+    {
+        if (va_preroll_backlog < VA_PREROLL_RING_FRAMES)
+        {
+            va_preroll_backlog++;
+        }
+        if (va_preroll_live < va_preroll_backlog)
+        {
+            va_preroll_live++;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_preroll_pop
+ *******************************************************************************
+ * Summary:
+ * Returns the oldest frame not yet processed by the detection.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Pointer to the audio frame, or NULL if the detection caught up.
+ *
+ *******************************************************************************/
+static int16_t* voice_assistant_preroll_pop(void)
+{
+    uint32_t index;
+
+    if (va_preroll_backlog == 0)
+    {
+        return NULL;
+    }
+
+    index = (va_preroll_write + VA_PREROLL_RING_FRAMES - va_preroll_backlog) % VA_PREROLL_RING_FRAMES;
+    if (va_preroll_live == va_preroll_backlog)
+    {
+        va_preroll_live--;
+    }
+    va_preroll_backlog--;
+
+    return va_preroll_buf[index];
+}
+#endif /* VA_PREROLL_FRAMES */
+
+/*******************************************************************************
+ * Function Name: voice_assistant_set_state
+ *******************************************************************************
+ * Summary:
+ * Changes the run state. When entering command detection, the last frames of
+ * the pre-roll ring are queued for replay, ahead of the live frames not yet
+ * processed. When leaving it, the pre-roll still queued is dropped but the
+ * live frames queued behind it are kept for the wake-word detection.
+ *
+ * Parameters:
+ *  state: New state to set.
+ *  preroll_frames: Number of pre-roll frames to replay.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void voice_assistant_set_state(va_run_state_t state, uint32_t preroll_frames)
+{
+#if (VA_PREROLL_FRAMES > 0)
+    if ((state == VA_RUN_CMD) && (va_state != VA_RUN_CMD))
+    {
+        /* The trigger frame is followed by the live frames still queued */
+        uint32_t queued = va_preroll_backlog;
+
+        preroll_frames += queued;
+        va_preroll_backlog = (preroll_frames < va_preroll_fill) ? preroll_frames : va_preroll_fill;
+        va_preroll_live = (queued < va_preroll_backlog) ? queued : va_preroll_backlog;
+        va_cmd_live_frames = va_preroll_live;
+        va_cmd_preroll_frames = va_preroll_backlog - va_preroll_live;
+    }
+    else if (state == VA_RUN_WWD)
+    {
+        /* Audio of a finished command must not be replayed for the next one */
+        va_preroll_backlog = va_preroll_live;
+        va_preroll_fill = (va_preroll_live < VA_PREROLL_FRAMES) ? va_preroll_live : VA_PREROLL_FRAMES;
+    }
+#else
+    (void) preroll_frames;
+    if ((state == VA_RUN_CMD) && (va_state != VA_RUN_CMD))
+    {
+        va_cmd_live_frames = 0;
+        va_cmd_preroll_frames = 0;
+    }
+#endif /* VA_PREROLL_FRAMES */
+
+    va_state = state;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_unload_model
+ *******************************************************************************
+ * Summary:
+ * De-initializes the wake-word and command detection that are initialized.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void voice_assistant_unload_model(void)
+{
+    if (va_wwd_initialized)
+    {
+        (void) mtb_wwd_deinit(&va_wwd_obj);
+        va_wwd_initialized = false;
+    }
+    if (va_nlu_initialized)
+    {
+        (void) mtb_nlu_deinit(&va_nlu_obj);
+        va_nlu_initialized = false;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_load_model
+ *******************************************************************************
+ * Summary:
+ * Initializes the wake-word and/or command detection for the current mode
+ * with the given model set. This (re-)initializes the tensor arenas of the
+ * model set. The detection loaded before is de-initialized first; if the new
+ * one cannot be initialized, nothing is left loaded and the caller restores
+ * the previous model set or mode.
+ *
+ * Parameters:
+ *  index: registry index of the model set.
  *
  * Return:
  *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
  *
  *******************************************************************************/
-va_rslt_t voice_assistant_init(va_mode_t mode)
+static va_rslt_t voice_assistant_load_model(uint32_t index)
 {
     cy_rslt_t result;
+    const va_model_set_t *model = va_model_registry_get(index);
 
-    va_mode = mode;
+    if ((model == NULL) || (va_mode > VA_MODE_CMD_ONLY))
+    {
+        return VA_RSLT_INVALID_ARGUMENT;
+    }
+
+    voice_assistant_unload_model();
+
+#ifdef VA_MODEL_LOADER
+    /* Prefer models updated in flash over the ones compiled in */
+    va_model_loader_apply(model, &va_model_load_info);
+#endif /* VA_MODEL_LOADER */
 
-    switch (mode)
+    if (va_mode != VA_MODE_CMD_ONLY)
     {
-        case VA_MODE_WW_SINGLE_CMD:
-        case VA_MODE_WW_MULTI_CMD:
-            result = mtb_wwd_init(&va_wwd_obj, MTB_WWD_NLU_CONFIG_STRUCT(PROJECT_PREFIX)[0]);
-            if (result != MTB_VA_RSLT_SUCCESS)
-            {
-                return VA_RSLT_FAIL;
-            }
-            result = mtb_nlu_init(&va_nlu_obj, MTB_WWD_NLU_CONFIG_STRUCT(PROJECT_PREFIX)[0]);
-            if (result != MTB_VA_RSLT_SUCCESS)
-            {
-                return VA_RSLT_FAIL;
-            }
-            va_state = VA_RUN_WWD;
-            break;
+        result = mtb_wwd_init(&va_wwd_obj, model->configs[0]);
+        if (result != MTB_VA_RSLT_SUCCESS)
+        {
+            return VA_RSLT_FAIL;
+        }
+        va_wwd_initialized = true;
+    }
 
-        case VA_MODE_WW_ONLY:
-            result = mtb_wwd_init(&va_wwd_obj, MTB_WWD_NLU_CONFIG_STRUCT(PROJECT_PREFIX)[0]);
-            if (result != MTB_VA_RSLT_SUCCESS)
-            {
-                return VA_RSLT_FAIL;
-            }
-            va_state = VA_RUN_WWD;
-            break;
+    if (va_mode != VA_MODE_WW_ONLY)
+    {
+        result = mtb_nlu_init(&va_nlu_obj, model->configs[0]);
+        if (result == MTB_VA_RSLT_SUCCESS)
+        {
+            va_nlu_initialized = true;
 
-        case VA_MODE_CMD_ONLY:
-            result = mtb_nlu_init(&va_nlu_obj, MTB_WWD_NLU_CONFIG_STRUCT(PROJECT_PREFIX)[0]);
-            if (result != MTB_VA_RSLT_SUCCESS)
+            /* A freshly initialized NLU uses the model default timeout */
+            if (va_command_timeout_ms != 0)
             {
-                return VA_RSLT_FAIL;
+                result = mtb_nlu_timeout(&va_nlu_obj, va_command_timeout_ms);
             }
-            va_state = VA_RUN_CMD;
-            break;
-
-        default:
-            return VA_RSLT_INVALID_ARGUMENT;
+        }
+        if (result != MTB_VA_RSLT_SUCCESS)
+        {
+            voice_assistant_unload_model();
+            return VA_RSLT_FAIL;
+        }
     }
 
+    va_model_index = index;
+
+#if (VA_PREROLL_FRAMES > 0)
+    /* Audio of the previous model set or mode is not replayed */
+    va_preroll_fill = 0;
+    va_preroll_backlog = 0;
+    va_preroll_live = 0;
+#endif /* VA_PREROLL_FRAMES */
+    voice_assistant_set_state((va_mode == VA_MODE_CMD_ONLY) ? VA_RUN_CMD : VA_RUN_WWD, 0);
+
     return VA_RSLT_SUCCESS;
 }
 
+/*******************************************************************************
+ * Function Name: voice_assistant_apply_model_switch
+ *******************************************************************************
+ * Summary:
+ * Loads the model set requested by voice_assistant_select_model and measures
+ * how long the switch takes. If the new model set cannot be loaded, the
+ * previous one is loaded again.
+ *
+ * Parameters:
+ *  event: Pointer to the event detected.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+static va_rslt_t voice_assistant_apply_model_switch(va_event_t *event)
+{
+    va_rslt_t result;
+    uint32_t start_cycles;
+    uint32_t previous_index = va_model_index;
+    uint32_t index;
+    uint32_t interrupt_state;
+
+    /* A selection made from another task between the read and the clear
+     * must not be lost
+     */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    index = (uint32_t) va_model_pending;
+    va_model_pending = VA_MODEL_SET_INVALID_INDEX;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    *event = VA_NO_EVENT;
+
+    if (index == va_model_index)
+    {
+        return VA_RSLT_SUCCESS;
+    }
+
+    start_cycles = profiler_get_cycle_count();
+    result = voice_assistant_load_model(index);
+    if (result != VA_RSLT_SUCCESS)
+    {
+        /* Keep running with the previous model set */
+        (void) voice_assistant_load_model(previous_index);
+    }
+    va_model_switch_time_us = (profiler_get_cycle_count() - start_cycles) / (SystemCoreClock / 1000000u);
+
+    if (result == VA_RSLT_SUCCESS)
+    {
+        *event = VA_EVENT_MODEL_CHANGED;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_init
+ *******************************************************************************
+ * Summary:
+ * Initializes the voice assistant with the specified mode and the default
+ * model set (DEEPCRAFT_PROJECT_NAME).
+ *
+ * Parameters:
+ *  mode: New mode to set.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t voice_assistant_init(va_mode_t mode)
+{
+    va_mode = mode;
+
+    /* Cycle counter is used to measure the model switch time */
+    profiler_init();
+
+    return voice_assistant_load_model(va_model_registry_default_index());
+}
+
 /*******************************************************************************
  * Function Name: voice_assistant_change_state
  *******************************************************************************
  * Summary:
- * Changes the state of the voice assistant.
+ * Changes the state of the voice assistant. Used for push-to-talk, so entering
+ * command detection replays the push-to-talk pre-roll.
  *
  * Parameters:
  *  state: New state to set.
@@ -129,70 +416,218 @@ va_rslt_t voice_assistant_init(va_mode_t mode)
  *******************************************************************************/
 void voice_assistant_change_state(va_run_state_t state)
 {
-    va_state = state;
+    voice_assistant_set_state(state, VA_PREROLL_PTT_FRAMES);
 }
 
 /*******************************************************************************
- * Function Name: voice_assistant_process
+ * Function Name: voice_assistant_get_state
  *******************************************************************************
  * Summary:
- * Processes the audio data and detects the wake word or command.
+ * Returns the detection the voice assistant is running.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  VA_RUN_WWD or VA_RUN_CMD.
+ *
+ *******************************************************************************/
+va_run_state_t voice_assistant_get_state(void)
+{
+    return va_state;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_process_wwd
+ *******************************************************************************
+ * Summary:
+ * Runs the wake-word detection on one audio frame.
  *
  * Parameters:
  *  audio_frame: Pointer to the audio data frame.
  *  event: Pointer to the event detected.
- *  va_data: Pointer to the data detected.
  *
  * Return:
  *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
  *
  *******************************************************************************/
-va_rslt_t voice_assistant_process(int16_t *audio_frame, va_event_t *event, va_data_t *va_data)
+static va_rslt_t voice_assistant_process_wwd(int16_t *audio_frame, va_event_t *event)
 {
     cy_rslt_t result;
     mtb_wwd_state_t wwd_state;
+
+    /* Run the wake-word detection process */
+    result = mtb_wwd_process(&va_wwd_obj, audio_frame, &wwd_state);
+
+    if (result == MTB_VA_RSLT_LICENSE_ERROR)
+    {
+        return VA_RSLT_LICENSE_ERROR;
+    } 
+    else if (result != MTB_VA_RSLT_SUCCESS)
+    {
+        return VA_RSLT_FAIL;
+    }
+
+    /* Check if the wake-word was detected */
+    if (wwd_state == CY_WWD_DETECTED)
+    {
+        *event = VA_EVENT_WW_DETECTED;
+
+        /* Change state to detect command */
+        if (va_mode != VA_MODE_WW_ONLY)
+        {
+            voice_assistant_set_state(VA_RUN_CMD, VA_PREROLL_WW_FRAMES);
+        }
+    }
+    else if (wwd_state == CY_WWD_NOT_DETECTED)
+    {
+        *event = VA_EVENT_WW_NOT_DETECTED;
+    }
+    else
+    {
+        *event = VA_NO_EVENT;
+    }
+
+    return VA_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_process_cmd
+ *******************************************************************************
+ * Summary:
+ * Runs the command detection on one audio frame.
+ *
+ * Parameters:
+ *  audio_frame: Pointer to the audio data frame.
+ *  event: Pointer to the event detected.
+ *  va_data: Pointer to the data detected.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+static va_rslt_t voice_assistant_process_cmd(int16_t *audio_frame, va_event_t *event, va_data_t *va_data)
+{
+    cy_rslt_t result;
     mtb_nlu_state_t nlu_state;
     mtb_nlu_variable_t variable[VA_NLU_MAX_NUM_VARIABLES] = {0};
-    
-    if ((event == NULL) || (audio_frame == NULL))
+
+    /* Run the command detection process */
+    result = mtb_nlu_process(&va_nlu_obj, audio_frame, &nlu_state, &va_data->intent_index, variable, &va_data->num_var);
+
+    if (result == MTB_VA_RSLT_LICENSE_ERROR)
     {
-        return VA_RSLT_INVALID_ARGUMENT;
+        return VA_RSLT_LICENSE_ERROR;
     }
 
-    /* Check if the current VA state is WWD */
-    if (va_state == VA_RUN_WWD)
+    /* Check if a command was detected */
+    if (nlu_state == CY_NLU_DETECTED)
     {
-        /* Run the wake-word detection process */
-        result = mtb_wwd_process(&va_wwd_obj, audio_frame, &wwd_state);
+        *event = VA_EVENT_CMD_DETECTED;
 
-        if (result == MTB_VA_RSLT_LICENSE_ERROR)
-        {
-            return VA_RSLT_LICENSE_ERROR;
-        } 
-        else if (result != MTB_VA_RSLT_SUCCESS)
+        va_data->cmd_latency_ms = va_cmd_live_frames * VA_AUDIO_FRAME_MS;
+        va_data->preroll_ms = va_cmd_preroll_frames * VA_AUDIO_FRAME_MS;
+
+        /* Further commands (multi command mode) are timed from this one */
+        va_cmd_live_frames = 0;
+        va_cmd_preroll_frames = 0;
+
+        if (va_mode == VA_MODE_WW_SINGLE_CMD)
         {
-            return VA_RSLT_FAIL;
+            voice_assistant_set_state(VA_RUN_WWD, 0);
         }
 
-        /* Check if the wake-word was detected */
-        if (wwd_state == CY_WWD_DETECTED)
+        for (int i = 0; i < va_data->num_var; i++)
         {
-            *event = VA_EVENT_WW_DETECTED;
-
-            /* Change state to detect command */
-            if (va_mode != VA_MODE_WW_ONLY)
-            {
-                va_state = VA_RUN_CMD;
-            }
+            va_data->variable[i].value = variable[i].value;
+            va_data->variable[i].unit_idx = variable[i].unit_idx;
         }
-        else if (wwd_state == CY_WWD_NOT_DETECTED)
+    }
+    else if (result == CY_NLU_RSLT_COMMAND_TIMEOUT)
+    {
+        *event = VA_EVENT_CMD_TIMEOUT;
+        if (va_mode != VA_MODE_CMD_ONLY)
         {
-            *event = VA_EVENT_WW_NOT_DETECTED;
+            voice_assistant_set_state(VA_RUN_WWD, 0);
         }
-        else
+    }
+    else if (result == CY_NLU_RSLT_PRE_SILENCE_TIMEOUT)
+    {
+        *event = VA_EVENT_CMD_SILENCE_TIMEOUT;
+        if ((va_mode != VA_MODE_CMD_ONLY) && (va_mode != VA_MODE_WW_MULTI_CMD))
+        {
+            voice_assistant_set_state(VA_RUN_WWD, 0);
+        }
+    }
+    else
+    {
+        *event = VA_NO_EVENT;
+    }
+
+    return VA_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_process_frame
+ *******************************************************************************
+ * Summary:
+ * Runs the detection of the current state on one audio frame, with the
+ * replay of the frames queued in the pre-roll ring.
+ *
+ * Parameters:
+ *  audio_frame: Pointer to the audio data frame.
+ *  event: Pointer to the event detected.
+ *  va_data: Pointer to the data detected.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+static va_rslt_t voice_assistant_process_frame(int16_t *audio_frame, va_event_t *event, va_data_t *va_data)
+{
+    va_rslt_t va_result = VA_RSLT_SUCCESS;
+
+    *event = VA_NO_EVENT;
+
+    /* Neither the model set switched to nor the previous one could be loaded */
+    if ((va_state == VA_RUN_WWD) ? !va_wwd_initialized : !va_nlu_initialized)
+    {
+        return VA_RSLT_FAIL;
+    }
+
+    /* Check if the current VA state is WWD */
+    if (va_state == VA_RUN_WWD)
+    {
+#if (VA_PREROLL_FRAMES > 0)
+        voice_assistant_preroll_push(audio_frame);
+
+        if (va_preroll_backlog > 0)
         {
-            *event = VA_NO_EVENT;
+            int16_t *frame;
+            uint32_t budget = VA_PREROLL_REPLAY_FRAMES + 1;
+
+            /* Live frames left over by the command detection come first */
+            while ((budget > 0) && (*event != VA_EVENT_WW_DETECTED))
+            {
+                frame = voice_assistant_preroll_pop();
+                if (frame == NULL)
+                {
+                    break;
+                }
+                budget--;
+
+                va_result = voice_assistant_process_wwd(frame, event);
+                if (va_result != VA_RSLT_SUCCESS)
+                {
+                    break;
+                }
+            }
+
+            return va_result;
         }
+#endif /* VA_PREROLL_FRAMES */
+
+        va_result = voice_assistant_process_wwd(audio_frame, event);
     }
     /* Check if the current VA state is CMD */
     else if (va_state == VA_RUN_CMD)
@@ -202,60 +637,162 @@ va_rslt_t voice_assistant_process(int16_t *audio_frame, va_event_t *event, va_da
             return VA_RSLT_INVALID_ARGUMENT;
         }
 
-        /* Run the command detection process */
-        result = mtb_nlu_process(&va_nlu_obj, audio_frame, &nlu_state, &va_data->intent_index, variable, &va_data->num_var);
+        va_cmd_live_frames++;
 
-        if (result == MTB_VA_RSLT_LICENSE_ERROR)
+#if (VA_PREROLL_FRAMES > 0)
+        if (va_preroll_backlog > 0)
         {
-            return VA_RSLT_LICENSE_ERROR;
-        }
+            int16_t *frame;
+            uint32_t budget = VA_PREROLL_REPLAY_FRAMES + 1;
 
-        /* Check if a command was detected */
-        if (nlu_state == CY_NLU_DETECTED)
-        {
-            *event = VA_EVENT_CMD_DETECTED;
+            /* Queue the live frame behind the pre-roll still to be replayed */
+            voice_assistant_preroll_push(audio_frame);
 
-            if (va_mode == VA_MODE_WW_SINGLE_CMD)
-            {
-                va_state = VA_RUN_WWD;
-            }
-            
-            for (int i = 0; i < va_data->num_var; i++)
+            while ((budget > 0) && (*event == VA_NO_EVENT) && (va_state == VA_RUN_CMD))
             {
-                va_data->variable[i].value = variable[i].value;
-                va_data->variable[i].unit_idx = variable[i].unit_idx;
+                frame = voice_assistant_preroll_pop();
+                if (frame == NULL)
+                {
+                    break;
+                }
+                budget--;
+
+                va_result = voice_assistant_process_cmd(frame, event, va_data);
+                if (va_result != VA_RSLT_SUCCESS)
+                {
+                    break;
+                }
             }
+
+            return va_result;
         }
-        else if (result == CY_NLU_RSLT_COMMAND_TIMEOUT)
+#endif /* VA_PREROLL_FRAMES */
+
+        va_result = voice_assistant_process_cmd(audio_frame, event, va_data);
+    }
+    
+    return va_result;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_process
+ *******************************************************************************
+ * Summary:
+ * Processes the audio data and detects the wake word or command. After a
+ * trigger, the pre-roll is replayed VA_PREROLL_REPLAY_FRAMES frames faster
+ * than real time until command detection has caught up with the live audio.
+ * Live frames still queued when the command detection ends are caught up the
+ * same way by the wake-word detection.
+ *
+ * Parameters:
+ *  audio_frame: Pointer to the audio data frame.
+ *  event: Pointer to the event detected.
+ *  va_data: Pointer to the data detected.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t voice_assistant_process(int16_t *audio_frame, va_event_t *event, va_data_t *va_data)
+{
+    if ((event == NULL) || (audio_frame == NULL))
+    {
+        return VA_RSLT_INVALID_ARGUMENT;
+    }
+
+    /* Model switches are applied here, in the context of the VA task, so the
+     * tensor arenas are only re-initialized once a switch is actually used.
+     * The current frame is dropped while the new model set is loaded.
+     */
+    if (va_model_pending != VA_MODEL_SET_INVALID_INDEX)
+    {
+        return voice_assistant_apply_model_switch(event);
+    }
+
+    return voice_assistant_process_frame(audio_frame, event, va_data);
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_process_batch
+ *******************************************************************************
+ * Summary:
+ * Processes a contiguous buffer of audio frames, e.g. a recording, without
+ * going through the audio queue of the VA task. Only events other than
+ * VA_NO_EVENT and VA_EVENT_WW_NOT_DETECTED are reported. Processing stops
+ * after the frame that fills the event list; the caller can resume from the
+ * frame following the last reported frame_offset.
+ *
+ * The detection of the active model set is re-initialized before and after
+ * the batch, so the batch does not start with the state of the live audio and
+ * the live audio does not continue with the state of the batch. A pending
+ * model switch is left for the live audio. Like voice_assistant_set_mode,
+ * this must be called in the context of the VA task.
+ *
+ * Parameters:
+ *  frames: Pointer to num_frames * VA_AUDIO_FRAME_SAMPLES audio samples.
+ *  num_frames: Number of 10 ms frames in the buffer.
+ *  events_out: List filled with the detected events.
+ *  num_events: In: size of events_out. Out: number of events reported.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t voice_assistant_process_batch(int16_t *frames, uint32_t num_frames,
+                                        va_batch_event_t *events_out, uint32_t *num_events)
+{
+    va_rslt_t result;
+    va_event_t event;
+    va_data_t va_data;
+    uint32_t max_events;
+    uint32_t count = 0;
+
+    if ((frames == NULL) || (events_out == NULL) || (num_events == NULL) || (*num_events == 0))
+    {
+        return VA_RSLT_INVALID_ARGUMENT;
+    }
+
+    max_events = *num_events;
+
+    result = voice_assistant_load_model(va_model_index);
+
+    for (uint32_t i = 0; (result == VA_RSLT_SUCCESS) && (i < num_frames) && (count < max_events); i++)
+    {
+        result = voice_assistant_process_frame(&frames[i * VA_AUDIO_FRAME_SAMPLES], &event, &va_data);
+        if (result != VA_RSLT_SUCCESS)
         {
-            *event = VA_EVENT_CMD_TIMEOUT;
-            if (va_mode != VA_MODE_CMD_ONLY)
-            {
-                va_state = VA_RUN_WWD;
-            }
+            break;
         }
-        else if (result == CY_NLU_RSLT_PRE_SILENCE_TIMEOUT)
+
+        if ((event != VA_NO_EVENT) && (event != VA_EVENT_WW_NOT_DETECTED))
         {
-            *event = VA_EVENT_CMD_SILENCE_TIMEOUT;
-            if ((va_mode != VA_MODE_CMD_ONLY) && (va_mode != VA_MODE_WW_MULTI_CMD))
+            events_out[count].frame_offset = i;
+            events_out[count].event = event;
+            if (event == VA_EVENT_CMD_DETECTED)
             {
-                va_state = VA_RUN_WWD;
+                events_out[count].data = va_data;
             }
-        }
-        else
-        {
-            *event = VA_NO_EVENT;
+            count++;
         }
     }
-    
-    return VA_RSLT_SUCCESS;
+
+    *num_events = count;
+
+    /* The live audio starts again with an empty pre-roll, in the initial state */
+    if (voice_assistant_load_model(va_model_index) != VA_RSLT_SUCCESS)
+    {
+        result = VA_RSLT_FAIL;
+    }
+
+    return result;
 }
 
 /*******************************************************************************
  * Function Name: voice_assistant_set_command_timeout
  *******************************************************************************
  * Summary:
- * Sets the command timeout for NLU detection.
+ * Sets the command timeout for NLU detection. It is kept across model set
+ * and mode switches.
  *
  * Parameters:
  *  timeout_ms: Timeout in milliseconds.
@@ -268,6 +805,13 @@ va_rslt_t voice_assistant_set_command_timeout(uint32_t timeout_ms)
 {
     cy_rslt_t result;
 
+    /* Without command detection, the timeout is applied by the next mode */
+    if (!va_nlu_initialized)
+    {
+        va_command_timeout_ms = timeout_ms;
+        return VA_RSLT_SUCCESS;
+    }
+
     result = mtb_nlu_timeout(&va_nlu_obj, timeout_ms);
 
     if (result != MTB_VA_RSLT_SUCCESS)
@@ -275,6 +819,8 @@ va_rslt_t voice_assistant_set_command_timeout(uint32_t timeout_ms)
         return VA_RSLT_FAIL;
     }
 
+    va_command_timeout_ms = timeout_ms;
+
     return VA_RSLT_SUCCESS;
 }
 
@@ -308,4 +854,239 @@ va_rslt_t voice_assistant_get_command(char *text)
     }
 
     return VA_RSLT_SUCCESS;
-}
\ No newline at end of file
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_decode_intent
+ *******************************************************************************
+ * Summary:
+ * Decodes a detected command into integer identifiers of the active model
+ * set, using the index generated with the model sets (no string or table
+ * search).
+ *
+ * Parameters:
+ *  va_data: data of a VA_EVENT_CMD_DETECTED event.
+ *  intent: decoded command.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t voice_assistant_decode_intent(const va_data_t *va_data, va_intent_t *intent)
+{
+    const va_model_set_t *model = va_model_registry_get(va_model_index);
+    va_intent_variable_t *variable;
+
+    if ((va_data == NULL) || (intent == NULL) ||
+        (va_data->intent_index < 0) || ((uint32_t) va_data->intent_index >= model->num_intents) ||
+        (va_data->num_var < 0) || (va_data->num_var > (int) VA_NLU_MAX_NUM_VARIABLES))
+    {
+        return VA_RSLT_INVALID_ARGUMENT;
+    }
+
+    intent->intent_id = (uint16_t) va_data->intent_index;
+    intent->num_variables = (uint16_t) va_data->num_var;
+
+    for (int i = 0; i < va_data->num_var; i++)
+    {
+        variable = &intent->variables[i];
+        variable->value = va_data->variable[i].value;
+        variable->unit_id = (int16_t) va_data->variable[i].unit_idx;
+
+        if ((va_data->variable[i].unit_idx < 0) &&
+            (va_data->variable[i].value >= 0) &&
+            ((uint32_t) va_data->variable[i].value < model->num_variable_phrases))
+        {
+            /* Phrase: its position in variable_phrase_list gives the variable */
+            variable->variable_id = model->phrase_variable[va_data->variable[i].value];
+            variable->phrase_id = (uint16_t) (va_data->variable[i].value - model->variable_offsets[variable->variable_id]);
+        }
+        else
+        {
+            /* Number: the variable is known if all commands of the intent agree */
+            variable->variable_id = (i < (int) VA_MODEL_MAX_VARIABLE_SLOTS) ?
+                model->intent_slot_variable[va_data->intent_index][i] : VA_MODEL_VARIABLE_UNKNOWN;
+            variable->phrase_id = VA_INTENT_NO_PHRASE;
+        }
+    }
+
+    return VA_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_select_model
+ *******************************************************************************
+ * Summary:
+ * Requests a switch to another model set linked into the firmware. The switch
+ * is applied by the next call to voice_assistant_process, which then returns
+ * VA_EVENT_MODEL_CHANGED. Can be called from any task.
+ *
+ * Parameters:
+ *  index: registry index of the model set.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t voice_assistant_select_model(uint32_t index)
+{
+    if (index >= va_model_registry_count())
+    {
+        return VA_RSLT_INVALID_ARGUMENT;
+    }
+
+    va_model_pending = (int32_t) index;
+
+    return VA_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_get_model
+ *******************************************************************************
+ * Summary:
+ * Returns the model set currently used by the voice assistant.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Pointer to the active model set.
+ *
+ *******************************************************************************/
+const va_model_set_t* voice_assistant_get_model(void)
+{
+    return va_model_registry_get(va_model_index);
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_get_model_index
+ *******************************************************************************
+ * Summary:
+ * Returns the registry index of the model set currently used.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Registry index of the active model set.
+ *
+ *******************************************************************************/
+uint32_t voice_assistant_get_model_index(void)
+{
+    return va_model_index;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_get_command_timeout
+ *******************************************************************************
+ * Summary:
+ * Returns the command timeout set by the application.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Timeout in milliseconds, 0 for the default of the model set.
+ *
+ *******************************************************************************/
+uint32_t voice_assistant_get_command_timeout(void)
+{
+    return va_command_timeout_ms;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_set_mode
+ *******************************************************************************
+ * Summary:
+ * Changes the running mode. The detection of the active model set is
+ * re-initialized for the new mode, so this must be called in the context of
+ * the VA task. If the new mode cannot be initialized, the previous mode is
+ * restored.
+ *
+ * Parameters:
+ *  mode: New mode to set.
+ *
+ * Return:
+ *  Returns VA_RSLT_SUCCESS if successful, otherwise returns an error code.
+ *
+ *******************************************************************************/
+va_rslt_t voice_assistant_set_mode(va_mode_t mode)
+{
+    va_rslt_t result;
+    va_mode_t previous_mode = va_mode;
+
+    if (mode > VA_MODE_CMD_ONLY)
+    {
+        return VA_RSLT_INVALID_ARGUMENT;
+    }
+    if (mode == va_mode)
+    {
+        return VA_RSLT_SUCCESS;
+    }
+
+    va_mode = mode;
+    result = voice_assistant_load_model(va_model_index);
+    if (result != VA_RSLT_SUCCESS)
+    {
+        va_mode = previous_mode;
+        (void) voice_assistant_load_model(va_model_index);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_get_mode
+ *******************************************************************************
+ * Summary:
+ * Returns the running mode.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Running mode of the voice assistant.
+ *
+ *******************************************************************************/
+va_mode_t voice_assistant_get_mode(void)
+{
+    return va_mode;
+}
+
+/*******************************************************************************
+ * Function Name: voice_assistant_get_model_switch_time_us
+ *******************************************************************************
+ * Summary:
+ * Returns how long the last model set switch took.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Duration of the last switch in microseconds.
+ *
+ *******************************************************************************/
+uint32_t voice_assistant_get_model_switch_time_us(void)
+{
+    return va_model_switch_time_us;
+}
+
+#ifdef VA_MODEL_LOADER
+/*******************************************************************************
+ * Function Name: voice_assistant_get_model_load_info
+ *******************************************************************************
+ * Summary:
+ * Returns where the models of the active model set were loaded from.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  Pointer to the load information.
+ *
+ *******************************************************************************/
+const va_model_load_info_t* voice_assistant_get_model_load_info(void)
+{
+    return &va_model_load_info;
+}
+#endif /* VA_MODEL_LOADER */
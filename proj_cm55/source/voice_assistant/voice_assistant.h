@@ -44,11 +44,48 @@ extern "C" {
 #include "mtb_nlu.h"
 #include "mtb_wwd.h"
 
+#include "va_model_registry.h"
+#ifdef VA_MODEL_LOADER
+#include "va_model_loader.h"
+#endif /* VA_MODEL_LOADER */
+
 /******************************************************************************
  * Macros
  *****************************************************************************/
 #define VA_NLU_MAX_NUM_VARIABLES   4u
 
+/* Phrase identifier of a variable holding a number */
+#define VA_INTENT_NO_PHRASE         (0xFFFFu)
+
+/* Audio frame consumed by the voice assistant: 10 ms at 16 kHz */
+#define VA_AUDIO_FRAME_MS           (10u)
+#define VA_AUDIO_FRAME_SAMPLES      (160u)
+
+/* Audio kept before the wake-word is detected or push-to-talk is pressed.
+ * It is replayed into the command detection so the first syllables of a
+ * command spoken right after (or together with) the trigger are not lost.
+ * Set to 0 to disable the pre-roll.
+ *
+ * The wake word is detected some time after its end, so only the audio of
+ * that delay is replayed after a wake word: VA_PREROLL_WW_MS must not be
+ * longer than the detection delay of the wake-word model, or the end of the
+ * wake word reaches the command detection.
+ */
+#ifndef VA_PREROLL_WW_MS
+#define VA_PREROLL_WW_MS            (100u)
+#endif /* VA_PREROLL_WW_MS */
+
+#ifndef VA_PREROLL_PTT_MS
+#define VA_PREROLL_PTT_MS           (400u)
+#endif /* VA_PREROLL_PTT_MS */
+
+/* Pre-roll frames replayed for every live frame until command detection has
+ * caught up with the live audio.
+ */
+#ifndef VA_PREROLL_REPLAY_FRAMES
+#define VA_PREROLL_REPLAY_FRAMES    (2u)
+#endif /* VA_PREROLL_REPLAY_FRAMES */
+
 /******************************************************************************
  * Typedefs
  *****************************************************************************/
@@ -68,6 +105,7 @@ typedef enum
     VA_EVENT_CMD_DETECTED = 3,
     VA_EVENT_CMD_TIMEOUT = 4,
     VA_EVENT_CMD_SILENCE_TIMEOUT = 5,
+    VA_EVENT_MODEL_CHANGED = 6,
 } va_event_t;
 
 typedef enum
@@ -92,16 +130,57 @@ typedef struct
     int     intent_index;
     int     num_var;
     mtb_nlu_variable_t variable[VA_NLU_MAX_NUM_VARIABLES];
+    uint32_t cmd_latency_ms;    /* Live audio from the trigger (or previous command) to the detection */
+    uint32_t preroll_ms;        /* Pre-roll audio replayed for this command */
 } va_data_t;
 
+/* Variable of a detected command, decoded with the model set index */
+typedef struct
+{
+    uint16_t    variable_id;    /* Index in variable_name_list, VA_MODEL_VARIABLE_UNKNOWN if not known */
+    uint16_t    phrase_id;      /* Phrase of the variable, VA_INTENT_NO_PHRASE for numbers */
+    int32_t     value;          /* Number, or index in variable_phrase_list */
+    int16_t     unit_id;        /* Index in unit_phrase_list, -1 for phrases */
+} va_intent_variable_t;
+
+/* Detected command with integer identifiers only */
+typedef struct
+{
+    uint16_t                intent_id;      /* Index in intent_name_list */
+    uint16_t                num_variables;
+    va_intent_variable_t    variables[VA_NLU_MAX_NUM_VARIABLES];
+} va_intent_t;
+
+/* Event reported by voice_assistant_process_batch */
+typedef struct
+{
+    uint32_t    frame_offset;   /* Frame of the batch that raised the event */
+    va_event_t  event;
+    va_data_t   data;           /* Valid for VA_EVENT_CMD_DETECTED */
+} va_batch_event_t;
+
 /*******************************************************************************
  * Function Prototypes
  *******************************************************************************/
 va_rslt_t voice_assistant_init(va_mode_t mode);
 void      voice_assistant_change_state(va_run_state_t state);
+va_run_state_t voice_assistant_get_state(void);
 va_rslt_t voice_assistant_process(int16_t *audio_frame, va_event_t *event, va_data_t *va_data);
+va_rslt_t voice_assistant_process_batch(int16_t *frames, uint32_t num_frames,
+                                        va_batch_event_t *events_out, uint32_t *num_events);
 va_rslt_t voice_assistant_set_command_timeout(uint32_t timeout_ms);
+uint32_t  voice_assistant_get_command_timeout(void);
+va_rslt_t voice_assistant_set_mode(va_mode_t mode);
+va_mode_t voice_assistant_get_mode(void);
 va_rslt_t voice_assistant_get_command(char *text);
+va_rslt_t voice_assistant_decode_intent(const va_data_t *va_data, va_intent_t *intent);
+va_rslt_t voice_assistant_select_model(uint32_t index);
+const va_model_set_t* voice_assistant_get_model(void);
+uint32_t  voice_assistant_get_model_index(void);
+uint32_t  voice_assistant_get_model_switch_time_us(void);
+#ifdef VA_MODEL_LOADER
+const va_model_load_info_t* voice_assistant_get_model_load_info(void);
+#endif /* VA_MODEL_LOADER */
 
 #if defined(__cplusplus)
 }
@@ -41,10 +41,15 @@
 
 #include "ifx_storage.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
 #include "ifx_voice_id.h"
 #include "app_logger.h"
 
@@ -52,8 +57,16 @@
 * Macros
 *******************************************************************************/
 
+/* Single file with all users, written before per-user records were used.
+ * Migrated to per-user records when found.
+ */
 #define IFX_EMBEDDINGS_FILE_NAME "embeddings"
 
+/* Index of the enrolled users, and one record per user slot */
+#define IFX_INDEX_FILE_NAME "vid_index"
+#define IFX_USER_FILE_NAME "vid_user%u"
+#define IFX_USER_FILE_NAME_SIZE (16U)
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -63,14 +76,147 @@ static mtb_serial_memory_t serial_memory_obj;
 static cy_stc_smif_mem_context_t smif_mem_context;
 static cy_stc_smif_mem_info_t smif_mem_info;
 static struct lfs_config lfs_cfg;
-lfs_t lfs;
+static bool storage_initialized = false;
+static bool storage_mounted = false;
+static lfs_t lfs;
+
+/* The file system is used by the Voice ID task, the Voice ID storage writer
+ * and the voice assistant task on a model switch. Every ifx_storage entry
+ * point holds this mutex; it is created by the first caller. It is
+ * recursive, so a task can also hold it across several calls.
+ */
+static SemaphoreHandle_t storage_mutex = NULL;
+static StaticSemaphore_t storage_mutex_buffer;
+
+#ifdef IFX_STORAGE_STATS
+/* Block device functions wrapped to count flash operations */
+static int (*bd_prog)(const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
+                      const void *buffer, lfs_size_t size);
+static int (*bd_erase)(const struct lfs_config *c, lfs_block_t block);
+static ifx_storage_stats_t storage_stats;
+#endif /* IFX_STORAGE_STATS */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void storage_write(voice_id_embeddings_t *embeddings);
+static ifx_en_voice_id_status_t storage_write_user(uint8_t user_idx, const void *user_embeddings);
+static ifx_en_voice_id_status_t storage_write_index(uint8_t user_count);
 
 
 /*******************************************************************************
-* Function Name: ifx_storage_init
+* Function Name: ifx_storage_lock
 ********************************************************************************
 * Summary:
-* Initialize flash based storage 
+* Take the storage mutex, creating it on the first call
+*
+* Parameters:
+*  None
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+void ifx_storage_lock(void) {
+    taskENTER_CRITICAL();
+    if (NULL == storage_mutex) {
+        storage_mutex = xSemaphoreCreateRecursiveMutexStatic(&storage_mutex_buffer);
+    }
+    taskEXIT_CRITICAL();
+
+    (void)xSemaphoreTakeRecursive(storage_mutex, portMAX_DELAY);
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_unlock
+********************************************************************************
+* Summary:
+* Give the storage mutex back
+*
+* Parameters:
+*  None
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+void ifx_storage_unlock(void) {
+    (void)xSemaphoreGiveRecursive(storage_mutex);
+}
+
+
+#ifdef IFX_STORAGE_STATS
+/*******************************************************************************
+* Function Name: storage_stats_prog
+********************************************************************************
+* Summary:
+* Programs the block device and counts the programmed bytes
+*
+* Parameters:
+*  *c, block, off, *buffer, size
+* 
+* Return:
+*  Result of the block device
+*
+*******************************************************************************/
+static int storage_stats_prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
+                              const void *buffer, lfs_size_t size) {
+    storage_stats.bytes_programmed += size;
+    return bd_prog(c, block, off, buffer, size);
+}
+
+
+/*******************************************************************************
+* Function Name: storage_stats_erase
+********************************************************************************
+* Summary:
+* Erases a block of the block device and counts the erased blocks
+*
+* Parameters:
+*  *c, block
+* 
+* Return:
+*  Result of the block device
+*
+*******************************************************************************/
+static int storage_stats_erase(const struct lfs_config *c, lfs_block_t block) {
+    storage_stats.blocks_erased++;
+    return bd_erase(c, block);
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_get_stats
+********************************************************************************
+* Summary:
+* Get the flash operations counted since the last call and reset the counters
+*
+* Parameters:
+*  *stats
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+void ifx_storage_get_stats(ifx_storage_stats_t *stats) {
+    ifx_storage_lock();
+    if (NULL != stats) {
+        *stats = storage_stats;
+        stats->block_size = lfs_cfg.block_size;
+    }
+    memset(&storage_stats, 0, sizeof(storage_stats));
+    ifx_storage_unlock();
+}
+#endif /* IFX_STORAGE_STATS */
+
+
+/*******************************************************************************
+* Function Name: storage_init
+********************************************************************************
+* Summary:
+* Initialize flash based storage and mount the file system. The file system
+* stays mounted; it is formatted by ifx_storage_read if it cannot be mounted.
 *
 * Parameters:
 *  None
@@ -79,9 +225,16 @@ lfs_t lfs;
 *  Result of storage initialization
 *
 *******************************************************************************/
-cy_rslt_t ifx_storage_init(void) {
+static cy_rslt_t storage_init(void) {
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
+    /* Storage is shared by Voice ID and the model loader, the caller holds
+     * the lock so only the first call sets it up
+     */
+    if (storage_initialized) {
+        return CY_RSLT_SUCCESS;
+    }
+
 #ifdef USE_KIT_PSE84_HMI
    result = mtb_serial_memory_setup(
         &serial_memory_obj,
@@ -117,110 +270,243 @@ cy_rslt_t ifx_storage_init(void) {
     if (CY_RSLT_SUCCESS != result) {
         app_log_print("ERROR: Creating SPI flash block device failed!\r\n");
     }
+    else {
+        storage_initialized = true;
+#ifdef IFX_STORAGE_STATS
+        bd_prog = lfs_cfg.prog;
+        bd_erase = lfs_cfg.erase;
+        lfs_cfg.prog = storage_stats_prog;
+        lfs_cfg.erase = storage_stats_erase;
+#endif /* IFX_STORAGE_STATS */
+        storage_mounted = (0 == lfs_mount(&lfs, &lfs_cfg));
+    }
 
     return result;
 }
 
 
 /*******************************************************************************
-* Function Name: ifx_storage_read
+* Function Name: storage_mount
 ********************************************************************************
 * Summary:
-* Read embeddings 
+* Make sure the file system is mounted, formatting the block device if it
+* cannot be mounted
 *
 * Parameters:
-*  *embeddings
+*  None
 * 
 * Return:
-*  None
+*  IFX_VOICE_ID_SUCCESS or the storage error
 *
 *******************************************************************************/
-void ifx_storage_read(ifx_voice_id_embeddings_t *embeddings) {
-    lfs_file_t file;
-    uint32_t magic;
+static ifx_en_voice_id_status_t storage_mount(void) {
     int32_t err;
 
-    if (NULL == embeddings) {
-        app_log_print("ERROR: Invalid input parameter!\r\n");
-        return; /* cannot set storage_status */
+    if (storage_mounted) {
+        return IFX_VOICE_ID_SUCCESS;
     }
-    embeddings->storage_status = IFX_VOICE_ID_SUCCESS;
-
-    /* Mount the filesystem */
-    err = lfs_mount(&lfs, &lfs_cfg);
 
     /* Reformat if we cannot mount the filesystem.
      * This should only happen when littlefs is set up on the storage device for
      * the first time.
      */
+    app_log_print(
+        "\nError in mounting. This could be the first time littlefs is "
+        "used on the storage device.\n");
+    app_log_print("Formatting the block device...\n");
+
+    err = lfs_format(&lfs, &lfs_cfg);
     if (err != 0) {
-        app_log_print(
-            "\nError in mounting. This could be the first time littlefs is "
-            "used on the storage device.\n");
-        app_log_print("Formatting the block device...\n");
-
-        err = lfs_format(&lfs, &lfs_cfg);
-        if (err != 0) {
-            app_log_print("ERROR: Formatting failed!\r\n");
-            embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_FORMAT;
-            return;
-        }
+        app_log_print("ERROR: Formatting failed!\r\n");
+        return IFX_VOICE_ID_STORAGE_ERROR_FORMAT;
+    }
 
-        err = lfs_mount(&lfs, &lfs_cfg);
-        if (err != 0) {
-            app_log_print("ERROR: Mount after format failed!\r\n");
-            embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_MOUNT;
-            return;
-        }
+    err = lfs_mount(&lfs, &lfs_cfg);
+    if (err != 0) {
+        app_log_print("ERROR: Mount after format failed!\r\n");
+        return IFX_VOICE_ID_STORAGE_ERROR_MOUNT;
     }
 
-    /* Read the current float array */
-    err = lfs_file_open(&lfs, &file, IFX_EMBEDDINGS_FILE_NAME, LFS_O_RDWR | LFS_O_CREAT);
+    storage_mounted = true;
+    return IFX_VOICE_ID_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: storage_write_record
+********************************************************************************
+* Summary:
+* Replace a file with a magic number, a count (number of users in the index,
+* slot number in a user record) and a data block. The file
+* is only updated when it is closed, so it either has the old or the new
+* content.
+*
+* Parameters:
+*  *name, count, *data, size
+* 
+* Return:
+*  IFX_VOICE_ID_SUCCESS or the storage error
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_write_record(const char *name, uint8_t count,
+                                                     const void *data, uint32_t size) {
+    lfs_file_t file;
+    uint32_t magic = VOICE_ID_EMBEDDINGS_MAGIC;
+    ifx_en_voice_id_status_t status = IFX_VOICE_ID_SUCCESS;
+    int32_t err;
+
+    err = lfs_file_open(&lfs, &file, name, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
     if (err != 0) {
         app_log_print("ERROR: File open failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_FILE_OPEN;
-        (void)lfs_unmount(&lfs);
-        return;
+        return IFX_VOICE_ID_STORAGE_ERROR_FILE_OPEN;
+    }
+
+    if (lfs_file_write(&lfs, &file, &magic, sizeof(magic)) < 0) {
+        app_log_print("ERROR: Writing magic number failed!\r\n");
+        status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_MAGIC;
+    }
+    else if (lfs_file_write(&lfs, &file, &count, sizeof(count)) < 0) {
+        app_log_print("ERROR: Writing user count failed!\r\n");
+        status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_USER_COUNT;
+    }
+    else if ((size != 0U) && (lfs_file_write(&lfs, &file, data, size) < 0)) {
+        app_log_print("ERROR: Writing embeddings data failed!\r\n");
+        status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_EMBEDDINGS;
     }
 
-    err = lfs_file_rewind(&lfs, &file);
+    /* The storage is not updated until the file is closed successfully */
+    err = lfs_file_close(&lfs, &file);
+    if ((err != 0) && (status == IFX_VOICE_ID_SUCCESS)) {
+        app_log_print("ERROR: Writing embeddings data failed!\r\n");
+        status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_EMBEDDINGS;
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: storage_read_record
+********************************************************************************
+* Summary:
+* Read a file written by storage_write_record
+*
+* Parameters:
+*  *name, *count, *data, size
+* 
+* Return:
+*  IFX_VOICE_ID_SUCCESS or the storage error
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_read_record(const char *name, uint8_t *count,
+                                                    void *data, uint32_t size) {
+    lfs_file_t file;
+    uint32_t magic;
+    ifx_en_voice_id_status_t status = IFX_VOICE_ID_SUCCESS;
+    int32_t err;
+
+    err = lfs_file_open(&lfs, &file, name, LFS_O_RDONLY);
     if (err != 0) {
-        app_log_print("ERROR: File rewind failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_FILE_REWIND;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+        return IFX_VOICE_ID_STORAGE_ERROR_FILE_OPEN;
     }
 
-    /* First read and validate the magic number */
-    err = lfs_file_read(&lfs, &file, &magic, sizeof(uint32_t));
-    if (err < 0) {
-        app_log_print("ERROR: Reading magic number failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_MAGIC;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+    if (lfs_file_read(&lfs, &file, &magic, sizeof(magic)) != (lfs_ssize_t)sizeof(magic)) {
+        status = IFX_VOICE_ID_STORAGE_ERROR_MAGIC;
+    }
+    else if (magic != VOICE_ID_EMBEDDINGS_MAGIC) {
+        status = IFX_VOICE_ID_STORAGE_ERROR_MAGIC;
+    }
+    else if (lfs_file_read(&lfs, &file, count, sizeof(*count)) != (lfs_ssize_t)sizeof(*count)) {
+        status = IFX_VOICE_ID_STORAGE_ERROR_READ_USER_COUNT;
+    }
+    else if ((size != 0U) && (lfs_file_read(&lfs, &file, data, size) != (lfs_ssize_t)size)) {
+        status = IFX_VOICE_ID_STORAGE_ERROR_READ_EMBEDDINGS;
     }
 
-    if (magic != IFX_VOICE_ID_MAGIC_NUMBER) {
-        app_log_print("\tNo valid data in the flash memory. Skip the reading.\r\n");
+    (void)lfs_file_close(&lfs, &file);
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: storage_read_legacy
+********************************************************************************
+* Summary:
+* Read the single embeddings file of previous firmware versions
+*
+* Parameters:
+*  *embeddings
+* 
+* Return:
+*  IFX_VOICE_ID_SUCCESS or the storage error
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_read_legacy(voice_id_embeddings_t *embeddings) {
+    ifx_en_voice_id_status_t status;
+
+    status = storage_read_record(IFX_EMBEDDINGS_FILE_NAME, &embeddings->user_count,
+                                 embeddings->users, sizeof(embeddings->users));
+    if ((status == IFX_VOICE_ID_SUCCESS) && (embeddings->user_count > IFX_MAX_SUPPORTED_USERS)) {
+        status = IFX_VOICE_ID_STORAGE_ERROR_USER_COUNT_RANGE;
+    }
+    if (status != IFX_VOICE_ID_SUCCESS) {
         embeddings->user_count = 0U;
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_MAGIC;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
     }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: storage_read
+********************************************************************************
+* Summary:
+* Read the index and the records of the enrolled users. Embeddings of
+* previous firmware versions are migrated to per-user records.
+*
+* Parameters:
+*  *embeddings
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+static void storage_read(voice_id_embeddings_t *embeddings) {
+    char name[IFX_USER_FILE_NAME_SIZE];
+    uint8_t user_idx;
+    uint8_t record_idx;
+    ifx_en_voice_id_status_t status;
+
+    if (NULL == embeddings) {
+        app_log_print("ERROR: Invalid input parameter!\r\n");
+        return; /* cannot set storage_status */
+    }
+    embeddings->user_count = 0U;
 
-    embeddings->magic = magic;
+    status = storage_mount();
+    if (status != IFX_VOICE_ID_SUCCESS) {
+        embeddings->storage_status = status;
+        return;
+    }
 
-    /* Then read the number of users */
-    err = lfs_file_read(&lfs, &file, &embeddings->user_count, sizeof(uint8_t));
-    if (err < 0) {
-        app_log_print("ERROR: Reading user count failed!\r\n");
+    status = storage_read_record(IFX_INDEX_FILE_NAME, &embeddings->user_count, NULL, 0U);
+    if (status == IFX_VOICE_ID_STORAGE_ERROR_FILE_OPEN) {
+        /* No index yet, look for embeddings of a previous firmware version */
+        if (IFX_VOICE_ID_SUCCESS == storage_read_legacy(embeddings)) {
+            app_log_print("\tMigrating embeddings to per-user records.\r\n");
+            storage_write(embeddings);
+            if (embeddings->storage_status == IFX_VOICE_ID_SUCCESS) {
+                (void)lfs_remove(&lfs, IFX_EMBEDDINGS_FILE_NAME);
+            }
+        }
+        else {
+            app_log_print("\tNo valid data in the flash memory. Skip the reading.\r\n");
+            embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_MAGIC;
+        }
+        return;
+    }
+    if (status != IFX_VOICE_ID_SUCCESS) {
+        app_log_print("\tNo valid data in the flash memory. Skip the reading.\r\n");
         embeddings->user_count = 0U;
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_READ_USER_COUNT;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
+        embeddings->storage_status = status;
         return;
     }
     if (embeddings->user_count > IFX_MAX_SUPPORTED_USERS) {
@@ -228,39 +514,32 @@ void ifx_storage_read(ifx_voice_id_embeddings_t *embeddings) {
                embeddings->user_count, (unsigned)IFX_MAX_SUPPORTED_USERS);
         embeddings->user_count = 0U;
         embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_USER_COUNT_RANGE;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
         return;
     }
 
-    /* Then read the embeddings data */
-    err = lfs_file_read(&lfs, &file, embeddings->users,
-                        sizeof(float) * IFX_EMBEDDINGS_LENGTH_WORDS *
-                            IFX_NUM_ENROLLMENT_EMBEDDINGS * IFX_MAX_SUPPORTED_USERS);
-    if (err < 0) {
-        app_log_print("ERROR: Reading embeddings data failed!\r\n");
-        embeddings->user_count = 0U;
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_READ_EMBEDDINGS;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+    /* Users are enrolled in consecutive slots, stop at the first bad record */
+    for (user_idx = 0U; user_idx < embeddings->user_count; user_idx++) {
+        (void)snprintf(name, sizeof(name), IFX_USER_FILE_NAME, (unsigned)user_idx);
+        status = storage_read_record(name, &record_idx,
+                                     embeddings->users[user_idx], VOICE_ID_USER_EMBEDDINGS_SIZE);
+        if ((status != IFX_VOICE_ID_SUCCESS) || (record_idx != user_idx)) {
+            app_log_print("ERROR: Reading embeddings of user %u failed!\r\n", (unsigned)user_idx);
+            embeddings->user_count = user_idx;
+            embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_READ_EMBEDDINGS;
+            return;
+        }
     }
 
-    /* The storage is not updated until the file is closed successfully */
-    (void)lfs_file_close(&lfs, &file);
-
-    /* Release any resources we were using */
-    (void)lfs_unmount(&lfs);
+    embeddings->magic = VOICE_ID_EMBEDDINGS_MAGIC;
     embeddings->storage_status = IFX_VOICE_ID_SUCCESS;
-    return;
 }
 
 
 /*******************************************************************************
-* Function Name: ifx_storage_write
+* Function Name: storage_write
 ********************************************************************************
 * Summary:
-* Write embeddings 
+* Write the records of all enrolled users and the index
 *
 * Parameters:
 *  *embeddings
@@ -269,101 +548,324 @@ void ifx_storage_read(ifx_voice_id_embeddings_t *embeddings) {
 *  None
 *
 *******************************************************************************/
-
-void ifx_storage_write(ifx_voice_id_embeddings_t *embeddings) {
-    lfs_file_t file;
-    int32_t err;
+static void storage_write(voice_id_embeddings_t *embeddings) {
+    ifx_en_voice_id_status_t status;
 
     if (NULL == embeddings) {
         app_log_print("ERROR: Invalid input parameter!\r\n");
         return; /* cannot set storage_status */
     }
-    embeddings->storage_status = IFX_VOICE_ID_SUCCESS;
 
-    /* Set magic number for validation */
-    embeddings->magic = IFX_VOICE_ID_MAGIC_NUMBER;
+    status = storage_mount();
+    for (uint8_t user_idx = 0U; (status == IFX_VOICE_ID_SUCCESS) && (user_idx < embeddings->user_count); user_idx++) {
+        status = storage_write_user(user_idx, embeddings->users[user_idx]);
+    }
+    if (status == IFX_VOICE_ID_SUCCESS) {
+        status = storage_write_index(embeddings->user_count);
+    }
 
-    /* Mount the filesystem */
-    err = lfs_mount(&lfs, &lfs_cfg);
+    embeddings->magic = VOICE_ID_EMBEDDINGS_MAGIC;
+    embeddings->storage_status = status;
+}
 
-    /* Reformat if we cannot mount the filesystem */
-    if (err != 0) {
-        app_log_print(
-            "\nError in mounting. This could be the first time littlefs is "
-            "used on the storage device.\n");
-        app_log_print("Formatting the block device...\n");
-
-        err = lfs_format(&lfs, &lfs_cfg);
-        if (err != 0) {
-            app_log_print("ERROR: Formatting failed!\r\n");
-            embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_FORMAT;
-            return;
-        }
 
-        err = lfs_mount(&lfs, &lfs_cfg);
-        if (err != 0) {
-            app_log_print("ERROR: Mount after format failed!\r\n");
-            embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_MOUNT;
-            return;
-        }
+/*******************************************************************************
+* Function Name: storage_write_user
+********************************************************************************
+* Summary:
+* Write the record of one user slot. The records of the other users are not
+* rewritten.
+*
+* Parameters:
+*  user_idx, *user_embeddings (VOICE_ID_USER_EMBEDDINGS_SIZE bytes)
+* 
+* Return:
+*  IFX_VOICE_ID_SUCCESS or the storage error
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_write_user(uint8_t user_idx, const void *user_embeddings) {
+    char name[IFX_USER_FILE_NAME_SIZE];
+    ifx_en_voice_id_status_t status;
+
+    if ((NULL == user_embeddings) || (user_idx >= IFX_MAX_SUPPORTED_USERS)) {
+        app_log_print("ERROR: Invalid input parameter!\r\n");
+        return IFX_VOICE_ID_STORAGE_ERROR_BAD_PARAM;
     }
 
-    /* Open file for writing */
-    err = lfs_file_open(&lfs, &file, IFX_EMBEDDINGS_FILE_NAME, LFS_O_RDWR | LFS_O_CREAT);
-    if (err != 0) {
-        app_log_print("ERROR: File open failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_FILE_OPEN;
-        (void)lfs_unmount(&lfs);
-        return;
+    status = storage_mount();
+    if (status == IFX_VOICE_ID_SUCCESS) {
+        (void)snprintf(name, sizeof(name), IFX_USER_FILE_NAME, (unsigned)user_idx);
+        status = storage_write_record(name, user_idx, user_embeddings, VOICE_ID_USER_EMBEDDINGS_SIZE);
     }
+    return status;
+}
 
-    err = lfs_file_rewind(&lfs, &file);
-    if (err != 0) {
-        app_log_print("ERROR: File rewind failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_FILE_REWIND;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+
+/*******************************************************************************
+* Function Name: storage_write_index
+********************************************************************************
+* Summary:
+* Write the index. Records of the users must be written before they are
+* added to the index, so an interrupted enrollment leaves the previous users
+* intact.
+*
+* Parameters:
+*  user_count
+* 
+* Return:
+*  IFX_VOICE_ID_SUCCESS or the storage error
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_write_index(uint8_t user_count) {
+    ifx_en_voice_id_status_t status;
+
+    status = storage_mount();
+    if (status == IFX_VOICE_ID_SUCCESS) {
+        status = storage_write_record(IFX_INDEX_FILE_NAME, user_count, NULL, 0U);
     }
+    return status;
+}
 
-    /* First write the magic number for validation */
-    err = lfs_file_write(&lfs, &file, &embeddings->magic, sizeof(uint32_t));
-    if (err < 0) {
-        app_log_print("ERROR: Writing magic number failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_MAGIC;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+
+/*******************************************************************************
+* Function Name: storage_erase
+********************************************************************************
+* Summary:
+* Write the index and remove the records of the user slots that are no
+* longer enrolled. The index is written first, so removed records are never
+* referenced.
+*
+* Parameters:
+*  user_count
+* 
+* Return:
+*  IFX_VOICE_ID_SUCCESS or the storage error
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_erase(uint8_t user_count) {
+    char name[IFX_USER_FILE_NAME_SIZE];
+    ifx_en_voice_id_status_t status;
+
+    status = storage_write_index(user_count);
+    if (status == IFX_VOICE_ID_SUCCESS) {
+        for (uint8_t user_idx = user_count; user_idx < IFX_MAX_SUPPORTED_USERS; user_idx++) {
+            (void)snprintf(name, sizeof(name), IFX_USER_FILE_NAME, (unsigned)user_idx);
+            (void)lfs_remove(&lfs, name);
+        }
     }
+    return status;
+}
 
-    /* Then write the number of users */
-    err = lfs_file_write(&lfs, &file, &embeddings->user_count, sizeof(uint8_t));
-    if (err < 0) {
-        app_log_print("ERROR: Writing user count failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_USER_COUNT;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+/*******************************************************************************
+* Function Name: storage_read_file
+********************************************************************************
+* Summary:
+* Read a block of data from a file 
+*
+* Parameters:
+*  *name, offset, *buffer, size
+* 
+* Return:
+*  CY_RSLT_SUCCESS if all bytes were read, CY_RSLT_TYPE_ERROR otherwise
+*
+*******************************************************************************/
+static cy_rslt_t storage_read_file(const char *name, uint32_t offset, void *buffer, uint32_t size) {
+    lfs_file_t file;
+    int32_t err;
+    cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+
+    if ((NULL == name) || (NULL == buffer)) {
+        app_log_print("ERROR: Invalid input parameter!\r\n");
+        return CY_RSLT_TYPE_ERROR;
     }
 
-    /* Then write the embeddings data */
-    err = lfs_file_write(&lfs, &file, embeddings->users,
-                         sizeof(float) * IFX_EMBEDDINGS_LENGTH_WORDS *
-                             IFX_NUM_ENROLLMENT_EMBEDDINGS * IFX_MAX_SUPPORTED_USERS);
-    if (err < 0) {
-        app_log_print("ERROR: Writing embeddings data failed!\r\n");
-        embeddings->storage_status = IFX_VOICE_ID_STORAGE_ERROR_WRITE_EMBEDDINGS;
-        (void)lfs_file_close(&lfs, &file);
-        (void)lfs_unmount(&lfs);
-        return;
+    /* Do not format here, a missing file system only means there is no file */
+    if (!storage_mounted) {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    err = lfs_file_open(&lfs, &file, name, LFS_O_RDONLY);
+    if (err != 0) {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    err = lfs_file_seek(&lfs, &file, (lfs_soff_t)offset, LFS_SEEK_SET);
+    if (err >= 0) {
+        err = lfs_file_read(&lfs, &file, buffer, size);
+        if (err == (int32_t)size) {
+            result = CY_RSLT_SUCCESS;
+        }
     }
 
-    /* The storage is not updated until the file is closed successfully */
     (void)lfs_file_close(&lfs, &file);
 
-    /* Release any resources we were using */
-    (void)lfs_unmount(&lfs);
-    embeddings->storage_status = IFX_VOICE_ID_SUCCESS;
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: ifx_storage_init
+********************************************************************************
+* Summary:
+* Initialize the storage once and mount the file system while holding the
+* storage mutex, see storage_init
+*
+* Parameters:
+*  None
+* 
+* Return:
+*  Result of storage_init
+*
+*******************************************************************************/
+cy_rslt_t ifx_storage_init(void) {
+    cy_rslt_t result;
+
+    ifx_storage_lock();
+    result = storage_init();
+    ifx_storage_unlock();
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_read
+********************************************************************************
+* Summary:
+* Read the embeddings of the enrolled users while holding the
+* storage mutex, see storage_read
+*
+* Parameters:
+*  *embeddings
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+void ifx_storage_read(voice_id_embeddings_t *embeddings) {
+    ifx_storage_lock();
+    storage_read(embeddings);
+    ifx_storage_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_write
+********************************************************************************
+* Summary:
+* Write the embeddings of all enrolled users while holding the
+* storage mutex, see storage_write
+*
+* Parameters:
+*  *embeddings
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+void ifx_storage_write(voice_id_embeddings_t *embeddings) {
+    ifx_storage_lock();
+    storage_write(embeddings);
+    ifx_storage_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_write_user
+********************************************************************************
+* Summary:
+* Write the record of one user slot while holding the
+* storage mutex, see storage_write_user
+*
+* Parameters:
+*  user_idx, *user_embeddings
+* 
+* Return:
+*  Result of storage_write_user
+*
+*******************************************************************************/
+ifx_en_voice_id_status_t ifx_storage_write_user(uint8_t user_idx, const void *user_embeddings) {
+    ifx_en_voice_id_status_t result;
+
+    ifx_storage_lock();
+    result = storage_write_user(user_idx, user_embeddings);
+    ifx_storage_unlock();
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_write_index
+********************************************************************************
+* Summary:
+* Write the index while holding the
+* storage mutex, see storage_write_index
+*
+* Parameters:
+*  user_count
+* 
+* Return:
+*  Result of storage_write_index
+*
+*******************************************************************************/
+ifx_en_voice_id_status_t ifx_storage_write_index(uint8_t user_count) {
+    ifx_en_voice_id_status_t result;
+
+    ifx_storage_lock();
+    result = storage_write_index(user_count);
+    ifx_storage_unlock();
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_erase
+********************************************************************************
+* Summary:
+* Remove the users no longer enrolled while holding the
+* storage mutex, see storage_erase
+*
+* Parameters:
+*  user_count
+* 
+* Return:
+*  Result of storage_erase
+*
+*******************************************************************************/
+ifx_en_voice_id_status_t ifx_storage_erase(uint8_t user_count) {
+    ifx_en_voice_id_status_t result;
+
+    ifx_storage_lock();
+    result = storage_erase(user_count);
+    ifx_storage_unlock();
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ifx_storage_read_file
+********************************************************************************
+* Summary:
+* Read a block of data from a file while holding the
+* storage mutex, see storage_read_file
+*
+* Parameters:
+*  *name, offset, *buffer, size
+* 
+* Return:
+*  Result of storage_read_file
+*
+*******************************************************************************/
+cy_rslt_t ifx_storage_read_file(const char *name, uint32_t offset, void *buffer, uint32_t size) {
+    cy_rslt_t result;
+
+    ifx_storage_lock();
+    result = storage_read_file(name, offset, buffer, size);
+    ifx_storage_unlock();
+
+    return result;
 }
 
 /* [] END OF FILE */
@@ -38,9 +38,11 @@
 #ifndef _IFX_STORAGE_H_
 #define _IFX_STORAGE_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "ifx_voice_id.h"
+#include "voice_id_embeddings.h"
 #include "cybsp.h"
 
 #include "lfs.h"
@@ -53,6 +55,23 @@
 #define FS_STORAGE_START_ADDRESS (0xA00000UL)
 #define FS_STORAGE_SIZE (0x400000UL)
 
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+#ifdef IFX_STORAGE_STATS
+/**
+ * \brief Flash operations of the block device
+ */
+typedef struct {
+    /* Bytes programmed */
+    uint32_t bytes_programmed;
+    /* Blocks erased */
+    uint32_t blocks_erased;
+    /* Size of an erase block in bytes */
+    uint32_t block_size;
+} ifx_storage_stats_t;
+#endif /* IFX_STORAGE_STATS */
+
 /*******************************************************************************
  * Function Prototypes
  *******************************************************************************/
@@ -64,25 +83,68 @@
  * \retval CY_RSLT_SUCCESS Storage system initialized successfully
  * \retval CY_RSLT_TYPE_ERROR Storage system initialization failed
  *
- * \post Storage system is initialized and ready for read/write operations
+ * \post Storage system is initialized and ready for read/write operations. The
+ *       file system stays mounted.
  *
- * \note This function must be called before any other storage operations
+ * \note This function must be called before any other storage operations.
+ *       It can be called by several tasks, only the first call sets up the
+ *       storage. The storage functions are serialized by a mutex, so they
+ *       must only be called by tasks.
  * \warning Ensure proper power supply during initialization to prevent corruption
  */
 cy_rslt_t ifx_storage_init(void);
 
 /**
- * \brief Writes voice embeddings to the storage system
+ * \brief Writes the embeddings of all enrolled users to the storage system
  *
  * \param[in] embeddings Pointer to the voice embeddings structure to be stored
  *
  * \pre Storage system must be initialized using ifx_storage_init()
- * \post Voice embeddings are persistently stored in flash memory
+ * \post One record per enrolled user and the index are persistently stored
+ *       in flash memory
  *
- * \note The function will overwrite existing embeddings with the same ID
  * \warning Do not power off the device during write operations
  */
-void ifx_storage_write(ifx_voice_id_embeddings_t *embeddings);
+void ifx_storage_write(voice_id_embeddings_t *embeddings);
+
+/**
+ * \brief Writes the embeddings of one user to the storage system
+ *
+ * \param[in] user_idx        User slot to write
+ * \param[in] user_embeddings Embeddings of the user (VOICE_ID_USER_EMBEDDINGS_SIZE bytes)
+ *
+ * \return Returns the storage status
+ *
+ * \pre Storage system must be initialized using ifx_storage_init()
+ * \post The record of the user is persistently stored in flash memory, the
+ *       records of the other users are not rewritten. The user is only read
+ *       back once added to the index with ifx_storage_write_index().
+ */
+ifx_en_voice_id_status_t ifx_storage_write_user(uint8_t user_idx, const void *user_embeddings);
+
+/**
+ * \brief Writes the number of enrolled users to the storage system
+ *
+ * \param[in] user_count Number of enrolled users
+ *
+ * \return Returns the storage status
+ *
+ * \pre Storage system must be initialized using ifx_storage_init()
+ */
+ifx_en_voice_id_status_t ifx_storage_write_index(uint8_t user_count);
+
+/**
+ * \brief Removes the users no longer enrolled from the storage system
+ *
+ * \param[in] user_count Number of users still enrolled
+ *
+ * \return Returns the storage status
+ *
+ * \pre Storage system must be initialized using ifx_storage_init()
+ * \post The index holds user_count users, the records of the other user
+ *       slots are removed
+ */
+ifx_en_voice_id_status_t ifx_storage_erase(uint8_t user_count);
 
 /**
  * \brief Reads voice embeddings from the storage system
@@ -92,10 +154,52 @@ void ifx_storage_write(ifx_voice_id_embeddings_t *embeddings);
  * \pre Storage system must be initialized using ifx_storage_init()
  * \post Embeddings structure is populated with data from storage
  *
- * \note Returns empty embeddings if no data is found
+ * \note Returns empty embeddings if no data is found, or if the data was
+ *       stored in another embedding format (see voice_id_embeddings.h)
  * \warning Ensure sufficient memory is allocated in the embeddings structure
  */
-void ifx_storage_read(ifx_voice_id_embeddings_t *embeddings);
+void ifx_storage_read(voice_id_embeddings_t *embeddings);
+
+/**
+ * \brief Reads a file from the storage system
+ *
+ * \param[in]  name       Name of the file
+ * \param[in]  offset     Offset in the file to start reading from
+ * \param[out] buffer     Buffer where the data will be stored
+ * \param[in]  size       Number of bytes to read
+ *
+ * \return Returns the read status
+ * \retval CY_RSLT_SUCCESS All requested bytes were read
+ * \retval CY_RSLT_TYPE_ERROR File system or file not available, or file too short
+ *
+ * \pre Storage system must be initialized using ifx_storage_init()
+ *
+ * \note The file system is not formatted if it cannot be mounted
+ */
+cy_rslt_t ifx_storage_read_file(const char *name, uint32_t offset, void *buffer, uint32_t size);
+
+/**
+ * \brief Takes the storage mutex
+ *
+ * Every storage function takes it; a task takes it itself to make several
+ * calls without another task using the storage in between. The mutex is
+ * recursive, every call must be matched by ifx_storage_unlock().
+ */
+void ifx_storage_lock(void);
+
+/**
+ * \brief Gives the storage mutex taken by ifx_storage_lock()
+ */
+void ifx_storage_unlock(void);
+
+#ifdef IFX_STORAGE_STATS
+/**
+ * \brief Gets the flash operations since the last call and resets the counters
+ *
+ * \param[out] stats Flash operations, may be NULL to only reset the counters
+ */
+void ifx_storage_get_stats(ifx_storage_stats_t *stats);
+#endif /* IFX_STORAGE_STATS */
 
 #endif /* _IFX_STORAGE_H_ */
 
@@ -0,0 +1,311 @@
+/******************************************************************************
+* File Name : voice_id_embeddings.c
+*
+* Description :
+* Storage format of the enrolled Voice ID embeddings
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#ifdef ENABLE_VOICE_ID
+#include <string.h>
+#include "voice_id_embeddings.h"
+
+
+/*******************************************************************************
+* Function Name: voice_id_quantize_s8
+********************************************************************************
+* Summary:
+* Quantizes a vector to symmetric int8 with one scale for the whole vector.
+*
+* Parameters:
+*  values: vector to quantize
+*  data: quantized vector
+*  length: number of elements
+*
+* Return:
+*  Scale of the quantized vector (0 for a zero vector)
+*
+*******************************************************************************/
+float voice_id_quantize_s8(const float *values, int8_t *data, uint32_t length)
+{
+    float max_abs = 0.0f;
+    float abs_value;
+    float inv_scale;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        abs_value = (values[i] < 0.0f) ? -values[i] : values[i];
+        max_abs = (abs_value > max_abs) ? abs_value : max_abs;
+    }
+
+    if (max_abs == 0.0f)
+    {
+        memset(data, 0, length);
+        return 0.0f;
+    }
+
+    inv_scale = 127.0f / max_abs;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        /* |values[i] * inv_scale| <= 127, round half away from zero */
+        data[i] = (int8_t) (values[i] * inv_scale + ((values[i] < 0.0f) ? -0.5f : 0.5f));
+    }
+    return max_abs / 127.0f;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_float_to_half
+********************************************************************************
+* Summary:
+* Converts a float to IEEE 754 half precision, rounding to nearest even.
+*
+* Parameters:
+*  value: value to convert
+*
+* Return:
+*  Half-precision bits
+*
+*******************************************************************************/
+uint16_t voice_id_float_to_half(float value)
+{
+    uint32_t bits;
+    uint32_t sign;
+    int32_t exponent;
+    uint32_t mantissa;
+    uint32_t shift;
+    uint32_t half;
+    uint32_t rest;
+    uint32_t halfway;
+
+    memcpy(&bits, &value, sizeof(bits));
+    sign = (bits >> 16) & 0x8000u;
+    exponent = (int32_t) ((bits >> 23) & 0xFFu) - 127 + 15;
+    mantissa = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu)
+    {
+        /* Infinity or NaN */
+        return (uint16_t) (sign | 0x7C00u | ((mantissa != 0) ? 0x200u : 0u));
+    }
+    if (exponent >= 31)
+    {
+        /* Overflow to infinity */
+        return (uint16_t) (sign | 0x7C00u);
+    }
+    if (exponent <= 0)
+    {
+        /* Subnormal or zero */
+        if (exponent < -10)
+        {
+            return (uint16_t) sign;
+        }
+        mantissa |= 0x800000u;
+        shift = (uint32_t) (14 - exponent);
+        half = mantissa >> shift;
+        rest = mantissa & ((1u << shift) - 1u);
+        halfway = 1u << (shift - 1u);
+    }
+    else
+    {
+        half = ((uint32_t) exponent << 10) | (mantissa >> 13);
+        rest = mantissa & 0x1FFFu;
+        halfway = 0x1000u;
+    }
+
+    /* A carry into the exponent gives the correctly rounded result */
+    if ((rest > halfway) || ((rest == halfway) && ((half & 1u) != 0)))
+    {
+        half++;
+    }
+    return (uint16_t) (sign | half);
+}
+
+/*******************************************************************************
+* Function Name: voice_id_half_to_float
+********************************************************************************
+* Summary:
+* Converts an IEEE 754 half-precision value to float.
+*
+* Parameters:
+*  value: half-precision bits
+*
+* Return:
+*  Converted value
+*
+*******************************************************************************/
+float voice_id_half_to_float(uint16_t value)
+{
+    uint32_t sign = ((uint32_t) value & 0x8000u) << 16;
+    uint32_t exponent = ((uint32_t) value >> 10) & 0x1Fu;
+    uint32_t mantissa = (uint32_t) value & 0x3FFu;
+    uint32_t bits;
+    float result;
+
+    if (exponent == 0)
+    {
+        /* Subnormal or zero: mantissa * 2^-24 */
+        result = (float) mantissa * (1.0f / 16777216.0f);
+        return (sign != 0) ? -result : result;
+    }
+
+    if (exponent == 31)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent - 15u + 127u) << 23) | (mantissa << 13);
+    }
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_embeddings_add
+********************************************************************************
+* Summary:
+* Stores an enrollment embedding of a user in the storage format.
+*
+* Parameters:
+*  embeddings_data: enrolled users' embeddings
+*  embedding: embedding to store (IFX_EMBEDDINGS_LENGTH_WORDS values)
+*  person_idx: user of the embedding
+*  embedding_idx: enrollment slot of the embedding
+*
+* Return:
+*  Status of the add operation
+*
+*******************************************************************************/
+ifx_en_voice_id_status_t voice_id_embeddings_add(voice_id_embeddings_t *embeddings_data, const float *embedding,
+                                                 uint8_t person_idx, uint8_t embedding_idx)
+{
+#if defined(VOICE_ID_EMBEDDING_INT8) || defined(VOICE_ID_EMBEDDING_FP16)
+    voice_id_embedding_t *slot;
+
+    if ((embeddings_data == NULL) || (embedding == NULL))
+    {
+        return IFX_VOICE_ID_ERROR_BAD_PARAM;
+    }
+    if (person_idx >= IFX_MAX_SUPPORTED_USERS)
+    {
+        return IFX_VOICE_ID_ERROR_USER_IDX_OUT_OF_RANGE;
+    }
+    if (embedding_idx >= IFX_NUM_ENROLLMENT_EMBEDDINGS)
+    {
+        return IFX_VOICE_ID_ERROR_EMBEDDING_IDX_OUT_OF_RANGE;
+    }
+
+    slot = &embeddings_data->users[person_idx][embedding_idx];
+#if defined(VOICE_ID_EMBEDDING_INT8)
+    slot->scale = voice_id_quantize_s8(embedding, slot->data, IFX_EMBEDDINGS_LENGTH_WORDS);
+#else
+    for (uint32_t i = 0; i < IFX_EMBEDDINGS_LENGTH_WORDS; i++)
+    {
+        slot->data[i] = voice_id_float_to_half(embedding[i]);
+    }
+#endif /* VOICE_ID_EMBEDDING_INT8 */
+    return IFX_VOICE_ID_SUCCESS;
+#else
+    return ifx_voice_id_add_embedding(embeddings_data, (float *) embedding, person_idx, embedding_idx);
+#endif /* VOICE_ID_EMBEDDING_INT8 || VOICE_ID_EMBEDDING_FP16 */
+}
+
+/*******************************************************************************
+* Function Name: voice_id_embeddings_get
+********************************************************************************
+* Summary:
+* Returns an enrollment embedding of a user as float.
+*
+* Parameters:
+*  embeddings_data: enrolled users' embeddings
+*  person_idx: user of the embedding
+*  embedding_idx: enrollment slot of the embedding
+*  embedding: embedding (IFX_EMBEDDINGS_LENGTH_WORDS values)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_embeddings_get(const voice_id_embeddings_t *embeddings_data, uint8_t person_idx,
+                             uint8_t embedding_idx, float *embedding)
+{
+#if defined(VOICE_ID_EMBEDDING_INT8)
+    const voice_id_embedding_t *slot = &embeddings_data->users[person_idx][embedding_idx];
+
+    for (uint32_t i = 0; i < IFX_EMBEDDINGS_LENGTH_WORDS; i++)
+    {
+        embedding[i] = slot->scale * (float) slot->data[i];
+    }
+#elif defined(VOICE_ID_EMBEDDING_FP16)
+    const voice_id_embedding_t *slot = &embeddings_data->users[person_idx][embedding_idx];
+
+    for (uint32_t i = 0; i < IFX_EMBEDDINGS_LENGTH_WORDS; i++)
+    {
+        embedding[i] = voice_id_half_to_float(slot->data[i]);
+    }
+#else
+    memcpy(embedding, embeddings_data->users[person_idx][embedding_idx],
+           sizeof(embeddings_data->users[person_idx][embedding_idx]));
+#endif /* VOICE_ID_EMBEDDING_INT8 */
+}
+
+/*******************************************************************************
+* Function Name: voice_id_embeddings_clear
+********************************************************************************
+* Summary:
+* Removes all enrolled users.
+*
+* Parameters:
+*  embeddings_data: enrolled users' embeddings
+*
+* Return:
+*  Status of the clear operation
+*
+*******************************************************************************/
+ifx_en_voice_id_status_t voice_id_embeddings_clear(voice_id_embeddings_t *embeddings_data)
+{
+#if defined(VOICE_ID_EMBEDDING_INT8) || defined(VOICE_ID_EMBEDDING_FP16)
+    if (embeddings_data == NULL)
+    {
+        return IFX_VOICE_ID_ERROR_BAD_PARAM;
+    }
+    embeddings_data->user_count = 0U;
+    memset(embeddings_data->users, 0, sizeof(embeddings_data->users));
+    return IFX_VOICE_ID_SUCCESS;
+#else
+    return ifx_voice_id_clear_all_enrolled_users(embeddings_data);
+#endif /* VOICE_ID_EMBEDDING_INT8 || VOICE_ID_EMBEDDING_FP16 */
+}
+#endif /* ENABLE_VOICE_ID */
+/* [] END OF FILE */
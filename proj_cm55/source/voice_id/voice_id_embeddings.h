@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name : voice_id_embeddings.h
+*
+* Description :
+* Header for the storage format of the enrolled Voice ID embeddings
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef _VOICE_ID_EMBEDDINGS_H_
+#define _VOICE_ID_EMBEDDINGS_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include "ifx_voice_id.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Enrolled embeddings are kept in RAM and flash as float by default. Define
+ * VOICE_ID_EMBEDDING_FP16 (2x smaller) or VOICE_ID_EMBEDDING_INT8 (4x smaller,
+ * one scale per embedding) to store them quantized. Embeddings stored in
+ * another format are not read back; users need to enroll again.
+ */
+#if defined(VOICE_ID_EMBEDDING_FP16) && defined(VOICE_ID_EMBEDDING_INT8)
+#error "Define only one of VOICE_ID_EMBEDDING_FP16 and VOICE_ID_EMBEDDING_INT8"
+#endif
+
+#if defined(VOICE_ID_EMBEDDING_INT8)
+#define VOICE_ID_EMBEDDINGS_MAGIC       (IFX_VOICE_ID_MAGIC_NUMBER + 2UL)
+#elif defined(VOICE_ID_EMBEDDING_FP16)
+#define VOICE_ID_EMBEDDINGS_MAGIC       (IFX_VOICE_ID_MAGIC_NUMBER + 1UL)
+#else
+#define VOICE_ID_EMBEDDINGS_MAGIC       (IFX_VOICE_ID_MAGIC_NUMBER)
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+#if defined(VOICE_ID_EMBEDDING_INT8) || defined(VOICE_ID_EMBEDDING_FP16)
+#if defined(VOICE_ID_EMBEDDING_INT8)
+/* Symmetric int8 embedding: value[i] = scale * data[i] */
+typedef struct {
+    float scale;
+    int8_t data[IFX_EMBEDDINGS_LENGTH_WORDS];
+} voice_id_embedding_t;
+#else
+/* IEEE 754 half-precision embedding */
+typedef struct {
+    uint16_t data[IFX_EMBEDDINGS_LENGTH_WORDS];
+} voice_id_embedding_t;
+#endif
+
+/**
+ * \brief Enrolled users' embeddings in quantized format.
+ *
+ * Same fields as ifx_voice_id_embeddings_t, with quantized embeddings.
+ */
+typedef struct {
+    /* Magic number for validation */
+    uint32_t magic;
+    /* Number of enrolled users */
+    uint8_t user_count;
+    /* Last storage (read/write) status */
+    ifx_en_voice_id_status_t storage_status;
+    /* Enrolled users embeddings */
+    voice_id_embedding_t users[IFX_MAX_SUPPORTED_USERS][IFX_NUM_ENROLLMENT_EMBEDDINGS];
+} voice_id_embeddings_t;
+#else
+typedef ifx_voice_id_embeddings_t voice_id_embeddings_t;
+#endif /* VOICE_ID_EMBEDDING_INT8 || VOICE_ID_EMBEDDING_FP16 */
+
+/* Size of the enrollment embeddings of one user */
+#define VOICE_ID_USER_EMBEDDINGS_SIZE   (sizeof(((voice_id_embeddings_t *)0)->users[0]))
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+ifx_en_voice_id_status_t voice_id_embeddings_add(voice_id_embeddings_t *embeddings_data, const float *embedding,
+                                                 uint8_t person_idx, uint8_t embedding_idx);
+void voice_id_embeddings_get(const voice_id_embeddings_t *embeddings_data, uint8_t person_idx,
+                             uint8_t embedding_idx, float *embedding);
+ifx_en_voice_id_status_t voice_id_embeddings_clear(voice_id_embeddings_t *embeddings_data);
+
+float voice_id_quantize_s8(const float *values, int8_t *data, uint32_t length);
+uint16_t voice_id_float_to_half(float value);
+float voice_id_half_to_float(uint16_t value);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VOICE_ID_EMBEDDINGS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,337 @@
+/******************************************************************************
+* File Name : voice_id_engine.c
+*
+* Description :
+* Voice ID scoring engine with cached user centroids
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#ifdef ENABLE_VOICE_ID
+#include <math.h>
+#include <string.h>
+#include "voice_id_engine.h"
+
+#ifdef VOICE_ID_ENGINE_USE_CMSIS_DSP
+#include "arm_math.h"
+#endif /* VOICE_ID_ENGINE_USE_CMSIS_DSP */
+#ifdef VOICE_ID_ENGINE_USE_MVE
+#include <arm_mve.h>
+#endif /* VOICE_ID_ENGINE_USE_MVE */
+
+
+/*******************************************************************************
+* Function Name: voice_id_engine_dot_ref
+********************************************************************************
+* Summary:
+* Scalar reference of the dot-product kernel. Accumulates in the same order
+* on every target, so results can be compared with host computations.
+*
+* Parameters:
+*  a, b: vectors to multiply
+*  length: number of elements
+*
+* Return:
+*  Dot product of a and b
+*
+*******************************************************************************/
+float voice_id_engine_dot_ref(const float *a, const float *b, uint32_t length)
+{
+    float sum = 0.0f;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_dot
+********************************************************************************
+* Summary:
+* Dot-product kernel used for scoring. Uses the CMSIS-DSP kernel (vectorized
+* with Helium on the CM55) when available, else the scalar reference. The
+* vector kernel sums in a different order, so results differ from the
+* reference within float rounding only.
+*
+* Parameters:
+*  a, b: vectors to multiply
+*  length: number of elements
+*
+* Return:
+*  Dot product of a and b
+*
+*******************************************************************************/
+float voice_id_engine_dot(const float *a, const float *b, uint32_t length)
+{
+#ifdef VOICE_ID_ENGINE_USE_CMSIS_DSP
+    float32_t result;
+
+    arm_dot_prod_f32(a, b, length, &result);
+    return result;
+#else
+    return voice_id_engine_dot_ref(a, b, length);
+#endif /* VOICE_ID_ENGINE_USE_CMSIS_DSP */
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_dot_s8_ref
+********************************************************************************
+* Summary:
+* Scalar reference of the int8 dot-product kernel.
+*
+* Parameters:
+*  a, b: vectors to multiply
+*  length: number of elements
+*
+* Return:
+*  Dot product of a and b
+*
+*******************************************************************************/
+int32_t voice_id_engine_dot_s8_ref(const int8_t *a, const int8_t *b, uint32_t length)
+{
+    int32_t sum = 0;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        sum += (int32_t) a[i] * (int32_t) b[i];
+    }
+    return sum;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_dot_s8
+********************************************************************************
+* Summary:
+* Int8 dot-product kernel used for scoring quantized centroids. Uses the
+* Helium multiply-accumulate-across-vector instruction, 16 elements at a time,
+* when available. Integer accumulation is exact, so results are identical to
+* the reference.
+*
+* Parameters:
+*  a, b: vectors to multiply
+*  length: number of elements
+*
+* Return:
+*  Dot product of a and b
+*
+*******************************************************************************/
+int32_t voice_id_engine_dot_s8(const int8_t *a, const int8_t *b, uint32_t length)
+{
+#ifdef VOICE_ID_ENGINE_USE_MVE
+    int32_t sum = 0;
+    uint32_t i = 0;
+
+    for (; (i + 16u) <= length; i += 16u)
+    {
+        sum = vmladavaq_s8(sum, vld1q_s8(&a[i]), vld1q_s8(&b[i]));
+    }
+    return sum + voice_id_engine_dot_s8_ref(&a[i], &b[i], length - i);
+#else
+    return voice_id_engine_dot_s8_ref(a, b, length);
+#endif /* VOICE_ID_ENGINE_USE_MVE */
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_update_user
+********************************************************************************
+* Summary:
+* Recomputes the centroid of one user from its enrollment embeddings. Must be
+* called whenever the embeddings of the user change.
+*
+* Parameters:
+*  engine: scoring engine to update
+*  embeddings_data: enrolled users' embeddings
+*  user_idx: user to update
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_engine_update_user(voice_id_engine_t *engine, const voice_id_embeddings_t *embeddings_data,
+                                 uint8_t user_idx)
+{
+    float centroid[IFX_EMBEDDINGS_LENGTH_WORDS] = {0};
+    float sample[IFX_EMBEDDINGS_LENGTH_WORDS];
+    float norm;
+    uint32_t num_samples = 0;
+
+    if ((engine == NULL) || (embeddings_data == NULL) || (user_idx >= IFX_MAX_SUPPORTED_USERS))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < IFX_NUM_ENROLLMENT_EMBEDDINGS; i++)
+    {
+        voice_id_embeddings_get(embeddings_data, user_idx, i, sample);
+        norm = sqrtf(voice_id_engine_dot(sample, sample, IFX_EMBEDDINGS_LENGTH_WORDS));
+
+        /* Skip empty slots */
+        if (norm > 0.0f)
+        {
+            for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+            {
+                centroid[j] += sample[j] / norm;
+            }
+            num_samples++;
+        }
+    }
+
+    if (num_samples > 1)
+    {
+        for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+        {
+            centroid[j] /= (float) num_samples;
+        }
+    }
+
+#if defined(VOICE_ID_EMBEDDING_INT8)
+    engine->centroid_scale[user_idx] = voice_id_quantize_s8(centroid, engine->centroid[user_idx],
+                                                            IFX_EMBEDDINGS_LENGTH_WORDS);
+#else
+    memcpy(engine->centroid[user_idx], centroid, sizeof(centroid));
+#endif /* VOICE_ID_EMBEDDING_INT8 */
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_build
+********************************************************************************
+* Summary:
+* Computes the centroids of all enrolled users. Must be called after the
+* embeddings are loaded from storage or erased.
+*
+* Parameters:
+*  engine: scoring engine to build
+*  embeddings_data: enrolled users' embeddings
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_engine_build(voice_id_engine_t *engine, const voice_id_embeddings_t *embeddings_data)
+{
+    if ((engine == NULL) || (embeddings_data == NULL))
+    {
+        return;
+    }
+
+    memset(engine, 0, sizeof(*engine));
+    engine->user_count = (embeddings_data->user_count < IFX_MAX_SUPPORTED_USERS) ?
+        embeddings_data->user_count : IFX_MAX_SUPPORTED_USERS;
+
+    for (uint8_t i = 0; i < engine->user_count; i++)
+    {
+        voice_id_engine_update_user(engine, embeddings_data, i);
+    }
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_get_scores
+********************************************************************************
+* Summary:
+* Calculates the average cosine similarity of an embedding with the
+* enrollment embeddings of every enrolled user.
+*
+* Parameters:
+*  engine: scoring engine
+*  embedding: embedding to score (IFX_EMBEDDINGS_LENGTH_WORDS values)
+*  scores: similarity score of each user (IFX_MAX_SUPPORTED_USERS values)
+*
+* Return:
+*  IFX_VOICE_ID_SUCCESS or IFX_VOICE_ID_ERROR_BAD_PARAM
+*
+*******************************************************************************/
+ifx_en_voice_id_status_t voice_id_engine_get_scores(const voice_id_engine_t *engine, const float *embedding,
+                                                    float *scores)
+{
+    float norm;
+#if defined(VOICE_ID_EMBEDDING_INT8)
+    int8_t query[IFX_EMBEDDINGS_LENGTH_WORDS];
+    float query_scale;
+#endif /* VOICE_ID_EMBEDDING_INT8 */
+
+    if ((engine == NULL) || (embedding == NULL) || (scores == NULL))
+    {
+        return IFX_VOICE_ID_ERROR_BAD_PARAM;
+    }
+
+    norm = sqrtf(voice_id_engine_dot(embedding, embedding, IFX_EMBEDDINGS_LENGTH_WORDS));
+    if (norm == 0.0f)
+    {
+        memset(scores, 0, engine->user_count * sizeof(float));
+        return IFX_VOICE_ID_SUCCESS;
+    }
+
+#if defined(VOICE_ID_EMBEDDING_INT8)
+    query_scale = voice_id_quantize_s8(embedding, query, IFX_EMBEDDINGS_LENGTH_WORDS) / norm;
+    for (uint8_t i = 0; i < engine->user_count; i++)
+    {
+        scores[i] = query_scale * engine->centroid_scale[i] *
+            (float) voice_id_engine_dot_s8(query, engine->centroid[i], IFX_EMBEDDINGS_LENGTH_WORDS);
+    }
+#else
+    for (uint8_t i = 0; i < engine->user_count; i++)
+    {
+        scores[i] = voice_id_engine_dot(embedding, engine->centroid[i], IFX_EMBEDDINGS_LENGTH_WORDS) / norm;
+    }
+#endif /* VOICE_ID_EMBEDDING_INT8 */
+    return IFX_VOICE_ID_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_engine_verify
+********************************************************************************
+* Summary:
+* Scores an embedding and returns the best matching user above
+* IFX_VOICE_ID_SIMILARITY_THRESHOLD.
+*
+* Parameters:
+*  engine: scoring engine
+*  embedding: embedding to verify
+*  scores: similarity score of each user (IFX_MAX_SUPPORTED_USERS values)
+*
+* Return:
+*  Index of the detected user, or -1 if no user is identified
+*
+*******************************************************************************/
+int32_t voice_id_engine_verify(const voice_id_engine_t *engine, const float *embedding, float *scores)
+{
+    if (IFX_VOICE_ID_SUCCESS != voice_id_engine_get_scores(engine, embedding, scores))
+    {
+        return -1;
+    }
+    return ifx_voice_id_find_max_score(scores, engine->user_count, IFX_VOICE_ID_SIMILARITY_THRESHOLD);
+}
+#endif /* ENABLE_VOICE_ID */
+/* [] END OF FILE */
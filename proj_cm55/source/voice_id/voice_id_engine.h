@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name : voice_id_engine.h
+*
+* Description :
+* Header for the Voice ID scoring engine with cached user centroids
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef _VOICE_ID_ENGINE_H_
+#define _VOICE_ID_ENGINE_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include "ifx_voice_id.h"
+#include "voice_id_embeddings.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* The dot-product kernel uses CMSIS-DSP (Helium on the CM55) when the
+ * component is linked. Define VOICE_ID_ENGINE_SCALAR to force the portable
+ * scalar reference kernel, e.g. for host builds.
+ */
+#if defined(COMPONENT_CMSIS_DSP) && !defined(VOICE_ID_ENGINE_SCALAR)
+#define VOICE_ID_ENGINE_USE_CMSIS_DSP
+#endif
+
+/* The int8 kernel uses Helium intrinsics when the target supports MVE */
+#if defined(__ARM_FEATURE_MVE) && !defined(VOICE_ID_ENGINE_SCALAR)
+#define VOICE_ID_ENGINE_USE_MVE
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/**
+ * \brief Scoring data derived from the enrolled users' embeddings.
+ *
+ * The centroid of a user is the mean of its L2-normalized enrollment
+ * embeddings, so that the dot product of a normalized embedding with the
+ * centroid is the average cosine similarity with the enrollment embeddings.
+ * Scoring a user therefore takes one dot product instead of one cosine
+ * similarity (three dot products) per enrollment embedding. With
+ * VOICE_ID_EMBEDDING_INT8, centroids are int8 and scored with an integer dot
+ * product against the quantized query, without dequantizing.
+ */
+typedef struct {
+    /* Number of users with a valid centroid */
+    uint8_t user_count;
+#if defined(VOICE_ID_EMBEDDING_INT8)
+    /* Quantized mean of the normalized enrollment embeddings of each user */
+    int8_t centroid[IFX_MAX_SUPPORTED_USERS][IFX_EMBEDDINGS_LENGTH_WORDS];
+    float centroid_scale[IFX_MAX_SUPPORTED_USERS];
+#else
+    /* Mean of the normalized enrollment embeddings of each user */
+    float centroid[IFX_MAX_SUPPORTED_USERS][IFX_EMBEDDINGS_LENGTH_WORDS];
+#endif /* VOICE_ID_EMBEDDING_INT8 */
+} voice_id_engine_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+void voice_id_engine_build(voice_id_engine_t *engine, const voice_id_embeddings_t *embeddings_data);
+void voice_id_engine_update_user(voice_id_engine_t *engine, const voice_id_embeddings_t *embeddings_data,
+                                 uint8_t user_idx);
+ifx_en_voice_id_status_t voice_id_engine_get_scores(const voice_id_engine_t *engine, const float *embedding,
+                                                    float *scores);
+int32_t voice_id_engine_verify(const voice_id_engine_t *engine, const float *embedding, float *scores);
+
+float voice_id_engine_dot(const float *a, const float *b, uint32_t length);
+float voice_id_engine_dot_ref(const float *a, const float *b, uint32_t length);
+int32_t voice_id_engine_dot_s8(const int8_t *a, const int8_t *b, uint32_t length);
+int32_t voice_id_engine_dot_s8_ref(const int8_t *a, const int8_t *b, uint32_t length);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VOICE_ID_ENGINE_H_ */
+
+/* [] END OF FILE */
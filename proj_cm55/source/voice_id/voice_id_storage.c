@@ -0,0 +1,391 @@
+/******************************************************************************
+* File Name : voice_id_storage.c
+*
+* Description :
+* Background writer of the Voice ID embeddings
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#ifdef ENABLE_VOICE_ID
+#include <string.h>
+#include "voice_id_storage.h"
+#include "ifx_storage.h"
+#include "cyabs_rtos.h"
+#include "app_logger.h"
+#ifdef IFX_STORAGE_STATS
+#include "profiler.h"
+#endif /* IFX_STORAGE_STATS */
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+#define VOICE_ID_STORAGE_TASK_STACK_SIZE        (1024)
+/* Below the Voice ID task, flash writes never delay audio processing */
+#define VOICE_ID_STORAGE_TASK_PRIORITY          (1)
+
+/* Requests coalesced into one flash update at most. The Voice ID task can
+ * queue more while the batch is drained, they go to the next batch.
+ */
+#define VOICE_ID_STORAGE_BATCH_LENGTH           (VOICE_ID_STORAGE_QUEUE_LENGTH + 1U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+typedef enum
+{
+    VOICE_ID_STORAGE_SAVE_USER,
+    VOICE_ID_STORAGE_ERASE_ALL
+} voice_id_storage_op_t;
+
+typedef struct
+{
+    voice_id_storage_op_t op;
+    uint8_t user_idx;
+    voice_id_storage_callback_t callback;
+    void *arg;
+} voice_id_storage_request_t;
+
+/* Requests coalesced into one flash update */
+typedef struct
+{
+    /* Users whose record is written */
+    uint32_t dirty_users;
+    /* Records of slots above the user count are removed */
+    bool erase;
+    uint32_t num_requests;
+    voice_id_storage_request_t requests[VOICE_ID_STORAGE_BATCH_LENGTH];
+} voice_id_storage_batch_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+static QueueHandle_t storage_queue_handle;
+static TaskHandle_t storage_task_handle;
+static voice_id_embeddings_t *storage_embeddings;
+
+/* Copy of the user record being written, the Voice ID task can keep
+ * updating the embeddings meanwhile
+ */
+static uint8_t user_record[VOICE_ID_USER_EMBEDDINGS_SIZE];
+
+
+/*******************************************************************************
+* Function Name: storage_batch_add
+********************************************************************************
+* Summary:
+* Merges a request into the batch. Saving a user twice writes it once, and an
+* erase drops the pending saves.
+*
+* Parameters:
+*  batch, request
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+static void storage_batch_add(voice_id_storage_batch_t *batch, const voice_id_storage_request_t *request)
+{
+    if (request->op == VOICE_ID_STORAGE_ERASE_ALL)
+    {
+        batch->dirty_users = 0U;
+        batch->erase = true;
+    }
+    else
+    {
+        batch->dirty_users |= (1UL << request->user_idx);
+    }
+    batch->requests[batch->num_requests++] = *request;
+}
+
+/*******************************************************************************
+* Function Name: storage_batch_write
+********************************************************************************
+* Summary:
+* Writes the records of the saved users and the index. User records are
+* copied with the scheduler suspended, a short copy instead of holding the
+* embeddings for the whole flash write.
+*
+* Parameters:
+*  batch
+* 
+* Return:
+*  Storage status
+*
+*******************************************************************************/
+static ifx_en_voice_id_status_t storage_batch_write(const voice_id_storage_batch_t *batch)
+{
+    ifx_en_voice_id_status_t status = IFX_VOICE_ID_SUCCESS;
+    uint8_t user_count;
+
+    for (uint8_t i = 0; (i < IFX_MAX_SUPPORTED_USERS) && (status == IFX_VOICE_ID_SUCCESS); i++)
+    {
+        if ((batch->dirty_users & (1UL << i)) != 0U)
+        {
+            vTaskSuspendAll();
+            memcpy(user_record, storage_embeddings->users[i], sizeof(user_record));
+            (void) xTaskResumeAll();
+            status = ifx_storage_write_user(i, user_record);
+        }
+    }
+
+    /* Written last, the index only references records already stored */
+    user_count = storage_embeddings->user_count;
+    if (status == IFX_VOICE_ID_SUCCESS)
+    {
+        status = batch->erase ? ifx_storage_erase(user_count) : ifx_storage_write_index(user_count);
+    }
+    return status;
+}
+
+#ifdef IFX_STORAGE_STATS
+/*******************************************************************************
+* Function Name: print_storage_stats
+********************************************************************************
+* Summary:
+* Prints the time and the flash operations of a storage update, and the
+* write amplification relative to the embeddings written.
+*
+* Parameters:
+*  start_cycles: cycle count at the start of the update
+*  batch: written requests
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+static void print_storage_stats(uint32_t start_cycles, const voice_id_storage_batch_t *batch)
+{
+    ifx_storage_stats_t stats;
+    uint32_t time_us = (profiler_get_cycle_count() - start_cycles) / (SystemCoreClock / 1000000u);
+    uint32_t payload = 0U;
+    uint32_t flash_bytes;
+
+    ifx_storage_get_stats(&stats);
+    flash_bytes = stats.bytes_programmed + stats.blocks_erased * stats.block_size;
+    for (uint8_t i = 0; i < IFX_MAX_SUPPORTED_USERS; i++)
+    {
+        payload += ((batch->dirty_users & (1UL << i)) != 0U) ? VOICE_ID_USER_EMBEDDINGS_SIZE : 0U;
+    }
+
+    app_log_print("Voice ID - Storage update (%u requests): %u us, %u bytes programmed, %u blocks erased\r\n",
+        batch->num_requests, time_us, stats.bytes_programmed, stats.blocks_erased);
+    if (payload != 0U)
+    {
+        app_log_print("Voice ID - Write amplification: %u.%02u (programmed and erased bytes per embedding byte)\r\n",
+            flash_bytes / payload, (flash_bytes % payload) * 100u / payload);
+    }
+}
+#endif /* IFX_STORAGE_STATS */
+
+/*******************************************************************************
+* Function Name: voice_id_storage_task
+********************************************************************************
+* Summary:
+* Waits for storage requests, coalesces all requests queued by then into one
+* batch, writes it and notifies the requesters.
+*
+* Parameters:
+*  arg
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+static void voice_id_storage_task(void *arg)
+{
+    static voice_id_storage_batch_t batch;
+    voice_id_storage_request_t request;
+    ifx_en_voice_id_status_t status;
+#ifdef IFX_STORAGE_STATS
+    uint32_t start_cycles;
+#endif /* IFX_STORAGE_STATS */
+
+    (void) arg;
+
+    while (1)
+    {
+        if (pdTRUE != xQueueReceive(storage_queue_handle, &request, portMAX_DELAY))
+        {
+            continue;
+        }
+
+        memset(&batch, 0, sizeof(batch));
+        storage_batch_add(&batch, &request);
+        while ((batch.num_requests < VOICE_ID_STORAGE_BATCH_LENGTH) &&
+               (pdTRUE == xQueueReceive(storage_queue_handle, &request, 0)))
+        {
+            storage_batch_add(&batch, &request);
+        }
+
+        /* The batch is written, and its flash operations counted, without
+         * another task using the storage in between
+         */
+        ifx_storage_lock();
+#ifdef IFX_STORAGE_STATS
+        ifx_storage_get_stats(NULL);
+        start_cycles = profiler_get_cycle_count();
+#endif /* IFX_STORAGE_STATS */
+        status = storage_batch_write(&batch);
+#ifdef IFX_STORAGE_STATS
+        print_storage_stats(start_cycles, &batch);
+#endif /* IFX_STORAGE_STATS */
+        ifx_storage_unlock();
+
+        storage_embeddings->storage_status = status;
+        for (uint32_t i = 0; i < batch.num_requests; i++)
+        {
+            if (batch.requests[i].callback != NULL)
+            {
+                batch.requests[i].callback(status, batch.requests[i].arg);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: voice_id_storage_send
+********************************************************************************
+* Summary:
+* Queues a storage request without blocking.
+*
+* Parameters:
+*  request
+* 
+* Return:
+*  true if queued, false if the queue is full
+*
+*******************************************************************************/
+static bool voice_id_storage_send(const voice_id_storage_request_t *request)
+{
+    if (pdTRUE != xQueueSend(storage_queue_handle, request, 0))
+    {
+        app_log_print("Voice ID - Storage queue full, request dropped\r\n");
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_storage_init
+********************************************************************************
+* Summary:
+* Creates the storage writer task. The embeddings are read from storage
+* before, with ifx_storage_read.
+*
+* Parameters:
+*  embeddings: enrolled users' embeddings kept in RAM
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_storage_init(voice_id_embeddings_t *embeddings)
+{
+    BaseType_t rtos_task_status;
+
+    storage_embeddings = embeddings;
+#ifdef IFX_STORAGE_STATS
+    profiler_init();
+#endif /* IFX_STORAGE_STATS */
+
+    storage_queue_handle = xQueueCreate(VOICE_ID_STORAGE_QUEUE_LENGTH, sizeof(voice_id_storage_request_t));
+    if (storage_queue_handle == NULL)
+    {
+        app_log_print("Voice ID storage queue initialization failed \r\n");
+        CY_ASSERT(0);
+    }
+
+    rtos_task_status = xTaskCreate(voice_id_storage_task, "Voice_ID_storage_task",
+                        VOICE_ID_STORAGE_TASK_STACK_SIZE, NULL, VOICE_ID_STORAGE_TASK_PRIORITY,
+                        &storage_task_handle);
+    if (pdPASS != rtos_task_status)
+    {
+        app_log_print("Voice ID storage task creation failed \r\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: voice_id_storage_save_user
+********************************************************************************
+* Summary:
+* Requests the embeddings of a user and the number of enrolled users to be
+* saved. Does not block.
+*
+* Parameters:
+*  user_idx: user to save
+*  callback: called when saved, may be NULL
+*  arg: argument of the callback
+* 
+* Return:
+*  true if the request is queued
+*
+*******************************************************************************/
+bool voice_id_storage_save_user(uint8_t user_idx, voice_id_storage_callback_t callback, void *arg)
+{
+    voice_id_storage_request_t request = { VOICE_ID_STORAGE_SAVE_USER, user_idx, callback, arg };
+
+    if (user_idx >= IFX_MAX_SUPPORTED_USERS)
+    {
+        return false;
+    }
+    return voice_id_storage_send(&request);
+}
+
+/*******************************************************************************
+* Function Name: voice_id_storage_erase_all
+********************************************************************************
+* Summary:
+* Requests the users removed from the embeddings to be removed from storage.
+* Does not block.
+*
+* Parameters:
+*  callback: called when erased, may be NULL
+*  arg: argument of the callback
+* 
+* Return:
+*  true if the request is queued
+*
+*******************************************************************************/
+bool voice_id_storage_erase_all(voice_id_storage_callback_t callback, void *arg)
+{
+    voice_id_storage_request_t request = { VOICE_ID_STORAGE_ERASE_ALL, 0U, callback, arg };
+
+    return voice_id_storage_send(&request);
+}
+#endif /* ENABLE_VOICE_ID */
+/* [] END OF FILE */
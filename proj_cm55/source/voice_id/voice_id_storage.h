@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name : voice_id_storage.h
+*
+* Description :
+* Header for the background writer of the Voice ID embeddings
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef _VOICE_ID_STORAGE_H_
+#define _VOICE_ID_STORAGE_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdbool.h>
+#include "ifx_voice_id.h"
+#include "voice_id_embeddings.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Requests that can wait for the writer. Requests queued while a batch is
+ * written are coalesced into the next batch.
+ */
+#define VOICE_ID_STORAGE_QUEUE_LENGTH           (8U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/**
+ * \brief Called by the writer task when a request is stored in flash.
+ *
+ * \param[in] status Storage status of the batch the request was written in
+ * \param[in] arg    Argument given with the request
+ */
+typedef void (*voice_id_storage_callback_t)(ifx_en_voice_id_status_t status, void *arg);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+void voice_id_storage_init(voice_id_embeddings_t *embeddings);
+bool voice_id_storage_save_user(uint8_t user_idx, voice_id_storage_callback_t callback, void *arg);
+bool voice_id_storage_erase_all(voice_id_storage_callback_t callback, void *arg);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VOICE_ID_STORAGE_H_ */
+
+/* [] END OF FILE */
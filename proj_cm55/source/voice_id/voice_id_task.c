@@ -41,6 +41,12 @@
 #include "voice_id_task.h"
 #include "cyabs_rtos.h"
 #include "app_logger.h"
+#if defined(VOICE_ID_ENGINE_CHECK) || defined(VOICE_ID_ENGINE_BENCHMARK)
+#include <math.h>
+#endif /* VOICE_ID_ENGINE_CHECK || VOICE_ID_ENGINE_BENCHMARK */
+#ifdef VOICE_ID_ENGINE_BENCHMARK
+#include "profiler.h"
+#endif /* VOICE_ID_ENGINE_BENCHMARK */
 
 /*******************************************************************************
 * Macros
@@ -52,15 +58,71 @@
 #define VOICE_ID_QUEUE_SIZE                     (MONO_AUDIO_DATA_IN_BYTES)
 #define VOICE_ID_QUEUE_ELEMENTS                 (10)                        
 
+#ifdef VOICE_ID_ENGINE_BENCHMARK
+/* Number of verifications timed for each number of enrolled users */
+#define VOICE_ID_BENCHMARK_REPEAT               (100u)
+/* Number of test embeddings per user for the accuracy comparison */
+#define VOICE_ID_BENCHMARK_QUERIES              (20u)
+/* Spread of the synthetic embeddings of a user around its base embedding */
+#define VOICE_ID_BENCHMARK_NOISE                (0.8f)
+#endif /* VOICE_ID_ENGINE_BENCHMARK */
+
+#ifdef VOICE_ID_STREAMING
+/* First provisional verification after this much audio */
+#ifndef VOICE_ID_STREAM_MIN_MS
+#define VOICE_ID_STREAM_MIN_MS                  (1000u)
+#endif
+/* Interval between provisional verifications */
+#ifndef VOICE_ID_STREAM_HOP_MS
+#define VOICE_ID_STREAM_HOP_MS                  (500u)
+#endif
+/* Score lead of the best user over the second best user, or over the
+ * similarity threshold, to accept a provisional verification
+ */
+#ifndef VOICE_ID_EARLY_EXIT_MARGIN
+#define VOICE_ID_EARLY_EXIT_MARGIN              (0.15f)
+#endif
+
+#define VOICE_ID_SAMPLES_PER_MS                 (16u)
+#define VOICE_ID_FRAME_SAMPLES                  (MONO_AUDIO_DATA_IN_BYTES / sizeof(int16_t))
+#endif /* VOICE_ID_STREAMING */
+
+#if defined(VOICE_ID_ENGINE_CHECK) && (defined(VOICE_ID_EMBEDDING_INT8) || defined(VOICE_ID_EMBEDDING_FP16))
+#error "VOICE_ID_ENGINE_CHECK compares with the library scores and needs float embeddings"
+#endif
+
+/* The Voice ID library verifies the float embeddings of all enrollments. The
+ * quantized embeddings and the score check are only scored by the centroid
+ * engine.
+ */
+#if !defined(VOICE_ID_CENTROID_ENGINE) && \
+    (defined(VOICE_ID_EMBEDDING_INT8) || defined(VOICE_ID_EMBEDDING_FP16) || defined(VOICE_ID_ENGINE_CHECK))
+#error "Quantized embeddings and VOICE_ID_ENGINE_CHECK need VOICE_ID_CENTROID_ENGINE"
+#endif
+
 /*******************************************************************************
  * Global Variables
  *******************************************************************************/
 
-/* Audio buffer used to generate an embedding from */
+#ifdef VOICE_ID_STREAMING
+/* Audio buffer used to generate an embedding from, see the memory map of
+ * va_arena.c. Without streaming, the library buffers the audio itself.
+ */
 int16_t audio_for_embedding[FE_AUDIO_LEN];
 
+/* Samples of the current verification in audio_for_embedding */
+static uint32_t stream_len;
+/* Length at which the next provisional verification runs */
+static uint32_t stream_checkpoint = VOICE_ID_STREAM_MIN_MS * VOICE_ID_SAMPLES_PER_MS;
+#endif /* VOICE_ID_STREAMING */
+
 /* Embeddings of enrolled users */
-ifx_voice_id_embeddings_t embeddings_data = {0};
+voice_id_embeddings_t embeddings_data = {0};
+
+#ifdef VOICE_ID_CENTROID_ENGINE
+/* Centroids of the enrolled users used for scoring */
+voice_id_engine_t voice_id_engine;
+#endif /* VOICE_ID_CENTROID_ENGINE */
 
 /* Embeddings during user verification */
 float embedding[IFX_EMBEDDINGS_LENGTH_WORDS * IFX_NUM_VERIFICATION_EMBEDDINGS] = {0};
@@ -69,6 +131,10 @@ TaskHandle_t rtos_vid_task;
 QueueHandle_t vid_queue_handle;
 int32_t detected_user=-1;
 
+/* Audio frames not queued to the Voice ID task because the queue was full */
+volatile uint32_t vid_frames_dropped = 0;
+static uint32_t enroll_frames_dropped;
+
 extern volatile uint8_t enroll_flag;
 extern volatile uint8_t erase_flag;
 
@@ -76,6 +142,57 @@ volatile char voice_id_mode = IFX_VOICE_ID_WAIT;
 
 
 
+/*******************************************************************************
+* Function Name: enrollment_saved
+********************************************************************************
+* Summary:
+* Called by the storage writer when an enrolled user is saved
+*
+* Parameters:
+*  status: storage status
+*  arg: index of the user
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+
+static void enrollment_saved(ifx_en_voice_id_status_t status, void *arg)
+{
+    if (status != IFX_VOICE_ID_SUCCESS) {
+        app_log_print("Voice ID - Saving user [%u] failed %s\r\n", (unsigned)(uintptr_t)arg,
+            ifx_voice_id_get_status_description(status));
+    } else {
+        app_log_print("Voice ID - User [%u] saved, %u audio frames dropped since enrollment start\r\n",
+            (unsigned)(uintptr_t)arg, (unsigned)(vid_frames_dropped - enroll_frames_dropped));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: erase_saved
+********************************************************************************
+* Summary:
+* Called by the storage writer when the erased enrollments are saved
+*
+* Parameters:
+*  status: storage status
+*  arg: unused
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+
+static void erase_saved(ifx_en_voice_id_status_t status, void *arg)
+{
+    (void)arg;
+    if (status != IFX_VOICE_ID_SUCCESS) {
+        app_log_print("Voice ID - Saving erased enrollments failed %s\r\n", ifx_voice_id_get_status_description(status));
+    }
+}
+
+
 /*******************************************************************************
 * Function Name: get_enrolled_users
 ********************************************************************************
@@ -97,11 +214,15 @@ uint8_t get_enrolled_users(void)
 void erase_enrolled_users(void)
 {
     ifx_en_voice_id_status_t status;
-    status = ifx_voice_id_clear_all_enrolled_users(&embeddings_data);
+
+    status = voice_id_embeddings_clear(&embeddings_data);
     if (status != IFX_VOICE_ID_SUCCESS) {
         app_log_print("Voice ID - Error in erasing enrolled users %s\r\n", ifx_voice_id_get_status_description(status));
     } else {
-        ifx_storage_write(&embeddings_data);
+#ifdef VOICE_ID_CENTROID_ENGINE
+        voice_id_engine_build(&voice_id_engine, &embeddings_data);
+#endif /* VOICE_ID_CENTROID_ENGINE */
+        (void)voice_id_storage_erase_all(erase_saved, NULL);
         app_log_print("Voice ID - All enrollments erased successfully!\r\n");
         print_voice_id_info(&embeddings_data);
     }
@@ -109,6 +230,332 @@ void erase_enrolled_users(void)
 }
 
 
+/*******************************************************************************
+* Function Name: verify_user
+********************************************************************************
+* Summary:
+* Finds the enrolled user of an embedding with the Voice ID library, or with
+* the centroid engine if VOICE_ID_CENTROID_ENGINE is defined.
+*
+* Parameters:
+*  query: embedding to verify
+*  scores: score of each user. Only set by the centroid engine, or by the
+*          library for the streaming verification
+* 
+* Return:
+*  Detected user, or -1
+*
+*******************************************************************************/
+
+static int32_t verify_user(float *query, float *scores)
+{
+#ifdef VOICE_ID_CENTROID_ENGINE
+    return voice_id_engine_verify(&voice_id_engine, query, scores);
+#else
+#ifdef VOICE_ID_STREAMING
+    /* The early exit compares the scores of the users */
+    if (IFX_VOICE_ID_SUCCESS != ifx_voice_id_get_similarity_scores(&embeddings_data, query, scores))
+    {
+        memset(scores, 0, IFX_MAX_SUPPORTED_USERS * sizeof(float));
+    }
+#else
+    (void)scores;
+#endif /* VOICE_ID_STREAMING */
+    return ifx_voice_id_verify(query, &embeddings_data);
+#endif /* VOICE_ID_CENTROID_ENGINE */
+}
+
+
+#ifdef VOICE_ID_ENGINE_CHECK
+/*******************************************************************************
+* Function Name: check_engine_scores
+********************************************************************************
+* Summary:
+* Compares the scores of the scoring engine with the scores calculated by the
+* Voice ID library from all enrollment embeddings and prints the largest
+* difference.
+*
+* Parameters:
+*  query: verified embedding
+*  scores: scores calculated by the scoring engine
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+
+static void check_engine_scores(float *query, const float *scores)
+{
+    float ref_scores[IFX_MAX_SUPPORTED_USERS];
+    float max_diff = 0.0f;
+
+    if (IFX_VOICE_ID_SUCCESS != ifx_voice_id_get_similarity_scores(&embeddings_data, query, ref_scores))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < voice_id_engine.user_count; i++)
+    {
+        float diff = fabsf(scores[i] - ref_scores[i]);
+        max_diff = (diff > max_diff) ? diff : max_diff;
+    }
+    app_log_print("Voice ID - Score deviation from library: %d.%06d\r\n",
+        (int) max_diff, (int) ((max_diff - (int) max_diff) * 1000000.0f));
+}
+#endif /* VOICE_ID_ENGINE_CHECK */
+
+#ifdef VOICE_ID_ENGINE_BENCHMARK
+/*******************************************************************************
+* Function Name: make_benchmark_embedding
+********************************************************************************
+* Summary:
+* Generates a deterministic synthetic embedding of a user: its base embedding
+* plus pseudo-random noise.
+*
+* Parameters:
+*  base: base embedding of the user, NULL to generate a base embedding
+*  embedding: generated embedding
+*  seed: state of the pseudo-random generator
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+
+static void make_benchmark_embedding(const float *base, float *embedding, uint32_t *seed)
+{
+    float noise;
+
+    for (uint32_t i = 0; i < IFX_EMBEDDINGS_LENGTH_WORDS; i++)
+    {
+        *seed = *seed * 1664525u + 1013904223u;
+        noise = (float) (int32_t) *seed / 2147483648.0f;
+        embedding[i] = (base != NULL) ? (base[i] + VOICE_ID_BENCHMARK_NOISE * noise) : noise;
+    }
+}
+
+/*******************************************************************************
+* Function Name: run_engine_benchmark
+********************************************************************************
+* Summary:
+* Measures the verification time of the Voice ID library and of the scoring
+* engine for 1 to IFX_MAX_SUPPORTED_USERS enrolled users, and compares the
+* scores and decisions of both on a synthetic test set. The engine uses the
+* configured embedding format, the library always uses float embeddings.
+*
+* Parameters:
+*  None
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+
+static void run_engine_benchmark(void)
+{
+    static ifx_voice_id_embeddings_t bench_data;
+    static voice_id_embeddings_t bench_store;
+    static voice_id_engine_t bench_engine;
+    static float base[IFX_MAX_SUPPORTED_USERS][IFX_EMBEDDINGS_LENGTH_WORDS];
+    float query[IFX_EMBEDDINGS_LENGTH_WORDS];
+    float scores[IFX_MAX_SUPPORTED_USERS];
+    float ref_scores[IFX_MAX_SUPPORTED_USERS];
+    float max_diff = 0.0f;
+    float diff;
+    uint32_t mismatches = 0;
+    uint32_t seed = 1u;
+    uint32_t start_cycles;
+    uint32_t lib_cycles;
+    uint32_t engine_cycles;
+
+    for (uint8_t user = 0; user < IFX_MAX_SUPPORTED_USERS; user++)
+    {
+        make_benchmark_embedding(NULL, base[user], &seed);
+        for (uint8_t i = 0; i < IFX_NUM_ENROLLMENT_EMBEDDINGS; i++)
+        {
+            make_benchmark_embedding(base[user], bench_data.users[user][i], &seed);
+            voice_id_embeddings_add(&bench_store, bench_data.users[user][i], user, i);
+        }
+    }
+    make_benchmark_embedding(base[0], query, &seed);
+    bench_data.magic = IFX_VOICE_ID_MAGIC_NUMBER;
+
+    profiler_init();
+    app_log_print("Voice ID - Verification benchmark (cycles per verification):\r\n");
+
+    for (uint8_t users = 1; users <= IFX_MAX_SUPPORTED_USERS; users++)
+    {
+        bench_data.user_count = users;
+        bench_store.user_count = users;
+        voice_id_engine_build(&bench_engine, &bench_store);
+
+        start_cycles = profiler_get_cycle_count();
+        for (uint32_t i = 0; i < VOICE_ID_BENCHMARK_REPEAT; i++)
+        {
+            ifx_voice_id_get_similarity_scores(&bench_data, query, scores);
+        }
+        lib_cycles = (profiler_get_cycle_count() - start_cycles) / VOICE_ID_BENCHMARK_REPEAT;
+
+        start_cycles = profiler_get_cycle_count();
+        for (uint32_t i = 0; i < VOICE_ID_BENCHMARK_REPEAT; i++)
+        {
+            voice_id_engine_verify(&bench_engine, query, scores);
+        }
+        engine_cycles = (profiler_get_cycle_count() - start_cycles) / VOICE_ID_BENCHMARK_REPEAT;
+
+        app_log_print("  %u users: library %u, engine %u\r\n", users, lib_cycles, engine_cycles);
+    }
+
+    /* Accuracy on the test set, all users enrolled */
+    for (uint32_t i = 0; i < VOICE_ID_BENCHMARK_QUERIES * IFX_MAX_SUPPORTED_USERS; i++)
+    {
+        make_benchmark_embedding(base[i % IFX_MAX_SUPPORTED_USERS], query, &seed);
+        ifx_voice_id_get_similarity_scores(&bench_data, query, ref_scores);
+        voice_id_engine_get_scores(&bench_engine, query, scores);
+
+        for (uint8_t user = 0; user < IFX_MAX_SUPPORTED_USERS; user++)
+        {
+            diff = fabsf(scores[user] - ref_scores[user]);
+            max_diff = (diff > max_diff) ? diff : max_diff;
+        }
+        if (ifx_voice_id_find_max_score(scores, IFX_MAX_SUPPORTED_USERS, IFX_VOICE_ID_SIMILARITY_THRESHOLD) !=
+            ifx_voice_id_find_max_score(ref_scores, IFX_MAX_SUPPORTED_USERS, IFX_VOICE_ID_SIMILARITY_THRESHOLD))
+        {
+            mismatches++;
+        }
+    }
+    app_log_print("  Score deviation from library: %d.%06d, decisions changed: %u of %u\r\n",
+        (int) max_diff, (int) ((max_diff - (int) max_diff) * 1000000.0f),
+        mismatches, VOICE_ID_BENCHMARK_QUERIES * IFX_MAX_SUPPORTED_USERS);
+    app_log_print("  Enrolled embeddings: %u bytes\r\n", (unsigned) sizeof(bench_store.users));
+}
+#endif /* VOICE_ID_ENGINE_BENCHMARK */
+
+#ifdef VOICE_ID_STREAMING
+/*******************************************************************************
+* Function Name: voice_id_stream_reset
+********************************************************************************
+* Summary:
+* Discards the audio of the current streaming verification
+*
+* Parameters:
+*  None
+* 
+* Return:
+*  None
+*
+*******************************************************************************/
+
+static void voice_id_stream_reset(void)
+{
+    stream_len = 0;
+    stream_checkpoint = VOICE_ID_STREAM_MIN_MS * VOICE_ID_SAMPLES_PER_MS;
+}
+
+
+/*******************************************************************************
+* Function Name: get_score_margin
+********************************************************************************
+* Summary:
+* Returns the lead of the best score over the second best score. Scores below
+* the similarity threshold count as the threshold, so a single enrolled user
+* must lead the threshold by the margin.
+*
+* Parameters:
+*  scores: score of each user
+*  user_count: number of users
+* 
+* Return:
+*  Score margin
+*
+*******************************************************************************/
+
+static float get_score_margin(const float *scores, uint8_t user_count)
+{
+    float best = IFX_VOICE_ID_SIMILARITY_THRESHOLD;
+    float second = IFX_VOICE_ID_SIMILARITY_THRESHOLD;
+
+    for (uint8_t i = 0; i < user_count; i++)
+    {
+        if (scores[i] > best)
+        {
+            second = best;
+            best = scores[i];
+        }
+        else if (scores[i] > second)
+        {
+            second = scores[i];
+        }
+    }
+    return best - second;
+}
+
+
+/*******************************************************************************
+* Function Name: voice_id_stream_verify
+********************************************************************************
+* Summary:
+* Adds a frame to the streaming verification. From VOICE_ID_STREAM_MIN_MS on,
+* every VOICE_ID_STREAM_HOP_MS a provisional embedding is computed from the
+* audio so far, repeated to fill the model window. The verification ends as
+* soon as the best user leads by VOICE_ID_EARLY_EXIT_MARGIN, or with the
+* embedding of the full window.
+*
+* Parameters:
+*  frame: audio frame (VOICE_ID_FRAME_SAMPLES samples)
+*  scores: score of each user of the last embedding
+*  user: detected user, or -1
+* 
+* Return:
+*  IFX_VOICE_ID_INFERENCE_COMPLETE when decided, IFX_VOICE_ID_INFERENCE_IN_PROGRESS
+*  while more audio is needed, or the inference error
+*
+*******************************************************************************/
+
+static ifx_en_voice_id_status_t voice_id_stream_verify(const int16_t *frame, float *scores, int32_t *user)
+{
+    uint32_t num_samples = FE_AUDIO_LEN - stream_len;
+    bool full_window;
+    ifx_en_voice_id_status_t status;
+
+    num_samples = (num_samples < VOICE_ID_FRAME_SAMPLES) ? num_samples : VOICE_ID_FRAME_SAMPLES;
+    memcpy(&audio_for_embedding[stream_len], frame, num_samples * sizeof(int16_t));
+    stream_len += num_samples;
+
+    full_window = (stream_len >= FE_AUDIO_LEN);
+    if (!full_window && (stream_len < stream_checkpoint))
+    {
+        return IFX_VOICE_ID_INFERENCE_IN_PROGRESS;
+    }
+
+    if (!full_window)
+    {
+        /* Repeat the audio so far, the repetitions are overwritten by the
+         * following frames
+         */
+        for (uint32_t i = stream_len; i < FE_AUDIO_LEN; i++)
+        {
+            audio_for_embedding[i] = audio_for_embedding[i - stream_len];
+        }
+        stream_checkpoint += VOICE_ID_STREAM_HOP_MS * VOICE_ID_SAMPLES_PER_MS;
+    }
+
+    status = ifx_voice_id_run_inference(audio_for_embedding, embedding);
+    if (status != IFX_VOICE_ID_SUCCESS)
+    {
+        return status;
+    }
+
+    *user = verify_user(embedding, scores);
+    if (!full_window && (get_score_margin(scores, embeddings_data.user_count) < VOICE_ID_EARLY_EXIT_MARGIN))
+    {
+        return IFX_VOICE_ID_INFERENCE_IN_PROGRESS;
+    }
+    return IFX_VOICE_ID_INFERENCE_COMPLETE;
+}
+#endif /* VOICE_ID_STREAMING */
+
+
 /*******************************************************************************
 * Function Name: voice_id_task_init
 ********************************************************************************
@@ -145,8 +592,16 @@ void voice_id_task_init(void)
     }
 
     ifx_storage_read(&embeddings_data);
-    
+#ifdef VOICE_ID_CENTROID_ENGINE
+    voice_id_engine_build(&voice_id_engine, &embeddings_data);
+#endif /* VOICE_ID_CENTROID_ENGINE */
+    voice_id_storage_init(&embeddings_data);
+
     print_voice_id_info(&embeddings_data);
+
+#ifdef VOICE_ID_ENGINE_BENCHMARK
+    run_engine_benchmark();
+#endif /* VOICE_ID_ENGINE_BENCHMARK */
     
     rtos_task_status = xTaskCreate(voice_id_task, "Voice_ID_task",
                         VOICE_ID_TASK_STACK_SIZE, NULL, VOICE_ID_TASK_PRIORITY,
@@ -195,6 +650,7 @@ void voice_id_task(void * arg)
     int32_t max_idx = 0;
     uint32_t embedding_idx = 0;
     uint8_t enroll_init = 0;
+    float scores[IFX_MAX_SUPPORTED_USERS];
     
     
     ifx_en_voice_id_status_t ret = IFX_VOICE_ID_SUCCESS;
@@ -216,6 +672,14 @@ void voice_id_task(void * arg)
             {
                 voice_id_mode = IFX_VOICE_ID_ENROLL;
             } 
+
+#ifdef VOICE_ID_STREAMING
+            /* A verification starts with the first frame in verify mode */
+            if (voice_id_mode != IFX_VOICE_ID_VERIFY)
+            {
+                voice_id_stream_reset();
+            }
+#endif /* VOICE_ID_STREAMING */
             
             if (voice_id_mode == IFX_VOICE_ID_ENROLL)
             {
@@ -228,6 +692,7 @@ void voice_id_task(void * arg)
                     }
                     embedding_idx = 0;
                       enroll_init = 1;
+                      enroll_frames_dropped = vid_frames_dropped;
                       app_log_print("Voice ID - Enrolling User [%d], Speak for approx ~ %d seconds \r\n",new_user_idx, 2 * IFX_NUM_ENROLLMENT_EMBEDDINGS);
                 }
                 
@@ -240,7 +705,7 @@ void voice_id_task(void * arg)
                 }
                 if (ret == IFX_VOICE_ID_INFERENCE_COMPLETE && embedding_idx < IFX_NUM_ENROLLMENT_EMBEDDINGS)
                 {
-                    ifx_voice_id_add_embedding(&embeddings_data, embedding, new_user_idx, (uint8_t)embedding_idx);
+                    voice_id_embeddings_add(&embeddings_data, embedding, new_user_idx, (uint8_t)embedding_idx);
                     memset(&embedding, 0, sizeof(embedding));
                     embedding_idx++;
                 }
@@ -249,9 +714,13 @@ void voice_id_task(void * arg)
                     if (embeddings_data.user_count < IFX_MAX_SUPPORTED_USERS) {
                         embeddings_data.user_count++;
                     }
+#ifdef VOICE_ID_CENTROID_ENGINE
+                    voice_id_engine_update_user(&voice_id_engine, &embeddings_data, new_user_idx);
+                    voice_id_engine.user_count = embeddings_data.user_count;
+#endif /* VOICE_ID_CENTROID_ENGINE */
 
-            /* Save embeddings to flash */
-                    ifx_storage_write(&embeddings_data);
+            /* Save embeddings to flash in the background */
+                    (void)voice_id_storage_save_user(new_user_idx, enrollment_saved, (void *)(uintptr_t)new_user_idx);
                     app_log_print("\r\n Voice ID - User [%d] enrolled. \r\n",new_user_idx);
                     voice_id_mode = IFX_VOICE_ID_WAIT;
                     enroll_flag=0;
@@ -261,7 +730,11 @@ void voice_id_task(void * arg)
             }
             else if (voice_id_mode == IFX_VOICE_ID_VERIFY)
             {
+#ifdef VOICE_ID_STREAMING
+                ret = voice_id_stream_verify((int16_t*)vid_audio_data, scores, &max_idx);
+#else
                 ret = ifx_voice_id_infer((int16_t*)vid_audio_data, embedding);
+#endif /* VOICE_ID_STREAMING */
                 //app_log_print("Voice id inferencing %x \r\n",ret);
                 if (ret == IFX_VOICE_ID_LIMIT)
                 {
@@ -271,7 +744,16 @@ void voice_id_task(void * arg)
                 if (ret == IFX_VOICE_ID_INFERENCE_COMPLETE)
                 {
                     app_log_print("Voice ID - Verifying User... \r\n");
-                    max_idx=ifx_voice_id_verify(embedding,&embeddings_data);
+#ifdef VOICE_ID_STREAMING
+                    app_log_print("Voice ID - Decided after %u ms of audio \r\n",
+                        (unsigned)(stream_len / VOICE_ID_SAMPLES_PER_MS));
+                    voice_id_stream_reset();
+#else
+                    max_idx = verify_user(embedding, scores);
+#endif /* VOICE_ID_STREAMING */
+#ifdef VOICE_ID_ENGINE_CHECK
+                    check_engine_scores(embedding, scores);
+#endif /* VOICE_ID_ENGINE_CHECK */
                     if (max_idx>=0)
                     {
                         detected_user=max_idx;
@@ -302,7 +784,7 @@ void voice_id_task(void * arg)
 *
 *******************************************************************************/
 
-void print_voice_id_info(const ifx_voice_id_embeddings_t* embeddings)
+void print_voice_id_info(const voice_id_embeddings_t* embeddings)
 {
    
     if (embeddings == NULL) {
@@ -43,6 +43,8 @@ extern "C" {
 
 #include "ifx_voice_id.h"
 #include "ifx_storage.h"
+#include "voice_id_engine.h"
+#include "voice_id_storage.h"
 
 /*******************************************************************************
 * Macros
@@ -57,7 +59,7 @@ extern "C" {
  
 void voice_id_task_init(void);
 void voice_id_task(void * arg);
-void print_voice_id_info(const ifx_voice_id_embeddings_t* embeddings);
+void print_voice_id_info(const voice_id_embeddings_t* embeddings);
 
 void erase_enrolled_users(void);
 uint8_t get_enrolled_users(void);
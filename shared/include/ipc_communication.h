@@ -54,6 +54,8 @@
 #include "cybsp.h"
 #include "cy_pdl.h"
 #include "cy_ipc_pipe.h"
+#include "ipc_snippet.h"
+#include "ipc_trace.h"
 
 /*******************************************************************************
 * Macros
@@ -69,10 +71,14 @@
 /* IPC Pipe Endpoint-1 config */
 #define CY_IPC_CYPIPE_CHAN_MASK_EP1     CY_IPC_CH_MASK(CY_IPC_CHAN_CYPIPE_EP1)
 #define CY_IPC_CYPIPE_INTR_MASK_EP1     CY_IPC_INTR_MASK(CY_IPC_INTR_CYPIPE_EP1)
-#define CY_IPC_INTR_CYPIPE_PRIOR_EP1    (1UL)
+/* Not above configMAX_SYSCALL_INTERRUPT_PRIORITY (0x40) of the CM33: the
+ * callback wakes the app task, and critical sections mask it
+ */
+#define CY_IPC_INTR_CYPIPE_PRIOR_EP1    (2UL)
 #define CY_IPC_INTR_CYPIPE_MUX_EP1      (CY_IPC0_INTR_MUX(CY_IPC_INTR_CYPIPE_EP1))
 #define CM33_IPC_PIPE_EP_ADDR           (1UL)
 #define CM33_IPC_PIPE_CLIENT_ID         (3UL)
+#define CM33_IPC_PIPE_CTRL_CLIENT_ID    (4UL)   /* Control responses */
 
 /* IPC Pipe Endpoint-2 config */
 #define CY_IPC_CYPIPE_CHAN_MASK_EP2     CY_IPC_CH_MASK(CY_IPC_CHAN_CYPIPE_EP2)
@@ -80,7 +86,7 @@
 #define CY_IPC_INTR_CYPIPE_PRIOR_EP2    (1UL)
 #define CY_IPC_INTR_CYPIPE_MUX_EP2      (CY_IPC0_INTR_MUX(CY_IPC_INTR_CYPIPE_EP2))
 #define CM55_IPC_PIPE_EP_ADDR           (2UL)
-#define CM55_IPC_PIPE_CLIENT_ID         (5UL)
+#define CM55_IPC_PIPE_CLIENT_ID         (5UL)   /* Control requests */
 
 /* Combined Interrupt Mask */
 #define CY_IPC_CYPIPE_INTR_MASK         ( CY_IPC_CYPIPE_CHAN_MASK_EP1 | CY_IPC_CYPIPE_CHAN_MASK_EP2)
@@ -91,26 +97,220 @@
 #define IPC_CMD_WAKE_WORD_STR "WAKE"
 #define IPC_CMD_TIMEOUT_STR "TIMEOUT"
 
-/* The actual payload being sent via IPC. This will vary b etween applications */
+/* Event of a payload */
+typedef enum
+{
+    IPC_EVENT_NONE = 0,
+    IPC_EVENT_WAKE_WORD,
+    IPC_EVENT_COMMAND,
+    IPC_EVENT_TIMEOUT,
+    IPC_EVENT_MODEL_CHANGED,
+    IPC_EVENT_ERROR,
+    IPC_EVENT_LICENSE_EXPIRED,
+} ipc_event_type_t;
+
+/* Type of a variable of a command */
+typedef enum
+{
+    IPC_VARIABLE_PHRASE = 0,
+    IPC_VARIABLE_NUMBER,
+} ipc_variable_type_t;
+
+/* Variables of a command, VA_NLU_MAX_NUM_VARIABLES on the CM55 */
+#define IPC_EVENT_MAX_VARIABLES     (4u)
+
+/* ID not known, or not used by the event */
+#define IPC_EVENT_NO_ID             (0xFFFFu)
+#define IPC_EVENT_NO_UNIT           (0xFFu)
+#define IPC_EVENT_NO_MODEL          (0xFFu)
+
+/* Variable of a command. The IDs index the lists of the model set in
+ * va_string_table.h
+ */
 typedef struct {
-    bool        is_mic_active;
-    bool        has_event;
-    char        event[256];
-    char        intent_name[50];
-    /* Currently no support for units and only one parameter is supported */
-    char        intent_param1_str_var[50];
-    int32_t     intent_param1_int_var;
+    uint16_t    variable_id;    /* IPC_EVENT_NO_ID if not known */
+    uint8_t     type;           /* ipc_variable_type_t */
+    uint8_t     unit_id;        /* Unit phrase of a number, IPC_EVENT_NO_UNIT if none */
+    int32_t     value;          /* Variable phrase ID, or the number */
+} ipc_variable_t;
+
+/* The actual payload being sent via IPC. This will vary between applications.
+ * Events are sent as integer IDs, turned back into strings by the CM33
+ * with va_string_table.h.
+ */
+typedef struct {
+    uint32_t        seq;            /* Incremented by every message */
+    uint32_t        timestamp_ms;   /* CM55 time of the message */
+    uint8_t         event;          /* ipc_event_type_t */
+    bool            is_mic_active;
+    uint8_t         model_id;       /* Active model set, VA_STR_MODEL_<name> */
+    uint8_t         num_variables;  /* IPC_EVENT_COMMAND */
+    uint16_t        intent_id;      /* IPC_EVENT_COMMAND, IPC_EVENT_NO_ID otherwise */
+    uint16_t        reserved;
+    ipc_variable_t  variables[IPC_EVENT_MAX_VARIABLES];
+
+    /* CM55 trace times of a detection, ipc_trace_now_us() */
+    uint32_t        capture_us;     /* Audio frame of the detection captured */
+    uint32_t        process_us;     /* Start of its voice assistant processing */
+    uint32_t        detect_us;      /* End of its voice assistant processing */
+    uint32_t        send_us;        /* Event queued to the CM33 */
 } ipc_payload_t;
 
+/* Ring of the events sent by the CM55, in shared memory. Single producer
+ * (CM55) and single consumer (CM33): the indexes run freely, the producer
+ * writes head only and the consumer tail only. The CM55 data cache is
+ * maintained by hand, so every slot and both indexes have cache lines of
+ * their own.
+ */
+#define IPC_RING_SLOTS              (16u)   /* Power of 2 */
+#define IPC_CACHE_LINE_SIZE         (32u)
+#define IPC_RING_SLOT_SIZE          (64u)   /* ipc_payload_t rounded up to cache lines */
+
+typedef union
+{
+    ipc_payload_t   payload;
+    uint8_t         line[IPC_RING_SLOT_SIZE];
+} ipc_ring_slot_t;
+
+_Static_assert(sizeof(ipc_payload_t) <= IPC_RING_SLOT_SIZE, "ipc_payload_t does not fit in a ring slot");
+
+typedef struct
+{
+    /* Written by the CM55 */
+    volatile uint32_t   head;
+    volatile uint32_t   dropped;        /* Events dropped with the ring full */
+    uint8_t             head_line[IPC_CACHE_LINE_SIZE - (2u * sizeof(uint32_t))];
+
+    /* Written by the CM33 */
+    volatile uint32_t   tail;
+    uint8_t             tail_line[IPC_CACHE_LINE_SIZE - sizeof(uint32_t)];
+
+    ipc_ring_slot_t     slots[IPC_RING_SLOTS];
+} ipc_ring_t;
+
 /* IPC Message structure */
-/* Pointer to this structure will be shared through IPC Pipe */
+/* Pointer to this structure will be shared through IPC Pipe. It is the
+ * doorbell of the event ring: sent only when the ring gets its first event.
+ */
 typedef struct
 {
     uint8_t         client_id; /* This must be a part of the IPC structure */
     uint16_t        intr_mask; /* This must be a part of the IPC structure */
-    ipc_payload_t   payload;
+    ipc_ring_t      *ring;
+    ipc_snippet_channel_t *snippets; /* NULL without VA_AUDIO_SNIPPETS on the CM55 */
 } ipc_msg_t;
 
+/* Timeout of cm33_ipc_wait_for_message() */
+#define IPC_WAIT_FOREVER            (0xFFFFFFFFu)
+
+/* Counters of the event ring, as seen by each core */
+typedef struct
+{
+    uint32_t        events;         /* Events received by the CM33, queued by the CM55 */
+    uint32_t        doorbells;      /* IPC interrupts received by the CM33, sent by the CM55 */
+    uint32_t        dropped;        /* Events dropped by the CM55 with the ring full */
+} ipc_ring_stats_t;
+
+/* Control requests from the CM33 to the CM55 */
+typedef enum
+{
+    IPC_CTRL_SET_PDM_GAIN = 1,      /* value: gain in dB */
+    IPC_CTRL_SET_RUNNING_MODE,      /* value: va_mode_t of the CM55 */
+    IPC_CTRL_SET_COMMAND_TIMEOUT,   /* value: timeout in ms */
+    IPC_CTRL_START_ENROLLMENT,      /* Voice ID enrollment of a new user */
+    IPC_CTRL_GET_STATS,             /* Response carries ipc_ctrl_stats_t */
+    IPC_CTRL_SYNC_CLOCK,            /* Only the trace times of the response */
+} ipc_ctrl_type_t;
+
+typedef enum
+{
+    IPC_CTRL_STATUS_OK = 0,
+    IPC_CTRL_STATUS_INVALID_ARGUMENT,
+    IPC_CTRL_STATUS_NOT_SUPPORTED,  /* Feature not built into the CM55 */
+    IPC_CTRL_STATUS_FAILED,
+    IPC_CTRL_STATUS_TIMEOUT,        /* Set by the CM33: no response in time */
+    IPC_CTRL_STATUS_BUSY,           /* Received while an earlier request was handled */
+} ipc_ctrl_status_t;
+
+typedef struct
+{
+    uint16_t        id;             /* Correlation ID, returned in the response */
+    uint8_t         type;           /* ipc_ctrl_type_t */
+    uint8_t         reserved;
+    int32_t         value;
+} ipc_ctrl_request_t;
+
+/* Audio pipeline of the CM55. The frame counters and processing times are
+ * restarted by every IPC_CTRL_GET_STATS request.
+ */
+typedef struct
+{
+    uint32_t        uptime_ms;
+    uint32_t        frames_processed;   /* 10 ms frames run through the voice assistant */
+    uint32_t        frames_dropped;     /* Frames lost with the voice assistant queue full */
+    uint32_t        frame_time_avg_us;  /* Voice assistant processing time of a frame */
+    uint32_t        frame_time_max_us;
+    uint32_t        events_sent;        /* Events queued to the CM33, since start-up */
+    uint32_t        events_dropped;     /* Events lost with the event ring full, since start-up */
+    uint32_t        command_timeout_ms;
+    int8_t          pdm_gain_db;
+    uint8_t         running_mode;       /* va_mode_t of the CM55 */
+    uint8_t         model_id;           /* VA_STR_MODEL_<name> */
+    uint8_t         reserved;
+    uint32_t        snippets_sent;      /* Audio snippets handed to the CM33, since start-up */
+    uint32_t        snippets_dropped;   /* Audio snippets lost with no buffer free, since start-up */
+} ipc_ctrl_stats_t;
+
+typedef struct
+{
+    uint16_t        id;             /* ID of the request */
+    uint8_t         type;           /* Type of the request */
+    uint8_t         status;         /* ipc_ctrl_status_t */
+    uint32_t        rx_us;          /* CM55 trace time of the request received */
+    uint32_t        tx_us;          /* CM55 trace time of the response sent */
+    ipc_ctrl_stats_t stats;         /* IPC_CTRL_GET_STATS only */
+} ipc_ctrl_response_t;
+
+/* IPC messages of the control channel, one in flight in each direction */
+typedef struct
+{
+    uint8_t         client_id; /* This must be a part of the IPC structure */
+    uint16_t        intr_mask; /* This must be a part of the IPC structure */
+    ipc_ctrl_request_t request;
+} ipc_ctrl_request_msg_t;
+
+typedef struct
+{
+    uint8_t         client_id; /* This must be a part of the IPC structure */
+    uint16_t        intr_mask; /* This must be a part of the IPC structure */
+    ipc_ctrl_response_t response;
+} ipc_ctrl_response_msg_t;
+
+/*******************************************************************************
+* Inline functions
+*******************************************************************************/
+/* Writes data of the CM55 cache to the shared memory */
+__STATIC_INLINE void ipc_cache_clean(volatile void *addr, uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr(addr, (int32_t) size);
+#else
+    (void) addr;
+    (void) size;
+#endif
+}
+
+/* Drops data of the CM55 cache, to read the shared memory */
+__STATIC_INLINE void ipc_cache_invalidate(volatile void *addr, uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_InvalidateDCache_by_Addr(addr, (int32_t) size);
+#else
+    (void) addr;
+    (void) size;
+#endif
+}
+
 /*******************************************************************************
 * Function prototypes
 *******************************************************************************/
@@ -121,16 +321,81 @@ void cm55_ipc_pipe_isr(void);
 
 /* App functions for cm33 */
 bool cm33_ipc_has_received_message(void);
+
+/* Last state reported by the CM55: microphone and model set, without event */
 void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target);
 
-/* A mechanism through which the application can get the last recorded/cached detection.
-    Invoking this call will return true if there was a detection. 
-    Invoking this call will also clear the last detection if there was one in the first place.
-   */
-bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t* target);
+/* CM33 trace times of an event */
+typedef struct {
+    uint32_t        received_us;    /* Doorbell rung by the event, or the event read if it did not ring it */
+    uint32_t        read_us;        /* Event taken from the ring */
+} ipc_event_trace_t;
+
+/* Takes up to max_events events from the ring, in order, and returns how
+   many were taken. The ring is not signaled again while it is not empty:
+   call again while it returns max_events. traces can be NULL.
+*/
+uint32_t cm33_ipc_receive_events(ipc_payload_t* events, ipc_event_trace_t* traces, uint32_t max_events);
+
+/* Blocks the calling task until a message is received or the timeout expires.
+   Returns whether a message was received.
+*/
+bool cm33_ipc_wait_for_message(uint32_t timeout_ms);
+
+/* Time since a CM55 timestamp_ms, in CM33 milliseconds. Returns false until
+   the clocks of the cores are matched by a first doorbell.
+*/
+bool cm33_ipc_get_cm55_age_ms(uint32_t cm55_ms, uint32_t* age_ms);
+
+/* Oldest audio snippet handed over by the CM55, NULL if none. The same
+   snippet is returned until it is released, which gives its buffer back.
+*/
+ipc_snippet_desc_t* cm33_ipc_take_snippet(void);
+void cm33_ipc_release_snippet(ipc_snippet_desc_t* snippet);
+void cm33_ipc_get_ring_stats(ipc_ring_stats_t* stats);
+
+/* Sends a control request to the CM55 and waits for its response, for one
+   task at a time. Returns the status of the response, or
+   IPC_CTRL_STATUS_TIMEOUT. rtt_us is the round-trip time of the request.
+   Every response also matches the trace clocks of the cores.
+*/
+ipc_ctrl_status_t cm33_ipc_control_request(ipc_ctrl_type_t type, int32_t value,
+    ipc_ctrl_response_t* response, uint32_t timeout_ms, uint32_t* rtt_us);
+
+/* Matches the trace clocks of the cores with IPC_CTRL_SYNC_CLOCK requests.
+   Returns whether they are matched.
+*/
+bool cm33_ipc_sync_clock(uint32_t requests, uint32_t timeout_ms);
+
+/* Converts a CM55 trace time to the CM33 trace clock. Returns false until the
+   clocks are matched.
+*/
+bool cm33_ipc_cm55_to_cm33_us(uint32_t cm55_us, uint32_t* cm33_us);
+
+/* Offset of the CM55 trace clock from the CM33 one, and the round trip of
+   the request that gave it, without the CM55 processing: the offset is
+   within half of it.
+*/
+bool cm33_ipc_get_clock_offset(int32_t* offset_us, uint32_t* round_trip_us);
 
 /* App functions for cm55 */
 ipc_payload_t* cm55_ipc_get_payload_ptr(void);
 void cm55_ipc_send_to_cm33(void);
+void cm55_ipc_get_ring_stats(ipc_ring_stats_t* stats);
+
+/* Records the Voice Assistant input for the audio snippets of the events */
+void cm55_ipc_put_audio(const int16_t* samples, uint32_t count);
+void cm55_ipc_get_snippet_stats(uint32_t* sent, uint32_t* dropped);
+
+/* Takes the control request received from the CM33, if any */
+bool cm55_ipc_receive_control_request(ipc_ctrl_request_t* request, uint32_t* rx_us);
+
+/* Takes a control request received while the previous one was handled, if
+ * any. It is answered with IPC_CTRL_STATUS_BUSY.
+ */
+bool cm55_ipc_receive_rejected_control_request(ipc_ctrl_request_t* request);
+
+/* Returns false if the IPC channel is busy: try again later */
+bool cm55_ipc_send_control_response(const ipc_ctrl_response_t* response);
 
 #endif /* SOURCE_IPC_COMMUNICATION_H */
@@ -0,0 +1,155 @@
+/******************************************************************************
+* File Name : ipc_snippet.h
+*
+* Description :
+* Bulk channel of the audio snippets of the Voice Assistant events, from the
+* CM55 to the CM33
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef IPC_SNIPPET_H
+#define IPC_SNIPPET_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Audio around a wake word or command detection: the end of the detection is
+ * 1.5 s into the snippet. Mono 16-bit samples of the Voice Assistant input.
+ */
+#define IPC_SNIPPET_SAMPLE_RATE     (16000u)
+#define IPC_SNIPPET_PRE_MS          (1500u)
+#define IPC_SNIPPET_POST_MS         (500u)
+#define IPC_SNIPPET_SAMPLES         ((IPC_SNIPPET_SAMPLE_RATE / 1000u) * (IPC_SNIPPET_PRE_MS + IPC_SNIPPET_POST_MS))
+#define IPC_SNIPPET_PRE_SAMPLES     ((IPC_SNIPPET_SAMPLE_RATE / 1000u) * IPC_SNIPPET_PRE_MS)
+#define IPC_SNIPPET_POST_SAMPLES    ((IPC_SNIPPET_SAMPLE_RATE / 1000u) * IPC_SNIPPET_POST_MS)
+
+/* One buffer is recorded while the others are uploaded by the CM33. The
+ * buffers take IPC_SNIPPET_BUFFERS * IPC_SNIPPET_SAMPLES * 2 = 192000 bytes of
+ * SOCMEM, which can outweigh what VA_SHARED_MODEL_BUFFERS saves.
+ */
+#define IPC_SNIPPET_BUFFERS         (3u)
+
+/* Descriptor rounded up to cache lines, and the alignment of the buffers */
+#define IPC_SNIPPET_DESC_SIZE       (64u)
+#define IPC_SNIPPET_ALIGN           (32u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Owner of a snippet buffer and its descriptor */
+typedef enum
+{
+    IPC_SNIPPET_FREE = 0,           /* Recorded by the CM55 */
+    IPC_SNIPPET_READY,              /* Handed to the CM33, until it is released */
+} ipc_snippet_state_t;
+
+/* Snippet handed to the CM33. The audio is not copied: data points to the
+ * buffer of the CM55, a circular buffer that starts at sample start. Written
+ * by the owner only, as given by state.
+ */
+typedef struct
+{
+    volatile uint32_t   state;          /* ipc_snippet_state_t */
+    uint32_t            seq;            /* Sequence number of the event, as in ipc_payload_t */
+    uint32_t            timestamp_ms;   /* CM55 time of the event */
+    uint32_t            ready_ms;       /* CM55 time of the handover */
+    uint8_t             event;          /* ipc_event_type_t */
+    uint8_t             model_id;       /* VA_STR_MODEL_<name> */
+    uint16_t            reserved;
+    uint32_t            samples;        /* Samples recorded, up to IPC_SNIPPET_SAMPLES */
+    uint32_t            start;          /* Index of the first sample in data */
+    const int16_t       *data;
+} ipc_snippet_desc_t;
+
+typedef union
+{
+    ipc_snippet_desc_t  desc;
+    uint8_t             line[IPC_SNIPPET_DESC_SIZE];
+} ipc_snippet_slot_t;
+
+/* Descriptors in the shared memory, one per buffer */
+typedef struct
+{
+    ipc_snippet_slot_t  slots[IPC_SNIPPET_BUFFERS];
+} ipc_snippet_channel_t;
+
+/* Recorder of the CM55, in its own memory */
+typedef struct
+{
+    ipc_snippet_channel_t   *channel;
+    int16_t                 (*buffers)[IPC_SNIPPET_SAMPLES];
+    uint32_t                active;         /* Buffer being recorded */
+    uint32_t                write;          /* Next sample of the active buffer */
+    uint32_t                recorded;       /* Samples in the active buffer */
+    uint32_t                post_samples;   /* Still to record after the event, 0 if none pending */
+    ipc_snippet_desc_t      pending;        /* Event of the snippet being completed */
+
+    /* Since start-up */
+    uint32_t                snippets;       /* Handed to the CM33 */
+    uint32_t                dropped;        /* No buffer free: the CM33 is behind */
+    uint32_t                overlapped;     /* Event while the previous snippet was completed */
+} ipc_snippet_writer_t;
+
+/*******************************************************************************
+* Functions Prototypes
+*******************************************************************************/
+/* Cache maintenance of the shared memory, defined by each core. Clean also
+ * completes the memory accesses before it.
+ */
+void ipc_snippet_cache_clean(const volatile void *addr, uint32_t size);
+void ipc_snippet_cache_invalidate(const volatile void *addr, uint32_t size);
+
+/* CM55: records the audio and hands the snippets over */
+void ipc_snippet_writer_init(ipc_snippet_writer_t *writer, ipc_snippet_channel_t *channel,
+                             int16_t (*buffers)[IPC_SNIPPET_SAMPLES]);
+void ipc_snippet_write(ipc_snippet_writer_t *writer, const int16_t *samples, uint32_t count, uint32_t now_ms);
+bool ipc_snippet_trigger(ipc_snippet_writer_t *writer, uint32_t seq, uint32_t timestamp_ms,
+                         uint8_t event, uint8_t model_id);
+
+/* CM33: takes the oldest snippet handed over, reads it in place and releases it */
+ipc_snippet_desc_t* ipc_snippet_take(ipc_snippet_channel_t *channel);
+uint32_t ipc_snippet_get_samples(const ipc_snippet_desc_t *desc, uint32_t offset, uint32_t max_samples,
+                                 const int16_t **samples);
+void ipc_snippet_release(ipc_snippet_desc_t *desc);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* IPC_SNIPPET_H */
+
+/* [] END OF FILE */
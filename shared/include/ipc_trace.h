@@ -0,0 +1,88 @@
+/******************************************************************************
+* File Name : ipc_trace.h
+*
+* Description :
+* Microsecond time of each core, to trace the latency of the Voice Assistant
+* events from the capture of the audio to the MQTT publish
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef IPC_TRACE_H
+#define IPC_TRACE_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define IPC_TRACE_US_PER_TICK       (1000000u / configTICK_RATE_HZ)
+
+/*******************************************************************************
+* Inline functions
+*******************************************************************************/
+/* Trace time of the calling core, in us: the FreeRTOS tick count and the
+ * SysTick count within the tick. Unlike the DWT cycle counter, it keeps
+ * counting while the core sleeps. The cores have clocks of their own, matched
+ * by the CM33 with the control channel. Wraps after 71 minutes: only the
+ * differences are meaningful. Can be called from an ISR.
+ */
+__STATIC_INLINE uint32_t ipc_trace_now_us(void)
+{
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t reload = SysTick->LOAD + 1u;
+    uint32_t ticks = (uint32_t) xTaskGetTickCountFromISR();
+    uint32_t val = SysTick->VAL;
+
+    /* SysTick wrapped, and its tick is not counted yet */
+    if (0u != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        val = SysTick->VAL;
+        ticks++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+    return (ticks * IPC_TRACE_US_PER_TICK) +
+           (uint32_t) (((uint64_t) (reload - 1u - val) * IPC_TRACE_US_PER_TICK) / reload);
+}
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* IPC_TRACE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name : va_model_index.h
+*
+* Description :
+* Decoding index of the DEEPCRAFT Voice Assistant model sets
+* Generated by tools/va_string_table_gen.c from the *_config.c files of the
+* model sets. Do not edit.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef VA_MODEL_INDEX_H
+#define VA_MODEL_INDEX_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+
+#include "va_string_table.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Variables per command in the index, and the variable of a slot that differs
+ * between the commands of an intent
+ */
+#define VA_IDX_MAX_VARIABLE_SLOTS                                        (4u)
+#define VA_IDX_VARIABLE_UNKNOWN                                          (65535u)
+
+/* Smart_Lights_Demo */
+#define VA_IDX_Smart_Lights_Demo_NUM_COMMANDS                            (82u)
+#define VA_IDX_Smart_Lights_Demo_INTENT_MAP_SIZE                         (326u)
+
+/* LED_Demo */
+#define VA_IDX_LED_Demo_NUM_COMMANDS                                     (16u)
+#define VA_IDX_LED_Demo_INTENT_MAP_SIZE                                  (38u)
+
+/* Cooktop_Demo */
+#define VA_IDX_Cooktop_Demo_NUM_COMMANDS                                 (13u)
+#define VA_IDX_Cooktop_Demo_INTENT_MAP_SIZE                              (46u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Smart_Lights_Demo */
+extern const uint32_t va_index_Smart_Lights_Demo_command_offsets[VA_IDX_Smart_Lights_Demo_NUM_COMMANDS];
+extern const uint16_t va_index_Smart_Lights_Demo_phrase_variable[VA_STR_Smart_Lights_Demo_NUM_VARIABLE_PHRASES];
+extern const uint16_t va_index_Smart_Lights_Demo_variable_offsets[VA_STR_Smart_Lights_Demo_NUM_VARIABLES];
+extern const uint16_t va_index_Smart_Lights_Demo_intent_slot_variable[VA_STR_Smart_Lights_Demo_NUM_INTENTS][VA_IDX_MAX_VARIABLE_SLOTS];
+
+/* LED_Demo */
+extern const uint32_t va_index_LED_Demo_command_offsets[VA_IDX_LED_Demo_NUM_COMMANDS];
+extern const uint16_t va_index_LED_Demo_phrase_variable[VA_STR_LED_Demo_NUM_VARIABLE_PHRASES];
+extern const uint16_t va_index_LED_Demo_variable_offsets[VA_STR_LED_Demo_NUM_VARIABLES];
+extern const uint16_t va_index_LED_Demo_intent_slot_variable[VA_STR_LED_Demo_NUM_INTENTS][VA_IDX_MAX_VARIABLE_SLOTS];
+
+/* Cooktop_Demo */
+extern const uint32_t va_index_Cooktop_Demo_command_offsets[VA_IDX_Cooktop_Demo_NUM_COMMANDS];
+extern const uint16_t va_index_Cooktop_Demo_phrase_variable[VA_STR_Cooktop_Demo_NUM_VARIABLE_PHRASES];
+extern const uint16_t va_index_Cooktop_Demo_variable_offsets[VA_STR_Cooktop_Demo_NUM_VARIABLES];
+extern const uint16_t va_index_Cooktop_Demo_intent_slot_variable[VA_STR_Cooktop_Demo_NUM_INTENTS][VA_IDX_MAX_VARIABLE_SLOTS];
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* VA_MODEL_INDEX_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name : va_string_table.h
+*
+* Description :
+* IDs of the strings of the DEEPCRAFT Voice Assistant model sets
+* Generated by tools/va_string_table_gen.c from the *_config.c files of the
+* model sets. Do not edit.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef VA_STRING_TABLE_H
+#define VA_STRING_TABLE_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Model sets. A new model set is given the next ID, so that the IDs of the
+ * others do not change.
+ */
+#define VA_STR_MODEL_Smart_Lights_Demo                                   (0u)
+#define VA_STR_MODEL_LED_Demo                                            (1u)
+#define VA_STR_MODEL_Cooktop_Demo                                        (2u)
+#define VA_STR_NUM_MODELS                                                (3u)
+
+/* Most variables of a model set, to decode the variables of a command by
+ * their ID
+ */
+#define VA_STR_MAX_NUM_VARIABLES                                         (4u)
+
+/* Smart_Lights_Demo */
+#define VA_STR_Smart_Lights_Demo_NUM_INTENTS                             (4u)
+#define VA_STR_Smart_Lights_Demo_NUM_VARIABLES                           (3u)
+#define VA_STR_Smart_Lights_Demo_NUM_VARIABLE_PHRASES                    (7u)
+#define VA_STR_Smart_Lights_Demo_NUM_UNIT_PHRASES                        (16u)
+#define VA_STR_Smart_Lights_Demo_INTENT_TurnOnLights                     (0u)
+#define VA_STR_Smart_Lights_Demo_INTENT_TurnOffLights                    (1u)
+#define VA_STR_Smart_Lights_Demo_INTENT_TurnOnAllLights                  (2u)
+#define VA_STR_Smart_Lights_Demo_INTENT_ChangeLights                     (3u)
+#define VA_STR_Smart_Lights_Demo_VARIABLE_LocationLightsOn               (0u)
+#define VA_STR_Smart_Lights_Demo_VARIABLE_LocationLightsOff              (1u)
+#define VA_STR_Smart_Lights_Demo_VARIABLE_Intensity                      (2u)
+#define VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOn_kitchen         (0u)
+#define VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOn_bedroom         (1u)
+#define VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOn_living_room     (2u)
+#define VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOff_kitchen        (3u)
+#define VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOff_bedroom        (4u)
+#define VA_STR_Smart_Lights_Demo_PHRASE_LocationLightsOff_living_room    (5u)
+
+/* LED_Demo */
+#define VA_STR_LED_Demo_NUM_INTENTS                                      (6u)
+#define VA_STR_LED_Demo_NUM_VARIABLES                                    (1u)
+#define VA_STR_LED_Demo_NUM_VARIABLE_PHRASES                             (1u)
+#define VA_STR_LED_Demo_NUM_UNIT_PHRASES                                 (16u)
+#define VA_STR_LED_Demo_INTENT_TurnOnLight                               (0u)
+#define VA_STR_LED_Demo_INTENT_IncreaseBrightness                        (1u)
+#define VA_STR_LED_Demo_INTENT_DecreaseBrightness                        (2u)
+#define VA_STR_LED_Demo_INTENT_SetBrightness                             (3u)
+#define VA_STR_LED_Demo_INTENT_ToggleLight                               (4u)
+#define VA_STR_LED_Demo_INTENT_TurnOffLight                              (5u)
+#define VA_STR_LED_Demo_VARIABLE_Brightness                              (0u)
+
+/* Cooktop_Demo */
+#define VA_STR_Cooktop_Demo_NUM_INTENTS                                  (5u)
+#define VA_STR_Cooktop_Demo_NUM_VARIABLES                                (4u)
+#define VA_STR_Cooktop_Demo_NUM_VARIABLE_PHRASES                         (5u)
+#define VA_STR_Cooktop_Demo_NUM_UNIT_PHRASES                             (16u)
+#define VA_STR_Cooktop_Demo_INTENT_SetPower                              (0u)
+#define VA_STR_Cooktop_Demo_INTENT_SetHob                                (1u)
+#define VA_STR_Cooktop_Demo_INTENT_SetTemp                               (2u)
+#define VA_STR_Cooktop_Demo_INTENT_SetTimer                              (3u)
+#define VA_STR_Cooktop_Demo_INTENT_OffMic                                (4u)
+#define VA_STR_Cooktop_Demo_VARIABLE_OnOff                               (0u)
+#define VA_STR_Cooktop_Demo_VARIABLE_Hob                                 (1u)
+#define VA_STR_Cooktop_Demo_VARIABLE_Temp                                (2u)
+#define VA_STR_Cooktop_Demo_VARIABLE_Minutes                             (3u)
+#define VA_STR_Cooktop_Demo_PHRASE_OnOff_on                              (0u)
+#define VA_STR_Cooktop_Demo_PHRASE_OnOff_off                             (1u)
+
+/*******************************************************************************
+* Functions Prototypes
+*******************************************************************************/
+const char* va_string_table_model_name(uint8_t model_id);
+const char* va_string_table_intent(uint8_t model_id, uint16_t intent_id);
+const char* va_string_table_variable(uint8_t model_id, uint16_t variable_id);
+const char* va_string_table_phrase(uint8_t model_id, uint32_t phrase_id);
+const char* va_string_table_unit(uint8_t model_id, uint8_t unit_id);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* VA_STRING_TABLE_H */
+
+/* [] END OF FILE */
@@ -46,6 +46,8 @@
 #include <string.h>
 #include "cybsp.h"
 #include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
 
@@ -63,35 +65,117 @@ static cy_ipc_pipe_callback_ptr_t ep1_cb_array[CY_IPC_CYPIPE_CLIENT_CNT];
 CY_SECTION_SHAREDMEM
 static uint32_t ipc_sema_array[CY_IPC_SEMA_COUNT / CY_IPC_SEMA_PER_WORD];
 
-/* Local copy of the IPC message received
-   This copy is not safe to be accessed from a task.
-   A task must make its own copy of this structure
-   while guarding the copying with taskENTER_CRITICAL() and taskEXIT_CRITICAL()
+/* Event ring of the CM55, known from its first doorbell message */
+static ipc_ring_t* volatile ipc_ring = NULL;
+
+/* Audio snippets of the CM55, NULL if it does not send any */
+static ipc_snippet_channel_t* volatile ipc_snippets = NULL;
+
+/* Last state reported by the CM55, without its event.
+   Guarded with taskENTER_CRITICAL() and taskEXIT_CRITICAL()
 */
-static ipc_msg_t ipc_recv_msg = {0};
-static ipc_payload_t ipc_last_detection_payload = {0};
-static bool ipc_has_saved_detection = false; // will be set upon receipt. reset when value is checked
+static ipc_payload_t ipc_last_payload = {0};
+static uint32_t ipc_events = 0;
+static volatile uint32_t ipc_doorbells = 0;
 static bool ipc_has_received_message = false; // will be set upon receipt. reset when value is checked
 
+/* Task woken by the doorbell, set by cm33_ipc_wait_for_message() */
+static TaskHandle_t volatile ipc_notify_task = NULL;
+
+/* CM33 time of the last doorbell, to match the timestamps of the CM55 with
+   the time of the CM33. The event that rings the doorbell is the first one
+   read after it, or an older one: the largest difference seen is the offset
+   between the clocks of the cores.
+*/
+static uint32_t ipc_doorbell_ms = 0;
+static uint32_t ipc_doorbell_us = 0;
+static bool ipc_doorbell_pending = false;
+static uint32_t ipc_clock_offset_ms = 0;
+static bool ipc_clock_synced = false;
+
+/* Control channel: request sent to the CM55, and the last response received.
+   The request buffer is not reused until the CM55 has released it.
+*/
+CY_SECTION_SHAREDMEM CY_ALIGN(IPC_CACHE_LINE_SIZE) static ipc_ctrl_request_msg_t ipc_ctrl_msg;
+static volatile bool ipc_ctrl_msg_in_flight = false;
+static ipc_ctrl_response_t ipc_ctrl_response;
+static SemaphoreHandle_t ipc_ctrl_response_sem = NULL;
+static uint16_t ipc_ctrl_id = 0;
+static uint32_t ipc_ctrl_response_us = 0; // CM33 trace time of the response received
+
+/* Trace clock of the CM55 matched with the control responses, NTP style: the
+   offset of the request with the shortest round trip is kept, and replaced
+   by a later one after IPC_CLOCK_SYNC_MAX_AGE_US, to follow the drift.
+*/
+#define IPC_CLOCK_SYNC_MAX_AGE_US   (60u * 1000000u)
+static int32_t ipc_trace_offset_us = 0; // CM55 minus CM33
+static uint32_t ipc_trace_round_trip_us = 0;
+static uint32_t ipc_trace_synced_us = 0;
+static bool ipc_trace_synced = false;
+
 
 /*******************************************************************************
-* Function Name: cm33_ipc_pipe_isr
+* Function Name: cm33_msg_callback
 ********************************************************************************
-* Callback for receipt of message from cm55
+* Callback for receipt of message from cm55: the event ring is not empty
+* any more. The events are taken from the ring by cm33_ipc_receive_events(),
+* in the task woken here.
 *******************************************************************************/
 static void cm33_msg_callback(uint32_t * msg_data)
 {
     if (msg_data != NULL) {
-        /* Copy the message received into our own copy IPC structure */
-        memcpy(&ipc_recv_msg, (void *) msg_data, sizeof(ipc_recv_msg));
-        if (ipc_recv_msg.payload.has_event) {
-            memcpy(&ipc_last_detection_payload, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-            ipc_has_saved_detection = true;
+        ipc_ring = ((ipc_msg_t *) msg_data)->ring;
+        ipc_snippets = ((ipc_msg_t *) msg_data)->snippets;
+        ipc_doorbells++;
+        ipc_doorbell_ms = (uint32_t) (xTaskGetTickCountFromISR() * portTICK_PERIOD_MS);
+        ipc_doorbell_us = ipc_trace_now_us();
+        ipc_doorbell_pending = true;
+        ipc_has_received_message = true;
+
+        TaskHandle_t task = ipc_notify_task;
+        if (task != NULL) {
+            BaseType_t higher_priority_task_woken = pdFALSE;
+            vTaskNotifyGiveFromISR(task, &higher_priority_task_woken);
+            portYIELD_FROM_ISR(higher_priority_task_woken);
         }
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm33_ctrl_callback
+********************************************************************************
+* Callback for receipt of a control response from cm55. The CM55 does not
+* ring the doorbell while the response holds the IPC channel, so the task
+* waiting for messages is woken as well, to drain the event ring.
+*******************************************************************************/
+static void cm33_ctrl_callback(uint32_t * msg_data)
+{
+    if (msg_data != NULL) {
+        BaseType_t higher_priority_task_woken = pdFALSE;
+
+        ipc_ctrl_response_us = ipc_trace_now_us();
+        memcpy(&ipc_ctrl_response, &((ipc_ctrl_response_msg_t *) msg_data)->response, sizeof(ipc_ctrl_response_t));
         ipc_has_received_message = true;
+
+        TaskHandle_t task = ipc_notify_task;
+        if (task != NULL) {
+            vTaskNotifyGiveFromISR(task, &higher_priority_task_woken);
+        }
+        xSemaphoreGiveFromISR(ipc_ctrl_response_sem, &higher_priority_task_woken);
+        portYIELD_FROM_ISR(higher_priority_task_woken);
     }
 }
 
+/*******************************************************************************
+* Function Name: cm33_ctrl_release_callback
+********************************************************************************
+* Called when the CM55 has taken the control request.
+*******************************************************************************/
+static void cm33_ctrl_release_callback(void)
+{
+    ipc_ctrl_msg_in_flight = false;
+}
+
 /*******************************************************************************
 * Function Name: cm33_ipc_pipe_isr
 ********************************************************************************
@@ -173,6 +257,17 @@ void cm33_ipc_communication_setup(void)
         handle_app_error();
     }
 
+    /* Register a callback function to handle the control responses of the CM55 */
+    pipe_status = Cy_IPC_Pipe_RegisterCallback(CM33_IPC_PIPE_EP_ADDR, &cm33_ctrl_callback,
+                                              (uint32_t)CM33_IPC_PIPE_CTRL_CLIENT_ID);
+    if (CY_IPC_PIPE_SUCCESS != pipe_status) {
+        handle_app_error();
+    }
+
+    ipc_ctrl_response_sem = xSemaphoreCreateBinary();
+    if (ipc_ctrl_response_sem == NULL) {
+        handle_app_error();
+    }
 }
 
 bool cm33_ipc_has_received_message(void)
@@ -187,22 +282,278 @@ bool cm33_ipc_has_received_message(void)
 void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target)
 {
     taskENTER_CRITICAL();
-    memcpy(target, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
+    memcpy(target, &ipc_last_payload, sizeof(ipc_payload_t));
     taskEXIT_CRITICAL();
 }
 
-bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t* target)
+bool cm33_ipc_wait_for_message(uint32_t timeout_ms)
+{
+    ipc_notify_task = xTaskGetCurrentTaskHandle();
+
+    if (cm33_ipc_has_received_message()) {
+        (void) ulTaskNotifyTake(pdTRUE, 0); // received before this call, drop its notification
+        return true;
+    }
+    (void) ulTaskNotifyTake(pdTRUE, (timeout_ms == IPC_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+    return cm33_ipc_has_received_message();
+}
+
+uint32_t cm33_ipc_receive_events(ipc_payload_t* events, ipc_event_trace_t* traces, uint32_t max_events)
 {
+    ipc_ring_t *ring = ipc_ring;
+    uint32_t count = 0;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t doorbell_ms;
+    uint32_t doorbell_us;
+    uint32_t doorbells;
+    bool doorbell_pending;
+
+    if (ring == NULL) {
+        return 0;
+    }
+
+    // a doorbell seen before the ring is read has its event read below
     taskENTER_CRITICAL();
-    if (ipc_has_saved_detection) {
-        memcpy(target, &ipc_last_detection_payload, sizeof(ipc_payload_t));
-        ipc_has_saved_detection = false;
+    doorbells = ipc_doorbells;
+    doorbell_ms = ipc_doorbell_ms;
+    doorbell_us = ipc_doorbell_us;
+    doorbell_pending = ipc_doorbell_pending;
+    taskEXIT_CRITICAL();
+
+    tail = ring->tail;
+    while (count < max_events) {
+        ipc_cache_invalidate(&ring->head, IPC_CACHE_LINE_SIZE);
+        head = ring->head;
+        if (head == tail) {
+            break;
+        }
+        __DMB(); // read the slots after head
+
+        while ((tail != head) && (count < max_events)) {
+            ipc_ring_slot_t *slot = &ring->slots[tail % IPC_RING_SLOTS];
+            ipc_cache_invalidate(slot, IPC_RING_SLOT_SIZE);
+            memcpy(&events[count], &slot->payload, sizeof(ipc_payload_t));
+            if (traces != NULL) {
+                // the first event read after a doorbell is the one that rang it
+                traces[count].read_us = ipc_trace_now_us();
+                traces[count].received_us = (doorbell_pending && (count == 0)) ? doorbell_us : traces[count].read_us;
+            }
+            count++;
+            tail++;
+        }
+
+        // free the slots, then look for events queued meanwhile:
+        // the CM55 only rings the doorbell for an empty ring
+        __DMB();
+        ring->tail = tail;
+        ipc_cache_clean(&ring->tail, IPC_CACHE_LINE_SIZE);
+        __DSB();
+    }
+
+    if (count > 0) {
+        taskENTER_CRITICAL();
+        memcpy(&ipc_last_payload, &events[count - 1], sizeof(ipc_payload_t));
+        ipc_last_payload.event = IPC_EVENT_NONE;
+        ipc_last_payload.intent_id = IPC_EVENT_NO_ID;
+        ipc_last_payload.num_variables = 0;
+        ipc_events += count;
+        if (doorbell_pending && (doorbells == ipc_doorbells)) {
+            ipc_doorbell_pending = false;
+        }
         taskEXIT_CRITICAL();
-        return true;
-    } else { 
-        // else use the last payload - it will not have an event
-        memcpy(target, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
+
+        if (doorbell_pending) {
+            uint32_t offset_ms = doorbell_ms - events[0].timestamp_ms;
+            if (!ipc_clock_synced || ((int32_t) (offset_ms - ipc_clock_offset_ms) > 0)) {
+                ipc_clock_offset_ms = offset_ms;
+                ipc_clock_synced = true;
+            }
+        }
+    }
+    return count;
+}
+
+bool cm33_ipc_get_cm55_age_ms(uint32_t cm55_ms, uint32_t* age_ms)
+{
+    if (!ipc_clock_synced) {
+        return false;
+    }
+    uint32_t now_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+    int32_t age = (int32_t) (now_ms - (cm55_ms + ipc_clock_offset_ms));
+    *age_ms = (age > 0) ? (uint32_t) age : 0;
+    return true;
+}
+
+ipc_snippet_desc_t* cm33_ipc_take_snippet(void)
+{
+    ipc_snippet_channel_t *channel = ipc_snippets;
+    return (channel != NULL) ? ipc_snippet_take(channel) : NULL;
+}
+
+void cm33_ipc_release_snippet(ipc_snippet_desc_t* snippet)
+{
+    ipc_snippet_release(snippet);
+}
+
+/* The CM33 has no data cache for the shared memory: only the order of the accesses matters */
+void ipc_snippet_cache_clean(const volatile void *addr, uint32_t size)
+{
+    ipc_cache_clean((volatile void *) addr, size);
+    __DMB();
+}
+
+void ipc_snippet_cache_invalidate(const volatile void *addr, uint32_t size)
+{
+    ipc_cache_invalidate((volatile void *) addr, size);
+}
+
+void cm33_ipc_get_ring_stats(ipc_ring_stats_t* stats)
+{
+    ipc_ring_t *ring = ipc_ring;
+
+    taskENTER_CRITICAL();
+    stats->events = ipc_events;
+    stats->doorbells = ipc_doorbells;
+    taskEXIT_CRITICAL();
+    if (ring != NULL) {
+        ipc_cache_invalidate(&ring->head, IPC_CACHE_LINE_SIZE);
+        stats->dropped = ring->dropped;
+    } else {
+        stats->dropped = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: update_clock_offset
+********************************************************************************
+* Matches the trace clock of the CM55 with the times of a control request:
+* sent and received by the CM33, received and answered by the CM55. The
+* processing time of the CM55 is taken out of the round trip, and the offset
+* is the one of the middle of both.
+*******************************************************************************/
+static void update_clock_offset(uint32_t send_us, uint32_t receive_us, const ipc_ctrl_response_t* response)
+{
+    uint32_t round_trip_us = (receive_us - send_us) - (response->tx_us - response->rx_us);
+    int32_t offset_us = ((int32_t) (response->rx_us - send_us) + (int32_t) (response->tx_us - receive_us)) / 2;
+
+    if (!ipc_trace_synced || (round_trip_us <= ipc_trace_round_trip_us) ||
+        ((receive_us - ipc_trace_synced_us) > IPC_CLOCK_SYNC_MAX_AGE_US)) {
+        taskENTER_CRITICAL();
+        ipc_trace_offset_us = offset_us;
+        ipc_trace_round_trip_us = round_trip_us;
+        ipc_trace_synced_us = receive_us;
+        ipc_trace_synced = true;
         taskEXIT_CRITICAL();
+    }
+}
+
+bool cm33_ipc_cm55_to_cm33_us(uint32_t cm55_us, uint32_t* cm33_us)
+{
+    int32_t offset_us;
+
+    if (!cm33_ipc_get_clock_offset(&offset_us, NULL)) {
         return false;
     }
+    *cm33_us = cm55_us - (uint32_t) offset_us;
+    return true;
+}
+
+bool cm33_ipc_get_clock_offset(int32_t* offset_us, uint32_t* round_trip_us)
+{
+    bool synced;
+
+    taskENTER_CRITICAL();
+    synced = ipc_trace_synced;
+    *offset_us = ipc_trace_offset_us;
+    if (round_trip_us != NULL) {
+        *round_trip_us = ipc_trace_round_trip_us;
+    }
+    taskEXIT_CRITICAL();
+    return synced;
+}
+
+bool cm33_ipc_sync_clock(uint32_t requests, uint32_t timeout_ms)
+{
+    ipc_ctrl_response_t response;
+
+    for (uint32_t i = 0; i < requests; i++) {
+        (void) cm33_ipc_control_request(IPC_CTRL_SYNC_CLOCK, 0, &response, timeout_ms, NULL);
+    }
+    return ipc_trace_synced;
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_control_request
+********************************************************************************
+* Sends a control request to the CM55 and waits for the response with the
+* same correlation ID. A response to an earlier request that timed out is
+* skipped. The CM55 handles the request with the next audio frame.
+*******************************************************************************/
+ipc_ctrl_status_t cm33_ipc_control_request(ipc_ctrl_type_t type, int32_t value,
+    ipc_ctrl_response_t* response, uint32_t timeout_ms, uint32_t* rtt_us)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    uint32_t send_us;
+    uint32_t receive_us;
+    cy_en_ipc_pipe_status_t pipe_status;
+    uint16_t id = ++ipc_ctrl_id;
+
+    // the previous request may still be held by the CM55 if it timed out
+    while (ipc_ctrl_msg_in_flight) {
+        if ((xTaskGetTickCount() - start) >= timeout) {
+            return IPC_CTRL_STATUS_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+    (void) xSemaphoreTake(ipc_ctrl_response_sem, 0); // late response of a previous request
+
+    ipc_ctrl_msg.client_id = CM55_IPC_PIPE_CLIENT_ID;
+    ipc_ctrl_msg.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP1;
+    ipc_ctrl_msg.request.id = id;
+    ipc_ctrl_msg.request.type = (uint8_t) type;
+    ipc_ctrl_msg.request.reserved = 0;
+    ipc_ctrl_msg.request.value = value;
+    ipc_cache_clean(&ipc_ctrl_msg, sizeof(ipc_ctrl_msg));
+    __DSB();
+
+    for (;;) {
+        ipc_ctrl_msg_in_flight = true;
+        send_us = ipc_trace_now_us();
+        pipe_status = Cy_IPC_Pipe_SendMessage(CM55_IPC_PIPE_EP_ADDR,
+                                 CM33_IPC_PIPE_EP_ADDR,
+                                 (void *) &ipc_ctrl_msg, &cm33_ctrl_release_callback);
+        if (CY_IPC_PIPE_SUCCESS == pipe_status) {
+            break;
+        }
+        ipc_ctrl_msg_in_flight = false;
+        if (CY_IPC_PIPE_ERROR_SEND_BUSY != pipe_status) {
+            handle_app_error();
+        }
+        if ((xTaskGetTickCount() - start) >= timeout) {
+            return IPC_CTRL_STATUS_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+
+    for (;;) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if ((elapsed >= timeout) || (pdTRUE != xSemaphoreTake(ipc_ctrl_response_sem, timeout - elapsed))) {
+            return IPC_CTRL_STATUS_TIMEOUT;
+        }
+        taskENTER_CRITICAL();
+        memcpy(response, &ipc_ctrl_response, sizeof(ipc_ctrl_response_t));
+        receive_us = ipc_ctrl_response_us;
+        taskEXIT_CRITICAL();
+        if (response->id == id) {
+            break;
+        }
+    }
+
+    update_clock_offset(send_us, receive_us, response);
+    if (rtt_us != NULL) {
+        *rtt_us = receive_us - send_us;
+    }
+    return (ipc_ctrl_status_t) response->status;
 }
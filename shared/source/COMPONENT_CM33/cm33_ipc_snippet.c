@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name : cm33_ipc_snippet.c
+*
+* Description :
+* Reader of the audio snippets of the Voice Assistant events, in place in the
+* buffers of the CM55
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stddef.h>
+
+#include "ipc_snippet.h"
+
+/*******************************************************************************
+* Function Name: ipc_snippet_take
+********************************************************************************
+* Summary:
+*  Returns the oldest snippet handed over by the CM55. The same snippet is
+*  returned until it is released.
+*
+* Parameters:
+*  channel: descriptors, in the shared memory
+*
+* Return:
+*  The snippet, or NULL if none is ready
+*
+*******************************************************************************/
+ipc_snippet_desc_t* ipc_snippet_take(ipc_snippet_channel_t *channel)
+{
+    ipc_snippet_desc_t *oldest = NULL;
+
+    for (uint32_t i = 0u; i < IPC_SNIPPET_BUFFERS; i++)
+    {
+        ipc_snippet_desc_t *desc = &channel->slots[i].desc;
+
+        ipc_snippet_cache_invalidate(desc, IPC_SNIPPET_DESC_SIZE);
+        if ((IPC_SNIPPET_READY == desc->state) &&
+            ((NULL == oldest) || ((int32_t) (desc->seq - oldest->seq) < 0)))
+        {
+            oldest = desc;
+        }
+    }
+    return oldest;
+}
+
+/*******************************************************************************
+* Function Name: ipc_snippet_get_samples
+********************************************************************************
+* Summary:
+*  Gives the samples of a snippet from an offset, in place in the buffer of
+*  the CM55. They are contiguous up to the wrap of the circular buffer.
+*
+* Parameters:
+*  desc: snippet taken
+*  offset: first sample, from the start of the snippet
+*  max_samples: largest number of samples wanted
+*  samples: set to the first sample
+*
+* Return:
+*  Number of samples, 0 at the end of the snippet
+*
+*******************************************************************************/
+uint32_t ipc_snippet_get_samples(const ipc_snippet_desc_t *desc, uint32_t offset, uint32_t max_samples,
+                                 const int16_t **samples)
+{
+    uint32_t index;
+    uint32_t count;
+
+    if (offset >= desc->samples)
+    {
+        return 0u;
+    }
+
+    index = (desc->start + offset) % IPC_SNIPPET_SAMPLES;
+    count = desc->samples - offset;
+    if (count > (IPC_SNIPPET_SAMPLES - index))
+    {
+        count = IPC_SNIPPET_SAMPLES - index;
+    }
+    if (count > max_samples)
+    {
+        count = max_samples;
+    }
+
+    *samples = &desc->data[index];
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: ipc_snippet_release
+********************************************************************************
+* Summary:
+*  Gives the buffer of a snippet back to the CM55. Its samples must not be
+*  read any more.
+*
+* Parameters:
+*  desc: snippet taken
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void ipc_snippet_release(ipc_snippet_desc_t *desc)
+{
+    /* The samples are read before the state changes */
+    ipc_snippet_cache_clean(desc, IPC_SNIPPET_DESC_SIZE);
+    desc->state = IPC_SNIPPET_FREE;
+    ipc_snippet_cache_clean(desc, IPC_SNIPPET_DESC_SIZE);
+}
+
+/* [] END OF FILE */
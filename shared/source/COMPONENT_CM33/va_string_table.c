@@ -0,0 +1,312 @@
+/******************************************************************************
+* File Name : va_string_table.c
+*
+* Description :
+* Strings of the DEEPCRAFT Voice Assistant model sets, by ID
+* Generated by tools/va_string_table_gen.c from the *_config.c files of the
+* model sets. Do not edit.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stddef.h>
+
+#include "va_string_table.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    const char          *name;
+    const char *const   *intents;
+    uint16_t            num_intents;
+    uint16_t            num_variables;
+    const char *const   *variables;
+    const char *const   *phrases;
+    uint32_t            num_phrases;
+    const char *const   *units;
+    uint32_t            num_units;
+} va_string_table_set_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const Smart_Lights_Demo_intents[] =
+{
+    "TurnOnLights",
+    "TurnOffLights",
+    "TurnOnAllLights",
+    "ChangeLights",
+};
+
+static const char *const Smart_Lights_Demo_variables[] =
+{
+    "LocationLightsOn",
+    "LocationLightsOff",
+    "Intensity",
+};
+
+static const char *const Smart_Lights_Demo_phrases[] =
+{
+    "kitchen",
+    "bedroom",
+    "living room",
+    "kitchen",
+    "bedroom",
+    "living room",
+    "",
+};
+
+static const char *const Smart_Lights_Demo_units[] =
+{
+    "degree",
+    "degrees",
+    "percent",
+    "level",
+    "levels",
+    "hour",
+    "hours",
+    "minute",
+    "minutes",
+    "second",
+    "seconds",
+    "day",
+    "days",
+    "",
+    "AM",
+    "PM",
+};
+
+static const char *const LED_Demo_intents[] =
+{
+    "TurnOnLight",
+    "IncreaseBrightness",
+    "DecreaseBrightness",
+    "SetBrightness",
+    "ToggleLight",
+    "TurnOffLight",
+};
+
+static const char *const LED_Demo_variables[] =
+{
+    "Brightness",
+};
+
+static const char *const LED_Demo_phrases[] =
+{
+    "",
+};
+
+static const char *const LED_Demo_units[] =
+{
+    "degree",
+    "degrees",
+    "percent",
+    "level",
+    "levels",
+    "hour",
+    "hours",
+    "minute",
+    "minutes",
+    "second",
+    "seconds",
+    "day",
+    "days",
+    "",
+    "AM",
+    "PM",
+};
+
+static const char *const Cooktop_Demo_intents[] =
+{
+    "SetPower",
+    "SetHob",
+    "SetTemp",
+    "SetTimer",
+    "OffMic",
+};
+
+static const char *const Cooktop_Demo_variables[] =
+{
+    "OnOff",
+    "Hob",
+    "Temp",
+    "Minutes",
+};
+
+static const char *const Cooktop_Demo_phrases[] =
+{
+    "on",
+    "off",
+    "",
+    "",
+    "",
+};
+
+static const char *const Cooktop_Demo_units[] =
+{
+    "degree",
+    "degrees",
+    "percent",
+    "level",
+    "levels",
+    "hour",
+    "hours",
+    "minute",
+    "minutes",
+    "second",
+    "seconds",
+    "day",
+    "days",
+    "",
+    "AM",
+    "PM",
+};
+
+static const va_string_table_set_t va_string_table_sets[VA_STR_NUM_MODELS] =
+{
+    [VA_STR_MODEL_Smart_Lights_Demo] =
+    {
+        .name           = "Smart_Lights_Demo",
+        .intents        = Smart_Lights_Demo_intents,
+        .num_intents    = VA_STR_Smart_Lights_Demo_NUM_INTENTS,
+        .num_variables  = VA_STR_Smart_Lights_Demo_NUM_VARIABLES,
+        .variables      = Smart_Lights_Demo_variables,
+        .phrases        = Smart_Lights_Demo_phrases,
+        .num_phrases    = VA_STR_Smart_Lights_Demo_NUM_VARIABLE_PHRASES,
+        .units          = Smart_Lights_Demo_units,
+        .num_units      = VA_STR_Smart_Lights_Demo_NUM_UNIT_PHRASES,
+    },
+    [VA_STR_MODEL_LED_Demo] =
+    {
+        .name           = "LED_Demo",
+        .intents        = LED_Demo_intents,
+        .num_intents    = VA_STR_LED_Demo_NUM_INTENTS,
+        .num_variables  = VA_STR_LED_Demo_NUM_VARIABLES,
+        .variables      = LED_Demo_variables,
+        .phrases        = LED_Demo_phrases,
+        .num_phrases    = VA_STR_LED_Demo_NUM_VARIABLE_PHRASES,
+        .units          = LED_Demo_units,
+        .num_units      = VA_STR_LED_Demo_NUM_UNIT_PHRASES,
+    },
+    [VA_STR_MODEL_Cooktop_Demo] =
+    {
+        .name           = "Cooktop_Demo",
+        .intents        = Cooktop_Demo_intents,
+        .num_intents    = VA_STR_Cooktop_Demo_NUM_INTENTS,
+        .num_variables  = VA_STR_Cooktop_Demo_NUM_VARIABLES,
+        .variables      = Cooktop_Demo_variables,
+        .phrases        = Cooktop_Demo_phrases,
+        .num_phrases    = VA_STR_Cooktop_Demo_NUM_VARIABLE_PHRASES,
+        .units          = Cooktop_Demo_units,
+        .num_units      = VA_STR_Cooktop_Demo_NUM_UNIT_PHRASES,
+    },
+};
+
+/*******************************************************************************
+ * Function Name: va_string_table_model_name
+ *******************************************************************************
+ * Summary:
+ * Returns the name of a model set, NULL if the ID is unknown.
+ *
+ *******************************************************************************/
+const char* va_string_table_model_name(uint8_t model_id)
+{
+    return (model_id < VA_STR_NUM_MODELS) ? va_string_table_sets[model_id].name : NULL;
+}
+
+/*******************************************************************************
+ * Function Name: va_string_table_intent
+ *******************************************************************************
+ * Summary:
+ * Returns the name of an intent of a model set, NULL if an ID is unknown.
+ *
+ *******************************************************************************/
+const char* va_string_table_intent(uint8_t model_id, uint16_t intent_id)
+{
+    if ((model_id >= VA_STR_NUM_MODELS) || (intent_id >= va_string_table_sets[model_id].num_intents))
+    {
+        return NULL;
+    }
+    return va_string_table_sets[model_id].intents[intent_id];
+}
+
+/*******************************************************************************
+ * Function Name: va_string_table_variable
+ *******************************************************************************
+ * Summary:
+ * Returns the name of a variable of a model set, NULL if an ID is unknown.
+ *
+ *******************************************************************************/
+const char* va_string_table_variable(uint8_t model_id, uint16_t variable_id)
+{
+    if ((model_id >= VA_STR_NUM_MODELS) || (variable_id >= va_string_table_sets[model_id].num_variables))
+    {
+        return NULL;
+    }
+    return va_string_table_sets[model_id].variables[variable_id];
+}
+
+/*******************************************************************************
+ * Function Name: va_string_table_phrase
+ *******************************************************************************
+ * Summary:
+ * Returns a variable phrase of a model set, NULL if an ID is unknown.
+ *
+ *******************************************************************************/
+const char* va_string_table_phrase(uint8_t model_id, uint32_t phrase_id)
+{
+    if ((model_id >= VA_STR_NUM_MODELS) || (phrase_id >= va_string_table_sets[model_id].num_phrases))
+    {
+        return NULL;
+    }
+    return va_string_table_sets[model_id].phrases[phrase_id];
+}
+
+/*******************************************************************************
+ * Function Name: va_string_table_unit
+ *******************************************************************************
+ * Summary:
+ * Returns a unit phrase of a model set, NULL if an ID is unknown.
+ *
+ *******************************************************************************/
+const char* va_string_table_unit(uint8_t model_id, uint8_t unit_id)
+{
+    if ((model_id >= VA_STR_NUM_MODELS) || (unit_id >= va_string_table_sets[model_id].num_units))
+    {
+        return NULL;
+    }
+    return va_string_table_sets[model_id].units[unit_id];
+}
+
+/* [] END OF FILE */
@@ -43,8 +43,13 @@
  * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
  */
 
+#include <string.h>
+
 #include "ipc_communication.h"
 
+#include "FreeRTOS.h"
+#include "task.h"
+
 /*******************************************************************************
 * Global Variable(s)
 *******************************************************************************/
@@ -54,7 +59,50 @@ static cy_stc_ipc_pipe_ep_t cm55_ipc_pipe_array[CY_IPC_MAX_ENDPOINTS];
 /* CB Array for EP2 */
 static cy_ipc_pipe_callback_ptr_t ep2_cb_array[CY_IPC_CYPIPE_CLIENT_CNT];
 
-CY_SECTION_SHAREDMEM static ipc_msg_t cm55_msg_data;
+/* Doorbell message and event ring, read by the CM33 */
+CY_SECTION_SHAREDMEM CY_ALIGN(IPC_CACHE_LINE_SIZE) static ipc_msg_t cm55_msg_data;
+CY_SECTION_SHAREDMEM CY_ALIGN(IPC_CACHE_LINE_SIZE) static ipc_ring_t cm55_event_ring;
+
+/* Event being filled by the application, queued by cm55_ipc_send_to_cm33() */
+static ipc_payload_t cm55_payload;
+
+/* Sequence number of the next event */
+static uint32_t cm55_msg_seq;
+static uint32_t cm55_doorbells;
+
+/* The doorbell found the IPC channel busy, it is rung again when the channel
+ * is released or with the next event
+ */
+static volatile bool cm55_doorbell_pending = false;
+
+/* Control channel: request received from the CM33, and response sent back.
+ * The response buffer is not reused until the CM33 has released it. A
+ * request is handled from its receipt until its response is sent: a request
+ * received meanwhile, re-sent by the CM33 after a timeout, is rejected.
+ */
+static ipc_ctrl_request_t cm55_ctrl_request;
+static uint32_t cm55_ctrl_request_rx_us;
+static volatile bool cm55_ctrl_request_pending = false;
+static volatile bool cm55_ctrl_request_busy = false;
+static ipc_ctrl_request_t cm55_ctrl_rejected;
+static volatile bool cm55_ctrl_rejected_pending = false;
+CY_SECTION_SHAREDMEM CY_ALIGN(IPC_CACHE_LINE_SIZE) static ipc_ctrl_response_msg_t cm55_ctrl_msg;
+static volatile bool cm55_ctrl_msg_in_flight = false;
+
+#ifdef VA_AUDIO_SNIPPETS
+/* Audio snippets of the events: descriptors in the shared memory, audio in
+ * the SOCMEM, read in place by the CM33
+ */
+CY_SECTION_SHAREDMEM CY_ALIGN(IPC_CACHE_LINE_SIZE) static ipc_snippet_channel_t cm55_snippet_channel;
+static int16_t cm55_snippet_buffers[IPC_SNIPPET_BUFFERS][IPC_SNIPPET_SAMPLES] __attribute__((aligned(IPC_SNIPPET_ALIGN)))
+                                          __attribute__((section(".cy_socmem_data")));
+static ipc_snippet_writer_t cm55_snippet_writer;
+#endif /* VA_AUDIO_SNIPPETS */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void cm55_doorbell_release_callback(void);
 
 
 __STATIC_INLINE void handle_app_error(void)
@@ -88,6 +136,125 @@ void Cy_SysIpcPipeIsrCm55(void)
 }
 
 
+/*******************************************************************************
+* Function Name: cm55_ring_doorbell
+********************************************************************************
+* Summary:
+*  Interrupts the CM33 to drain the event ring. If the IPC channel is busy
+*  with the previous doorbell or a control response, the doorbell is left
+*  pending and rung again by the release callback of either. Called with the
+*  interrupts disabled, or from the release callbacks.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_ring_doorbell(void)
+{
+    cy_en_ipc_pipe_status_t pipe_status;
+
+    pipe_status = Cy_IPC_Pipe_SendMessage(CM33_IPC_PIPE_EP_ADDR,
+                             CM55_IPC_PIPE_EP_ADDR,
+                             (void *) &cm55_msg_data, &cm55_doorbell_release_callback);
+    if (CY_IPC_PIPE_SUCCESS == pipe_status)
+    {
+        cm55_doorbell_pending = false;
+        cm55_doorbells++;
+    }
+    else if (CY_IPC_PIPE_ERROR_SEND_BUSY == pipe_status)
+    {
+        cm55_doorbell_pending = true;
+    }
+    else
+    {
+        handle_app_error();
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm55_doorbell_release_callback
+********************************************************************************
+* Summary:
+*  Called when the CM33 has taken the doorbell. Rings a doorbell that found
+*  the channel busy meanwhile.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_doorbell_release_callback(void)
+{
+    if (cm55_doorbell_pending)
+    {
+        cm55_ring_doorbell();
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm55_ctrl_callback
+********************************************************************************
+* Summary:
+*  Callback for receipt of a control request from the CM33. The request is
+*  copied, so that the CM33 can send the next one, and is handled in the
+*  context of the voice assistant. While the previous request is handled, the
+*  new one is kept aside to be rejected instead.
+*
+* Parameters:
+*  msg_data: IPC message, ipc_ctrl_request_msg_t
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_ctrl_callback(uint32_t * msg_data)
+{
+    if (msg_data != NULL)
+    {
+        ipc_ctrl_request_msg_t *msg = (ipc_ctrl_request_msg_t *) msg_data;
+
+        ipc_cache_invalidate(msg, sizeof(ipc_ctrl_request_msg_t));
+        if (cm55_ctrl_request_busy)
+        {
+            memcpy(&cm55_ctrl_rejected, &msg->request, sizeof(ipc_ctrl_request_t));
+            cm55_ctrl_rejected_pending = true;
+            return;
+        }
+        memcpy(&cm55_ctrl_request, &msg->request, sizeof(ipc_ctrl_request_t));
+        cm55_ctrl_request_rx_us = ipc_trace_now_us();
+        cm55_ctrl_request_busy = true;
+        cm55_ctrl_request_pending = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm55_ctrl_release_callback
+********************************************************************************
+* Summary:
+*  Called when the CM33 has taken the control response. Rings a doorbell
+*  that found the channel busy meanwhile.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_ctrl_release_callback(void)
+{
+    cm55_ctrl_msg_in_flight = false;
+    if (cm55_doorbell_pending)
+    {
+        cm55_ring_doorbell();
+    }
+}
+
 /*******************************************************************************
 * Function Name: cm55_ipc_communication_setup
 ********************************************************************************
@@ -139,25 +306,248 @@ void cm55_ipc_communication_setup(void)
     Cy_IPC_Pipe_Config(cm55_ipc_pipe_array);
 
     Cy_IPC_Pipe_Init(&cm55_ipc_pipe_config);
+
+    /* The doorbell message never changes */
+    memset((void *) &cm55_event_ring, 0, sizeof(cm55_event_ring));
+    ipc_cache_clean(&cm55_event_ring, sizeof(cm55_event_ring));
+    cm55_msg_data.client_id = CM33_IPC_PIPE_CLIENT_ID;
+    cm55_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+    cm55_msg_data.ring = &cm55_event_ring;
+#ifdef VA_AUDIO_SNIPPETS
+    ipc_snippet_writer_init(&cm55_snippet_writer, &cm55_snippet_channel, cm55_snippet_buffers);
+    cm55_msg_data.snippets = &cm55_snippet_channel;
+#else
+    cm55_msg_data.snippets = NULL;
+#endif /* VA_AUDIO_SNIPPETS */
+    ipc_cache_clean(&cm55_msg_data, sizeof(cm55_msg_data));
+
+    cm55_ctrl_msg.client_id = CM33_IPC_PIPE_CTRL_CLIENT_ID;
+    cm55_ctrl_msg.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+
+    cy_en_ipc_pipe_status_t pipe_status;
+    /* Register a callback function to handle the control requests of the CM33 */
+    pipe_status = Cy_IPC_Pipe_RegisterCallback(CM55_IPC_PIPE_EP_ADDR, &cm55_ctrl_callback,
+                                              (uint32_t)CM55_IPC_PIPE_CLIENT_ID);
+    if (CY_IPC_PIPE_SUCCESS != pipe_status)
+    {
+        handle_app_error();
+    }
 }
 
 
 ipc_payload_t* cm55_ipc_get_payload_ptr(void)
 {
-    return &cm55_msg_data.payload;
+    return &cm55_payload;
 }
 
+/*******************************************************************************
+* Function Name: cm55_ipc_send_to_cm33
+********************************************************************************
+* Summary:
+*  Queues the event filled in cm55_ipc_get_payload_ptr() to the CM33. The
+*  CM33 is only interrupted when the ring was empty, or when the last
+*  doorbell found the IPC channel busy: otherwise it has not finished
+*  draining the ring, and takes this event in the same batch. If the ring is
+*  full, the event is dropped and counted.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
 void cm55_ipc_send_to_cm33(void)
+{
+    ipc_ring_t *ring = &cm55_event_ring;
+    ipc_ring_slot_t *slot;
+    uint32_t head = ring->head;
+    uint32_t interrupt_state;
+
+    cm55_payload.seq = cm55_msg_seq++;
+    cm55_payload.timestamp_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+#ifdef VA_AUDIO_SNIPPETS
+    if ((IPC_EVENT_WAKE_WORD == cm55_payload.event) || (IPC_EVENT_COMMAND == cm55_payload.event))
+    {
+        ipc_snippet_trigger(&cm55_snippet_writer, cm55_payload.seq, cm55_payload.timestamp_ms,
+                            cm55_payload.event, cm55_payload.model_id);
+    }
+#endif /* VA_AUDIO_SNIPPETS */
+
+    ipc_cache_invalidate(&ring->tail, IPC_CACHE_LINE_SIZE);
+    if ((head - ring->tail) >= IPC_RING_SLOTS)
+    {
+        /* The sequence numbers tell the CM33 which events it missed */
+        ring->dropped++;
+        ipc_cache_clean(&ring->head, IPC_CACHE_LINE_SIZE);
+        return;
+    }
+
+    /* The event must be in the shared memory before the CM33 sees the new head */
+    slot = &ring->slots[head % IPC_RING_SLOTS];
+    cm55_payload.send_us = ipc_trace_now_us();
+    memcpy(&slot->payload, &cm55_payload, sizeof(ipc_payload_t));
+    ipc_cache_clean(slot, IPC_RING_SLOT_SIZE);
+    __DSB();
+    ring->head = head + 1u;
+    ipc_cache_clean(&ring->head, IPC_CACHE_LINE_SIZE);
+    __DSB();
+
+    /* Read tail after publishing head. The CM33 publishes tail before it
+     * reads head again, so either the doorbell rings or the CM33 takes the
+     * event on its own.
+     */
+    ipc_cache_invalidate(&ring->tail, IPC_CACHE_LINE_SIZE);
+    if ((ring->tail != head) && !cm55_doorbell_pending)
+    {
+        return;
+    }
+
+    /* A release callback cannot run between the send and the pending flag */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    cm55_ring_doorbell();
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_put_audio
+********************************************************************************
+* Summary:
+*  Records the audio of the Voice Assistant for the snippets of the events.
+*  The snippet of a wake word or a command is handed over to the CM33 once
+*  IPC_SNIPPET_POST_MS of audio after it is recorded. Does nothing without
+*  VA_AUDIO_SNIPPETS.
+*
+* Parameters:
+*  samples: mono audio at 16 kHz
+*  count: number of samples
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void cm55_ipc_put_audio(const int16_t *samples, uint32_t count)
+{
+#ifdef VA_AUDIO_SNIPPETS
+    ipc_snippet_write(&cm55_snippet_writer, samples, count,
+                      (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS));
+#else
+    (void) samples;
+    (void) count;
+#endif /* VA_AUDIO_SNIPPETS */
+}
+
+void cm55_ipc_get_snippet_stats(uint32_t* sent, uint32_t* dropped)
+{
+#ifdef VA_AUDIO_SNIPPETS
+    *sent = cm55_snippet_writer.snippets;
+    *dropped = cm55_snippet_writer.dropped;
+#else
+    *sent = 0u;
+    *dropped = 0u;
+#endif /* VA_AUDIO_SNIPPETS */
+}
+
+void ipc_snippet_cache_clean(const volatile void *addr, uint32_t size)
+{
+    ipc_cache_clean((volatile void *) addr, size);
+    __DSB();
+}
+
+void ipc_snippet_cache_invalidate(const volatile void *addr, uint32_t size)
+{
+    ipc_cache_invalidate((volatile void *) addr, size);
+}
+
+void cm55_ipc_get_ring_stats(ipc_ring_stats_t* stats)
+{
+    stats->dropped = cm55_event_ring.dropped;
+    stats->events = cm55_msg_seq - stats->dropped;
+    stats->doorbells = cm55_doorbells;
+}
+
+bool cm55_ipc_receive_control_request(ipc_ctrl_request_t* request, uint32_t* rx_us)
+{
+    bool received = false;
+
+    taskENTER_CRITICAL();
+    if (cm55_ctrl_request_pending)
+    {
+        memcpy(request, &cm55_ctrl_request, sizeof(ipc_ctrl_request_t));
+        *rx_us = cm55_ctrl_request_rx_us;
+        cm55_ctrl_request_pending = false;
+        received = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return received;
+}
+
+bool cm55_ipc_receive_rejected_control_request(ipc_ctrl_request_t* request)
+{
+    bool received = false;
+
+    taskENTER_CRITICAL();
+    if (cm55_ctrl_rejected_pending)
+    {
+        memcpy(request, &cm55_ctrl_rejected, sizeof(ipc_ctrl_request_t));
+        cm55_ctrl_rejected_pending = false;
+        received = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return received;
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_send_control_response
+********************************************************************************
+* Summary:
+*  Sends the response of a control request to the CM33. Once the response
+*  of the request being handled is sent, the next request is accepted.
+*
+* Parameters:
+*  response: response to send
+*
+* Return :
+*  false if the IPC channel or the previous response is still busy
+*
+*******************************************************************************/
+bool cm55_ipc_send_control_response(const ipc_ctrl_response_t* response)
 {
     cy_en_ipc_pipe_status_t pipe_status;
 
-    cm55_msg_data.client_id = CM33_IPC_PIPE_CLIENT_ID;
-    cm55_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+    if (cm55_ctrl_msg_in_flight)
+    {
+        return false;
+    }
+
+    memcpy(&cm55_ctrl_msg.response, response, sizeof(ipc_ctrl_response_t));
+    /* Stamped last, so that the CM33 can take the time spent on the CM55 out
+     * of the round trip */
+    cm55_ctrl_msg.response.tx_us = ipc_trace_now_us();
+    ipc_cache_clean(&cm55_ctrl_msg, sizeof(cm55_ctrl_msg));
+    __DSB();
 
+    cm55_ctrl_msg_in_flight = true;
     pipe_status = Cy_IPC_Pipe_SendMessage(CM33_IPC_PIPE_EP_ADDR,
                              CM55_IPC_PIPE_EP_ADDR,
-                             (void *) &cm55_msg_data, 0);
-    if (CY_IPC_PIPE_SUCCESS != pipe_status) {
-        handle_app_error();
+                             (void *) &cm55_ctrl_msg, &cm55_ctrl_release_callback);
+    if (CY_IPC_PIPE_SUCCESS != pipe_status)
+    {
+        cm55_ctrl_msg_in_flight = false;
+        if (CY_IPC_PIPE_ERROR_SEND_BUSY != pipe_status)
+        {
+            handle_app_error();
+        }
+        return false;
     }
-}
\ No newline at end of file
+
+    if (response->id == cm55_ctrl_request.id)
+    {
+        cm55_ctrl_request_busy = false;
+    }
+
+    return true;
+}
@@ -0,0 +1,258 @@
+/******************************************************************************
+* File Name : cm55_ipc_snippet.c
+*
+* Description :
+* Recorder of the audio snippets of the Voice Assistant events, handed over
+* to the CM33 without copy
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+
+#include "ipc_snippet.h"
+
+/*******************************************************************************
+* Function Name: find_free_buffer
+********************************************************************************
+* Summary:
+*  Looks for a buffer released by the CM33, other than the active one.
+*
+* Parameters:
+*  writer: recorder
+*  index: buffer found
+*
+* Return:
+*  True if a buffer is free
+*
+*******************************************************************************/
+static bool find_free_buffer(ipc_snippet_writer_t *writer, uint32_t *index)
+{
+    for (uint32_t i = 1u; i < IPC_SNIPPET_BUFFERS; i++)
+    {
+        uint32_t next = (writer->active + i) % IPC_SNIPPET_BUFFERS;
+        ipc_snippet_desc_t *desc = &writer->channel->slots[next].desc;
+
+        ipc_snippet_cache_invalidate(desc, IPC_SNIPPET_DESC_SIZE);
+        if (IPC_SNIPPET_FREE == desc->state)
+        {
+            *index = next;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: hand_over
+********************************************************************************
+* Summary:
+*  Hands the active buffer over to the CM33 and records into a free one,
+*  which starts with the last IPC_SNIPPET_PRE_MS of audio, the history of the
+*  next snippet. If none is free, the snippet is dropped and the active buffer
+*  kept.
+*
+* Parameters:
+*  writer: recorder
+*  now_ms: CM55 time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void hand_over(ipc_snippet_writer_t *writer, uint32_t now_ms)
+{
+    ipc_snippet_desc_t *desc = &writer->channel->slots[writer->active].desc;
+    const int16_t *last = writer->buffers[writer->active];
+    uint32_t history;
+    uint32_t first;
+    uint32_t next;
+
+    writer->post_samples = 0u;
+    if (!find_free_buffer(writer, &next))
+    {
+        writer->dropped++;
+        return;
+    }
+
+    /* The audio and the descriptor must be in the shared memory before the
+     * CM33 sees the new state
+     */
+    ipc_snippet_cache_clean(writer->buffers[writer->active], sizeof(writer->buffers[0]));
+    desc->seq = writer->pending.seq;
+    desc->timestamp_ms = writer->pending.timestamp_ms;
+    desc->ready_ms = now_ms;
+    desc->event = writer->pending.event;
+    desc->model_id = writer->pending.model_id;
+    desc->samples = writer->recorded;
+    desc->start = (writer->recorded < IPC_SNIPPET_SAMPLES) ? 0u : writer->write;
+    desc->data = writer->buffers[writer->active];
+    ipc_snippet_cache_clean(desc, IPC_SNIPPET_DESC_SIZE);
+    desc->state = IPC_SNIPPET_READY;
+    ipc_snippet_cache_clean(desc, IPC_SNIPPET_DESC_SIZE);
+
+    writer->snippets++;
+    writer->active = next;
+
+    /* The CM33 only reads the buffer handed over, so its last samples can
+     * still be copied: first the end of the circular buffer, then its start
+     */
+    history = (writer->recorded < IPC_SNIPPET_PRE_SAMPLES) ? writer->recorded : IPC_SNIPPET_PRE_SAMPLES;
+    first = (writer->write >= history) ? 0u : (history - writer->write);
+    memcpy(writer->buffers[next], &last[IPC_SNIPPET_SAMPLES - first], first * sizeof(int16_t));
+    memcpy(&writer->buffers[next][first], &last[writer->write - (history - first)],
+           (history - first) * sizeof(int16_t));
+    writer->write = history;
+    writer->recorded = history;
+}
+
+/*******************************************************************************
+* Function Name: ipc_snippet_writer_init
+********************************************************************************
+* Summary:
+*  Starts the recorder with all buffers free.
+*
+* Parameters:
+*  writer: recorder
+*  channel: descriptors, in the shared memory
+*  buffers: IPC_SNIPPET_BUFFERS audio buffers, readable by the CM33
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void ipc_snippet_writer_init(ipc_snippet_writer_t *writer, ipc_snippet_channel_t *channel,
+                             int16_t (*buffers)[IPC_SNIPPET_SAMPLES])
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->channel = channel;
+    writer->buffers = buffers;
+
+    memset(channel, 0, sizeof(*channel));
+    for (uint32_t i = 0u; i < IPC_SNIPPET_BUFFERS; i++)
+    {
+        channel->slots[i].desc.state = IPC_SNIPPET_FREE;
+        channel->slots[i].desc.data = buffers[i];
+    }
+    ipc_snippet_cache_clean(channel, sizeof(*channel));
+}
+
+/*******************************************************************************
+* Function Name: ipc_snippet_write
+********************************************************************************
+* Summary:
+*  Records audio into the active buffer, and hands it over once the audio
+*  after the event is recorded.
+*
+* Parameters:
+*  writer: recorder
+*  samples: mono audio
+*  count: number of samples
+*  now_ms: CM55 time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void ipc_snippet_write(ipc_snippet_writer_t *writer, const int16_t *samples, uint32_t count, uint32_t now_ms)
+{
+    while (count > 0u)
+    {
+        uint32_t n = IPC_SNIPPET_SAMPLES - writer->write;
+
+        if (n > count)
+        {
+            n = count;
+        }
+        if ((writer->post_samples > 0u) && (n > writer->post_samples))
+        {
+            n = writer->post_samples;
+        }
+
+        memcpy(&writer->buffers[writer->active][writer->write], samples, n * sizeof(int16_t));
+        writer->write = (writer->write + n) % IPC_SNIPPET_SAMPLES;
+        writer->recorded += n;
+        if (writer->recorded > IPC_SNIPPET_SAMPLES)
+        {
+            writer->recorded = IPC_SNIPPET_SAMPLES;
+        }
+        samples += n;
+        count -= n;
+
+        if (writer->post_samples > 0u)
+        {
+            writer->post_samples -= n;
+            if (0u == writer->post_samples)
+            {
+                hand_over(writer, now_ms);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_snippet_trigger
+********************************************************************************
+* Summary:
+*  Starts a snippet for an event: it is handed over once IPC_SNIPPET_POST_MS
+*  of audio is recorded. An event while the previous snippet is completed is
+*  only counted, as its audio is mostly in that snippet.
+*
+* Parameters:
+*  writer: recorder
+*  seq: sequence number of the event
+*  timestamp_ms: CM55 time of the event
+*  event: ipc_event_type_t
+*  model_id: model set of the event
+*
+* Return:
+*  True if a snippet is started
+*
+*******************************************************************************/
+bool ipc_snippet_trigger(ipc_snippet_writer_t *writer, uint32_t seq, uint32_t timestamp_ms,
+                         uint8_t event, uint8_t model_id)
+{
+    if (writer->post_samples > 0u)
+    {
+        writer->overlapped++;
+        return false;
+    }
+
+    writer->pending.seq = seq;
+    writer->pending.timestamp_ms = timestamp_ms;
+    writer->pending.event = event;
+    writer->pending.model_id = model_id;
+    writer->post_samples = IPC_SNIPPET_POST_SAMPLES;
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,135 @@
+/******************************************************************************
+* File Name : va_model_index.c
+*
+* Description :
+* Decoding index of the DEEPCRAFT Voice Assistant model sets
+* Generated by tools/va_string_table_gen.c from the *_config.c files of the
+* model sets. Do not edit.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "va_model_index.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Smart_Lights_Demo: start of every command record in the intent map */
+const uint32_t va_index_Smart_Lights_Demo_command_offsets[VA_IDX_Smart_Lights_Demo_NUM_COMMANDS] =
+{
+    0u, 4u, 8u, 12u, 16u, 20u, 24u, 28u, 32u, 36u, 40u, 44u, 48u, 52u, 56u, 60u,
+    64u, 68u, 72u, 76u, 80u, 84u, 88u, 92u, 96u, 100u, 104u, 108u, 112u, 116u, 120u, 124u,
+    128u, 132u, 136u, 140u, 144u, 148u, 152u, 156u, 160u, 164u, 168u, 172u, 176u, 180u, 184u, 188u,
+    192u, 196u, 200u, 204u, 208u, 212u, 216u, 220u, 224u, 228u, 232u, 236u, 240u, 244u, 248u, 252u,
+    256u, 260u, 264u, 268u, 272u, 276u, 280u, 284u, 288u, 290u, 294u, 298u, 302u, 306u, 310u, 314u,
+    318u, 322u,
+};
+
+/* Smart_Lights_Demo: variable of every variable phrase */
+const uint16_t va_index_Smart_Lights_Demo_phrase_variable[VA_STR_Smart_Lights_Demo_NUM_VARIABLE_PHRASES] =
+{
+    0u, 0u, 0u, 1u, 1u, 1u, 2u,
+};
+
+/* Smart_Lights_Demo: first variable phrase of every variable */
+const uint16_t va_index_Smart_Lights_Demo_variable_offsets[VA_STR_Smart_Lights_Demo_NUM_VARIABLES] =
+{
+    0u, 3u, 6u,
+};
+
+/* Smart_Lights_Demo: variable of every slot of an intent */
+const uint16_t va_index_Smart_Lights_Demo_intent_slot_variable[VA_STR_Smart_Lights_Demo_NUM_INTENTS][VA_IDX_MAX_VARIABLE_SLOTS] =
+{
+    { 0u, 65535u, 65535u, 65535u, }, /* TurnOnLights */
+    { 1u, 65535u, 65535u, 65535u, }, /* TurnOffLights */
+    { 65535u, 65535u, 65535u, 65535u, }, /* TurnOnAllLights */
+    { 2u, 65535u, 65535u, 65535u, }, /* ChangeLights */
+};
+
+/* LED_Demo: start of every command record in the intent map */
+const uint32_t va_index_LED_Demo_command_offsets[VA_IDX_LED_Demo_NUM_COMMANDS] =
+{
+    0u, 2u, 4u, 6u, 8u, 10u, 12u, 14u, 18u, 22u, 26u, 28u, 30u, 32u, 34u, 36u,
+};
+
+/* LED_Demo: variable of every variable phrase */
+const uint16_t va_index_LED_Demo_phrase_variable[VA_STR_LED_Demo_NUM_VARIABLE_PHRASES] =
+{
+    0u,
+};
+
+/* LED_Demo: first variable phrase of every variable */
+const uint16_t va_index_LED_Demo_variable_offsets[VA_STR_LED_Demo_NUM_VARIABLES] =
+{
+    0u,
+};
+
+/* LED_Demo: variable of every slot of an intent */
+const uint16_t va_index_LED_Demo_intent_slot_variable[VA_STR_LED_Demo_NUM_INTENTS][VA_IDX_MAX_VARIABLE_SLOTS] =
+{
+    { 65535u, 65535u, 65535u, 65535u, }, /* TurnOnLight */
+    { 65535u, 65535u, 65535u, 65535u, }, /* IncreaseBrightness */
+    { 65535u, 65535u, 65535u, 65535u, }, /* DecreaseBrightness */
+    { 0u, 65535u, 65535u, 65535u, }, /* SetBrightness */
+    { 65535u, 65535u, 65535u, 65535u, }, /* ToggleLight */
+    { 65535u, 65535u, 65535u, 65535u, }, /* TurnOffLight */
+};
+
+/* Cooktop_Demo: start of every command record in the intent map */
+const uint32_t va_index_Cooktop_Demo_command_offsets[VA_IDX_Cooktop_Demo_NUM_COMMANDS] =
+{
+    0u, 4u, 8u, 12u, 16u, 20u, 24u, 28u, 32u, 36u, 40u, 42u, 44u,
+};
+
+/* Cooktop_Demo: variable of every variable phrase */
+const uint16_t va_index_Cooktop_Demo_phrase_variable[VA_STR_Cooktop_Demo_NUM_VARIABLE_PHRASES] =
+{
+    0u, 0u, 1u, 2u, 3u,
+};
+
+/* Cooktop_Demo: first variable phrase of every variable */
+const uint16_t va_index_Cooktop_Demo_variable_offsets[VA_STR_Cooktop_Demo_NUM_VARIABLES] =
+{
+    0u, 2u, 3u, 4u,
+};
+
+/* Cooktop_Demo: variable of every slot of an intent */
+const uint16_t va_index_Cooktop_Demo_intent_slot_variable[VA_STR_Cooktop_Demo_NUM_INTENTS][VA_IDX_MAX_VARIABLE_SLOTS] =
+{
+    { 0u, 65535u, 65535u, 65535u, }, /* SetPower */
+    { 1u, 65535u, 65535u, 65535u, }, /* SetHob */
+    { 2u, 65535u, 65535u, 65535u, }, /* SetTemp */
+    { 3u, 65535u, 65535u, 65535u, }, /* SetTimer */
+    { 65535u, 65535u, 65535u, 65535u, }, /* OffMic */
+};
+
+/* [] END OF FILE */
@@ -0,0 +1,371 @@
+/******************************************************************************
+* File Name : ipc_snippet_sim.c
+*
+* Description :
+* Host simulation of the audio snippet channel (cm55_ipc_snippet.c and
+* cm33_ipc_snippet.c), with two threads as the two cores. The CM55 thread
+* records numbered samples in real time and raises events at random, the CM33
+* thread uploads the snippets at a given MQTT rate. Every snippet is checked,
+* and the upload throughput and the delay to pick a snippet up are measured.
+*
+* Build and run from the repository root:
+*   gcc -O2 -Ishared/include tools/ipc_snippet_sim.c
+*       shared/source/COMPONENT_CM55/cm55_ipc_snippet.c
+*       shared/source/COMPONENT_CM33/cm33_ipc_snippet.c -lpthread -lm -o ipc_snippet_sim
+*   ./ipc_snippet_sim
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ipc_snippet.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_SECONDS             (300u)
+#define SIM_FRAME               (160u)
+/* Simulated time runs this much faster than the wall clock */
+#define SIM_SPEEDUP             (20u)
+
+/* Events at random, at least 300 ms and on average 2.5 s apart */
+#define SIM_EVENT_MIN_MS        (300u)
+#define SIM_EVENT_MEAN_MS       (2500u)
+#define SIM_MAX_EVENTS          (SIM_SECONDS * 1000u / SIM_EVENT_MIN_MS + 1u)
+
+/* CM33 app task: chunk size and pause between chunks, and the poll interval
+ * without upload, as in app_task.c
+ */
+#define SIM_CHUNK_SAMPLES       (512u)
+#define SIM_CHUNK_INTERVAL_MS   (1u)
+#define SIM_POLL_INTERVAL_MS    (100u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    const char  *name;
+    uint32_t    upload_bps;     /* MQTT upload rate in bytes/s, 0 for no limit */
+} sim_case_t;
+
+typedef struct
+{
+    uint32_t    events;
+    uint32_t    received;
+    uint32_t    dropped;
+    uint32_t    overlapped;
+    uint32_t    errors;         /* Samples out of sequence, or snippets out of order */
+    uint64_t    bytes;
+    double      upload_ms;      /* Simulated time spent uploading */
+    double      pickup_ms_sum;  /* From the handover to the start of the upload */
+    uint32_t    pickup_ms_max;
+} sim_result_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const sim_case_t sim_cases[] =
+{
+    { "no upload limit",    0u     },
+    { "upload 64 kB/s",     65536u },
+    { "upload 32 kB/s",     32768u },
+    { "upload 16 kB/s",     16384u },
+};
+
+/* Shared memory and SOCMEM of the cores */
+static ipc_snippet_channel_t sim_channel __attribute__((aligned(IPC_SNIPPET_ALIGN)));
+static int16_t sim_buffers[IPC_SNIPPET_BUFFERS][IPC_SNIPPET_SAMPLES] __attribute__((aligned(IPC_SNIPPET_ALIGN)));
+static ipc_snippet_writer_t sim_writer;
+
+/* Number of the sample after the last one of the snippet of each event,
+ * written by the CM55 before the event
+ */
+static uint32_t sim_event_end[SIM_MAX_EVENTS];
+
+static const sim_case_t *sim_case;
+static sim_result_t sim_result;
+static volatile uint32_t sim_now_ms;
+static volatile bool sim_done;
+static uint32_t sim_seed = 1u;
+
+/*******************************************************************************
+* Function Name: ipc_snippet_cache_clean, ipc_snippet_cache_invalidate
+********************************************************************************
+* Summary:
+*   No cache on the host, only the order of the accesses between the threads.
+*
+*******************************************************************************/
+void ipc_snippet_cache_clean(const volatile void *addr, uint32_t size)
+{
+    (void)addr;
+    (void)size;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void ipc_snippet_cache_invalidate(const volatile void *addr, uint32_t size)
+{
+    (void)addr;
+    (void)size;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*******************************************************************************
+* Function Name: sim_random
+*******************************************************************************/
+static double sim_random(void)
+{
+    sim_seed = sim_seed * 1664525u + 1013904223u;
+    return (double)(sim_seed >> 8) / 16777216.0;
+}
+
+/*******************************************************************************
+* Function Name: sim_wall_s
+*******************************************************************************/
+static double sim_wall_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*******************************************************************************
+* Function Name: sim_sleep_ms
+********************************************************************************
+* Summary:
+*   Sleeps for a simulated time.
+*
+*******************************************************************************/
+static void sim_sleep_ms(double ms)
+{
+    double s = ms / 1000.0 / SIM_SPEEDUP;
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)s;
+    ts.tv_nsec = (long)((s - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+}
+
+/*******************************************************************************
+* Function Name: sim_cm55
+********************************************************************************
+* Summary:
+*   Voice assistant task: records 10 ms frames in real time, simulated, and
+*   raises events at random.
+*   Every sample is its number, to check the snippets on the CM33. No event
+*   in the last second, so that every snippet is completed.
+*
+*******************************************************************************/
+static void *sim_cm55(void *arg)
+{
+    uint32_t frames = SIM_SECONDS * 100u;
+    uint32_t next_event_ms = SIM_EVENT_MEAN_MS;
+    uint32_t sample = 0u;
+    double start = sim_wall_s();
+    int16_t frame[SIM_FRAME];
+
+    (void)arg;
+    for (uint32_t f = 0u; f < frames; f++)
+    {
+        uint32_t now_ms = f * 10u;
+        double wait = start + (double)now_ms / 1000.0 / SIM_SPEEDUP - sim_wall_s();
+
+        if (wait > 0.0)
+        {
+            sim_sleep_ms(wait * 1000.0 * SIM_SPEEDUP);
+        }
+        sim_now_ms = now_ms;
+
+        for (uint32_t i = 0u; i < SIM_FRAME; i++)
+        {
+            frame[i] = (int16_t)(uint16_t)(sample++);
+        }
+        ipc_snippet_write(&sim_writer, frame, SIM_FRAME, now_ms);
+
+        if ((now_ms >= next_event_ms) && (now_ms + 1000u < frames * 10u))
+        {
+            uint32_t seq = sim_result.events++;
+
+            sim_event_end[seq] = sample + IPC_SNIPPET_POST_SAMPLES;
+            ipc_snippet_trigger(&sim_writer, seq, now_ms, 1u, 0u);
+            next_event_ms = now_ms + SIM_EVENT_MIN_MS +
+                            (uint32_t)(-(double)(SIM_EVENT_MEAN_MS - SIM_EVENT_MIN_MS) * log1p(-sim_random()));
+        }
+    }
+    sim_done = true;
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: sim_cm33
+********************************************************************************
+* Summary:
+*   App task: uploads the snippets in chunks read in place, at the upload rate
+*   of the case, and checks that the samples follow each other up to the end
+*   of the snippet of their event, with the full history before it.
+*
+*******************************************************************************/
+static void *sim_cm33(void *arg)
+{
+    bool have_seq = false;
+    uint32_t last_seq = 0u;
+
+    (void)arg;
+    while (true)
+    {
+        bool done = sim_done;
+        ipc_snippet_desc_t *desc = ipc_snippet_take(&sim_channel);
+
+        if (desc == NULL)
+        {
+            if (done)
+            {
+                break;
+            }
+            sim_sleep_ms(SIM_POLL_INTERVAL_MS);
+            continue;
+        }
+
+        uint32_t pickup_ms = sim_now_ms - desc->ready_ms;
+        uint32_t start_ms = sim_now_ms;
+        uint32_t expected = sim_event_end[desc->seq] - desc->samples;
+        const int16_t *samples;
+        uint32_t offset = 0u;
+        uint32_t count;
+
+        sim_result.pickup_ms_sum += pickup_ms;
+        if (pickup_ms > sim_result.pickup_ms_max)
+        {
+            sim_result.pickup_ms_max = pickup_ms;
+        }
+        if (have_seq && ((int32_t)(desc->seq - last_seq) <= 0))
+        {
+            sim_result.errors++;
+        }
+        last_seq = desc->seq;
+        have_seq = true;
+
+        /* Every buffer starts with the history of the previous one, so only
+         * the snippets of the first seconds are short
+         */
+        if ((sim_event_end[desc->seq] >= IPC_SNIPPET_SAMPLES) && (desc->samples != IPC_SNIPPET_SAMPLES))
+        {
+            sim_result.errors++;
+        }
+
+        while ((count = ipc_snippet_get_samples(desc, offset, SIM_CHUNK_SAMPLES, &samples)) > 0u)
+        {
+            double send_ms = (sim_case->upload_bps != 0u) ?
+                             1000.0 * count * sizeof(int16_t) / sim_case->upload_bps : 0.0;
+            sim_sleep_ms(send_ms + SIM_CHUNK_INTERVAL_MS);
+            for (uint32_t i = 0u; i < count; i++)
+            {
+                if ((uint16_t)samples[i] != (uint16_t)(expected++))
+                {
+                    sim_result.errors++;
+                    break;
+                }
+            }
+            offset += count;
+        }
+
+        sim_result.bytes += (uint64_t)desc->samples * sizeof(int16_t);
+        sim_result.upload_ms += sim_now_ms - start_ms;
+        sim_result.received++;
+        ipc_snippet_release(desc);
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: simulate
+*******************************************************************************/
+static void simulate(const sim_case_t *c, sim_result_t *result)
+{
+    pthread_t cm55;
+    pthread_t cm33;
+
+    memset(&sim_result, 0, sizeof(sim_result));
+    sim_case = c;
+    sim_done = false;
+    sim_now_ms = 0u;
+    ipc_snippet_writer_init(&sim_writer, &sim_channel, sim_buffers);
+
+    pthread_create(&cm33, NULL, sim_cm33, NULL);
+    pthread_create(&cm55, NULL, sim_cm55, NULL);
+    pthread_join(cm55, NULL);
+    pthread_join(cm33, NULL);
+
+    sim_result.dropped = sim_writer.dropped;
+    sim_result.overlapped = sim_writer.overlapped;
+    *result = sim_result;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    int failures = 0;
+
+    printf("%u s of audio per case, %u buffers of %u ms\n\n", SIM_SECONDS, IPC_SNIPPET_BUFFERS,
+           IPC_SNIPPET_PRE_MS + IPC_SNIPPET_POST_MS);
+    printf("case              events  uploaded  dropped  overlapped  errors  pickup avg/max ms  upload kB/s\n");
+    for (uint32_t c = 0u; c < sizeof(sim_cases) / sizeof(sim_cases[0]); c++)
+    {
+        sim_result_t r;
+
+        simulate(&sim_cases[c], &r);
+        printf("  %-16s %6u  %8u  %7u  %10u  %6u  %8.0f/%-8u  %11.1f\n", sim_cases[c].name,
+               (unsigned)r.events, (unsigned)r.received, (unsigned)r.dropped, (unsigned)r.overlapped,
+               (unsigned)r.errors, (r.received != 0u) ? r.pickup_ms_sum / r.received : 0.0,
+               (unsigned)r.pickup_ms_max,
+               (r.upload_ms > 0.0) ? (double)r.bytes / r.upload_ms * 1000.0 / 1024.0 : 0.0);
+
+        /* Every event has its snippet, or is counted */
+        if ((r.errors != 0u) || (r.received + r.dropped + r.overlapped != r.events))
+        {
+            failures++;
+        }
+    }
+
+    printf("\n%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
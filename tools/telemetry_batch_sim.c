@@ -0,0 +1,535 @@
+/******************************************************************************
+* File Name : telemetry_batch_sim.c
+*
+* Description :
+* Host simulation of the telemetry publisher of the CM33 app task
+* (telemetry_batch.c) under synthetic event storms, over one hour each. The
+* events and the idle state are queued as in app_task.c, and every message is
+* applied to the state of a simulated cloud, which is checked against the
+* state of the device. The MQTT publishes per hour and the bytes on the wire
+* are counted, with the IoTConnect JSON of the records and an estimate of the
+* MQTT and TLS overhead, for every event sent on its own (the publisher
+* before the batching) and for the batched configurations. String fields set
+* again in a coalesced record, up to the size of the record, are checked too.
+*
+* Build and run from the repository root:
+*   gcc -O2 -Iproj_cm33_ns tools/telemetry_batch_sim.c
+*       proj_cm33_ns/telemetry_batch.c -lm -o telemetry_batch_sim
+*   ./telemetry_batch_sim
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "telemetry_batch.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_SECONDS             (3600u)
+
+/* App task: state published after this long without an event, and the
+ * snapshot interval, as in app_task.c
+ */
+#define SIM_IDLE_INTERVAL_MS    (10000u)
+#define SIM_SNAPSHOT_MS         (5u * 60u * 1000u)
+
+/* MQTT PUBLISH QoS 1: fixed header with a 2-byte remaining length, topic
+ * length, topic of about 50 characters with the DUID, and packet ID. Then
+ * the 4-byte PUBACK. Every MQTT packet is a TLS record with AES-GCM:
+ * 5-byte header, 8-byte explicit nonce, 16-byte tag.
+ */
+#define SIM_MQTT_PUBLISH_BYTES  (3u + 2u + 50u + 2u)
+#define SIM_MQTT_PUBACK_BYTES   (4u)
+#define SIM_TLS_RECORD_BYTES    (5u + 8u + 16u)
+
+#define SIM_ROOMS               (3u)
+#define SIM_LIGHT_LEVEL_MAX     (10)
+#define SIM_JSON_LEN            (8192u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    const char  *name;
+    uint32_t    events_per_s;   /* Average, 0 for idle */
+} sim_storm_t;
+
+typedef struct
+{
+    const char  *name;
+    uint32_t    flush_interval_ms;
+    uint32_t    batch_size;
+    uint32_t    snapshot_interval_ms;
+} sim_config_t;
+
+/* Fields of the application reported in every record */
+typedef struct
+{
+    bool        mic_active;
+    int         light_levels[SIM_ROOMS];
+} sim_state_t;
+
+typedef struct
+{
+    uint32_t    events;
+    uint32_t    events_received;
+    uint32_t    messages;
+    uint64_t    json_bytes;
+    uint64_t    wire_bytes;
+    uint32_t    delay_max_ms;   /* From an event to its message */
+    uint32_t    errors;         /* State of the cloud not the state of the device */
+} sim_result_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const sim_storm_t sim_storms[] =
+{
+    { "idle",           0u  },
+    { "1 event/s",      1u  },
+    { "5 events/s",     5u  },
+    { "20 events/s",    20u },
+};
+
+static const sim_config_t sim_configs[] =
+{
+    /* The publisher before the batching: a full message per record */
+    { "per event",      0u,     1u,     0u },
+    { "500 ms / 8",     500u,   8u,     SIM_SNAPSHOT_MS },
+    { "2000 ms / 16",   2000u,  16u,    SIM_SNAPSHOT_MS },
+};
+
+static const char *const sim_rooms[SIM_ROOMS] = { "kitchen", "bedroom", "living_room" };
+static const char *const sim_light_fields[SIM_ROOMS] = { "ll_kitchen", "ll_bedroom", "ll_living_room" };
+
+static sim_state_t sim_device;
+static sim_state_t sim_sent;        /* State of the last record queued */
+static sim_state_t sim_cloud;
+static bool sim_cloud_mic_known;
+static bool sim_cloud_lights_known[SIM_ROOMS];
+static sim_result_t sim_result;
+static uint32_t sim_now_ms;
+static uint32_t sim_event_ms[TELEMETRY_BATCH_MAX_RECORDS];  /* Of the events in the batch */
+static uint32_t sim_num_event_ms;
+static uint32_t sim_seed;
+static char sim_json[SIM_JSON_LEN];
+static telemetry_record_t sim_captured;     /* Last record sent by sim_capture() */
+static uint32_t sim_num_captured;
+
+/*******************************************************************************
+* Function Name: sim_random
+********************************************************************************
+* Summary:
+*   Uniform random number in [0, 1), reproducible across runs.
+*
+*******************************************************************************/
+static double sim_random(void)
+{
+    sim_seed = sim_seed * 1103515245u + 12345u;
+    return (double)(sim_seed >> 8) / (double)(1u << 24);
+}
+
+/*******************************************************************************
+* Function Name: sim_send
+********************************************************************************
+* Summary:
+*   Sink of the batch: formats the message as the IoTConnect SDK does, counts
+*   its bytes, and applies it to the state of the cloud.
+*
+*******************************************************************************/
+static void sim_send(const telemetry_record_t *records, uint32_t count, void *context)
+{
+    int len = snprintf(sim_json, sizeof(sim_json), "{\"d\":[");
+
+    (void)context;
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        const telemetry_record_t *record = &records[i];
+
+        len += snprintf(&sim_json[len], sizeof(sim_json) - (size_t)len,
+                        "%s{\"dt\":\"2026-01-01T00:00:00.000Z\",\"d\":{", (i > 0u) ? "," : "");
+        for (uint32_t f = 0u; f < record->num_fields; f++)
+        {
+            const telemetry_field_t *field = &record->fields[f];
+            const char *sep = (f > 0u) ? "," : "";
+
+            if (field->type == TELEMETRY_NUMBER)
+            {
+                len += snprintf(&sim_json[len], sizeof(sim_json) - (size_t)len, "%s\"%s\":%g",
+                                sep, field->name, field->number);
+            }
+            else if (field->type == TELEMETRY_BOOL)
+            {
+                len += snprintf(&sim_json[len], sizeof(sim_json) - (size_t)len, "%s\"%s\":%s",
+                                sep, field->name, field->boolean ? "true" : "false");
+            }
+            else
+            {
+                len += snprintf(&sim_json[len], sizeof(sim_json) - (size_t)len, "%s\"%s\":\"%s\"",
+                                sep, field->name, telemetry_record_string(record, field));
+            }
+
+            if (0 == strcmp(field->name, "microphone_active"))
+            {
+                sim_cloud.mic_active = field->boolean;
+                sim_cloud_mic_known = true;
+            }
+            for (uint32_t room = 0u; room < SIM_ROOMS; room++)
+            {
+                if (0 == strcmp(field->name, sim_light_fields[room]))
+                {
+                    sim_cloud.light_levels[room] = (int)field->number;
+                    sim_cloud_lights_known[room] = true;
+                }
+            }
+        }
+        len += snprintf(&sim_json[len], sizeof(sim_json) - (size_t)len, "}}");
+        if (record->has_event)
+        {
+            sim_result.events_received++;
+        }
+    }
+    len += snprintf(&sim_json[len], sizeof(sim_json) - (size_t)len, "]}");
+
+    sim_result.messages++;
+    sim_result.json_bytes += (uint64_t)len;
+    sim_result.wire_bytes += (uint64_t)len + SIM_MQTT_PUBLISH_BYTES + SIM_MQTT_PUBACK_BYTES
+                             + 2u * SIM_TLS_RECORD_BYTES;
+
+    /* The cloud has the state of the last record */
+    bool match = sim_cloud_mic_known && (sim_cloud.mic_active == sim_sent.mic_active);
+    for (uint32_t room = 0u; room < SIM_ROOMS; room++)
+    {
+        match = match && sim_cloud_lights_known[room]
+                && (sim_cloud.light_levels[room] == sim_sent.light_levels[room]);
+    }
+    if (!match)
+    {
+        sim_result.errors++;
+    }
+
+    for (uint32_t i = 0u; i < sim_num_event_ms; i++)
+    {
+        uint32_t delay_ms = sim_now_ms - sim_event_ms[i];
+        if (delay_ms > sim_result.delay_max_ms)
+        {
+            sim_result.delay_max_ms = delay_ms;
+        }
+    }
+    sim_num_event_ms = 0u;
+}
+
+/*******************************************************************************
+* Function Name: sim_queue
+********************************************************************************
+* Summary:
+*   Queues the telemetry of an event, or of the state only if event is NULL,
+*   with the fields of queue_telemetry() in app_task.c.
+*
+*******************************************************************************/
+static void sim_queue(telemetry_batch_t *batch, const char *event)
+{
+    telemetry_batch_begin(batch, sim_now_ms, event);
+    sim_sent = sim_device;
+    telemetry_batch_set_string(batch, "version", "S-02.00.00");
+    telemetry_batch_set_bool(batch, "microphone_active", sim_device.mic_active);
+    for (uint32_t room = 0u; room < SIM_ROOMS; room++)
+    {
+        telemetry_batch_set_number(batch, sim_light_fields[room], sim_device.light_levels[room]);
+    }
+    if (event)
+    {
+        sim_event_ms[sim_num_event_ms++] = sim_now_ms;
+    }
+    telemetry_batch_end(batch, sim_now_ms);
+}
+
+/*******************************************************************************
+* Function Name: sim_event
+********************************************************************************
+* Summary:
+*   Raises the next event of a conversation: a wake word, then a command that
+*   turns the lights of a room on or off, or changes their level.
+*
+*******************************************************************************/
+static void sim_event(telemetry_batch_t *batch)
+{
+    static char event_str[64];
+
+    if (!sim_device.mic_active)
+    {
+        sim_device.mic_active = true;
+        sim_queue(batch, "wake word");
+        return;
+    }
+
+    uint32_t room = (uint32_t)(sim_random() * SIM_ROOMS);
+    double action = sim_random();
+    sim_device.mic_active = false;
+    if (action < 0.4)
+    {
+        sim_device.light_levels[room] = SIM_LIGHT_LEVEL_MAX;
+        snprintf(event_str, sizeof(event_str), "TurnOnLights %s", sim_rooms[room]);
+    }
+    else if (action < 0.8)
+    {
+        sim_device.light_levels[room] = 0;
+        snprintf(event_str, sizeof(event_str), "TurnOffLights %s", sim_rooms[room]);
+    }
+    else
+    {
+        int level = (int)(sim_random() * (SIM_LIGHT_LEVEL_MAX + 1));
+        for (uint32_t r = 0u; r < SIM_ROOMS; r++)
+        {
+            if (sim_device.light_levels[r] > 0)
+            {
+                sim_device.light_levels[r] = level;
+            }
+        }
+        snprintf(event_str, sizeof(event_str), "ChangeLights %d", level);
+    }
+    sim_queue(batch, event_str);
+}
+
+/*******************************************************************************
+* Function Name: simulate
+********************************************************************************
+* Summary:
+*   Runs an hour of a storm with a configuration of the publisher. The events
+*   are a Poisson process at the rate of the storm.
+*
+*******************************************************************************/
+static void simulate(const sim_storm_t *storm, const sim_config_t *config, sim_result_t *r)
+{
+    static telemetry_batch_t batch;
+    double next_event_ms = 0.0;
+    uint32_t last_publish_ms = 0u;
+
+    memset(&sim_result, 0, sizeof(sim_result));
+    memset(&sim_device, 0, sizeof(sim_device));
+    memset(&sim_cloud, 0, sizeof(sim_cloud));
+    sim_cloud_mic_known = false;
+    memset(sim_cloud_lights_known, 0, sizeof(sim_cloud_lights_known));
+    sim_device.light_levels[SIM_ROOMS - 1u] = SIM_LIGHT_LEVEL_MAX;
+    sim_num_event_ms = 0u;
+    sim_seed = 1u;
+    sim_now_ms = 0u;
+
+    telemetry_batch_init(&batch, config->flush_interval_ms, config->batch_size,
+                         config->snapshot_interval_ms, sim_send, NULL);
+    sim_queue(&batch, NULL);
+
+    if (storm->events_per_s > 0u)
+    {
+        next_event_ms = -log(1.0 - sim_random()) * 1000.0 / storm->events_per_s;
+    }
+    for (sim_now_ms = 1u; sim_now_ms <= SIM_SECONDS * 1000u; sim_now_ms++)
+    {
+        bool has_event = false;
+
+        while ((storm->events_per_s > 0u) && (next_event_ms <= (double)sim_now_ms))
+        {
+            sim_event(&batch);
+            sim_result.events++;
+            has_event = true;
+            next_event_ms += -log(1.0 - sim_random()) * 1000.0 / storm->events_per_s;
+        }
+        if (has_event)
+        {
+            last_publish_ms = sim_now_ms;
+        }
+        else if ((sim_now_ms - last_publish_ms) >= SIM_IDLE_INTERVAL_MS)
+        {
+            sim_queue(&batch, NULL);
+            last_publish_ms = sim_now_ms;
+        }
+        (void)telemetry_batch_poll(&batch, sim_now_ms);
+    }
+    telemetry_batch_flush(&batch);
+
+    *r = sim_result;
+}
+
+/*******************************************************************************
+* Function Name: sim_capture
+********************************************************************************
+* Summary:
+*   Sink of the batch for sim_check_strings(): keeps the last record.
+*
+*******************************************************************************/
+static void sim_capture(const telemetry_record_t *records, uint32_t count, void *context)
+{
+    (void)context;
+    sim_captured = records[count - 1u];
+    sim_num_captured += count;
+}
+
+/*******************************************************************************
+* Function Name: sim_captured_string
+********************************************************************************
+* Summary:
+*   Returns the string of a field of the captured record, NULL if it does not
+*   have the field.
+*
+*******************************************************************************/
+static const char *sim_captured_string(const char *name)
+{
+    for (uint32_t f = 0u; f < sim_captured.num_fields; f++)
+    {
+        if ((0 == strcmp(sim_captured.fields[f].name, name))
+            && (sim_captured.fields[f].type == TELEMETRY_STRING))
+        {
+            return telemetry_record_string(&sim_captured, &sim_captured.fields[f]);
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: sim_check_strings
+********************************************************************************
+* Summary:
+*   Sets string fields again in a coalesced state record: the old value is
+*   replaced without taking more room, a value without room leaves the old one
+*   and the other fields in place, and a dropped field is sent with the next
+*   record. Returns the number of failed checks.
+*
+*******************************************************************************/
+static int sim_check_strings(void)
+{
+    static telemetry_batch_t batch;
+    static char a1[101];
+    static char a2[101];
+    static char a3[151];
+    static char b[61];
+    int failures = 0;
+
+    memset(a1, 'a', sizeof(a1) - 1u);
+    memset(a2, 'A', sizeof(a2) - 1u);
+    memset(a3, 'x', sizeof(a3) - 1u);
+    memset(b, 'b', sizeof(b) - 1u);
+    sim_num_captured = 0u;
+    telemetry_batch_init(&batch, 1000u, TELEMETRY_BATCH_MAX_RECORDS, 60000u, sim_capture, NULL);
+
+    /* Two 100-character values do not fit together: the first one is freed */
+    telemetry_batch_begin(&batch, 0u, NULL);
+    telemetry_batch_set_string(&batch, "a", a1);
+    telemetry_batch_set_number(&batch, "n", 1.0);
+    telemetry_batch_end(&batch, 0u);
+    telemetry_batch_begin(&batch, 10u, NULL);
+    telemetry_batch_set_string(&batch, "a", a2);
+    telemetry_batch_end(&batch, 10u);
+    failures += (batch.records[0].strings_len != sizeof(a2)) ? 1 : 0;
+
+    /* No room for a larger value and a new field: the old value and the
+     * fields after it stay
+     */
+    telemetry_batch_begin(&batch, 20u, NULL);
+    telemetry_batch_set_string(&batch, "b", b);
+    telemetry_batch_set_string(&batch, "a", a3);
+    telemetry_batch_set_number(&batch, "n", 2.0);
+    telemetry_batch_end(&batch, 20u);
+    telemetry_batch_flush(&batch);
+    failures += ((sim_captured_string("a") == NULL) || (0 != strcmp(sim_captured_string("a"), a2))) ? 1 : 0;
+    failures += ((sim_captured_string("b") == NULL) || (0 != strcmp(sim_captured_string("b"), b))) ? 1 : 0;
+    failures += (batch.stats.fields_dropped != 1u) ? 1 : 0;
+    failures += ((sim_captured.num_fields != 4u) || (sim_captured.fields[2].number != 2.0)) ? 1 : 0;
+
+    /* The value without room is sent with the next record, the others are
+     * unchanged. Then a new field without room is sent with the next record.
+     */
+    telemetry_batch_begin(&batch, 30u, NULL);
+    telemetry_batch_set_string(&batch, "a", a3);
+    telemetry_batch_set_string(&batch, "b", b);
+    telemetry_batch_set_number(&batch, "n", 2.0);
+    telemetry_batch_set_string(&batch, "c", b);
+    telemetry_batch_end(&batch, 30u);
+    telemetry_batch_flush(&batch);
+    failures += ((sim_captured_string("a") == NULL) || (0 != strcmp(sim_captured_string("a"), a3))) ? 1 : 0;
+    failures += ((sim_captured_string("b") != NULL) || (sim_captured_string("c") != NULL)) ? 1 : 0;
+    telemetry_batch_begin(&batch, 40u, NULL);
+    telemetry_batch_set_string(&batch, "a", a3);
+    telemetry_batch_set_string(&batch, "c", b);
+    telemetry_batch_end(&batch, 40u);
+    telemetry_batch_flush(&batch);
+    failures += ((sim_captured_string("a") != NULL) || (sim_captured_string("c") == NULL)) ? 1 : 0;
+    failures += (sim_num_captured != 3u) ? 1 : 0;
+
+    printf("coalesced string fields: %s (%u dropped)\n", (failures == 0) ? "ok" : "FAILED",
+           (unsigned)batch.stats.fields_dropped);
+    return failures;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    int failures = 0;
+
+    printf("%u s per case. Wire bytes with %u B of MQTT and %u B of TLS per publish\n\n", SIM_SECONDS,
+           SIM_MQTT_PUBLISH_BYTES + SIM_MQTT_PUBACK_BYTES, 2u * SIM_TLS_RECORD_BYTES);
+    printf("storm        publisher      events  publishes/h   JSON kB/h   wire kB/h  B/event  delay max ms  errors\n");
+    for (uint32_t s = 0u; s < sizeof(sim_storms) / sizeof(sim_storms[0]); s++)
+    {
+        for (uint32_t c = 0u; c < sizeof(sim_configs) / sizeof(sim_configs[0]); c++)
+        {
+            sim_result_t r;
+
+            simulate(&sim_storms[s], &sim_configs[c], &r);
+            printf("  %-11s %-13s %7u  %11u  %10.1f  %10.1f  %7.0f  %12u  %6u\n", sim_storms[s].name,
+                   sim_configs[c].name, (unsigned)r.events, (unsigned)r.messages,
+                   (double)r.json_bytes / 1024.0, (double)r.wire_bytes / 1024.0,
+                   (r.events != 0u) ? (double)r.wire_bytes / r.events : 0.0,
+                   (unsigned)r.delay_max_ms, (unsigned)r.errors);
+
+            /* Every event reaches the cloud, with the state of the device */
+            if ((r.errors != 0u) || (r.events_received != r.events))
+            {
+                failures++;
+            }
+        }
+    }
+
+    printf("\n");
+    failures += sim_check_strings();
+
+    printf("\n%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,599 @@
+/******************************************************************************
+* File Name : usb_capture_recorder.c
+*
+* Description :
+* Host recorder of the USB capture stream (USB_CAPTURE_MODE): writes the mic
+* channels and the voice assistant input to a multichannel WAV file, and the
+* voice assistant markers and the dropped frames to an event sidecar.
+*
+* Build from the repository root:
+*   gcc -O2 -Iproj_cm55/source/usb_audio tools/usb_capture_recorder.c
+*       -o usb_capture_recorder
+* Record from the USB audio device (4 channels, 16 kHz, 16-bit), e.g. on Linux:
+*   arecord -D hw:<card> -c 4 -r 16000 -f S16_LE -t raw |
+*       ./usb_capture_recorder -o capture
+* The input is raw interleaved 16-bit PCM, or a WAV file recorded by another
+* tool. The outputs are capture.wav (mic left, mic right, voice assistant
+* input) and capture.events.csv. Missing frames are filled with silence in
+* the WAV file, so that its time matches the frame sequence numbers.
+*
+* tools/usb_capture_sim.c simulates the device and its USB IN endpoint.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usb_capture_format.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define REC_FRAME               (USB_CAPTURE_FRAME_SAMPLES)
+/* Two frames: a frame and the header of the next one are checked together */
+#define REC_BUFFER_FRAMES       (2u * REC_FRAME)
+#define REC_WAV_CHANNELS        (3u)
+/* Longer gaps are reported as a discontinuity and not filled with silence */
+#define REC_MAX_FILL_FRAMES     (60u * 100u)
+#define REC_PATH_MAX            (512u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    FILE        *in;
+    FILE        *wav;
+    FILE        *events;
+
+    /* Stream samples, 4 channels interleaved, not yet consumed */
+    int16_t     buf[REC_BUFFER_FRAMES][USB_CAPTURE_CHANNELS];
+    uint32_t    count;
+    bool        eof;
+
+    bool        started;
+    uint32_t    first_seq;
+    uint32_t    next_seq;
+    uint32_t    dropped;
+    uint16_t    state;
+
+    uint32_t    frames;
+    uint32_t    filled_frames;
+    uint32_t    device_drops;
+    uint32_t    transport_drops;
+    uint32_t    underrun_samples;
+    uint32_t    unsynced_samples;
+    uint32_t    damaged_frames;
+    uint32_t    va_events;
+    uint32_t    wav_samples;
+} recorder_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Names of va_event_t (voice_assistant.h) */
+static const char *const va_event_names[] =
+{
+    "NO_EVENT", "WW_DETECTED", "WW_NOT_DETECTED", "CMD_DETECTED",
+    "CMD_TIMEOUT", "CMD_SILENCE_TIMEOUT", "MODEL_CHANGED"
+};
+
+static recorder_t rec;
+
+/*******************************************************************************
+* Function Name: put_u16 / put_u32
+********************************************************************************
+* Summary:
+*   Write little-endian integers of the WAV header.
+*
+*******************************************************************************/
+static void put_u16(FILE *f, uint16_t v)
+{
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void put_u32(FILE *f, uint32_t v)
+{
+    put_u16(f, (uint16_t)v);
+    put_u16(f, (uint16_t)(v >> 16));
+}
+
+/*******************************************************************************
+* Function Name: wav_write_header
+********************************************************************************
+* Summary:
+*   Write the 44-byte header of a 16-bit PCM WAV file of data_samples samples
+*   per channel. Written once empty and again when the recording ends.
+*
+*******************************************************************************/
+static void wav_write_header(FILE *f, uint32_t data_samples)
+{
+    uint32_t data_bytes = data_samples * REC_WAV_CHANNELS * 2u;
+
+    fwrite("RIFF", 1, 4, f);
+    put_u32(f, 36u + data_bytes);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put_u32(f, 16u);
+    put_u16(f, 1u);
+    put_u16(f, REC_WAV_CHANNELS);
+    put_u32(f, USB_CAPTURE_SAMPLE_RATE);
+    put_u32(f, USB_CAPTURE_SAMPLE_RATE * REC_WAV_CHANNELS * 2u);
+    put_u16(f, REC_WAV_CHANNELS * 2u);
+    put_u16(f, 16u);
+    fwrite("data", 1, 4, f);
+    put_u32(f, data_bytes);
+}
+
+/*******************************************************************************
+* Function Name: input_skip_wav_header
+********************************************************************************
+* Summary:
+*   Skip the header of an input WAV file, up to its data chunk. Raw input is
+*   left untouched, the bytes read are put back in the sample buffer.
+*
+*******************************************************************************/
+static bool input_skip_wav_header(recorder_t *r)
+{
+    /* Two whole sample frames, enough for the RIFF header */
+    uint8_t hdr[2u * sizeof(r->buf[0])];
+    size_t n = fread(hdr, 1, sizeof(hdr), r->in);
+
+    if ((n == sizeof(hdr)) && (memcmp(hdr, "RIFF", 4) == 0) && (memcmp(&hdr[8], "WAVE", 4) == 0))
+    {
+        uint8_t chunk[8];
+        size_t have = 4u;
+
+        /* The first bytes of the first chunk header were read already */
+        memcpy(chunk, &hdr[12], have);
+        while (fread(&chunk[have], 1, sizeof(chunk) - have, r->in) == (sizeof(chunk) - have))
+        {
+            have = 0u;
+            uint32_t size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+
+            if (memcmp(chunk, "fmt ", 4) == 0)
+            {
+                uint8_t fmt[16];
+
+                if ((size < sizeof(fmt)) || (fread(fmt, 1, sizeof(fmt), r->in) != sizeof(fmt)))
+                {
+                    return false;
+                }
+                if ((fmt[2] | (fmt[3] << 8)) != USB_CAPTURE_CHANNELS || (fmt[14] | (fmt[15] << 8)) != 16)
+                {
+                    fprintf(stderr, "input WAV is not %u channels of 16-bit samples\n",
+                            (unsigned)USB_CAPTURE_CHANNELS);
+                    return false;
+                }
+                size -= sizeof(fmt);
+            }
+            else if (memcmp(chunk, "data", 4) == 0)
+            {
+                return true;
+            }
+            for (; size > 0u; size--)
+            {
+                fgetc(r->in);
+            }
+        }
+        return false;
+    }
+
+    /* Raw PCM: keep the whole sample frames read, drop a partial one */
+    memcpy(r->buf, hdr, n);
+    r->count = (uint32_t)(n / sizeof(r->buf[0]));
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: input_fill
+********************************************************************************
+* Summary:
+*   Read the stream until the sample buffer is full or the input ends.
+*
+*******************************************************************************/
+static void input_fill(recorder_t *r)
+{
+    while (!r->eof && (r->count < REC_BUFFER_FRAMES))
+    {
+        size_t n = fread(r->buf[r->count], sizeof(r->buf[0]), REC_BUFFER_FRAMES - r->count, r->in);
+
+        if (n == 0u)
+        {
+            r->eof = true;
+        }
+        r->count += (uint32_t)n;
+    }
+}
+
+/*******************************************************************************
+* Function Name: input_consume
+********************************************************************************
+* Summary:
+*   Remove samples from the front of the sample buffer.
+*
+*******************************************************************************/
+static void input_consume(recorder_t *r, uint32_t samples)
+{
+    memmove(r->buf, r->buf[samples], (r->count - samples) * sizeof(r->buf[0]));
+    r->count -= samples;
+}
+
+/*******************************************************************************
+* Function Name: header_at
+********************************************************************************
+* Summary:
+*   Read the frame header of the data channel starting at a sample, if all of
+*   it is buffered and valid.
+*
+*******************************************************************************/
+static bool header_at(const recorder_t *r, uint32_t pos, uint16_t *header)
+{
+    if ((pos + USB_CAPTURE_HDR_WORDS) > r->count)
+    {
+        return false;
+    }
+    for (uint32_t i = 0u; i < USB_CAPTURE_HDR_WORDS; i++)
+    {
+        header[i] = (uint16_t)r->buf[pos + i][USB_CAPTURE_CH_DATA];
+    }
+    return (header[USB_CAPTURE_HDR_SYNC0] == USB_CAPTURE_SYNC0) &&
+           (header[USB_CAPTURE_HDR_SYNC1] == USB_CAPTURE_SYNC1) &&
+           (header[USB_CAPTURE_HDR_VERSION] == USB_CAPTURE_VERSION) &&
+           (header[USB_CAPTURE_HDR_CHECKSUM] == usb_capture_header_checksum(header));
+}
+
+/*******************************************************************************
+* Function Name: is_silent
+********************************************************************************
+* Summary:
+*   Check that buffered samples are silent on all channels: frames the device
+*   sends when it has no captured frame ready (underrun).
+*
+*******************************************************************************/
+static bool is_silent(const recorder_t *r, uint32_t pos, uint32_t samples)
+{
+    for (uint32_t i = pos; (i < pos + samples) && (i < r->count); i++)
+    {
+        for (uint32_t ch = 0u; ch < USB_CAPTURE_CHANNELS; ch++)
+        {
+            if (r->buf[i][ch] != 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: frame_complete
+********************************************************************************
+* Summary:
+*   Check that the frame at a sample was received whole. A frame that lost
+*   USB packets is shorter, so the header of the next frame starts inside it.
+*   The caller buffers the samples up to the next header.
+*
+*******************************************************************************/
+static bool frame_complete(const recorder_t *r, uint32_t pos)
+{
+    uint16_t header[USB_CAPTURE_HDR_WORDS];
+
+    for (uint32_t next = pos + 1u; next < pos + REC_FRAME; next++)
+    {
+        if (header_at(r, next, header))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: write_event
+********************************************************************************
+* Summary:
+*   Write a line of the event sidecar. The time is that of the frame in the
+*   WAV file.
+*
+*******************************************************************************/
+static void write_event(recorder_t *r, uint32_t seq, const char *type, long value, const char *detail)
+{
+    fprintf(r->events, "%.2f,%u,%s,%ld,%s\n", (double)(seq - r->first_seq) * 0.01,
+            (unsigned)seq, type, value, detail);
+}
+
+/*******************************************************************************
+* Function Name: write_frames
+********************************************************************************
+* Summary:
+*   Write a captured frame to the WAV file, or silence if frame is NULL.
+*
+*******************************************************************************/
+static void write_frames(recorder_t *r, const int16_t (*frame)[USB_CAPTURE_CHANNELS], uint32_t count)
+{
+    static const int16_t silence[USB_CAPTURE_CHANNELS] = { 0 };
+
+    for (uint32_t f = 0u; f < count; f++)
+    {
+        for (uint32_t i = 0u; i < REC_FRAME; i++)
+        {
+            const int16_t *s = (frame != NULL) ? frame[i] : silence;
+
+            fwrite(&s[USB_CAPTURE_CH_MIC_LEFT], 2, 1, r->wav);
+            fwrite(&s[USB_CAPTURE_CH_MIC_RIGHT], 2, 1, r->wav);
+            fwrite(&s[USB_CAPTURE_CH_OUTPUT], 2, 1, r->wav);
+        }
+        r->wav_samples += REC_FRAME;
+    }
+}
+
+/*******************************************************************************
+* Function Name: process_frame
+********************************************************************************
+* Summary:
+*   Check the sequence number of a received frame, report the frames missing
+*   before it and its voice assistant markers, and write it.
+*
+*******************************************************************************/
+static void process_frame(recorder_t *r, uint32_t pos, const uint16_t *header)
+{
+    uint32_t seq = header[USB_CAPTURE_HDR_SEQ_LO] | ((uint32_t)header[USB_CAPTURE_HDR_SEQ_HI] << 16);
+    uint32_t dropped = header[USB_CAPTURE_HDR_DROPPED_LO] | ((uint32_t)header[USB_CAPTURE_HDR_DROPPED_HI] << 16);
+    uint16_t state = header[USB_CAPTURE_HDR_STATE];
+    uint16_t event = header[USB_CAPTURE_HDR_EVENT];
+    char detail[64];
+
+    if (!r->started)
+    {
+        r->started = true;
+        r->first_seq = seq;
+        r->next_seq = seq;
+        r->dropped = dropped;
+        r->state = state;
+        write_event(r, seq, "start", state, (state == 0u) ? "WWD" : "CMD");
+    }
+
+    if (seq != r->next_seq)
+    {
+        uint32_t gap = seq - r->next_seq;
+
+        if ((gap > REC_MAX_FILL_FRAMES) || (dropped < r->dropped))
+        {
+            /* Sequence restarted (device reset) or long outage: restart the time base */
+            snprintf(detail, sizeof(detail), "expected %u", (unsigned)r->next_seq);
+            write_event(r, seq, "discontinuity", (long)(int32_t)gap, detail);
+            r->first_seq = seq - (r->wav_samples / REC_FRAME);
+        }
+        else
+        {
+            /* Frames the device dropped are counted on the device, the rest
+             * was lost on the way to the host
+             */
+            uint32_t device = dropped - r->dropped;
+
+            if (device > gap)
+            {
+                device = gap;
+            }
+            snprintf(detail, sizeof(detail), "device %u transport %u", (unsigned)device,
+                     (unsigned)(gap - device));
+            write_event(r, r->next_seq, "gap", (long)gap, detail);
+            write_frames(r, NULL, gap);
+            r->filled_frames += gap;
+            r->device_drops += device;
+            r->transport_drops += gap - device;
+        }
+    }
+
+    if (state != r->state)
+    {
+        write_event(r, seq, "state", state, (state == 0u) ? "WWD" : "CMD");
+        r->state = state;
+    }
+    if (event != 0u)
+    {
+        const char *name = (event < (sizeof(va_event_names) / sizeof(va_event_names[0]))) ?
+                           va_event_names[event] : "UNKNOWN";
+
+        if (header[USB_CAPTURE_HDR_EVENT_ARG] != USB_CAPTURE_NO_ARG)
+        {
+            snprintf(detail, sizeof(detail), "%s arg %u", name, (unsigned)header[USB_CAPTURE_HDR_EVENT_ARG]);
+        }
+        else
+        {
+            snprintf(detail, sizeof(detail), "%s", name);
+        }
+        write_event(r, seq, "event", event, detail);
+        r->va_events++;
+    }
+
+    write_frames(r, (const int16_t (*)[USB_CAPTURE_CHANNELS])r->buf[pos], 1u);
+    r->frames++;
+    r->next_seq = seq + 1u;
+    r->dropped = dropped;
+}
+
+/*******************************************************************************
+* Function Name: record
+********************************************************************************
+* Summary:
+*   Find the frames in the stream and process them. While in sync, a frame
+*   starts right where the previous one ended; underrun silence is skipped
+*   and anything else is searched through for the next valid header.
+*
+*******************************************************************************/
+static void record(recorder_t *r)
+{
+    uint16_t header[USB_CAPTURE_HDR_WORDS];
+
+    for (;;)
+    {
+        uint32_t pos;
+        uint32_t last;
+        bool found = false;
+
+        input_fill(r);
+        if (r->count < REC_FRAME)
+        {
+            break;
+        }
+
+        /* A frame is only accepted with the start of the next one buffered */
+        last = r->count - REC_FRAME;
+        if (!r->eof)
+        {
+            last -= USB_CAPTURE_HDR_WORDS;
+        }
+
+        for (pos = 0u; pos <= last; pos++)
+        {
+            if (header_at(r, pos, header))
+            {
+                if (frame_complete(r, pos))
+                {
+                    found = true;
+                    break;
+                }
+                /* Header of a frame that lost packets */
+                r->damaged_frames++;
+            }
+        }
+
+        if (!found)
+        {
+            /* Keep the samples that may still start a frame */
+            uint32_t skip = r->eof ? r->count : (last + 1u);
+
+            if (is_silent(r, 0u, skip))
+            {
+                r->underrun_samples += skip;
+            }
+            else
+            {
+                r->unsynced_samples += skip;
+            }
+            input_consume(r, skip);
+            continue;
+        }
+
+        if (pos > 0u)
+        {
+            if (is_silent(r, 0u, pos))
+            {
+                r->underrun_samples += pos;
+            }
+            else
+            {
+                r->unsynced_samples += pos;
+                if (r->started)
+                {
+                    write_event(r, r->next_seq, "resync", (long)pos, "samples skipped");
+                }
+            }
+        }
+        process_frame(r, pos, header);
+        input_consume(r, pos + REC_FRAME);
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *input = "-";
+    const char *prefix = NULL;
+    char path[REC_PATH_MAX];
+    recorder_t *r = &rec;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc))
+        {
+            input = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+        {
+            prefix = argv[++i];
+        }
+        else
+        {
+            prefix = NULL;
+            break;
+        }
+    }
+    if (prefix == NULL)
+    {
+        fprintf(stderr, "usage: %s [-i <input.raw|input.wav|->] -o <output prefix>\n", argv[0]);
+        return 2;
+    }
+
+    r->in = (strcmp(input, "-") == 0) ? stdin : fopen(input, "rb");
+    snprintf(path, sizeof(path), "%s.wav", prefix);
+    r->wav = fopen(path, "wb");
+    snprintf(path, sizeof(path), "%s.events.csv", prefix);
+    r->events = fopen(path, "w");
+    if ((r->in == NULL) || (r->wav == NULL) || (r->events == NULL))
+    {
+        fprintf(stderr, "cannot open the input or the outputs\n");
+        return 1;
+    }
+
+    if (!input_skip_wav_header(r))
+    {
+        fprintf(stderr, "unsupported input WAV file\n");
+        return 1;
+    }
+    wav_write_header(r->wav, 0u);
+    fprintf(r->events, "time_s,seq,type,value,detail\n");
+
+    record(r);
+
+    fseek(r->wav, 0, SEEK_SET);
+    wav_write_header(r->wav, r->wav_samples);
+    fclose(r->wav);
+    fclose(r->events);
+
+    printf("frames %u, missing %u (device %u, transport %u), damaged %u\n",
+           (unsigned)r->frames, (unsigned)r->filled_frames, (unsigned)r->device_drops,
+           (unsigned)r->transport_drops, (unsigned)r->damaged_frames);
+    printf("va events %u, underrun samples %u, unsynced samples %u, %.2f s written\n",
+           (unsigned)r->va_events, (unsigned)r->underrun_samples, (unsigned)r->unsynced_samples,
+           (double)r->wav_samples / USB_CAPTURE_SAMPLE_RATE);
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,334 @@
+/******************************************************************************
+* File Name : usb_capture_sim.c
+*
+* Description :
+* Simulated USB IN endpoint of the capture mode (USB_CAPTURE_MODE), to test
+* tools/usb_capture_recorder.c on a host. Frames are built as in usb_capture.c
+* and sent as in audio_usb_send_utils.c: 8-frame rings filled all or none,
+* and one 1 ms packet per USB IN callback, silence when the rings are empty.
+* The simulation adds producer stalls (underruns), host stalls (frames
+* dropped on the device) and lost packets, and prints what the recorder is
+* expected to report.
+*
+* Build and run from the repository root:
+*   gcc -O2 -Iproj_cm55/source/usb_audio tools/usb_capture_sim.c -lm -o usb_capture_sim
+*   ./usb_capture_sim -o sim.raw -t 120
+*   ./usb_capture_recorder -i sim.raw -o sim
+* Channel 3 of every frame holds its sequence number modulo 30000, to check
+* the alignment of the recorded WAV file.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usb_capture_format.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_FRAME               (USB_CAPTURE_FRAME_SAMPLES)
+#define SIM_PACKET_SAMPLES      (SIM_FRAME / 10u)
+#define SIM_RING_FRAMES         (8u)
+#define SIM_PI                  (3.14159265358979f)
+
+/* Event probabilities per 1 ms tick, in parts per million */
+#define SIM_PRODUCER_STALL_PPM  (500u)      /* AFE late by 10 to 100 ms */
+#define SIM_HOST_STALL_PPM      (100u)      /* Host does not poll for 50 to 200 ms */
+#define SIM_PACKET_LOSS_PPM     (300u)
+
+/* Voice assistant markers: a wake-word every 2.5 s, a command 1 s after */
+#define SIM_WW_PERIOD_FRAMES    (250u)
+#define SIM_CMD_DELAY_FRAMES    (100u)
+
+/* va_event_t and va_run_state_t values (voice_assistant.h) */
+#define SIM_EVENT_WW_DETECTED   (1u)
+#define SIM_EVENT_CMD_DETECTED  (3u)
+#define SIM_EVENT_MODEL_CHANGED (6u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    int16_t     samples[SIM_FRAME][USB_CAPTURE_CHANNELS];
+    bool        damaged;            /* A packet of the frame was lost */
+} sim_frame_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static sim_frame_t ring[SIM_RING_FRAMES];
+static uint32_t ring_head;
+static uint32_t ring_tail;
+
+static uint32_t sim_seed = 1u;
+static uint32_t seq = 1000u;
+static uint32_t device_dropped;
+static uint16_t va_state;
+
+/*******************************************************************************
+* Function Name: sim_rand
+********************************************************************************
+* Summary:
+*   Deterministic pseudo-random numbers, so that runs can be repeated.
+*
+*******************************************************************************/
+static uint32_t sim_rand(void)
+{
+    sim_seed = sim_seed * 1664525u + 1013904223u;
+    return sim_seed >> 8;
+}
+
+static bool sim_chance(uint32_t ppm)
+{
+    return (sim_rand() % 1000000u) < ppm;
+}
+
+/*******************************************************************************
+* Function Name: produce_frame
+********************************************************************************
+* Summary:
+*   Build the next frame as usb_capture_put() does and queue it, or count it
+*   as dropped if the ring is full.
+*
+*******************************************************************************/
+static void produce_frame(uint32_t *events)
+{
+    static int16_t frame[SIM_FRAME][USB_CAPTURE_CHANNELS];
+    uint16_t header[USB_CAPTURE_HDR_WORDS];
+    uint16_t event = 0u;
+    uint16_t arg = USB_CAPTURE_NO_ARG;
+    uint32_t phase = seq % SIM_WW_PERIOD_FRAMES;
+
+    if (phase == 0u)
+    {
+        event = SIM_EVENT_WW_DETECTED;
+        va_state = 1u;
+    }
+    else if (phase == SIM_CMD_DELAY_FRAMES)
+    {
+        event = SIM_EVENT_CMD_DETECTED;
+        arg = (uint16_t)(seq % 7u);
+        va_state = 0u;
+    }
+    else if ((seq % (8u * SIM_WW_PERIOD_FRAMES)) == (SIM_WW_PERIOD_FRAMES / 2u))
+    {
+        event = SIM_EVENT_MODEL_CHANGED;
+        arg = (uint16_t)((seq / (8u * SIM_WW_PERIOD_FRAMES)) % 3u);
+    }
+
+    memset(header, 0, sizeof(header));
+    header[USB_CAPTURE_HDR_SYNC0] = USB_CAPTURE_SYNC0;
+    header[USB_CAPTURE_HDR_SYNC1] = USB_CAPTURE_SYNC1;
+    header[USB_CAPTURE_HDR_VERSION] = USB_CAPTURE_VERSION;
+    header[USB_CAPTURE_HDR_SEQ_LO] = (uint16_t)seq;
+    header[USB_CAPTURE_HDR_SEQ_HI] = (uint16_t)(seq >> 16);
+    header[USB_CAPTURE_HDR_STATE] = va_state;
+    header[USB_CAPTURE_HDR_EVENT] = event;
+    header[USB_CAPTURE_HDR_EVENT_ARG] = arg;
+    header[USB_CAPTURE_HDR_DROPPED_LO] = (uint16_t)device_dropped;
+    header[USB_CAPTURE_HDR_DROPPED_HI] = (uint16_t)(device_dropped >> 16);
+    header[USB_CAPTURE_HDR_CHECKSUM] = usb_capture_header_checksum(header);
+
+    for (uint32_t i = 0u; i < SIM_FRAME; i++)
+    {
+        float t = (float)(seq * SIM_FRAME + i) / USB_CAPTURE_SAMPLE_RATE;
+
+        frame[i][USB_CAPTURE_CH_MIC_LEFT] = (int16_t)(8000.0f * sinf(2.0f * SIM_PI * 440.0f * t));
+        frame[i][USB_CAPTURE_CH_MIC_RIGHT] = (int16_t)(8000.0f * sinf(2.0f * SIM_PI * 660.0f * t));
+        frame[i][USB_CAPTURE_CH_OUTPUT] = (int16_t)(seq % 30000u);
+        frame[i][USB_CAPTURE_CH_DATA] = (i < USB_CAPTURE_HDR_WORDS) ? (int16_t)header[i] : 0;
+    }
+    seq++;
+
+    if ((ring_head - ring_tail) >= SIM_RING_FRAMES)
+    {
+        device_dropped++;
+        return;
+    }
+    memcpy(ring[ring_head % SIM_RING_FRAMES].samples, frame, sizeof(frame));
+    ring[ring_head % SIM_RING_FRAMES].damaged = false;
+    ring_head++;
+    if (event != 0u)
+    {
+        (*events)++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *output = NULL;
+    uint32_t seconds = 60u;
+    FILE *out;
+    static sim_frame_t current;
+    uint32_t counter = 3u;              /* The host starts mid-frame */
+    bool current_valid = false;
+    uint32_t producer_stall = 0u;
+    uint32_t producer_backlog = 0u;
+    uint32_t host_stall = 0u;
+    uint32_t queued_events = 0u;
+    uint32_t sent_frames = 0u;
+    uint32_t damaged_frames = 0u;
+    uint32_t silent_frames = 0u;
+    uint32_t lost_packets = 0u;
+    uint32_t first_seq = 0u;
+    uint32_t last_seq = 0u;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+        {
+            output = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+        {
+            seconds = (uint32_t)atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+        {
+            sim_seed = (uint32_t)atoi(argv[++i]);
+        }
+        else
+        {
+            output = NULL;
+            break;
+        }
+    }
+    if (output == NULL)
+    {
+        fprintf(stderr, "usage: %s -o <output.raw> [-t <seconds>] [-s <seed>]\n", argv[0]);
+        return 2;
+    }
+    out = fopen(output, "wb");
+    if (out == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", output);
+        return 1;
+    }
+
+    /* The device runs a little before the host starts recording */
+    produce_frame(&queued_events);
+
+    for (uint32_t tick = 0u; tick < seconds * 1000u; tick++)
+    {
+        /* Producer: one frame every 10 ms, late frames follow in a burst */
+        if ((tick % 10u) == 0u)
+        {
+            producer_backlog++;
+        }
+        if (producer_stall > 0u)
+        {
+            producer_stall--;
+        }
+        else if (sim_chance(SIM_PRODUCER_STALL_PPM))
+        {
+            producer_stall = 10u + (sim_rand() % 91u);
+        }
+        else
+        {
+            for (; producer_backlog > 0u; producer_backlog--)
+            {
+                produce_frame(&queued_events);
+            }
+        }
+
+        /* Host: the USB IN callback is not called while the host stalls */
+        if (host_stall > 0u)
+        {
+            host_stall--;
+            continue;
+        }
+        if (sim_chance(SIM_HOST_STALL_PPM))
+        {
+            host_stall = 50u + (sim_rand() % 151u);
+            continue;
+        }
+
+        /* USB IN callback: take a complete frame every 10 packets */
+        if (counter == 0u)
+        {
+            if (current_valid)
+            {
+                sent_frames++;
+                damaged_frames += current.damaged ? 1u : 0u;
+            }
+            current_valid = (ring_head != ring_tail);
+            if (current_valid)
+            {
+                current = ring[ring_tail % SIM_RING_FRAMES];
+                ring_tail++;
+                last_seq = (uint16_t)current.samples[USB_CAPTURE_HDR_SEQ_LO][USB_CAPTURE_CH_DATA] |
+                           ((uint32_t)(uint16_t)current.samples[USB_CAPTURE_HDR_SEQ_HI][USB_CAPTURE_CH_DATA] << 16);
+                if (first_seq == 0u)
+                {
+                    first_seq = last_seq;
+                }
+            }
+            else
+            {
+                memset(&current, 0, sizeof(current));
+                silent_frames++;
+            }
+        }
+
+        if (sim_chance(SIM_PACKET_LOSS_PPM))
+        {
+            current.damaged = current_valid;
+            lost_packets++;
+        }
+        else
+        {
+            fwrite(current.samples[counter * SIM_PACKET_SAMPLES], sizeof(current.samples[0]),
+                   SIM_PACKET_SAMPLES, out);
+        }
+        counter = (counter + 1u) % 10u;
+    }
+    fclose(out);
+
+    /* The partly sent first frame and the last frame are not counted */
+    printf("seq %u to %u: %u frames sent whole or damaged, %u damaged by %u lost packets\n",
+           (unsigned)first_seq, (unsigned)last_seq, (unsigned)sent_frames, (unsigned)damaged_frames,
+           (unsigned)lost_packets);
+    printf("%u frames dropped on the device, %u silent frames (underrun)\n",
+           (unsigned)device_dropped, (unsigned)silent_frames);
+    return 0;
+}
+
+/* [] END OF FILE */
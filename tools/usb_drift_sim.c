@@ -0,0 +1,481 @@
+/******************************************************************************
+* File Name : usb_drift_sim.c
+*
+* Description :
+* Host simulation of the USB clock drift compensation (audio_usb_drift.c) with
+* the host clock off by up to +/-500 ppm from the device clock:
+* - IN: the device queues 10 ms frames (with processing jitter), the host
+*   reads one packet per ms. Every sample is numbered to check that none is
+*   lost, repeated or changed.
+* - OUT: the host writes one packet per ms, the device reads 10 ms frames
+*   through the resampler. The SNR of a sine read out is measured.
+* Each case also runs without compensation (nominal packet size, no
+* resampling), as the firmware did before, to count the slips avoided.
+*
+* Build and run from the repository root:
+*   gcc -O2 -Iproj_cm55/source/usb_audio/emusb_audio_class tools/usb_drift_sim.c
+*       proj_cm55/source/usb_audio/emusb_audio_class/audio_usb_drift.c -lm -o usb_drift_sim
+*   ./usb_drift_sim
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "audio_usb_drift.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_SECONDS             (600u)
+#define SIM_SAMPLE_RATE         (16000.0)
+#define SIM_FRAME               (160u)
+#define SIM_PACKET              (16u)
+/* Settling time excluded from the steady-state measurements */
+#define SIM_SETTLE_SECONDS      (60u)
+
+/* IN: 8 frames buffered, as the debug channel rings, 3 targeted */
+#define SIM_IN_CAPACITY         (8u * SIM_FRAME)
+#define SIM_IN_TARGET           (3u * SIM_FRAME)
+/* Frames reach the rings up to 4 ms late, after the audio processing */
+#define SIM_IN_JITTER_MS        (4.0)
+
+/* OUT: 2 frames targeted in the FIFO */
+#define SIM_OUT_TARGET          (2u * SIM_FRAME)
+#define SIM_OUT_TONE_HZ         (997.0)
+#define SIM_OUT_AMPLITUDE       (12000.0)
+#define SIM_FIT_BLOCK           (1600u)
+#define SIM_FIT_SPAN_PPM        (200.0)
+#define SIM_OUT_MIN_SNR_DB      (55.0)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t    overruns;
+    uint32_t    underruns;
+    uint32_t    discontinuities;
+    float       ppm;
+    uint32_t    fill_min;
+    uint32_t    fill_max;
+    double      snr_db;
+} sim_result_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const double sim_drifts_ppm[] = { -500.0, -100.0, 0.0, 100.0, 500.0 };
+
+static usb_drift_fifo_t sim_fifo;
+static uint32_t sim_seed = 1u;
+
+/*******************************************************************************
+* Function Name: sim_random
+*******************************************************************************/
+static double sim_random(void)
+{
+    sim_seed = sim_seed * 1664525u + 1013904223u;
+    return (double)(sim_seed >> 8) / 16777216.0;
+}
+
+/*******************************************************************************
+* Function Name: simulate_in
+********************************************************************************
+* Summary:
+*   Device to host. drift_ppm is how much faster the device clock runs than
+*   the host clock. The ring holds the number of every sample, so that the
+*   host can check the samples it receives follow each other.
+*
+*******************************************************************************/
+static void simulate_in(double drift_ppm, bool compensate, sim_result_t *result)
+{
+    static uint32_t ring[SIM_IN_CAPACITY];
+    usb_drift_t drift;
+    double frame_period = 10.0 / (1.0 + drift_ppm * 1e-6);    /* In host ms */
+    double next_frame = 0.0;
+    double ready[8];
+    uint32_t pending = 0u;
+    uint32_t produced = 0u;
+    uint32_t head = 0u;
+    uint32_t tail = 0u;
+    uint32_t last = 0u;
+    bool started = false;
+
+    memset(result, 0, sizeof(*result));
+    usb_drift_init(&drift, SIM_IN_TARGET, 1u);
+    if (!compensate)
+    {
+        drift.kp = 0.0f;
+        drift.ki = 0.0f;
+    }
+    result->fill_min = SIM_IN_CAPACITY;
+
+    for (uint32_t ms = 0u; ms < SIM_SECONDS * 1000u; ms++)
+    {
+        uint32_t fill;
+        uint32_t count;
+
+        /* Frames of the device clock reach the ring after the processing */
+        while (next_frame <= (double)ms)
+        {
+            ready[pending++] = next_frame + sim_random() * SIM_IN_JITTER_MS;
+            next_frame += frame_period;
+        }
+        while ((pending > 0u) && (ready[0] <= (double)ms))
+        {
+            if ((head - tail + SIM_FRAME) > SIM_IN_CAPACITY)
+            {
+                result->overruns++;
+            }
+            else
+            {
+                for (uint32_t i = 0u; i < SIM_FRAME; i++)
+                {
+                    ring[(head + i) % SIM_IN_CAPACITY] = produced + i;
+                }
+                head += SIM_FRAME;
+            }
+            produced += SIM_FRAME;
+            pending--;
+            memmove(ready, &ready[1], pending * sizeof(ready[0]));
+        }
+
+        /* One packet per host ms */
+        fill = head - tail;
+        count = usb_drift_packet_samples(&drift, fill, SIM_PACKET);
+        if (count > fill)
+        {
+            /* The device sends silence until the target level is back */
+            usb_drift_underrun(&drift);
+            count = 0u;
+        }
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            uint32_t sample = ring[tail % SIM_IN_CAPACITY];
+
+            if (started && (sample != last + 1u))
+            {
+                result->discontinuities++;
+            }
+            started = true;
+            last = sample;
+            tail++;
+        }
+
+        if (ms >= SIM_SETTLE_SECONDS * 1000u)
+        {
+            if (fill < result->fill_min)
+            {
+                result->fill_min = fill;
+            }
+            if (fill > result->fill_max)
+            {
+                result->fill_max = fill;
+            }
+        }
+    }
+    result->underruns = drift.underruns;
+    result->ppm = drift.integral;
+}
+
+/*******************************************************************************
+* Function Name: fit_snr
+********************************************************************************
+* Summary:
+*   SNR of a block of a sine of given frequency: least-squares fit of its
+*   sine, cosine and offset components, and power of the residual.
+*
+*******************************************************************************/
+static double fit_snr(const int16_t *x, uint32_t stride, uint32_t n, double cycles_per_sample)
+{
+    double m[3][4] = { { 0.0 } };
+    double coef[3];
+    double signal = 0.0;
+    double noise = 0.0;
+
+    double rot_s = sin(2.0 * M_PI * cycles_per_sample);
+    double rot_c = cos(2.0 * M_PI * cycles_per_sample);
+    double sn = 0.0;
+    double cs = 1.0;
+
+    /* Normal equations, the right-hand side in the last column. The sine and
+     * cosine are generated by rotation, exact enough over one block.
+     */
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        double basis[3] = { sn, cs, 1.0 };
+        double next = sn * rot_c + cs * rot_s;
+
+        cs = cs * rot_c - sn * rot_s;
+        sn = next;
+
+        for (uint32_t r = 0u; r < 3u; r++)
+        {
+            for (uint32_t c = 0u; c < 3u; c++)
+            {
+                m[r][c] += basis[r] * basis[c];
+            }
+            m[r][3] += basis[r] * x[i * stride];
+        }
+    }
+
+    /* Gauss-Jordan elimination, the matrix is positive definite */
+    for (uint32_t p = 0u; p < 3u; p++)
+    {
+        for (uint32_t r = 0u; r < 3u; r++)
+        {
+            double f = m[r][p] / m[p][p];
+
+            if (r == p)
+            {
+                continue;
+            }
+            for (uint32_t c = p; c < 4u; c++)
+            {
+                m[r][c] -= f * m[p][c];
+            }
+        }
+    }
+    for (uint32_t r = 0u; r < 3u; r++)
+    {
+        coef[r] = m[r][3] / m[r][r];
+    }
+
+    sn = 0.0;
+    cs = 1.0;
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        double tone = coef[0] * sn + coef[1] * cs;
+        double residual = x[i * stride] - tone - coef[2];
+        double next = sn * rot_c + cs * rot_s;
+
+        cs = cs * rot_c - sn * rot_s;
+        sn = next;
+
+        signal += tone * tone;
+        noise += residual * residual;
+    }
+    return 10.0 * log10(signal / (noise + 1e-9));
+}
+
+/*******************************************************************************
+* Function Name: best_snr
+********************************************************************************
+* Summary:
+*   SNR of a block of a sine around the given frequency, at the frequency that
+*   fits best: golden-section search within +/-SIM_FIT_SPAN_PPM. The accuracy
+*   of the rate is checked on the estimate, this checks the resampler.
+*
+*******************************************************************************/
+static double best_snr(const int16_t *x, uint32_t stride, uint32_t n, double cycles_per_sample)
+{
+    const double ratio = 0.6180339887;
+    double lo = cycles_per_sample * (1.0 - SIM_FIT_SPAN_PPM * 1e-6);
+    double hi = cycles_per_sample * (1.0 + SIM_FIT_SPAN_PPM * 1e-6);
+    double a = hi - ratio * (hi - lo);
+    double b = lo + ratio * (hi - lo);
+    double snr_a = fit_snr(x, stride, n, a);
+    double snr_b = fit_snr(x, stride, n, b);
+
+    for (uint32_t i = 0u; i < 24u; i++)
+    {
+        if (snr_a > snr_b)
+        {
+            hi = b;
+            b = a;
+            snr_b = snr_a;
+            a = hi - ratio * (hi - lo);
+            snr_a = fit_snr(x, stride, n, a);
+        }
+        else
+        {
+            lo = a;
+            a = b;
+            snr_a = snr_b;
+            b = lo + ratio * (hi - lo);
+            snr_b = fit_snr(x, stride, n, b);
+        }
+    }
+    return (snr_a > snr_b) ? snr_a : snr_b;
+}
+
+/*******************************************************************************
+* Function Name: simulate_out
+********************************************************************************
+* Summary:
+*   Host to device. drift_ppm is how much faster the device clock runs than
+*   the host clock. The host sends a sine, the device reads 10 ms frames at
+*   its clock. Without compensation, the frames are read as they are.
+*
+*******************************************************************************/
+static void simulate_out(double drift_ppm, bool compensate, sim_result_t *result)
+{
+    static int16_t frame[SIM_FRAME * 2u];
+    static int16_t block[SIM_FIT_BLOCK * 2u];
+    usb_drift_t drift;
+    double tick_period = 10.0 / (1.0 + drift_ppm * 1e-6);     /* In host ms */
+    double next_tick = 0.0;
+    uint64_t host_sample = 0u;
+    uint32_t block_fill = 0u;
+    double snr_sum = 0.0;
+    uint32_t snr_blocks = 0u;
+    double snr_min = 1000.0;
+
+    memset(result, 0, sizeof(*result));
+    usb_drift_fifo_init(&sim_fifo);
+    usb_drift_init(&drift, SIM_OUT_TARGET, 10u);
+    if (!compensate)
+    {
+        drift.kp = 0.0f;
+        drift.ki = 0.0f;
+    }
+    result->fill_min = USB_DRIFT_FIFO_SAMPLES;
+
+    for (uint32_t ms = 0u; ms < SIM_SECONDS * 1000u; ms++)
+    {
+        int16_t packet[SIM_PACKET * 2u];
+
+        for (uint32_t i = 0u; i < SIM_PACKET; i++, host_sample++)
+        {
+            double v = SIM_OUT_AMPLITUDE * sin(2.0 * M_PI * SIM_OUT_TONE_HZ * (double)host_sample / SIM_SAMPLE_RATE);
+
+            packet[2u * i] = (int16_t)lrint(v);
+            packet[2u * i + 1u] = (int16_t)lrint(-v);
+        }
+        (void)usb_drift_fifo_write(&sim_fifo, (const uint8_t *)packet, sizeof(packet));
+
+        while (next_tick <= (double)(ms + 1u))
+        {
+            uint32_t level = usb_drift_fifo_level(&sim_fifo);
+            uint32_t underruns = drift.underruns;
+
+            next_tick += tick_period;
+            usb_drift_fifo_read(&sim_fifo, &drift, frame, SIM_FRAME);
+            if (ms < SIM_SETTLE_SECONDS * 1000u)
+            {
+                continue;
+            }
+
+            if (level < result->fill_min)
+            {
+                result->fill_min = level;
+            }
+            if (level > result->fill_max)
+            {
+                result->fill_max = level;
+            }
+            if (drift.underruns != underruns)
+            {
+                block_fill = 0u;
+                continue;
+            }
+            memcpy(&block[block_fill * 2u], frame, sizeof(frame));
+            block_fill += SIM_FRAME;
+            if (block_fill == SIM_FIT_BLOCK)
+            {
+                /* The device samples the host sine at its own clock */
+                double snr = best_snr(block, 2u, SIM_FIT_BLOCK,
+                                     SIM_OUT_TONE_HZ / (SIM_SAMPLE_RATE * (1.0 + drift_ppm * 1e-6)));
+
+                snr_sum += snr;
+                snr_blocks++;
+                if (snr < snr_min)
+                {
+                    snr_min = snr;
+                }
+                block_fill = 0u;
+            }
+        }
+    }
+    result->overruns = sim_fifo.overruns;
+    result->underruns = drift.underruns;
+    result->ppm = drift.integral;
+    result->snr_db = (snr_blocks > 0u) ? snr_min : 0.0;
+    (void)snr_sum;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    int failures = 0;
+
+    printf("%u s per case, steady state after %u s\n\n", SIM_SECONDS, SIM_SETTLE_SECONDS);
+    printf("IN (device to host)          ppm est  fill min..max  overruns  underruns  discontinuities\n");
+    for (uint32_t d = 0u; d < sizeof(sim_drifts_ppm) / sizeof(sim_drifts_ppm[0]); d++)
+    {
+        for (int compensate = 1; compensate >= 0; compensate--)
+        {
+            sim_result_t r;
+
+            simulate_in(sim_drifts_ppm[d], compensate, &r);
+            printf("  drift %+5.0f ppm %-12s %+7.1f  %4u..%-4u     %6u  %9u  %15u\n", sim_drifts_ppm[d],
+                   compensate ? "compensated" : "nominal", (double)r.ppm, (unsigned)r.fill_min,
+                   (unsigned)r.fill_max, (unsigned)r.overruns, (unsigned)r.underruns,
+                   (unsigned)r.discontinuities);
+            if (compensate && ((r.overruns != 0u) || (r.underruns != 0u) || (r.discontinuities != 0u) ||
+                (fabs(r.ppm - sim_drifts_ppm[d]) > 20.0)))
+            {
+                failures++;
+            }
+        }
+    }
+
+    printf("\nOUT (host to device)         ppm est  fill min..max  overruns  underruns  min SNR\n");
+    for (uint32_t d = 0u; d < sizeof(sim_drifts_ppm) / sizeof(sim_drifts_ppm[0]); d++)
+    {
+        for (int compensate = 1; compensate >= 0; compensate--)
+        {
+            sim_result_t r;
+
+            simulate_out(sim_drifts_ppm[d], compensate, &r);
+            printf("  drift %+5.0f ppm %-12s %+7.1f  %4u..%-4u     %6u  %9u  %5.1f dB\n", sim_drifts_ppm[d],
+                   compensate ? "compensated" : "nominal", (double)r.ppm, (unsigned)r.fill_min,
+                   (unsigned)r.fill_max, (unsigned)r.overruns, (unsigned)r.underruns, r.snr_db);
+            /* The device reads faster when its clock is slower */
+            if (compensate && ((r.overruns != 0u) || (r.underruns != 0u) || (r.snr_db < SIM_OUT_MIN_SNR_DB) ||
+                (fabs(r.ppm + sim_drifts_ppm[d]) > 20.0)))
+            {
+                failures++;
+            }
+        }
+    }
+
+    printf("\n%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
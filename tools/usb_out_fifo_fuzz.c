@@ -0,0 +1,315 @@
+/******************************************************************************
+* File Name : usb_out_fifo_fuzz.c
+*
+* Description :
+* Host fuzz test of the USB audio OUT endpoint packetizer: the byte stream
+* writer of the drift compensation FIFO (usb_drift_fifo_write() in
+* audio_usb_drift.c). Random sequences of packet sizes (nominal, odd, short,
+* empty and the largest the endpoint takes) are written while a consumer
+* drains the FIFO at random, and stalls to force packets to be dropped.
+* Every stereo sample holds its index, and its right channel the complement
+* of its left channel. The samples read are checked against a reference:
+* every sample of which no byte was in a dropped packet is read once, in
+* order and aligned; no other sample is read.
+*
+* Build and run from the repository root:
+*   gcc -O1 -g -fsanitize=address,undefined -Iproj_cm55/source/usb_audio/emusb_audio_class
+*       tools/usb_out_fifo_fuzz.c proj_cm55/source/usb_audio/emusb_audio_class/audio_usb_drift.c
+*       -lm -o usb_out_fifo_fuzz
+*   ./usb_out_fifo_fuzz [seed] [packets]
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio_usb_drift.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Largest OUT packet the endpoint takes, MAX_AUDIO_OUT_PACKET_SIZE_BYTES */
+#define FUZZ_MAX_PACKET         (68u)
+#define FUZZ_SAMPLE_BYTES       (USB_DRIFT_FIFO_CHANNELS * sizeof(int16_t))
+#define FUZZ_DEFAULT_PACKETS    (2000000u)
+
+/* Guard bytes around the packet buffer, checked after every write */
+#define FUZZ_GUARD              (16u)
+#define FUZZ_GUARD_BYTE         (0xA5u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static usb_drift_fifo_t fuzz_fifo;
+static uint32_t fuzz_seed = 1u;
+
+/* Per sample of the stream: true if a byte of it was in a dropped packet */
+static bool *fuzz_lost;
+
+/*******************************************************************************
+* Function Name: fuzz_rand
+********************************************************************************
+* Summary:
+*   Deterministic pseudo-random numbers, so that a failing seed can be rerun.
+*
+*******************************************************************************/
+static uint32_t fuzz_rand(void)
+{
+    fuzz_seed = fuzz_seed * 1664525u + 1013904223u;
+    return fuzz_seed >> 8;
+}
+
+/*******************************************************************************
+* Function Name: fuzz_packet_size
+********************************************************************************
+* Summary:
+*   Size of the next packet. The mode changes every few hundred packets:
+*   nominal 1 ms packets, the largest packets, any size, or dribbles of a
+*   few bytes.
+*
+*******************************************************************************/
+static uint32_t fuzz_packet_size(void)
+{
+    static uint32_t mode = 0u;
+    static uint32_t left = 0u;
+
+    if (left == 0u)
+    {
+        mode = fuzz_rand() % 4u;
+        left = 1u + (fuzz_rand() % 500u);
+    }
+    left--;
+
+    switch (mode)
+    {
+        case 0u:
+            return 64u;
+        case 1u:
+            return FUZZ_MAX_PACKET - (fuzz_rand() % 2u);
+        case 2u:
+            return fuzz_rand() % (FUZZ_MAX_PACKET + 1u);
+        default:
+            return fuzz_rand() % 4u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: fuzz_byte
+********************************************************************************
+* Summary:
+*   Byte of the stream at an offset: sample k holds k in its left channel and
+*   ~k in its right channel, little-endian.
+*
+*******************************************************************************/
+static uint8_t fuzz_byte(uint64_t offset)
+{
+    uint64_t k = offset / FUZZ_SAMPLE_BYTES;
+    uint16_t left = (uint16_t)k;
+    uint16_t right = (uint16_t)~left;
+
+    switch (offset % FUZZ_SAMPLE_BYTES)
+    {
+        case 0u:
+            return (uint8_t)left;
+        case 1u:
+            return (uint8_t)(left >> 8);
+        case 2u:
+            return (uint8_t)right;
+        default:
+            return (uint8_t)(right >> 8);
+    }
+}
+
+/*******************************************************************************
+* Function Name: fuzz_drain
+********************************************************************************
+* Summary:
+*   Read up to count samples as the resampler does at 0 ppm, and check them
+*   against the reference.
+*
+* Parameters:
+*  count    - Samples to read at most
+*  next     - Index of the next sample expected, updated
+*  complete - Number of samples of the stream whose bytes were all written
+*
+* Return:
+*  Number of errors
+*
+*******************************************************************************/
+static uint32_t fuzz_drain(uint32_t count, uint64_t *next, uint64_t complete)
+{
+    uint32_t errors = 0u;
+    uint32_t tail = fuzz_fifo.tail;
+
+    while ((count > 0u) && (tail != fuzz_fifo.head))
+    {
+        const int16_t *sample = fuzz_fifo.samples[tail % USB_DRIFT_FIFO_SAMPLES];
+        uint16_t left = (uint16_t)sample[0];
+        uint16_t right = (uint16_t)sample[1];
+        uint16_t complement = (uint16_t)~left;
+
+        while ((*next < complete) && fuzz_lost[*next])
+        {
+            (*next)++;
+        }
+        if ((*next >= complete) || (left != (uint16_t)*next) || (right != complement))
+        {
+            if (errors == 0u)
+            {
+                printf("  sample %llu: read %04x %04x, expected %04x %04x\n", (unsigned long long)*next,
+                       left, right, (uint16_t)*next, (uint16_t)~(uint16_t)*next);
+            }
+            errors++;
+        }
+        (*next)++;
+        tail++;
+        count--;
+    }
+    fuzz_fifo.tail = tail;
+    return errors;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static uint8_t buffer[FUZZ_GUARD + FUZZ_MAX_PACKET + FUZZ_GUARD];
+    uint8_t *packet = &buffer[FUZZ_GUARD];
+    uint32_t packets = FUZZ_DEFAULT_PACKETS;
+    uint64_t offset = 0u;
+    uint64_t next = 0u;
+    uint64_t lost_samples = 0u;
+    uint32_t dropped = 0u;
+    uint32_t stall = 0u;
+    uint32_t errors = 0u;
+
+    if (argc > 1)
+    {
+        fuzz_seed = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2)
+    {
+        packets = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    fuzz_lost = calloc(((uint64_t)packets * FUZZ_MAX_PACKET / FUZZ_SAMPLE_BYTES) + 2u, sizeof(bool));
+    if (fuzz_lost == NULL)
+    {
+        return 1;
+    }
+
+    usb_drift_fifo_init(&fuzz_fifo);
+    usb_drift_fifo_write_start(&fuzz_fifo);
+    memset(buffer, FUZZ_GUARD_BYTE, sizeof(buffer));
+
+    for (uint32_t p = 0u; p < packets; p++)
+    {
+        uint32_t bytes = fuzz_packet_size();
+        uint32_t overruns = fuzz_fifo.overruns;
+        uint32_t level = usb_drift_fifo_level(&fuzz_fifo);
+
+        for (uint32_t i = 0u; i < bytes; i++)
+        {
+            packet[i] = fuzz_byte(offset + i);
+        }
+        (void)usb_drift_fifo_write(&fuzz_fifo, packet, bytes);
+
+        for (uint32_t i = 0u; i < FUZZ_GUARD; i++)
+        {
+            if ((buffer[i] != FUZZ_GUARD_BYTE) || (packet[FUZZ_MAX_PACKET + i] != FUZZ_GUARD_BYTE))
+            {
+                printf("  packet %u: guard bytes changed\n", (unsigned)p);
+                errors++;
+                break;
+            }
+        }
+
+        if (fuzz_fifo.overruns != overruns)
+        {
+            /* Only a packet that did not fit may be dropped */
+            if ((level + ((bytes + FUZZ_SAMPLE_BYTES - 1u) / FUZZ_SAMPLE_BYTES) + 1u) <= USB_DRIFT_FIFO_SAMPLES)
+            {
+                printf("  packet %u: dropped with %u samples free\n", (unsigned)p,
+                       (unsigned)(USB_DRIFT_FIFO_SAMPLES - level));
+                errors++;
+            }
+            for (uint64_t k = offset / FUZZ_SAMPLE_BYTES; k <= (offset + bytes - 1u) / FUZZ_SAMPLE_BYTES; k++)
+            {
+                if ((bytes > 0u) && !fuzz_lost[k])
+                {
+                    fuzz_lost[k] = true;
+                    lost_samples++;
+                }
+            }
+            dropped++;
+        }
+        offset += bytes;
+
+        /* The consumer reads a 10 ms frame now and then, or stalls */
+        if (stall > 0u)
+        {
+            stall--;
+        }
+        else if ((fuzz_rand() % 1000u) == 0u)
+        {
+            stall = 50u + (fuzz_rand() % 200u);
+        }
+        else if ((fuzz_rand() % 10u) == 0u)
+        {
+            errors += fuzz_drain(160u + (fuzz_rand() % 3u) - 1u, &next, offset / FUZZ_SAMPLE_BYTES);
+        }
+    }
+
+    /* Everything complete and not lost must have been read */
+    errors += fuzz_drain(USB_DRIFT_FIFO_SAMPLES, &next, offset / FUZZ_SAMPLE_BYTES);
+    while ((next < (offset / FUZZ_SAMPLE_BYTES)) && fuzz_lost[next])
+    {
+        next++;
+    }
+    if (next != (offset / FUZZ_SAMPLE_BYTES))
+    {
+        printf("  %llu samples not read\n", (unsigned long long)((offset / FUZZ_SAMPLE_BYTES) - next));
+        errors++;
+    }
+
+    printf("seed %u: %u packets, %llu bytes, %u dropped (%llu samples), %u errors\n",
+           (unsigned)strtoul((argc > 1) ? argv[1] : "1", NULL, 0), (unsigned)packets,
+           (unsigned long long)offset, (unsigned)dropped, (unsigned long long)lost_samples, (unsigned)errors);
+    free(fuzz_lost);
+    printf("%s\n", (errors == 0u) ? "PASS" : "FAIL");
+    return (errors == 0u) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,430 @@
+/******************************************************************************
+* File Name : va_model_pack.c
+*
+* Description :
+* Host packer of the model containers read by the model loader of the CM55
+* (va_model_loader.c, VA_MODEL_LOADER). A container is the 64-byte header
+* va_model_container_hdr_t of va_model_loader.h followed by the model data.
+* The model data is read from the <set>_U55_WWmodel.c or <set>_U55_CMDmodel.c
+* file generated by the DEEPCRAFT Voice Assistant cloud tool, or from a raw
+* binary file.
+*
+* Pack a model into a container, to be copied as <set>_<ww|cmd>.vam into the
+* LittleFS partition:
+*   va_model_pack <model set> <ww|cmd> <version> <model .c|.bin> <output .vam>
+* Concatenate containers into an image of the XIP region, each one at a
+* 16-byte boundary, padded with erased flash:
+*   va_model_pack -x <output image> <container .vam>...
+* Check containers the way the loader does and print their headers:
+*   va_model_pack -c <container .vam>...
+*
+* Build and run from the repository root:
+*   gcc -O1 -o va_model_pack tools/va_model_pack.c
+*   M=proj_cm55/source/voice_assistant/va_models/LED_Demo
+*   ./va_model_pack LED_Demo ww 2 $M/LED_Demo_U55_WWmodel.c LED_Demo_ww.vam
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Container format of va_model_loader.h */
+#define PACK_MAGIC              (0x434D4156UL)  /* "VAMC" */
+#define PACK_FORMAT_VERSION     (1u)
+#define PACK_ALIGN              (16u)
+#define PACK_SET_NAME_LEN       (32u)
+#define PACK_HEADER_SIZE        (64u)
+
+#define PACK_TYPE_WW            (1u)
+#define PACK_TYPE_CMD           (2u)
+
+/* Offsets of the fields in the header, all little endian */
+#define PACK_OFF_MAGIC          (0u)
+#define PACK_OFF_FORMAT_VERSION (4u)
+#define PACK_OFF_HEADER_SIZE    (6u)
+#define PACK_OFF_MODEL_TYPE     (8u)
+#define PACK_OFF_MODEL_VERSION  (12u)
+#define PACK_OFF_PAYLOAD_SIZE   (16u)
+#define PACK_OFF_PAYLOAD_CRC32  (20u)
+#define PACK_OFF_MODEL_SET      (24u)
+#define PACK_OFF_RESERVED       (PACK_OFF_MODEL_SET + PACK_SET_NAME_LEN)
+#define PACK_OFF_HEADER_CRC32   (PACK_OFF_RESERVED + 4u)
+
+_Static_assert(PACK_OFF_HEADER_CRC32 + 4u == PACK_HEADER_SIZE, "Header layout of va_model_loader.h");
+
+/*******************************************************************************
+* Function Name: pack_crc32
+********************************************************************************
+* Summary:
+*   CRC-32 (IEEE 802.3) of the containers, the same as va_model_crc32.
+*
+*******************************************************************************/
+static uint32_t pack_crc32(const uint8_t *data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1u) ? 0xEDB88320UL : 0u);
+        }
+    }
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+static void pack_put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void pack_put32(uint8_t *p, uint32_t value)
+{
+    pack_put16(p, (uint16_t)value);
+    pack_put16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint32_t pack_get16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t pack_get32(const uint8_t *p)
+{
+    return pack_get16(p) | (pack_get16(p + 2) << 16);
+}
+
+/*******************************************************************************
+* Function Name: pack_read_file
+********************************************************************************
+* Summary:
+*   Reads a whole file into a buffer, with a null character after its end.
+*
+*******************************************************************************/
+static uint8_t *pack_read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long length;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    data = malloc((size_t)length + 1u);
+    if ((data == NULL) || (fread(data, 1, (size_t)length, file) != (size_t)length))
+    {
+        fprintf(stderr, "Cannot read %s\n", path);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    data[length] = '\0';
+    fclose(file);
+    *size = (size_t)length;
+    return data;
+}
+
+/*******************************************************************************
+* Function Name: pack_parse_array
+********************************************************************************
+* Summary:
+*   Converts the initializer of the model array of a generated .c file into
+*   bytes, in place. Returns false if the file has no array or a value is not
+*   a byte.
+*
+*******************************************************************************/
+static bool pack_parse_array(uint8_t *text, size_t *size, const char *path)
+{
+    char *p = strchr((char *)text, '=');
+    size_t count = 0;
+
+    p = (p == NULL) ? NULL : strchr(p, '{');
+    if (p == NULL)
+    {
+        fprintf(stderr, "%s: no array initializer\n", path);
+        return false;
+    }
+    p++;
+
+    while (true)
+    {
+        char *end;
+        unsigned long value;
+
+        while (isspace((unsigned char)*p) || (*p == ','))
+        {
+            p++;
+        }
+        if (*p == '}')
+        {
+            break;
+        }
+        value = strtoul(p, &end, 0);
+        if ((end == p) || (value > 0xFFu))
+        {
+            fprintf(stderr, "%s: invalid byte in the array\n", path);
+            return false;
+        }
+        /* The bytes are never written past the text already parsed */
+        text[count++] = (uint8_t)value;
+        p = end;
+    }
+
+    *size = count;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pack_model
+********************************************************************************
+* Summary:
+*   Writes a container with the model of a file.
+*
+*******************************************************************************/
+static bool pack_model(const char *set, const char *type, const char *version,
+                       const char *input, const char *output)
+{
+    uint8_t header[PACK_HEADER_SIZE] = { 0 };
+    uint32_t model_type;
+    size_t input_len = strlen(input);
+    size_t size;
+    uint8_t *model;
+    FILE *file;
+    bool ok;
+
+    if (strlen(set) >= PACK_SET_NAME_LEN)
+    {
+        fprintf(stderr, "Model set name %s longer than %u characters\n", set, PACK_SET_NAME_LEN - 1u);
+        return false;
+    }
+    if (0 == strcmp(type, "ww"))
+    {
+        model_type = PACK_TYPE_WW;
+    }
+    else if (0 == strcmp(type, "cmd"))
+    {
+        model_type = PACK_TYPE_CMD;
+    }
+    else
+    {
+        fprintf(stderr, "Model type %s is not ww or cmd\n", type);
+        return false;
+    }
+
+    model = pack_read_file(input, &size);
+    if (model == NULL)
+    {
+        return false;
+    }
+    if ((input_len > 2u) && (0 == strcmp(input + input_len - 2u, ".c")) &&
+        !pack_parse_array(model, &size, input))
+    {
+        free(model);
+        return false;
+    }
+
+    pack_put32(header + PACK_OFF_MAGIC, PACK_MAGIC);
+    pack_put16(header + PACK_OFF_FORMAT_VERSION, PACK_FORMAT_VERSION);
+    pack_put16(header + PACK_OFF_HEADER_SIZE, PACK_HEADER_SIZE);
+    pack_put32(header + PACK_OFF_MODEL_TYPE, model_type);
+    pack_put32(header + PACK_OFF_MODEL_VERSION, (uint32_t)strtoul(version, NULL, 0));
+    pack_put32(header + PACK_OFF_PAYLOAD_SIZE, (uint32_t)size);
+    pack_put32(header + PACK_OFF_PAYLOAD_CRC32, pack_crc32(model, size));
+    memcpy(header + PACK_OFF_MODEL_SET, set, strlen(set));
+    pack_put32(header + PACK_OFF_HEADER_CRC32, pack_crc32(header, PACK_OFF_HEADER_CRC32));
+
+    file = fopen(output, "wb");
+    ok = (file != NULL) &&
+         (fwrite(header, 1, sizeof(header), file) == sizeof(header)) &&
+         (fwrite(model, 1, size, file) == size);
+    if ((file != NULL) && (fclose(file) != 0))
+    {
+        ok = false;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Cannot write %s\n", output);
+    }
+    else
+    {
+        printf("%s: %s model of %s, version %s, %zu bytes\n", output, type, set, version, size);
+    }
+    free(model);
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: pack_check
+********************************************************************************
+* Summary:
+*   Checks a container with the tests of va_model_check_header and of the
+*   payload CRC, and prints its header. Returns the size of the container, 0
+*   if it is not valid.
+*
+*******************************************************************************/
+static size_t pack_check(const uint8_t *data, size_t size, const char *path)
+{
+    char set[PACK_SET_NAME_LEN + 1u] = { 0 };
+    uint32_t payload_size;
+
+    if ((size < PACK_HEADER_SIZE) ||
+        (pack_get32(data + PACK_OFF_MAGIC) != PACK_MAGIC) ||
+        (pack_get16(data + PACK_OFF_FORMAT_VERSION) != PACK_FORMAT_VERSION) ||
+        (pack_get16(data + PACK_OFF_HEADER_SIZE) != PACK_HEADER_SIZE))
+    {
+        fprintf(stderr, "%s: not a container of format version %u\n", path, PACK_FORMAT_VERSION);
+        return 0;
+    }
+    if (pack_get32(data + PACK_OFF_HEADER_CRC32) != pack_crc32(data, PACK_OFF_HEADER_CRC32))
+    {
+        fprintf(stderr, "%s: header CRC error\n", path);
+        return 0;
+    }
+    payload_size = pack_get32(data + PACK_OFF_PAYLOAD_SIZE);
+    if ((size - PACK_HEADER_SIZE) < payload_size)
+    {
+        fprintf(stderr, "%s: payload of %u bytes truncated\n", path, payload_size);
+        return 0;
+    }
+    if (pack_get32(data + PACK_OFF_PAYLOAD_CRC32) != pack_crc32(data + PACK_HEADER_SIZE, payload_size))
+    {
+        fprintf(stderr, "%s: payload CRC error\n", path);
+        return 0;
+    }
+
+    memcpy(set, data + PACK_OFF_MODEL_SET, PACK_SET_NAME_LEN);
+    printf("%s: %s model of %s, version %u, %u bytes\n", path,
+           (pack_get32(data + PACK_OFF_MODEL_TYPE) == PACK_TYPE_WW) ? "ww" :
+           (pack_get32(data + PACK_OFF_MODEL_TYPE) == PACK_TYPE_CMD) ? "cmd" : "unknown",
+           set, pack_get32(data + PACK_OFF_MODEL_VERSION), payload_size);
+    return PACK_HEADER_SIZE + payload_size;
+}
+
+/*******************************************************************************
+* Function Name: pack_xip_image
+********************************************************************************
+* Summary:
+*   Writes the containers back to back, each one at a PACK_ALIGN boundary as
+*   va_model_find_xip expects, padded with 0xFF.
+*
+*******************************************************************************/
+static bool pack_xip_image(const char *output, char *inputs[], int num_inputs)
+{
+    static const uint8_t erased[PACK_ALIGN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    FILE *file = fopen(output, "wb");
+    size_t offset = 0;
+    bool ok = (file != NULL);
+
+    for (int i = 0; ok && (i < num_inputs); i++)
+    {
+        size_t size;
+        size_t length;
+        uint8_t *data = pack_read_file(inputs[i], &size);
+
+        length = (data == NULL) ? 0 : pack_check(data, size, inputs[i]);
+        ok = (length != 0) && (fwrite(data, 1, length, file) == length);
+        offset += length;
+        if (ok && ((offset % PACK_ALIGN) != 0u))
+        {
+            size_t padding = PACK_ALIGN - (offset % PACK_ALIGN);
+            ok = (fwrite(erased, 1, padding, file) == padding);
+            offset += padding;
+        }
+        free(data);
+    }
+
+    if ((file != NULL) && (fclose(file) != 0))
+    {
+        ok = false;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Cannot write %s\n", output);
+    }
+    else
+    {
+        printf("%s: %zu bytes\n", output, offset);
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    if ((argc >= 4) && (0 == strcmp(argv[1], "-x")))
+    {
+        return pack_xip_image(argv[2], &argv[3], argc - 3) ? 0 : 1;
+    }
+
+    if ((argc >= 3) && (0 == strcmp(argv[1], "-c")))
+    {
+        int errors = 0;
+
+        for (int i = 2; i < argc; i++)
+        {
+            size_t size;
+            uint8_t *data = pack_read_file(argv[i], &size);
+
+            errors += ((data == NULL) || (pack_check(data, size, argv[i]) == 0)) ? 1 : 0;
+            free(data);
+        }
+        return (errors == 0) ? 0 : 1;
+    }
+
+    if (argc == 6)
+    {
+        return pack_model(argv[1], argv[2], argv[3], argv[4], argv[5]) ? 0 : 1;
+    }
+
+    fprintf(stderr, "Usage: %s <model set> <ww|cmd> <version> <model .c|.bin> <output .vam>\n"
+                    "       %s -x <output image> <container .vam>...\n"
+                    "       %s -c <container .vam>...\n", argv[0], argv[0], argv[0]);
+    return 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,1157 @@
+/******************************************************************************
+* File Name : va_string_table_gen.c
+*
+* Description :
+* Host generator of the string table of the DEEPCRAFT Voice Assistant model
+* sets. The CM55 sends the events of the Voice Assistant to the CM33 as
+* integer IDs (intent, variables, phrases and units, see ipc_communication.h),
+* and the CM33 turns them back into strings with this table. The string lists
+* are read from the <set>_config.c file of every model set, generated by the
+* DEEPCRAFT Voice Assistant cloud tool.
+*
+* The generator also writes the decoding index of every model set, built
+* into the CM55 application: the start of every command record in the intent
+* map, the variable of every variable phrase and the first phrase of every
+* variable, and the variable of every slot of an intent. A detection is then
+* decoded with table lookups only, whatever the number of commands.
+*
+* The IDs of the model sets are given in the order of the command line: add
+* a new model set at the end to keep the IDs of the others. Rerun after a
+* model set is regenerated; the CM55 build checks the sizes of the lists
+* against the table.
+*
+* Build and run from the repository root:
+*   gcc -O1 -o va_string_table_gen tools/va_string_table_gen.c
+*   ./va_string_table_gen proj_cm55/source/voice_assistant/va_models shared
+*       Smart_Lights_Demo LED_Demo Cooktop_Demo
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define GEN_MAX_SETS            (32u)
+#define GEN_MAX_ENTRIES         (1024u)
+#define GEN_MAX_COMMANDS        (16384u)
+#define GEN_MAX_MAP_ENTRIES     (GEN_MAX_COMMANDS * 8u)
+#define GEN_MAX_IDENTIFIER      (128u)
+#define GEN_MAX_PATH            (512u)
+#define GEN_DEFINE_WIDTH        (64)
+
+/* The IPC event records carry IDs of unit phrases in 8 bits, and reserve
+ * 0xFF for "no unit"
+ */
+#define GEN_MAX_UNITS           (255u)
+
+/* Variables per command in the decoding index, and the variable of a slot
+ * that differs between the commands of an intent
+ */
+#define GEN_MAX_VARIABLE_SLOTS  (4u)
+#define GEN_VARIABLE_UNKNOWN    (0xFFFFu)
+
+#define GEN_HEADER_NAME         "va_string_table.h"
+#define GEN_SOURCE_NAME         "va_string_table.c"
+#define GEN_INDEX_HEADER_NAME   "va_model_index.h"
+#define GEN_INDEX_SOURCE_NAME   "va_model_index.c"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    char        *entries[GEN_MAX_ENTRIES];
+    uint32_t    count;
+} gen_list_t;
+
+typedef struct
+{
+    const char  *name;
+    gen_list_t  intents;
+    gen_list_t  variables;
+    gen_list_t  phrases;
+    gen_list_t  units;
+    long        phrase_sizes[GEN_MAX_ENTRIES];
+    uint32_t    num_phrase_sizes;
+    long        *intent_map;
+    uint32_t    intent_map_size;
+    long        *command_sizes;
+    uint32_t    num_commands;
+
+    /* Decoding index */
+    uint32_t    *command_offsets;
+    uint16_t    phrase_variable[GEN_MAX_ENTRIES];
+    uint16_t    variable_offsets[GEN_MAX_ENTRIES];
+    uint16_t    intent_slot_variable[GEN_MAX_ENTRIES][GEN_MAX_VARIABLE_SLOTS];
+} gen_set_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static gen_set_t gen_sets[GEN_MAX_SETS];
+static uint32_t gen_num_sets;
+
+static const char *const gen_license[] =
+{
+    "* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon",
+    "* Technologies AG. All rights reserved.",
+    "* This software, associated documentation and materials (\"Software\") is",
+    "* owned by Infineon Technologies AG or one of its affiliates (\"Infineon\")",
+    "* and is protected by and subject to worldwide patent protection, worldwide",
+    "* copyright laws, and international treaty provisions. Therefore, you may use",
+    "* this Software only as provided in the license agreement accompanying the",
+    "* software package from which you obtained this Software. If no license",
+    "* agreement applies, then any use, reproduction, modification, translation, or",
+    "* compilation of this Software is prohibited without the express written",
+    "* permission of Infineon.",
+    "*",
+    "* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE",
+    "* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,",
+    "* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF",
+    "* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A",
+    "* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.",
+    "* Infineon reserves the right to make changes to the Software without notice.",
+    "* You are responsible for properly designing, programming, and testing the",
+    "* functionality and safety of your intended application of the Software, as",
+    "* well as complying with any legal requirements related to its use. Infineon",
+    "* does not guarantee that the Software will be free from intrusion, data theft",
+    "* or loss, or other breaches (\"Security Breaches\"), and Infineon shall have",
+    "* no liability arising out of any Security Breaches. Unless otherwise",
+    "* explicitly approved by Infineon, the Software may not be used in any",
+    "* application where a failure of the Product or any consequences of the use",
+    "* thereof can reasonably be expected to result in personal injury.",
+};
+
+/* Lookup functions of the generated source file */
+static const char *const gen_functions[] =
+{
+    "/*******************************************************************************",
+    " * Function Name: va_string_table_model_name",
+    " *******************************************************************************",
+    " * Summary:",
+    " * Returns the name of a model set, NULL if the ID is unknown.",
+    " *",
+    " *******************************************************************************/",
+    "const char* va_string_table_model_name(uint8_t model_id)",
+    "{",
+    "    return (model_id < VA_STR_NUM_MODELS) ? va_string_table_sets[model_id].name : NULL;",
+    "}",
+    "",
+    "/*******************************************************************************",
+    " * Function Name: va_string_table_intent",
+    " *******************************************************************************",
+    " * Summary:",
+    " * Returns the name of an intent of a model set, NULL if an ID is unknown.",
+    " *",
+    " *******************************************************************************/",
+    "const char* va_string_table_intent(uint8_t model_id, uint16_t intent_id)",
+    "{",
+    "    if ((model_id >= VA_STR_NUM_MODELS) || (intent_id >= va_string_table_sets[model_id].num_intents))",
+    "    {",
+    "        return NULL;",
+    "    }",
+    "    return va_string_table_sets[model_id].intents[intent_id];",
+    "}",
+    "",
+    "/*******************************************************************************",
+    " * Function Name: va_string_table_variable",
+    " *******************************************************************************",
+    " * Summary:",
+    " * Returns the name of a variable of a model set, NULL if an ID is unknown.",
+    " *",
+    " *******************************************************************************/",
+    "const char* va_string_table_variable(uint8_t model_id, uint16_t variable_id)",
+    "{",
+    "    if ((model_id >= VA_STR_NUM_MODELS) || (variable_id >= va_string_table_sets[model_id].num_variables))",
+    "    {",
+    "        return NULL;",
+    "    }",
+    "    return va_string_table_sets[model_id].variables[variable_id];",
+    "}",
+    "",
+    "/*******************************************************************************",
+    " * Function Name: va_string_table_phrase",
+    " *******************************************************************************",
+    " * Summary:",
+    " * Returns a variable phrase of a model set, NULL if an ID is unknown.",
+    " *",
+    " *******************************************************************************/",
+    "const char* va_string_table_phrase(uint8_t model_id, uint32_t phrase_id)",
+    "{",
+    "    if ((model_id >= VA_STR_NUM_MODELS) || (phrase_id >= va_string_table_sets[model_id].num_phrases))",
+    "    {",
+    "        return NULL;",
+    "    }",
+    "    return va_string_table_sets[model_id].phrases[phrase_id];",
+    "}",
+    "",
+    "/*******************************************************************************",
+    " * Function Name: va_string_table_unit",
+    " *******************************************************************************",
+    " * Summary:",
+    " * Returns a unit phrase of a model set, NULL if an ID is unknown.",
+    " *",
+    " *******************************************************************************/",
+    "const char* va_string_table_unit(uint8_t model_id, uint8_t unit_id)",
+    "{",
+    "    if ((model_id >= VA_STR_NUM_MODELS) || (unit_id >= va_string_table_sets[model_id].num_units))",
+    "    {",
+    "        return NULL;",
+    "    }",
+    "    return va_string_table_sets[model_id].units[unit_id];",
+    "}",
+};
+
+/*******************************************************************************
+* Function Name: gen_read_file
+********************************************************************************
+* Summary:
+*   Reads a whole text file into a buffer terminated by a null character.
+*
+*******************************************************************************/
+static char *gen_read_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    char *text;
+    long size;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    text = malloc((size_t)size + 1u);
+    if ((text == NULL) || (fread(text, 1, (size_t)size, file) != (size_t)size))
+    {
+        fprintf(stderr, "Cannot read %s\n", path);
+        free(text);
+        fclose(file);
+        return NULL;
+    }
+    text[size] = '\0';
+    fclose(file);
+    return text;
+}
+
+/*******************************************************************************
+* Function Name: gen_find_array
+********************************************************************************
+* Summary:
+*   Finds the definition "<set><suffix>[...] = {" of a generated array, and
+*   returns the first character of its initializer, NULL if it is missing.
+*   References to the array (without the brackets) are skipped.
+*
+*******************************************************************************/
+static const char *gen_find_array(const char *text, const char *set, const char *suffix)
+{
+    char name[GEN_MAX_IDENTIFIER];
+    const char *p = text;
+    size_t length;
+
+    snprintf(name, sizeof(name), "%s%s", set, suffix);
+    length = strlen(name);
+
+    while ((p = strstr(p, name)) != NULL)
+    {
+        bool start = (p == text) || !(isalnum((unsigned char)p[-1]) || (p[-1] == '_'));
+        const char *q = p + length;
+
+        p = q;
+        if (!start)
+        {
+            continue;
+        }
+        while (isspace((unsigned char)*q))
+        {
+            q++;
+        }
+        if (*q != '[')
+        {
+            continue;
+        }
+        q = strchr(q, '=');
+        if (q == NULL)
+        {
+            return NULL;
+        }
+        q = strchr(q, '{');
+        return (q == NULL) ? NULL : (q + 1);
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: gen_skip_comment
+********************************************************************************
+* Summary:
+*   Skips a comment starting at p, if any.
+*
+*******************************************************************************/
+static const char *gen_skip_comment(const char *p)
+{
+    if ((p[0] == '/') && (p[1] == '/'))
+    {
+        while ((*p != '\0') && (*p != '\n'))
+        {
+            p++;
+        }
+    }
+    else if ((p[0] == '/') && (p[1] == '*'))
+    {
+        const char *end = strstr(p + 2, "*/");
+        p = (end == NULL) ? (p + strlen(p)) : (end + 2);
+    }
+    return p;
+}
+
+/*******************************************************************************
+* Function Name: gen_parse_strings
+********************************************************************************
+* Summary:
+*   Parses the string literals of an array initializer up to its closing
+*   brace. Escape sequences are kept as they are, as the strings are written
+*   back as C literals.
+*
+*******************************************************************************/
+static bool gen_parse_strings(const char *p, gen_list_t *list, const char *what)
+{
+    list->count = 0;
+
+    while (*p != '}')
+    {
+        const char *next = gen_skip_comment(p);
+
+        if (next != p)
+        {
+            p = next;
+            continue;
+        }
+        if (*p == '\0')
+        {
+            fprintf(stderr, "Unterminated %s\n", what);
+            return false;
+        }
+        if (*p != '"')
+        {
+            p++;
+            continue;
+        }
+
+        const char *start = ++p;
+        while ((*p != '"') && (*p != '\0') && (*p != '\n'))
+        {
+            p += (*p == '\\') ? 2 : 1;
+        }
+        if (*p != '"')
+        {
+            fprintf(stderr, "Unterminated string in %s\n", what);
+            return false;
+        }
+        if (list->count >= GEN_MAX_ENTRIES)
+        {
+            fprintf(stderr, "Too many entries in %s\n", what);
+            return false;
+        }
+        list->entries[list->count] = malloc((size_t)(p - start) + 1u);
+        memcpy(list->entries[list->count], start, (size_t)(p - start));
+        list->entries[list->count][p - start] = '\0';
+        list->count++;
+        p++;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: gen_parse_numbers
+********************************************************************************
+* Summary:
+*   Parses the integers of an array initializer up to its closing brace.
+*
+*******************************************************************************/
+static bool gen_parse_numbers(const char *p, long *numbers, uint32_t max, uint32_t *count, const char *what)
+{
+    *count = 0;
+
+    while (*p != '}')
+    {
+        const char *next = gen_skip_comment(p);
+        char *end;
+
+        if (next != p)
+        {
+            p = next;
+            continue;
+        }
+        if (*p == '\0')
+        {
+            fprintf(stderr, "Unterminated %s\n", what);
+            return false;
+        }
+        if (!isdigit((unsigned char)*p) && (*p != '-'))
+        {
+            p++;
+            continue;
+        }
+        if (*count >= max)
+        {
+            fprintf(stderr, "Too many entries in %s\n", what);
+            return false;
+        }
+        numbers[(*count)++] = strtol(p, &end, 0);
+        p = end;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: gen_load_set
+********************************************************************************
+* Summary:
+*   Reads the string lists of a model set from its <set>_config.c file, as
+*   generated by the DEEPCRAFT Voice Assistant cloud tool.
+*
+*******************************************************************************/
+static bool gen_load_set(gen_set_t *set, const char *models_dir)
+{
+    static const char *const suffixes[] =
+    {
+        "_intent_name_list", "_variable_name_list", "_variable_phrase_list", "_unit_phrase_list"
+    };
+    gen_list_t *lists[] = { &set->intents, &set->variables, &set->phrases, &set->units };
+    char path[GEN_MAX_PATH];
+    const char *p;
+    char *text;
+    uint32_t expected = 0;
+    bool ok = true;
+
+    snprintf(path, sizeof(path), "%s/%s/%s_config.c", models_dir, set->name, set->name);
+    text = gen_read_file(path);
+    if (text == NULL)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; ok && (i < sizeof(suffixes) / sizeof(suffixes[0])); i++)
+    {
+        p = gen_find_array(text, set->name, suffixes[i]);
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: no %s%s\n", path, set->name, suffixes[i]);
+            ok = false;
+        }
+        else
+        {
+            ok = gen_parse_strings(p, lists[i], suffixes[i] + 1);
+        }
+    }
+
+    if (ok)
+    {
+        p = gen_find_array(text, set->name, "_variable_phrase_sizes");
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: no %s_variable_phrase_sizes\n", path, set->name);
+            ok = false;
+        }
+        else
+        {
+            ok = gen_parse_numbers(p, set->phrase_sizes, GEN_MAX_ENTRIES, &set->num_phrase_sizes,
+                "variable_phrase_sizes");
+        }
+    }
+
+    if (ok)
+    {
+        set->intent_map = malloc(GEN_MAX_MAP_ENTRIES * sizeof(long));
+        set->command_sizes = malloc(GEN_MAX_COMMANDS * sizeof(long));
+        set->command_offsets = malloc(GEN_MAX_COMMANDS * sizeof(uint32_t));
+        ok = (set->intent_map != NULL) && (set->command_sizes != NULL) && (set->command_offsets != NULL);
+    }
+    if (ok)
+    {
+        p = gen_find_array(text, set->name, "_intent_map_array");
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: no %s_intent_map_array\n", path, set->name);
+            ok = false;
+        }
+        else
+        {
+            ok = gen_parse_numbers(p, set->intent_map, GEN_MAX_MAP_ENTRIES, &set->intent_map_size,
+                "intent_map_array");
+        }
+    }
+    if (ok)
+    {
+        p = gen_find_array(text, set->name, "_intent_map_array_sizes");
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: no %s_intent_map_array_sizes\n", path, set->name);
+            ok = false;
+        }
+        else
+        {
+            ok = gen_parse_numbers(p, set->command_sizes, GEN_MAX_COMMANDS, &set->num_commands,
+                "intent_map_array_sizes");
+        }
+    }
+
+    /* Variables without phrases (numbers) still have one empty phrase */
+    if (ok && (set->num_phrase_sizes != set->variables.count))
+    {
+        fprintf(stderr, "%s: %u phrase sizes for %u variables\n", path,
+            set->num_phrase_sizes, set->variables.count);
+        ok = false;
+    }
+    for (uint32_t i = 0; ok && (i < set->num_phrase_sizes); i++)
+    {
+        expected += (set->phrase_sizes[i] > 0) ? (uint32_t)set->phrase_sizes[i] : 1u;
+    }
+    if (ok && (expected != set->phrases.count))
+    {
+        fprintf(stderr, "%s: %u variable phrases, %u expected\n", path, set->phrases.count, expected);
+        ok = false;
+    }
+    if (ok && (set->units.count > GEN_MAX_UNITS))
+    {
+        fprintf(stderr, "%s: more than %u unit phrases\n", path, GEN_MAX_UNITS);
+        ok = false;
+    }
+
+    free(text);
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: gen_build_index
+********************************************************************************
+* Summary:
+*   Builds the decoding index of a model set, and checks every command record
+*   of its intent map (intent, n, n x (variable, phrase)) on the way. The
+*   variable of a slot of an intent is known if all its commands agree on it.
+*
+*******************************************************************************/
+static bool gen_build_index(gen_set_t *set)
+{
+    uint32_t offset = 0;
+
+    /* Variables without phrases (numbers) still have one empty phrase */
+    for (uint32_t v = 0; v < set->variables.count; v++)
+    {
+        uint32_t count = (set->phrase_sizes[v] > 0) ? (uint32_t)set->phrase_sizes[v] : 1u;
+
+        set->variable_offsets[v] = (uint16_t)offset;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            set->phrase_variable[offset + i] = (uint16_t)v;
+        }
+        offset += count;
+    }
+
+    for (uint32_t i = 0; i < set->intents.count; i++)
+    {
+        for (uint32_t slot = 0; slot < GEN_MAX_VARIABLE_SLOTS; slot++)
+        {
+            /* Not seen in any command yet */
+            set->intent_slot_variable[i][slot] = GEN_VARIABLE_UNKNOWN - 1u;
+        }
+    }
+
+    offset = 0;
+    for (uint32_t c = 0; c < set->num_commands; c++)
+    {
+        const long *record = &set->intent_map[offset];
+        long intent;
+        long num_vars;
+
+        if ((offset + 2u > set->intent_map_size) || (set->command_sizes[c] < 2))
+        {
+            fprintf(stderr, "%s: command %u is past the intent map\n", set->name, c);
+            return false;
+        }
+        intent = record[0];
+        num_vars = record[1];
+        if ((intent < 0) || ((uint32_t)intent >= set->intents.count) || (num_vars < 0) ||
+            (set->command_sizes[c] != 2 + (2 * num_vars)) ||
+            (offset + (uint32_t)set->command_sizes[c] > set->intent_map_size))
+        {
+            fprintf(stderr, "%s: command %u has a bad record\n", set->name, c);
+            return false;
+        }
+
+        set->command_offsets[c] = offset;
+
+        for (uint32_t slot = 0; (slot < (uint32_t)num_vars) && (slot < GEN_MAX_VARIABLE_SLOTS); slot++)
+        {
+            uint16_t *slot_variable = &set->intent_slot_variable[intent][slot];
+            long variable = record[2u + (2u * slot)];
+
+            if ((variable < 0) || ((uint32_t)variable >= set->variables.count))
+            {
+                fprintf(stderr, "%s: command %u has a bad variable\n", set->name, c);
+                return false;
+            }
+            if (*slot_variable == GEN_VARIABLE_UNKNOWN - 1u)
+            {
+                *slot_variable = (uint16_t)variable;
+            }
+            else if (*slot_variable != (uint16_t)variable)
+            {
+                *slot_variable = GEN_VARIABLE_UNKNOWN;
+            }
+        }
+        offset += (uint32_t)set->command_sizes[c];
+    }
+
+    if (offset != set->intent_map_size)
+    {
+        fprintf(stderr, "%s: %u intent map entries, %u used by the commands\n", set->name,
+            set->intent_map_size, offset);
+        return false;
+    }
+
+    /* Unused slots are unknown too */
+    for (uint32_t i = 0; i < set->intents.count; i++)
+    {
+        for (uint32_t slot = 0; slot < GEN_MAX_VARIABLE_SLOTS; slot++)
+        {
+            if (set->intent_slot_variable[i][slot] >= set->variables.count)
+            {
+                set->intent_slot_variable[i][slot] = GEN_VARIABLE_UNKNOWN;
+            }
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: gen_identifier
+********************************************************************************
+* Summary:
+*   Turns a string into the end of a macro name: every run of characters
+*   that cannot be in an identifier becomes one underscore. Returns false if
+*   nothing is left.
+*
+*******************************************************************************/
+static bool gen_identifier(char *out, size_t size, const char *text)
+{
+    size_t length = 0;
+    bool separator = false;
+
+    for (; (*text != '\0') && (length + 2u < size); text++)
+    {
+        if (isalnum((unsigned char)*text))
+        {
+            if (separator && (length > 0u))
+            {
+                out[length++] = '_';
+            }
+            out[length++] = *text;
+            separator = false;
+        }
+        else
+        {
+            separator = true;
+        }
+    }
+    out[length] = '\0';
+    return (length > 0u);
+}
+
+/*******************************************************************************
+* Function Name: gen_write_banner
+********************************************************************************
+* Summary:
+*   Writes the file banner of a generated file.
+*
+*******************************************************************************/
+static void gen_write_banner(FILE *file, const char *name, const char *description)
+{
+    fprintf(file, "/******************************************************************************\n");
+    fprintf(file, "* File Name : %s\n", name);
+    fprintf(file, "*\n");
+    fprintf(file, "* Description :\n");
+    fprintf(file, "* %s\n", description);
+    fprintf(file, "* Generated by tools/va_string_table_gen.c from the *_config.c files of the\n");
+    fprintf(file, "* model sets. Do not edit.\n");
+    fprintf(file, "********************************************************************************\n");
+    for (uint32_t i = 0; i < sizeof(gen_license) / sizeof(gen_license[0]); i++)
+    {
+        fprintf(file, "%s\n", gen_license[i]);
+    }
+    fprintf(file, "*******************************************************************************/\n\n");
+}
+
+/*******************************************************************************
+* Function Name: gen_write_define
+********************************************************************************
+* Summary:
+*   Writes an unsigned integer macro, its value aligned to the others.
+*
+*******************************************************************************/
+static void gen_write_define(FILE *file, uint32_t value, const char *format, ...)
+{
+    char name[GEN_MAX_IDENTIFIER * 3u];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(name, sizeof(name), format, args);
+    va_end(args);
+    fprintf(file, "#define %-*s (%uu)\n", GEN_DEFINE_WIDTH, name, value);
+}
+
+/*******************************************************************************
+* Function Name: gen_write_header
+********************************************************************************
+* Summary:
+*   Writes the header shared by both cores: the IDs of the model sets, and
+*   per model set the sizes of its lists and the IDs of its intents,
+*   variables and variable phrases.
+*
+*******************************************************************************/
+static bool gen_write_header(const char *path)
+{
+    char id[GEN_MAX_IDENTIFIER];
+    char phrase[GEN_MAX_IDENTIFIER];
+    uint32_t max_variables = 0;
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return false;
+    }
+
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        if (gen_sets[s].variables.count > max_variables)
+        {
+            max_variables = gen_sets[s].variables.count;
+        }
+    }
+
+    gen_write_banner(file, GEN_HEADER_NAME,
+        "IDs of the strings of the DEEPCRAFT Voice Assistant model sets");
+    fprintf(file, "#ifndef VA_STRING_TABLE_H\n#define VA_STRING_TABLE_H\n\n");
+    fprintf(file, "#if defined(__cplusplus)\nextern \"C\" {\n#endif /* __cplusplus */\n\n");
+    fprintf(file, "#include <stdint.h>\n\n");
+
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Macros\n");
+    fprintf(file, "*******************************************************************************/\n");
+    fprintf(file, "/* Model sets. A new model set is given the next ID, so that the IDs of the\n");
+    fprintf(file, " * others do not change.\n */\n");
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        gen_write_define(file, s, "VA_STR_MODEL_%s", gen_sets[s].name);
+    }
+    gen_write_define(file, gen_num_sets, "VA_STR_NUM_MODELS");
+
+    fprintf(file, "\n/* Most variables of a model set, to decode the variables of a command by\n");
+    fprintf(file, " * their ID\n */\n");
+    gen_write_define(file, max_variables, "VA_STR_MAX_NUM_VARIABLES");
+
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        const gen_set_t *set = &gen_sets[s];
+        uint32_t phrase_id = 0;
+
+        fprintf(file, "\n/* %s */\n", set->name);
+        gen_write_define(file, set->intents.count, "VA_STR_%s_NUM_INTENTS", set->name);
+        gen_write_define(file, set->variables.count, "VA_STR_%s_NUM_VARIABLES", set->name);
+        gen_write_define(file, set->phrases.count, "VA_STR_%s_NUM_VARIABLE_PHRASES", set->name);
+        gen_write_define(file, set->units.count, "VA_STR_%s_NUM_UNIT_PHRASES", set->name);
+
+        for (uint32_t i = 0; i < set->intents.count; i++)
+        {
+            if (!gen_identifier(id, sizeof(id), set->intents.entries[i]))
+            {
+                fprintf(stderr, "%s: intent %u has no name\n", set->name, i);
+                fclose(file);
+                return false;
+            }
+            gen_write_define(file, i, "VA_STR_%s_INTENT_%s", set->name, id);
+        }
+        for (uint32_t i = 0; i < set->variables.count; i++)
+        {
+            if (!gen_identifier(id, sizeof(id), set->variables.entries[i]))
+            {
+                fprintf(stderr, "%s: variable %u has no name\n", set->name, i);
+                fclose(file);
+                return false;
+            }
+            gen_write_define(file, i, "VA_STR_%s_VARIABLE_%s", set->name, id);
+        }
+
+        /* Phrases, named after their variable: the same phrase can be used
+         * by several variables. Empty phrases of number variables are left out.
+         */
+        for (uint32_t v = 0; v < set->variables.count; v++)
+        {
+            uint32_t count = (set->phrase_sizes[v] > 0) ? (uint32_t)set->phrase_sizes[v] : 1u;
+
+            gen_identifier(id, sizeof(id), set->variables.entries[v]);
+            for (uint32_t i = 0; i < count; i++, phrase_id++)
+            {
+                if (gen_identifier(phrase, sizeof(phrase), set->phrases.entries[phrase_id]))
+                {
+                    gen_write_define(file, phrase_id, "VA_STR_%s_PHRASE_%s_%s", set->name, id, phrase);
+                }
+            }
+        }
+    }
+
+    fprintf(file, "\n/*******************************************************************************\n");
+    fprintf(file, "* Functions Prototypes\n");
+    fprintf(file, "*******************************************************************************/\n");
+    fprintf(file, "const char* va_string_table_model_name(uint8_t model_id);\n");
+    fprintf(file, "const char* va_string_table_intent(uint8_t model_id, uint16_t intent_id);\n");
+    fprintf(file, "const char* va_string_table_variable(uint8_t model_id, uint16_t variable_id);\n");
+    fprintf(file, "const char* va_string_table_phrase(uint8_t model_id, uint32_t phrase_id);\n");
+    fprintf(file, "const char* va_string_table_unit(uint8_t model_id, uint8_t unit_id);\n\n");
+    fprintf(file, "#if defined(__cplusplus)\n}\n#endif /* __cplusplus */\n\n");
+    fprintf(file, "#endif /* VA_STRING_TABLE_H */\n\n/* [] END OF FILE */\n");
+
+    return (fclose(file) == 0);
+}
+
+/*******************************************************************************
+* Function Name: gen_write_list
+********************************************************************************
+* Summary:
+*   Writes one string list of a model set.
+*
+*******************************************************************************/
+static void gen_write_list(FILE *file, const char *set, const char *name, const gen_list_t *list)
+{
+    fprintf(file, "static const char *const %s_%s[] =\n{\n", set, name);
+    for (uint32_t i = 0; i < list->count; i++)
+    {
+        fprintf(file, "    \"%s\",\n", list->entries[i]);
+    }
+    fprintf(file, "};\n\n");
+}
+
+/*******************************************************************************
+* Function Name: gen_write_source
+********************************************************************************
+* Summary:
+*   Writes the string table and its lookup functions, built into the CM33
+*   application only.
+*
+*******************************************************************************/
+static bool gen_write_source(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return false;
+    }
+
+    gen_write_banner(file, GEN_SOURCE_NAME,
+        "Strings of the DEEPCRAFT Voice Assistant model sets, by ID");
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Header Files\n");
+    fprintf(file, "*******************************************************************************/\n");
+    fprintf(file, "#include <stddef.h>\n\n#include \"%s\"\n\n", GEN_HEADER_NAME);
+
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Data Types\n");
+    fprintf(file, "*******************************************************************************/\n");
+    fprintf(file, "typedef struct\n{\n");
+    fprintf(file, "    const char          *name;\n");
+    fprintf(file, "    const char *const   *intents;\n");
+    fprintf(file, "    uint16_t            num_intents;\n");
+    fprintf(file, "    uint16_t            num_variables;\n");
+    fprintf(file, "    const char *const   *variables;\n");
+    fprintf(file, "    const char *const   *phrases;\n");
+    fprintf(file, "    uint32_t            num_phrases;\n");
+    fprintf(file, "    const char *const   *units;\n");
+    fprintf(file, "    uint32_t            num_units;\n");
+    fprintf(file, "} va_string_table_set_t;\n\n");
+
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Global Variables\n");
+    fprintf(file, "*******************************************************************************/\n");
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        gen_write_list(file, gen_sets[s].name, "intents", &gen_sets[s].intents);
+        gen_write_list(file, gen_sets[s].name, "variables", &gen_sets[s].variables);
+        gen_write_list(file, gen_sets[s].name, "phrases", &gen_sets[s].phrases);
+        gen_write_list(file, gen_sets[s].name, "units", &gen_sets[s].units);
+    }
+
+    fprintf(file, "static const va_string_table_set_t va_string_table_sets[VA_STR_NUM_MODELS] =\n{\n");
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        const char *name = gen_sets[s].name;
+
+        fprintf(file, "    [VA_STR_MODEL_%s] =\n    {\n", name);
+        fprintf(file, "        .name           = \"%s\",\n", name);
+        fprintf(file, "        .intents        = %s_intents,\n", name);
+        fprintf(file, "        .num_intents    = VA_STR_%s_NUM_INTENTS,\n", name);
+        fprintf(file, "        .num_variables  = VA_STR_%s_NUM_VARIABLES,\n", name);
+        fprintf(file, "        .variables      = %s_variables,\n", name);
+        fprintf(file, "        .phrases        = %s_phrases,\n", name);
+        fprintf(file, "        .num_phrases    = VA_STR_%s_NUM_VARIABLE_PHRASES,\n", name);
+        fprintf(file, "        .units          = %s_units,\n", name);
+        fprintf(file, "        .num_units      = VA_STR_%s_NUM_UNIT_PHRASES,\n", name);
+        fprintf(file, "    },\n");
+    }
+    fprintf(file, "};\n\n");
+
+    for (uint32_t i = 0; i < sizeof(gen_functions) / sizeof(gen_functions[0]); i++)
+    {
+        fprintf(file, "%s\n", gen_functions[i]);
+    }
+    fprintf(file, "\n/* [] END OF FILE */\n");
+
+    return (fclose(file) == 0);
+}
+
+/*******************************************************************************
+* Function Name: gen_write_index_header
+********************************************************************************
+* Summary:
+*   Writes the header of the decoding index of the model sets.
+*
+*******************************************************************************/
+static bool gen_write_index_header(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return false;
+    }
+
+    gen_write_banner(file, GEN_INDEX_HEADER_NAME,
+        "Decoding index of the DEEPCRAFT Voice Assistant model sets");
+    fprintf(file, "#ifndef VA_MODEL_INDEX_H\n#define VA_MODEL_INDEX_H\n\n");
+    fprintf(file, "#if defined(__cplusplus)\nextern \"C\" {\n#endif /* __cplusplus */\n\n");
+    fprintf(file, "#include <stdint.h>\n\n#include \"%s\"\n\n", GEN_HEADER_NAME);
+
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Macros\n");
+    fprintf(file, "*******************************************************************************/\n");
+    fprintf(file, "/* Variables per command in the index, and the variable of a slot that differs\n");
+    fprintf(file, " * between the commands of an intent\n */\n");
+    gen_write_define(file, GEN_MAX_VARIABLE_SLOTS, "VA_IDX_MAX_VARIABLE_SLOTS");
+    gen_write_define(file, GEN_VARIABLE_UNKNOWN, "VA_IDX_VARIABLE_UNKNOWN");
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        fprintf(file, "\n/* %s */\n", gen_sets[s].name);
+        gen_write_define(file, gen_sets[s].num_commands, "VA_IDX_%s_NUM_COMMANDS", gen_sets[s].name);
+        gen_write_define(file, gen_sets[s].intent_map_size, "VA_IDX_%s_INTENT_MAP_SIZE", gen_sets[s].name);
+    }
+
+    fprintf(file, "\n/*******************************************************************************\n");
+    fprintf(file, "* Global Variables\n");
+    fprintf(file, "*******************************************************************************/\n");
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        const char *name = gen_sets[s].name;
+
+        fprintf(file, "/* %s */\n", name);
+        fprintf(file, "extern const uint32_t va_index_%s_command_offsets[VA_IDX_%s_NUM_COMMANDS];\n",
+            name, name);
+        fprintf(file, "extern const uint16_t va_index_%s_phrase_variable[VA_STR_%s_NUM_VARIABLE_PHRASES];\n",
+            name, name);
+        fprintf(file, "extern const uint16_t va_index_%s_variable_offsets[VA_STR_%s_NUM_VARIABLES];\n",
+            name, name);
+        fprintf(file, "extern const uint16_t va_index_%s_intent_slot_variable[VA_STR_%s_NUM_INTENTS]"
+            "[VA_IDX_MAX_VARIABLE_SLOTS];\n\n", name, name);
+    }
+
+    fprintf(file, "#if defined(__cplusplus)\n}\n#endif /* __cplusplus */\n\n");
+    fprintf(file, "#endif /* VA_MODEL_INDEX_H */\n\n/* [] END OF FILE */\n");
+
+    return (fclose(file) == 0);
+}
+
+/*******************************************************************************
+* Function Name: gen_write_numbers
+********************************************************************************
+* Summary:
+*   Writes the values of an index array, 16 per line.
+*
+*******************************************************************************/
+static void gen_write_numbers(FILE *file, const void *values, bool wide, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t value = wide ? ((const uint32_t *)values)[i] : ((const uint16_t *)values)[i];
+
+        fprintf(file, "%s%uu,%s", ((i % 16u) == 0u) ? "    " : " ", value,
+            (((i % 16u) == 15u) || (i + 1u == count)) ? "\n" : "");
+    }
+}
+
+/*******************************************************************************
+* Function Name: gen_write_index_source
+********************************************************************************
+* Summary:
+*   Writes the decoding index of the model sets, built into the CM55
+*   application. The index of a model set not linked into the firmware is
+*   dropped by the linker.
+*
+*******************************************************************************/
+static bool gen_write_index_source(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return false;
+    }
+
+    gen_write_banner(file, GEN_INDEX_SOURCE_NAME,
+        "Decoding index of the DEEPCRAFT Voice Assistant model sets");
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Header Files\n");
+    fprintf(file, "*******************************************************************************/\n");
+    fprintf(file, "#include \"%s\"\n\n", GEN_INDEX_HEADER_NAME);
+
+    fprintf(file, "/*******************************************************************************\n");
+    fprintf(file, "* Global Variables\n");
+    fprintf(file, "*******************************************************************************/\n");
+    for (uint32_t s = 0; s < gen_num_sets; s++)
+    {
+        const gen_set_t *set = &gen_sets[s];
+        const char *name = set->name;
+
+        fprintf(file, "/* %s: start of every command record in the intent map */\n", name);
+        fprintf(file, "const uint32_t va_index_%s_command_offsets[VA_IDX_%s_NUM_COMMANDS] =\n{\n", name, name);
+        gen_write_numbers(file, set->command_offsets, true, set->num_commands);
+        fprintf(file, "};\n\n");
+
+        fprintf(file, "/* %s: variable of every variable phrase */\n", name);
+        fprintf(file, "const uint16_t va_index_%s_phrase_variable[VA_STR_%s_NUM_VARIABLE_PHRASES] =\n{\n",
+            name, name);
+        gen_write_numbers(file, set->phrase_variable, false, set->phrases.count);
+        fprintf(file, "};\n\n");
+
+        fprintf(file, "/* %s: first variable phrase of every variable */\n", name);
+        fprintf(file, "const uint16_t va_index_%s_variable_offsets[VA_STR_%s_NUM_VARIABLES] =\n{\n", name, name);
+        gen_write_numbers(file, set->variable_offsets, false, set->variables.count);
+        fprintf(file, "};\n\n");
+
+        fprintf(file, "/* %s: variable of every slot of an intent */\n", name);
+        fprintf(file, "const uint16_t va_index_%s_intent_slot_variable[VA_STR_%s_NUM_INTENTS]"
+            "[VA_IDX_MAX_VARIABLE_SLOTS] =\n{\n", name, name);
+        for (uint32_t i = 0; i < set->intents.count; i++)
+        {
+            fprintf(file, "    {");
+            for (uint32_t slot = 0; slot < GEN_MAX_VARIABLE_SLOTS; slot++)
+            {
+                fprintf(file, " %uu,", set->intent_slot_variable[i][slot]);
+            }
+            fprintf(file, " }, /* %s */\n", set->intents.entries[i]);
+        }
+        fprintf(file, "};\n\n");
+    }
+    fprintf(file, "/* [] END OF FILE */\n");
+
+    return (fclose(file) == 0);
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    char path[GEN_MAX_PATH];
+
+    if ((argc < 4) || ((uint32_t)(argc - 3) > GEN_MAX_SETS))
+    {
+        fprintf(stderr, "Usage: %s <va_models directory> <shared directory> <model set>...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 3; i < argc; i++)
+    {
+        gen_sets[gen_num_sets].name = argv[i];
+        if (!gen_load_set(&gen_sets[gen_num_sets], argv[1]) || !gen_build_index(&gen_sets[gen_num_sets]))
+        {
+            return 1;
+        }
+        gen_num_sets++;
+    }
+
+    snprintf(path, sizeof(path), "%s/include/%s", argv[2], GEN_HEADER_NAME);
+    if (!gen_write_header(path))
+    {
+        return 1;
+    }
+    printf("%s\n", path);
+
+    snprintf(path, sizeof(path), "%s/source/COMPONENT_CM33/%s", argv[2], GEN_SOURCE_NAME);
+    if (!gen_write_source(path))
+    {
+        return 1;
+    }
+    printf("%s\n", path);
+
+    snprintf(path, sizeof(path), "%s/include/%s", argv[2], GEN_INDEX_HEADER_NAME);
+    if (!gen_write_index_header(path))
+    {
+        return 1;
+    }
+    printf("%s\n", path);
+
+    snprintf(path, sizeof(path), "%s/source/COMPONENT_CM55/%s", argv[2], GEN_INDEX_SOURCE_NAME);
+    if (!gen_write_index_source(path))
+    {
+        return 1;
+    }
+    printf("%s\n", path);
+
+    return 0;
+}
+
+/* [] END OF FILE */
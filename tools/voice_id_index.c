@@ -0,0 +1,692 @@
+/******************************************************************************
+* File Name : voice_id_index.c
+*
+* Description :
+* Two-level speaker index of Voice ID: coarse centroids with product quantized
+* residuals, for scoring large numbers of enrolled users. It is not part of
+* the firmware yet: the Voice ID library enrolls at most
+* IFX_MAX_SUPPORTED_USERS users, far below VOICE_ID_INDEX_MIN_TRAIN_USERS,
+* so its integration is deferred until the library supports more users. It
+* is evaluated on the host by tools/voice_id_index_bench.c.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#ifdef ENABLE_VOICE_ID
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include "voice_id_index.h"
+#include "voice_id_engine.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SCRATCH_ROWS    ((VOICE_ID_INDEX_LISTS > VOICE_ID_INDEX_CODEWORDS) ? \
+                         VOICE_ID_INDEX_LISTS : VOICE_ID_INDEX_CODEWORDS)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Accumulators of the k-means updates, only used while training */
+static float train_sums[SCRATCH_ROWS * IFX_EMBEDDINGS_LENGTH_WORDS];
+static uint16_t train_counts[VOICE_ID_INDEX_SUBSPACES][SCRATCH_ROWS];
+
+/* Residual score of each codeword for the current query. Searches are run by
+ * a single task (Voice ID task), so the table is not on its stack.
+ */
+static float search_table[VOICE_ID_INDEX_SUBSPACES][VOICE_ID_INDEX_CODEWORDS];
+
+/*******************************************************************************
+* Function Name: get_code / set_code
+********************************************************************************
+* Summary:
+* Access the 4-bit code of a subspace in a packed user code.
+*
+*******************************************************************************/
+static inline uint8_t get_code(const uint8_t *code, uint32_t subspace)
+{
+    return (code[subspace >> 1] >> ((subspace & 1u) * 4u)) & 0x0Fu;
+}
+
+static inline void set_code(uint8_t *code, uint32_t subspace, uint8_t value)
+{
+    uint8_t shift = (uint8_t) ((subspace & 1u) * 4u);
+
+    code[subspace >> 1] = (uint8_t) ((code[subspace >> 1] & ~(0x0Fu << shift)) | (value << shift));
+}
+
+/*******************************************************************************
+* Function Name: nearest
+********************************************************************************
+* Summary:
+* Returns the nearest of a set of centroids (squared euclidean distance).
+*
+* Parameters:
+*  vector: vector to assign
+*  centroids: centroids, one every length values
+*  count: number of centroids
+*  length: dimension of the vectors
+*
+* Return:
+*  Index of the nearest centroid
+*
+*******************************************************************************/
+static uint32_t nearest(const float *vector, const float *centroids, uint32_t count, uint32_t length)
+{
+    uint32_t best = 0;
+    float best_distance = 0.0f;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float *centroid = &centroids[i * length];
+        float distance = 0.0f;
+
+        for (uint32_t j = 0; j < length; j++)
+        {
+            float diff = vector[j] - centroid[j];
+            distance += diff * diff;
+        }
+        if ((i == 0) || (distance < best_distance))
+        {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+/*******************************************************************************
+* Function Name: quantizer_checksum
+********************************************************************************
+* Summary:
+* Checksum of the trained data of the quantizer, to detect torn or stale
+* copies in flash.
+*
+*******************************************************************************/
+static uint32_t quantizer_checksum(const voice_id_index_quantizer_t *quantizer)
+{
+    const uint8_t *data = (const uint8_t *) &quantizer->trained_users;
+    uint32_t size = sizeof(*quantizer) - offsetof(voice_id_index_quantizer_t, trained_users);
+    uint32_t sum1 = 0xFFFFu;
+    uint32_t sum2 = 0xFFFFu;
+
+    /* Fletcher-32 over bytes */
+    for (uint32_t i = 0; i < size; i++)
+    {
+        sum1 = (sum1 + data[i]) % 65535u;
+        sum2 = (sum2 + sum1) % 65535u;
+    }
+    return (sum2 << 16) | sum1;
+}
+
+/*******************************************************************************
+* Function Name: normalize / get_unit_vector
+********************************************************************************
+* Summary:
+* The index clusters and quantizes the direction of the user vectors: the
+* centroids of the engine are shorter than the normalized query, and their
+* norm varies with the spread of the user's enrollment embeddings, which would
+* bias the choice of the lists to probe. Exact scores use the raw vectors.
+*
+*******************************************************************************/
+static void normalize(float *vector)
+{
+    float norm = sqrtf(voice_id_engine_dot(vector, vector, IFX_EMBEDDINGS_LENGTH_WORDS));
+
+    if (norm > 0.0f)
+    {
+        for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+        {
+            vector[j] /= norm;
+        }
+    }
+}
+
+static void get_unit_vector(voice_id_index_vector_fn_t get_vector, void *context, uint16_t user, float *vector)
+{
+    get_vector(user, vector, context);
+    normalize(vector);
+}
+
+/*******************************************************************************
+* Function Name: link_user
+********************************************************************************
+* Summary:
+* Assigns a user to its list and encodes its residual, or to list 0 without a
+* code when the index is not trained. The vector is normalized.
+*
+*******************************************************************************/
+static void link_user(voice_id_index_t *index, uint16_t user, const float *vector)
+{
+    const voice_id_index_quantizer_t *quantizer = &index->quantizer;
+    float residual[VOICE_ID_INDEX_SUBSPACE_DIM];
+    uint16_t list = 0;
+
+    if (index->trained)
+    {
+        list = (uint16_t) nearest(vector, &quantizer->coarse[0][0], VOICE_ID_INDEX_LISTS,
+                                  IFX_EMBEDDINGS_LENGTH_WORDS);
+
+        for (uint32_t m = 0; m < VOICE_ID_INDEX_SUBSPACES; m++)
+        {
+            for (uint32_t j = 0; j < VOICE_ID_INDEX_SUBSPACE_DIM; j++)
+            {
+                uint32_t k = (m * VOICE_ID_INDEX_SUBSPACE_DIM) + j;
+                residual[j] = vector[k] - quantizer->coarse[list][k];
+            }
+            set_code(index->codes[user], m, (uint8_t) nearest(residual, &quantizer->codebook[m][0][0],
+                                                               VOICE_ID_INDEX_CODEWORDS,
+                                                               VOICE_ID_INDEX_SUBSPACE_DIM));
+        }
+    }
+
+    index->list[user] = list;
+    index->next[user] = index->head[list];
+    index->head[list] = user;
+}
+
+/*******************************************************************************
+* Function Name: relink_all
+********************************************************************************
+* Summary:
+* Reassigns and re-encodes all indexed users after the quantizers changed.
+*
+*******************************************************************************/
+static void relink_all(voice_id_index_t *index, voice_id_index_vector_fn_t get_vector, void *context)
+{
+    float vector[IFX_EMBEDDINGS_LENGTH_WORDS];
+
+    for (uint32_t l = 0; l < VOICE_ID_INDEX_LISTS; l++)
+    {
+        index->head[l] = VOICE_ID_INDEX_NONE;
+    }
+    for (uint16_t user = 0; user < VOICE_ID_INDEX_MAX_USERS; user++)
+    {
+        if (index->list[user] != VOICE_ID_INDEX_NONE)
+        {
+            get_unit_vector(get_vector, context, user, vector);
+            link_user(index, user, vector);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_init
+********************************************************************************
+* Summary:
+* Initializes an empty, untrained index.
+*
+* Parameters:
+*  index: index to initialize
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_index_init(voice_id_index_t *index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+
+    memset(index, 0, sizeof(*index));
+    memset(index->head, 0xFF, sizeof(index->head));
+    memset(index->list, 0xFF, sizeof(index->list));
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_insert
+********************************************************************************
+* Summary:
+* Adds a user to the index, or updates it if already indexed. Takes one
+* coarse assignment and one residual encoding, the index is not retrained.
+*
+* Parameters:
+*  index: index to update
+*  user: user identifier, below VOICE_ID_INDEX_MAX_USERS
+*  vector: vector of the user (IFX_EMBEDDINGS_LENGTH_WORDS values)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_index_insert(voice_id_index_t *index, uint16_t user, const float *vector)
+{
+    float unit[IFX_EMBEDDINGS_LENGTH_WORDS];
+
+    if ((index == NULL) || (vector == NULL) || (user >= VOICE_ID_INDEX_MAX_USERS))
+    {
+        return;
+    }
+
+    memcpy(unit, vector, sizeof(unit));
+    normalize(unit);
+    voice_id_index_remove(index, user);
+    link_user(index, user, unit);
+    index->num_users++;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_remove
+********************************************************************************
+* Summary:
+* Removes a user from the index. Takes a walk of the user's list.
+*
+* Parameters:
+*  index: index to update
+*  user: user identifier
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void voice_id_index_remove(voice_id_index_t *index, uint16_t user)
+{
+    uint16_t *link;
+
+    if ((index == NULL) || (user >= VOICE_ID_INDEX_MAX_USERS) || (index->list[user] == VOICE_ID_INDEX_NONE))
+    {
+        return;
+    }
+
+    link = &index->head[index->list[user]];
+    while ((*link != VOICE_ID_INDEX_NONE) && (*link != user))
+    {
+        link = &index->next[*link];
+    }
+    if (*link == user)
+    {
+        *link = index->next[user];
+    }
+
+    index->list[user] = VOICE_ID_INDEX_NONE;
+    index->num_users--;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_needs_training
+********************************************************************************
+* Summary:
+* Tells whether the index should be (re)trained: it reached
+* VOICE_ID_INDEX_MIN_TRAIN_USERS, or the number of users grew by half since it
+* was trained.
+*
+* Parameters:
+*  index: index to check
+*
+* Return:
+*  True if voice_id_index_train should be called
+*
+*******************************************************************************/
+bool voice_id_index_needs_training(const voice_id_index_t *index)
+{
+    if ((index == NULL) || (index->num_users < VOICE_ID_INDEX_MIN_TRAIN_USERS))
+    {
+        return false;
+    }
+    return (!index->trained) ||
+           (index->num_users >= (index->quantizer.trained_users + (index->quantizer.trained_users / 2u)));
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_train
+********************************************************************************
+* Summary:
+* Trains the coarse centroids and the residual codebooks with k-means on the
+* indexed users, then reassigns all users. Centroids are seeded with evenly
+* spaced users so training is deterministic. Costs
+* VOICE_ID_INDEX_KMEANS_ITERATIONS passes over the users for each level.
+*
+* Parameters:
+*  index: index to train
+*  get_vector: returns the vector of an indexed user
+*  context: passed to get_vector
+*
+* Return:
+*  True if trained, false if there are fewer than
+*  VOICE_ID_INDEX_MIN_TRAIN_USERS users
+*
+*******************************************************************************/
+bool voice_id_index_train(voice_id_index_t *index, voice_id_index_vector_fn_t get_vector, void *context)
+{
+    voice_id_index_quantizer_t *quantizer;
+    float vector[IFX_EMBEDDINGS_LENGTH_WORDS];
+    uint32_t seen;
+    uint32_t seed;
+
+    if ((index == NULL) || (get_vector == NULL) || (index->num_users < VOICE_ID_INDEX_MIN_TRAIN_USERS))
+    {
+        return false;
+    }
+    quantizer = &index->quantizer;
+
+    /* Seed the coarse centroids with evenly spaced users */
+    seen = 0;
+    seed = 0;
+    for (uint16_t user = 0; (user < VOICE_ID_INDEX_MAX_USERS) && (seed < VOICE_ID_INDEX_LISTS); user++)
+    {
+        if (index->list[user] == VOICE_ID_INDEX_NONE)
+        {
+            continue;
+        }
+        if (seen == ((seed * index->num_users) / VOICE_ID_INDEX_LISTS))
+        {
+            get_unit_vector(get_vector, context, user, quantizer->coarse[seed]);
+            seed++;
+        }
+        seen++;
+    }
+
+    /* Coarse k-means, the assignments are kept in the user lists */
+    for (uint32_t it = 0; it < VOICE_ID_INDEX_KMEANS_ITERATIONS; it++)
+    {
+        memset(train_sums, 0, sizeof(train_sums));
+        memset(train_counts, 0, sizeof(train_counts));
+
+        for (uint16_t user = 0; user < VOICE_ID_INDEX_MAX_USERS; user++)
+        {
+            if (index->list[user] == VOICE_ID_INDEX_NONE)
+            {
+                continue;
+            }
+            get_unit_vector(get_vector, context, user, vector);
+            uint32_t list = nearest(vector, &quantizer->coarse[0][0], VOICE_ID_INDEX_LISTS,
+                                    IFX_EMBEDDINGS_LENGTH_WORDS);
+            index->list[user] = (uint16_t) list;
+            for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+            {
+                train_sums[(list * IFX_EMBEDDINGS_LENGTH_WORDS) + j] += vector[j];
+            }
+            train_counts[0][list]++;
+        }
+
+        /* Empty lists keep their centroid */
+        for (uint32_t l = 0; l < VOICE_ID_INDEX_LISTS; l++)
+        {
+            if (train_counts[0][l] == 0)
+            {
+                continue;
+            }
+            for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+            {
+                quantizer->coarse[l][j] = train_sums[(l * IFX_EMBEDDINGS_LENGTH_WORDS) + j] /
+                    (float) train_counts[0][l];
+            }
+        }
+    }
+
+    /* Seed the codebooks with the residuals of evenly spaced users */
+    seen = 0;
+    seed = 0;
+    for (uint16_t user = 0; (user < VOICE_ID_INDEX_MAX_USERS) && (seed < VOICE_ID_INDEX_CODEWORDS); user++)
+    {
+        if (index->list[user] == VOICE_ID_INDEX_NONE)
+        {
+            continue;
+        }
+        if (seen == ((seed * index->num_users) / VOICE_ID_INDEX_CODEWORDS))
+        {
+            get_unit_vector(get_vector, context, user, vector);
+            uint16_t list = (uint16_t) nearest(vector, &quantizer->coarse[0][0], VOICE_ID_INDEX_LISTS,
+                                               IFX_EMBEDDINGS_LENGTH_WORDS);
+            for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+            {
+                quantizer->codebook[j / VOICE_ID_INDEX_SUBSPACE_DIM][seed][j % VOICE_ID_INDEX_SUBSPACE_DIM] =
+                    vector[j] - quantizer->coarse[list][j];
+            }
+            seed++;
+        }
+        seen++;
+    }
+
+    /* Residual k-means, all subspaces in the same pass over the users */
+    for (uint32_t it = 0; it < VOICE_ID_INDEX_KMEANS_ITERATIONS; it++)
+    {
+        memset(train_sums, 0, sizeof(train_sums));
+        memset(train_counts, 0, sizeof(train_counts));
+
+        for (uint16_t user = 0; user < VOICE_ID_INDEX_MAX_USERS; user++)
+        {
+            if (index->list[user] == VOICE_ID_INDEX_NONE)
+            {
+                continue;
+            }
+            get_unit_vector(get_vector, context, user, vector);
+            uint16_t list = (uint16_t) nearest(vector, &quantizer->coarse[0][0], VOICE_ID_INDEX_LISTS,
+                                               IFX_EMBEDDINGS_LENGTH_WORDS);
+            for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+            {
+                vector[j] -= quantizer->coarse[list][j];
+            }
+            for (uint32_t m = 0; m < VOICE_ID_INDEX_SUBSPACES; m++)
+            {
+                const float *residual = &vector[m * VOICE_ID_INDEX_SUBSPACE_DIM];
+                uint32_t k = nearest(residual, &quantizer->codebook[m][0][0], VOICE_ID_INDEX_CODEWORDS,
+                                     VOICE_ID_INDEX_SUBSPACE_DIM);
+                float *sum = &train_sums[((k * VOICE_ID_INDEX_SUBSPACES) + m) * VOICE_ID_INDEX_SUBSPACE_DIM];
+
+                for (uint32_t j = 0; j < VOICE_ID_INDEX_SUBSPACE_DIM; j++)
+                {
+                    sum[j] += residual[j];
+                }
+                train_counts[m][k]++;
+            }
+        }
+
+        for (uint32_t m = 0; m < VOICE_ID_INDEX_SUBSPACES; m++)
+        {
+            for (uint32_t k = 0; k < VOICE_ID_INDEX_CODEWORDS; k++)
+            {
+                const float *sum = &train_sums[((k * VOICE_ID_INDEX_SUBSPACES) + m) * VOICE_ID_INDEX_SUBSPACE_DIM];
+
+                if (train_counts[m][k] == 0)
+                {
+                    continue;
+                }
+                for (uint32_t j = 0; j < VOICE_ID_INDEX_SUBSPACE_DIM; j++)
+                {
+                    quantizer->codebook[m][k][j] = sum[j] / (float) train_counts[m][k];
+                }
+            }
+        }
+    }
+
+    quantizer->magic = VOICE_ID_INDEX_MAGIC;
+    quantizer->trained_users = index->num_users;
+    quantizer->checksum = quantizer_checksum(quantizer);
+    index->trained = true;
+    relink_all(index, get_vector, context);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_load
+********************************************************************************
+* Summary:
+* Uses quantizers read into index->quantizer, e.g. from flash, instead of
+* training. Validates them and reassigns all indexed users.
+*
+* Parameters:
+*  index: index with the quantizers read
+*  get_vector: returns the vector of an indexed user
+*  context: passed to get_vector
+*
+* Return:
+*  True if the quantizers are valid, false if the index is left untrained
+*
+*******************************************************************************/
+bool voice_id_index_load(voice_id_index_t *index, voice_id_index_vector_fn_t get_vector, void *context)
+{
+    if ((index == NULL) || (get_vector == NULL))
+    {
+        return false;
+    }
+
+    index->trained = (index->quantizer.magic == VOICE_ID_INDEX_MAGIC) &&
+                     (index->quantizer.checksum == quantizer_checksum(&index->quantizer));
+    relink_all(index, get_vector, context);
+    return index->trained;
+}
+
+/*******************************************************************************
+* Function Name: shortlist_add
+********************************************************************************
+* Summary:
+* Inserts a candidate in a list sorted by decreasing score, dropping the last
+* one if the list is full.
+*
+*******************************************************************************/
+static void shortlist_add(uint16_t *users, float *scores, uint32_t *count, uint32_t capacity,
+                          uint16_t user, float score)
+{
+    uint32_t i = *count;
+
+    if ((i == capacity) && (score <= scores[i - 1u]))
+    {
+        return;
+    }
+    if (i == capacity)
+    {
+        i--;
+    }
+    else
+    {
+        (*count)++;
+    }
+    while ((i > 0) && (scores[i - 1u] < score))
+    {
+        users[i] = users[i - 1u];
+        scores[i] = scores[i - 1u];
+        i--;
+    }
+    users[i] = user;
+    scores[i] = score;
+}
+
+/*******************************************************************************
+* Function Name: voice_id_index_search
+********************************************************************************
+* Summary:
+* Finds the users most similar to a query. The lists of the
+* VOICE_ID_INDEX_PROBES nearest coarse centroids are scanned with the
+* approximate score coarse + sum of residual table lookups, then the best
+* VOICE_ID_INDEX_SHORTLIST candidates are scored exactly with their vector.
+* The work is bounded by the size of the probed lists, not by the number of
+* users. An untrained index scores all users exactly. Not reentrant.
+*
+* Parameters:
+*  index: index to search
+*  query: L2-normalized query (IFX_EMBEDDINGS_LENGTH_WORDS values)
+*  get_vector: returns the vector of an indexed user
+*  context: passed to get_vector
+*  users: best users, by decreasing exact score
+*  scores: exact dot product of the query with the vector of each user
+*  max_results: capacity of users and scores
+*
+* Return:
+*  Number of results
+*
+*******************************************************************************/
+uint32_t voice_id_index_search(const voice_id_index_t *index, const float *query,
+                               voice_id_index_vector_fn_t get_vector, void *context,
+                               uint16_t *users, float *scores, uint32_t max_results)
+{
+    const voice_id_index_quantizer_t *quantizer;
+    float vector[IFX_EMBEDDINGS_LENGTH_WORDS];
+    float coarse_scores[VOICE_ID_INDEX_LISTS];
+    uint16_t probes[VOICE_ID_INDEX_PROBES];
+    float probe_scores[VOICE_ID_INDEX_PROBES];
+    uint16_t candidates[VOICE_ID_INDEX_SHORTLIST];
+    float candidate_scores[VOICE_ID_INDEX_SHORTLIST];
+    uint32_t num_probes = 0;
+    uint32_t num_candidates = 0;
+    uint32_t count = 0;
+
+    if ((index == NULL) || (query == NULL) || (get_vector == NULL) || (users == NULL) ||
+        (scores == NULL) || (max_results == 0))
+    {
+        return 0;
+    }
+    quantizer = &index->quantizer;
+
+    if (!index->trained)
+    {
+        for (uint16_t user = index->head[0]; user != VOICE_ID_INDEX_NONE; user = index->next[user])
+        {
+            get_vector(user, vector, context);
+            shortlist_add(users, scores, &count, max_results, user,
+                          voice_id_engine_dot(query, vector, IFX_EMBEDDINGS_LENGTH_WORDS));
+        }
+        return count;
+    }
+
+    for (uint16_t l = 0; l < VOICE_ID_INDEX_LISTS; l++)
+    {
+        coarse_scores[l] = voice_id_engine_dot(query, quantizer->coarse[l], IFX_EMBEDDINGS_LENGTH_WORDS);
+        shortlist_add(probes, probe_scores, &num_probes, VOICE_ID_INDEX_PROBES, l, coarse_scores[l]);
+    }
+
+    for (uint32_t m = 0; m < VOICE_ID_INDEX_SUBSPACES; m++)
+    {
+        for (uint32_t k = 0; k < VOICE_ID_INDEX_CODEWORDS; k++)
+        {
+            search_table[m][k] = voice_id_engine_dot_ref(&query[m * VOICE_ID_INDEX_SUBSPACE_DIM],
+                                                  quantizer->codebook[m][k], VOICE_ID_INDEX_SUBSPACE_DIM);
+        }
+    }
+
+    for (uint32_t p = 0; p < num_probes; p++)
+    {
+        for (uint16_t user = index->head[probes[p]]; user != VOICE_ID_INDEX_NONE; user = index->next[user])
+        {
+            float score = coarse_scores[probes[p]];
+
+            for (uint32_t m = 0; m < VOICE_ID_INDEX_SUBSPACES; m++)
+            {
+                score += search_table[m][get_code(index->codes[user], m)];
+            }
+            shortlist_add(candidates, candidate_scores, &num_candidates, VOICE_ID_INDEX_SHORTLIST, user, score);
+        }
+    }
+
+    for (uint32_t i = 0; i < num_candidates; i++)
+    {
+        get_vector(candidates[i], vector, context);
+        shortlist_add(users, scores, &count, max_results, candidates[i],
+                      voice_id_engine_dot(query, vector, IFX_EMBEDDINGS_LENGTH_WORDS));
+    }
+    return count;
+}
+#endif /* ENABLE_VOICE_ID */
+/* [] END OF FILE */
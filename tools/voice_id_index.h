@@ -0,0 +1,163 @@
+/******************************************************************************
+* File Name : voice_id_index.h
+*
+* Description :
+* Header for the two-level speaker index of Voice ID
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef _VOICE_ID_INDEX_H_
+#define _VOICE_ID_INDEX_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stdbool.h>
+#include "ifx_voice_id.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Users the index can hold */
+#ifndef VOICE_ID_INDEX_MAX_USERS
+#define VOICE_ID_INDEX_MAX_USERS            (IFX_MAX_SUPPORTED_USERS)
+#endif
+
+/* Coarse centroids, and how many of their lists are searched */
+#ifndef VOICE_ID_INDEX_LISTS
+#define VOICE_ID_INDEX_LISTS                (16u)
+#endif
+#ifndef VOICE_ID_INDEX_PROBES
+#define VOICE_ID_INDEX_PROBES               (6u)
+#endif
+
+/* Product quantization of the residuals: 4-bit code per subspace */
+#define VOICE_ID_INDEX_SUBSPACES            (48u)
+#define VOICE_ID_INDEX_SUBSPACE_DIM         (IFX_EMBEDDINGS_LENGTH_WORDS / VOICE_ID_INDEX_SUBSPACES)
+#define VOICE_ID_INDEX_CODEWORDS            (16u)
+#define VOICE_ID_INDEX_CODE_SIZE            (VOICE_ID_INDEX_SUBSPACES / 2u)
+
+/* Candidates of the quantized search scored exactly */
+#ifndef VOICE_ID_INDEX_SHORTLIST
+#define VOICE_ID_INDEX_SHORTLIST            (8u)
+#endif
+
+/* Below this number of users, the index is searched exhaustively and not
+ * trained: scoring all users is as fast as a search. Once trained, it is
+ * retrained when the number of users grew by half, as users inserted later
+ * are only assigned to the existing lists.
+ */
+#ifndef VOICE_ID_INDEX_MIN_TRAIN_USERS
+#define VOICE_ID_INDEX_MIN_TRAIN_USERS      (128u)
+#endif
+
+#define VOICE_ID_INDEX_KMEANS_ITERATIONS    (8u)
+
+/* Identifies the quantizer layout in flash */
+#define VOICE_ID_INDEX_MAGIC                (0x56495800UL ^ (VOICE_ID_INDEX_LISTS << 16) ^ \
+                                             (VOICE_ID_INDEX_SUBSPACES << 8) ^ VOICE_ID_INDEX_CODEWORDS)
+
+#define VOICE_ID_INDEX_NONE                 (0xFFFFu)
+
+#if (IFX_EMBEDDINGS_LENGTH_WORDS % VOICE_ID_INDEX_SUBSPACES) != 0
+#error "VOICE_ID_INDEX_SUBSPACES must divide IFX_EMBEDDINGS_LENGTH_WORDS"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/**
+ * \brief Trained quantizers of the index, stored in flash.
+ */
+typedef struct {
+    /* VOICE_ID_INDEX_MAGIC */
+    uint32_t magic;
+    /* Checksum of the fields below */
+    uint32_t checksum;
+    /* Number of users the quantizers were trained with */
+    uint32_t trained_users;
+    /* Coarse centroids */
+    float coarse[VOICE_ID_INDEX_LISTS][IFX_EMBEDDINGS_LENGTH_WORDS];
+    /* Residual codebook of each subspace */
+    float codebook[VOICE_ID_INDEX_SUBSPACES][VOICE_ID_INDEX_CODEWORDS][VOICE_ID_INDEX_SUBSPACE_DIM];
+} voice_id_index_quantizer_t;
+
+/**
+ * \brief Two-level speaker index.
+ *
+ * Users are assigned to the list of their nearest coarse centroid and their
+ * residual to it is product quantized to VOICE_ID_INDEX_CODE_SIZE bytes. A
+ * search scores the coarse centroids, scans the lists of the best
+ * VOICE_ID_INDEX_PROBES with table lookups, and scores the best
+ * VOICE_ID_INDEX_SHORTLIST candidates exactly. Until trained, all users are
+ * in list 0 and scored exactly.
+ */
+typedef struct {
+    voice_id_index_quantizer_t quantizer;
+    bool trained;
+    uint16_t num_users;
+    /* First user of each list, next user in the list of each user */
+    uint16_t head[VOICE_ID_INDEX_LISTS];
+    uint16_t next[VOICE_ID_INDEX_MAX_USERS];
+    /* List of each user, VOICE_ID_INDEX_NONE if not indexed */
+    uint16_t list[VOICE_ID_INDEX_MAX_USERS];
+    uint8_t codes[VOICE_ID_INDEX_MAX_USERS][VOICE_ID_INDEX_CODE_SIZE];
+} voice_id_index_t;
+
+/**
+ * \brief Returns the full vector of an indexed user. Vectors are kept by the
+ * caller, e.g. the centroids of the scoring engine.
+ */
+typedef void (*voice_id_index_vector_fn_t)(uint16_t user, float *vector, void *context);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+void voice_id_index_init(voice_id_index_t *index);
+void voice_id_index_insert(voice_id_index_t *index, uint16_t user, const float *vector);
+void voice_id_index_remove(voice_id_index_t *index, uint16_t user);
+bool voice_id_index_needs_training(const voice_id_index_t *index);
+bool voice_id_index_train(voice_id_index_t *index, voice_id_index_vector_fn_t get_vector, void *context);
+bool voice_id_index_load(voice_id_index_t *index, voice_id_index_vector_fn_t get_vector, void *context);
+uint32_t voice_id_index_search(const voice_id_index_t *index, const float *query,
+                               voice_id_index_vector_fn_t get_vector, void *context,
+                               uint16_t *users, float *scores, uint32_t max_results);
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* _VOICE_ID_INDEX_H_ */
+
+/* [] END OF FILE */
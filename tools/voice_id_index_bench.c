@@ -0,0 +1,278 @@
+/******************************************************************************
+* File Name : voice_id_index_bench.c
+*
+* Description :
+* Host benchmark of the Voice ID speaker index: recall and search time of the
+* index compared with scoring all users, from 10 to 1000 synthetic users.
+*
+* Build and run from the repository root:
+*   gcc -O2 -ffunction-sections -Wl,--gc-sections -DENABLE_VOICE_ID -DVOICE_ID_ENGINE_SCALAR
+*       -DVOICE_ID_INDEX_MAX_USERS=1024 -Itools -Iproj_cm55/source/voice_id tools/voice_id_index_bench.c
+*       tools/voice_id_index.c proj_cm55/source/voice_id/voice_id_engine.c
+*       -lm -o voice_id_index_bench
+*   ./voice_id_index_bench
+* The Voice ID library is not needed: section garbage collection drops the
+* engine functions that call it.
+********************************************************************************
+* (c) 2026, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+*
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "voice_id_index.h"
+#include "voice_id_engine.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_MAX_USERS         (VOICE_ID_INDEX_MAX_USERS)
+#define BENCH_QUERIES           (2000u)
+/* Users share one of a few "voice types", so that users are not all
+ * orthogonal as random vectors would be
+ */
+#define BENCH_USERS_PER_GROUP   (8u)
+#define BENCH_GROUP_SPREAD      (0.6f)
+/* Spread of the embeddings of a user around its voice */
+#define BENCH_SAMPLE_NOISE      (0.8f)
+/* Share of the users removed after the index is built */
+#define BENCH_REMOVED_PERCENT   (10u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const uint32_t bench_user_counts[] = { 10u, 30u, 100u, 200u, 300u, 500u, 1000u };
+
+static float voices[BENCH_MAX_USERS][IFX_EMBEDDINGS_LENGTH_WORDS];
+static float centroids[BENCH_MAX_USERS][IFX_EMBEDDINGS_LENGTH_WORDS];
+static bool removed[BENCH_MAX_USERS];
+static voice_id_index_t bench_index;
+static uint32_t bench_seed = 1u;
+
+/*******************************************************************************
+* Function Name: bench_gauss
+********************************************************************************
+* Summary:
+* Deterministic normal random numbers (xorshift and Box-Muller).
+*
+*******************************************************************************/
+static float bench_uniform(void)
+{
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+    return ((float) (bench_seed >> 8) + 0.5f) / 16777216.0f;
+}
+
+static float bench_gauss(void)
+{
+    return sqrtf(-2.0f * logf(bench_uniform())) * cosf(6.2831853f * bench_uniform());
+}
+
+/*******************************************************************************
+* Function Name: bench_noisy
+********************************************************************************
+* Summary:
+* Writes base + noise, L2-normalized.
+*
+*******************************************************************************/
+static void bench_noisy(const float *base, float noise, float *out)
+{
+    float norm = 0.0f;
+
+    for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+    {
+        out[j] = base[j] + noise * bench_gauss() / sqrtf((float) IFX_EMBEDDINGS_LENGTH_WORDS);
+        norm += out[j] * out[j];
+    }
+    norm = sqrtf(norm);
+    for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+    {
+        out[j] /= norm;
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_make_users
+********************************************************************************
+* Summary:
+* Creates the voices of the users and their centroids, the mean of
+* IFX_NUM_ENROLLMENT_EMBEDDINGS normalized noisy samples as in the engine.
+*
+*******************************************************************************/
+static void bench_make_users(uint32_t num_users)
+{
+    float zero[IFX_EMBEDDINGS_LENGTH_WORDS] = {0};
+    float group[IFX_EMBEDDINGS_LENGTH_WORDS];
+    float sample[IFX_EMBEDDINGS_LENGTH_WORDS];
+
+    for (uint32_t u = 0; u < num_users; u++)
+    {
+        if ((u % BENCH_USERS_PER_GROUP) == 0)
+        {
+            bench_noisy(zero, 1.0f, group);
+        }
+        bench_noisy(group, BENCH_GROUP_SPREAD, voices[u]);
+
+        memset(centroids[u], 0, sizeof(centroids[u]));
+        for (uint32_t i = 0; i < IFX_NUM_ENROLLMENT_EMBEDDINGS; i++)
+        {
+            bench_noisy(voices[u], BENCH_SAMPLE_NOISE, sample);
+            for (uint32_t j = 0; j < IFX_EMBEDDINGS_LENGTH_WORDS; j++)
+            {
+                centroids[u][j] += sample[j] / (float) IFX_NUM_ENROLLMENT_EMBEDDINGS;
+            }
+        }
+        removed[u] = false;
+    }
+}
+
+static void bench_get_vector(uint16_t user, float *vector, void *context)
+{
+    (void) context;
+    memcpy(vector, centroids[user], sizeof(centroids[user]));
+}
+
+static double bench_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double) ts.tv_sec * 1e6) + ((double) ts.tv_nsec / 1e3);
+}
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+* Enrolls the users one by one into the index, training it as the Voice ID
+* task does, removes some, then compares searches with scoring all users.
+*
+*******************************************************************************/
+static void bench_run(uint32_t num_users)
+{
+    float query[IFX_EMBEDDINGS_LENGTH_WORDS];
+    uint16_t users[VOICE_ID_INDEX_SHORTLIST];
+    float scores[VOICE_ID_INDEX_SHORTLIST];
+    uint32_t trainings = 0;
+    uint32_t recall = 0;
+    uint32_t exact_correct = 0;
+    uint32_t index_correct = 0;
+    uint32_t removed_found = 0;
+    uint32_t queries = 0;
+    double exact_us = 0.0;
+    double index_us = 0.0;
+    double train_us = 0.0;
+    double start;
+
+    bench_make_users(num_users);
+    voice_id_index_init(&bench_index);
+    for (uint32_t u = 0; u < num_users; u++)
+    {
+        voice_id_index_insert(&bench_index, (uint16_t) u, centroids[u]);
+        if (voice_id_index_needs_training(&bench_index))
+        {
+            start = bench_time_us();
+            (void) voice_id_index_train(&bench_index, bench_get_vector, NULL);
+            train_us = bench_time_us() - start;
+            trainings++;
+        }
+    }
+    for (uint32_t u = 0; u < num_users; u += (100u / BENCH_REMOVED_PERCENT))
+    {
+        voice_id_index_remove(&bench_index, (uint16_t) u);
+        removed[u] = true;
+    }
+
+    for (uint32_t q = 0; q < BENCH_QUERIES; q++)
+    {
+        uint32_t speaker = (uint32_t) (bench_uniform() * (float) num_users) % num_users;
+        int32_t exact_best = -1;
+        float exact_score = 0.0f;
+        uint32_t count;
+
+        if (removed[speaker])
+        {
+            continue;
+        }
+        bench_noisy(voices[speaker], BENCH_SAMPLE_NOISE, query);
+        queries++;
+
+        start = bench_time_us();
+        for (uint32_t u = 0; u < num_users; u++)
+        {
+            float score = voice_id_engine_dot(query, centroids[u], IFX_EMBEDDINGS_LENGTH_WORDS);
+
+            if (!removed[u] && ((exact_best < 0) || (score > exact_score)))
+            {
+                exact_best = (int32_t) u;
+                exact_score = score;
+            }
+        }
+        exact_us += bench_time_us() - start;
+
+        start = bench_time_us();
+        count = voice_id_index_search(&bench_index, query, bench_get_vector, NULL,
+                                      users, scores, VOICE_ID_INDEX_SHORTLIST);
+        index_us += bench_time_us() - start;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            removed_found += removed[users[i]] ? 1u : 0u;
+        }
+        recall += ((count > 0) && ((int32_t) users[0] == exact_best)) ? 1u : 0u;
+        exact_correct += (exact_best == (int32_t) speaker) ? 1u : 0u;
+        index_correct += ((count > 0) && (users[0] == speaker)) ? 1u : 0u;
+    }
+
+    printf("%5u  %-9s %5u  %7.2f%%  %7.2f%%  %7.2f%%  %9.2f  %9.2f  %9.1f  %u\n",
+        (unsigned) num_users, bench_index.trained ? "IVF-PQ" : "exhaust.", (unsigned) trainings,
+        100.0 * recall / queries, 100.0 * exact_correct / queries, 100.0 * index_correct / queries,
+        exact_us / queries, index_us / queries, train_us / 1000.0, (unsigned) removed_found);
+}
+
+int main(void)
+{
+    printf("Index: %u lists, %u probes, %u x %u-bit codes (%u bytes/user), shortlist %u, quantizers %u bytes\n",
+        (unsigned) VOICE_ID_INDEX_LISTS, (unsigned) VOICE_ID_INDEX_PROBES, (unsigned) VOICE_ID_INDEX_SUBSPACES,
+        4u, (unsigned) VOICE_ID_INDEX_CODE_SIZE, (unsigned) VOICE_ID_INDEX_SHORTLIST,
+        (unsigned) sizeof(voice_id_index_quantizer_t));
+    printf("users  search    train  recall@1  exact ok  index ok  exact us   index us   train ms  removed hits\n");
+    for (uint32_t i = 0; i < (sizeof(bench_user_counts) / sizeof(bench_user_counts[0])); i++)
+    {
+        bench_run(bench_user_counts[i]);
+    }
+    return 0;
+}
+
+/* [] END OF FILE */